@@ -3,6 +3,7 @@
 #include <Core/ResourceManager/Implementation/ResourceManagerState.h>
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 
 ezTypelessResourceHandle ezResourceManager::LoadResourceByType(const ezRTTI* pResourceType, const char* szResourceID)
 {
@@ -127,29 +128,6 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
   }
 }
 
-void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
-{
-  // Yep, it's really bubble sort!
-  // This will move the entry with the smallest value to the front and move all other values closer to their correct position,
-  // which is exactly what we need for the priority queue.
-  // We do this once a frame, which gives us nice iterative sorting, with relatively deterministic performance characteristics.
-
-  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
-
-  const ezUInt32 uiCount = data.GetCount();
-
-  for (ezUInt32 i = uiCount; i > 1; --i)
-  {
-    const ezUInt32 idx2 = i - 1;
-    const ezUInt32 idx1 = i - 2;
-
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
-    {
-      ezMath::Swap(data[idx1], data[idx2]);
-    }
-  }
-}
-
 void ezResourceManager::UpdateLoadingDeadlines()
 {
   if (s_State->s_LoadingQueue.IsEmpty())
@@ -159,39 +137,68 @@ void ezResourceManager::UpdateLoadingDeadlines()
 
   EZ_PROFILE_SCOPE("UpdateLoadingDeadlines");
 
-  const ezUInt32 uiCount = s_State->s_LoadingQueue.GetCount();
-  s_State->s_uiLastResourcePriorityUpdateIdx = ezMath::Min(s_State->s_uiLastResourcePriorityUpdateIdx, uiCount);
+  // The loading priorities change over time (e.g. when a resource gets acquired again), so a couple of them are re-evaluated
+  // every time, iterating over the whole queue over multiple calls.
+  // Every updated entry is moved to its correct place in the queue right away, so the next resource to load is always the most important one
+  // that we know of. Since entries move around in the heap, some may get updated twice and others not at all in one round, which is fine.
 
-  ezUInt32 uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
+  ezResourceLoadingQueue& queue = s_State->s_LoadingQueue;
+  const ezUInt32 uiUpdateCount = ezMath::Min(50u, queue.GetCount());
+  const ezTime tNow = ezTime::Now();
 
-  if (uiUpdateCount == 0)
-  {
-    s_State->s_uiLastResourcePriorityUpdateIdx = 0;
-    uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
-  }
-
-  if (uiUpdateCount > 0)
+  for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
   {
+    if (s_State->s_uiLastResourcePriorityUpdateIdx >= queue.GetCount())
     {
-      EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
-
-      const ezTime tNow = ezTime::Now();
-
-      for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
-      {
-        auto& element = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx];
-        element.m_fPriority = element.m_pResource->GetLoadingPriority(tNow);
-        ++s_State->s_uiLastResourcePriorityUpdateIdx;
-      }
+      s_State->s_uiLastResourcePriorityUpdateIdx = 0;
     }
 
-    {
-      EZ_PROFILE_SCOPE("SortLoadingDeadlines");
-      ReverseBubbleSortStep(s_State->s_LoadingQueue);
-    }
+    ezResource* pResource = queue[s_State->s_uiLastResourcePriorityUpdateIdx].m_pResource;
+    queue.UpdatePriority(pResource, pResource->GetLoadingPriority(tNow));
+
+    ++s_State->s_uiLastResourcePriorityUpdateIdx;
   }
 }
 
+void ezResourceManager::UpdateLoadingQueueStats()
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  LoadingQueueStats& stats = s_State->s_LoadingQueueStatsCurrentFrame;
+  stats.m_uiQueueDepth = s_State->s_LoadingQueue.GetCount();
+  stats.m_uiMaxQueueDepth = ezMath::Max(stats.m_uiMaxQueueDepth, stats.m_uiQueueDepth);
+
+  if (stats.m_uiNumLoadsStarted > 0)
+    stats.m_AverageTimeInQueue = s_State->s_TimeInQueueSum / stats.m_uiNumLoadsStarted;
+
+  if (stats.m_uiNumLoadsFinished > 0)
+    stats.m_AverageTimeToLoad = s_State->s_TimeToLoadSum / stats.m_uiNumLoadsFinished;
+
+  s_State->s_LoadingQueueStats = stats;
+
+  // start the next frame with the resources that are still queued
+  stats = LoadingQueueStats();
+  stats.m_uiMaxQueueDepth = s_State->s_LoadingQueue.GetCount();
+  s_State->s_TimeInQueueSum.SetZero();
+  s_State->s_TimeToLoadSum.SetZero();
+
+  const LoadingQueueStats& res = s_State->s_LoadingQueueStats;
+  ezStats::SetStat("Resource Manager/Loading Queue/Depth", res.m_uiQueueDepth);
+  ezStats::SetStat("Resource Manager/Loading Queue/Max Depth", res.m_uiMaxQueueDepth);
+  ezStats::SetStat("Resource Manager/Loading Queue/Loads Started", res.m_uiNumLoadsStarted);
+  ezStats::SetStat("Resource Manager/Loading Queue/Loads Finished", res.m_uiNumLoadsFinished);
+  ezStats::SetStat("Resource Manager/Loading Queue/Avg Time In Queue (ms)", res.m_AverageTimeInQueue.GetMilliseconds());
+  ezStats::SetStat("Resource Manager/Loading Queue/Max Time In Queue (ms)", res.m_MaxTimeInQueue.GetMilliseconds());
+  ezStats::SetStat("Resource Manager/Loading Queue/Avg Time To Load (ms)", res.m_AverageTimeToLoad.GetMilliseconds());
+  ezStats::SetStat("Resource Manager/Loading Queue/Max Time To Load (ms)", res.m_MaxTimeToLoad.GetMilliseconds());
+}
+
+ezResourceManager::LoadingQueueStats ezResourceManager::GetLoadingQueueStats()
+{
+  EZ_LOCK(s_ResourceMutex);
+  return s_State->s_LoadingQueueStats;
+}
+
 void ezResourceManager::PreloadResource(ezResource* pResource)
 {
   InternalPreloadResource(pResource, false);
@@ -220,10 +227,7 @@ ezResult ezResourceManager::RemoveFromLoadingQueue(ezResource* pResource)
   if (!IsQueuedForLoading(pResource))
     return EZ_SUCCESS;
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
-  if (s_State->s_LoadingQueue.RemoveAndSwap(li))
+  if (s_State->s_LoadingQueue.Remove(pResource))
   {
     pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     return EZ_SUCCESS;
@@ -239,20 +243,18 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
 
   pResource->m_Flags.Add(ezResourceFlags::IsQueuedForLoading);
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
   if (bHighestPriority)
   {
     pResource->SetPriority(ezResourcePriority::Critical);
-    li.m_fPriority = 0.0f;
-    s_State->s_LoadingQueue.PushFront(li);
+    s_State->s_LoadingQueue.InsertFront(pResource, ezTime::Now());
   }
   else
   {
-    li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
-    s_State->s_LoadingQueue.PushBack(li);
+    s_State->s_LoadingQueue.Insert(pResource, pResource->GetLoadingPriority(s_State->s_LastFrameUpdate), ezTime::Now());
   }
+
+  LoadingQueueStats& stats = s_State->s_LoadingQueueStatsCurrentFrame;
+  stats.m_uiMaxQueueDepth = ezMath::Max(stats.m_uiMaxQueueDepth, s_State->s_LoadingQueue.GetCount());
 }
 
 bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
@@ -284,10 +286,7 @@ bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
   {
     bAllowPreloading = false;
 
-    LoadingInfo li;
-    li.m_pResource = pResource;
-
-    if (s_State->s_LoadingQueue.IndexOf(li) == ezInvalidIndex)
+    if (!s_State->s_LoadingQueue.Contains(pResource))
     {
       // the resource is marked as 'loading' but it is not in the queue anymore
       // that means some task is already working on loading it
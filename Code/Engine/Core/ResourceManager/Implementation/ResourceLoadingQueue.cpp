@@ -0,0 +1,185 @@
+#include <CorePCH.h>
+
+#include <Core/ResourceManager/Implementation/ResourceLoadingQueue.h>
+#include <Core/ResourceManager/Resource.h>
+
+ezResourceLoadingQueue::ezResourceLoadingQueue() = default;
+
+ezResourceLoadingQueue::~ezResourceLoadingQueue()
+{
+  Clear();
+}
+
+bool ezResourceLoadingQueue::Contains(const ezResource* pResource) const
+{
+  return pResource->m_uiLoadingQueueIndex != ezInvalidIndex;
+}
+
+void ezResourceLoadingQueue::Insert(ezResource* pResource, float fPriority, ezTime queuedTime)
+{
+  InsertEntry(pResource, fPriority, queuedTime, 0);
+}
+
+void ezResourceLoadingQueue::InsertFront(ezResource* pResource, ezTime queuedTime)
+{
+  InsertEntry(pResource, 0.0f, queuedTime, m_uiNextFrontOrder++);
+}
+
+bool ezResourceLoadingQueue::Remove(ezResource* pResource)
+{
+  if (!Contains(pResource))
+    return false;
+
+  RemoveAt(pResource->m_uiLoadingQueueIndex);
+  return true;
+}
+
+void ezResourceLoadingQueue::UpdatePriority(ezResource* pResource, float fPriority)
+{
+  EZ_ASSERT_DEV(Contains(pResource), "Resource '{0}' is not in the loading queue", pResource->GetResourceID());
+
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  Entry& entry = m_Heap[uiIndex];
+
+  if (entry.m_fPriority == fPriority)
+    return;
+
+  const bool bMovesUp = fPriority < entry.m_fPriority;
+  entry.m_fPriority = fPriority;
+
+  if (bMovesUp)
+    SiftUp(uiIndex);
+  else
+    SiftDown(uiIndex);
+}
+
+const ezResourceLoadingQueue::Entry& ezResourceLoadingQueue::PeekFront() const
+{
+  EZ_ASSERT_DEV(!m_Heap.IsEmpty(), "The loading queue is empty");
+  return m_Heap[0];
+}
+
+void ezResourceLoadingQueue::PopFront()
+{
+  EZ_ASSERT_DEV(!m_Heap.IsEmpty(), "The loading queue is empty");
+  RemoveAt(0);
+}
+
+void ezResourceLoadingQueue::Clear()
+{
+  for (Entry& entry : m_Heap)
+  {
+    entry.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+  }
+
+  m_Heap.Clear();
+  m_uiNextFrontOrder = 1;
+}
+
+bool ezResourceLoadingQueue::IsLoadedBefore(const Entry& lhs, const Entry& rhs)
+{
+  if (lhs.m_fPriority != rhs.m_fPriority)
+    return lhs.m_fPriority < rhs.m_fPriority;
+
+  if (lhs.m_uiFrontOrder != rhs.m_uiFrontOrder)
+    return lhs.m_uiFrontOrder > rhs.m_uiFrontOrder;
+
+  return lhs.m_QueuedTime < rhs.m_QueuedTime;
+}
+
+void ezResourceLoadingQueue::InsertEntry(ezResource* pResource, float fPriority, ezTime queuedTime, ezUInt32 uiFrontOrder)
+{
+  EZ_ASSERT_DEV(!Contains(pResource), "Resource '{0}' is already in the loading queue", pResource->GetResourceID());
+
+  Entry& entry = m_Heap.ExpandAndGetRef();
+  entry.m_fPriority = fPriority;
+  entry.m_QueuedTime = queuedTime;
+  entry.m_uiFrontOrder = uiFrontOrder;
+  entry.m_pResource = pResource;
+
+  const ezUInt32 uiIndex = m_Heap.GetCount() - 1;
+  pResource->m_uiLoadingQueueIndex = uiIndex;
+
+  SiftUp(uiIndex);
+}
+
+void ezResourceLoadingQueue::MoveToIndex(Entry&& entry, ezUInt32 uiIndex)
+{
+  entry.m_pResource->m_uiLoadingQueueIndex = uiIndex;
+  m_Heap[uiIndex] = std::move(entry);
+}
+
+void ezResourceLoadingQueue::SiftUp(ezUInt32 uiIndex)
+{
+  Entry entry = std::move(m_Heap[uiIndex]);
+
+  while (uiIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiIndex - 1) / Arity;
+
+    if (!IsLoadedBefore(entry, m_Heap[uiParent]))
+      break;
+
+    MoveToIndex(std::move(m_Heap[uiParent]), uiIndex);
+    uiIndex = uiParent;
+  }
+
+  MoveToIndex(std::move(entry), uiIndex);
+}
+
+void ezResourceLoadingQueue::SiftDown(ezUInt32 uiIndex)
+{
+  const ezUInt32 uiCount = m_Heap.GetCount();
+  Entry entry = std::move(m_Heap[uiIndex]);
+
+  while (true)
+  {
+    const ezUInt32 uiFirstChild = uiIndex * Arity + 1;
+
+    if (uiFirstChild >= uiCount)
+      break;
+
+    const ezUInt32 uiLastChild = ezMath::Min(uiFirstChild + Arity, uiCount);
+
+    ezUInt32 uiBestChild = uiFirstChild;
+    for (ezUInt32 uiChild = uiFirstChild + 1; uiChild < uiLastChild; ++uiChild)
+    {
+      if (IsLoadedBefore(m_Heap[uiChild], m_Heap[uiBestChild]))
+        uiBestChild = uiChild;
+    }
+
+    if (!IsLoadedBefore(m_Heap[uiBestChild], entry))
+      break;
+
+    MoveToIndex(std::move(m_Heap[uiBestChild]), uiIndex);
+    uiIndex = uiBestChild;
+  }
+
+  MoveToIndex(std::move(entry), uiIndex);
+}
+
+void ezResourceLoadingQueue::RemoveAt(ezUInt32 uiIndex)
+{
+  m_Heap[uiIndex].m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+
+  const ezUInt32 uiLastIndex = m_Heap.GetCount() - 1;
+
+  if (uiIndex != uiLastIndex)
+  {
+    // move the last entry into the gap and restore the heap property from there
+    m_Heap[uiIndex] = m_Heap[uiLastIndex];
+    m_Heap.PopBack();
+
+    if (uiIndex > 0 && IsLoadedBefore(m_Heap[uiIndex], m_Heap[(uiIndex - 1) / Arity]))
+      SiftUp(uiIndex);
+    else
+      SiftDown(uiIndex);
+  }
+  else
+  {
+    m_Heap.PopBack();
+  }
+}
+
+
+EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_ResourceLoadingQueue);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Core/CoreInternal.h>
+EZ_CORE_INTERNAL_HEADER
+
+#include <Core/ResourceManager/Implementation/Declarations.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Time/Time.h>
+
+/// \brief [internal] The priority queue of resources that are waiting for a ezResourceManagerWorkerDataLoad task to load them.
+///
+/// This is an indexed d-ary min-heap. Every queued resource stores its current position in the heap (see ezResource::m_uiLoadingQueueIndex),
+/// so removing a resource or changing its priority only costs O(log n) and does not require to search for it first.
+///
+/// Entries with a lower priority value are loaded first. Entries with the same priority value are loaded in the order in which they were queued,
+/// except for entries that were pushed to the front with InsertFront(), which are loaded before all others with the same priority, newest first.
+class ezResourceLoadingQueue
+{
+public:
+  struct Entry
+  {
+    float m_fPriority = 0.0f;
+    ezTime m_QueuedTime;
+    ezUInt32 m_uiFrontOrder = 0; ///< Non-zero for entries added with InsertFront(), larger values were added later.
+    ezResource* m_pResource = nullptr;
+  };
+
+  ezResourceLoadingQueue();
+  ~ezResourceLoadingQueue();
+
+  EZ_ALWAYS_INLINE bool IsEmpty() const { return m_Heap.IsEmpty(); }
+  EZ_ALWAYS_INLINE ezUInt32 GetCount() const { return m_Heap.GetCount(); }
+
+  /// \brief Gives access to the entries in heap order, which is not the order in which they will be loaded.
+  EZ_ALWAYS_INLINE const Entry& operator[](ezUInt32 uiIndex) const { return m_Heap[uiIndex]; }
+
+  /// \brief Returns whether the resource is currently waiting in this queue.
+  bool Contains(const ezResource* pResource) const;
+
+  /// \brief Adds the resource to the queue. It must not be in the queue already.
+  void Insert(ezResource* pResource, float fPriority, ezTime queuedTime);
+
+  /// \brief Adds the resource with priority 0 in front of everything that is already queued. It must not be in the queue already.
+  void InsertFront(ezResource* pResource, ezTime queuedTime);
+
+  /// \brief Removes the resource from the queue. Returns false, if it was not in the queue.
+  bool Remove(ezResource* pResource);
+
+  /// \brief Changes the priority of a queued resource and moves it to its new position in the queue.
+  void UpdatePriority(ezResource* pResource, float fPriority);
+
+  /// \brief Returns the entry that should be loaded next. The queue must not be empty.
+  const Entry& PeekFront() const;
+
+  /// \brief Removes the entry that should be loaded next. The queue must not be empty.
+  void PopFront();
+
+  void Clear();
+
+private:
+  /// \brief Each node has this many children. With 4 the heap is flatter than a binary heap and the children of a node share a cache line.
+  static constexpr ezUInt32 Arity = 4;
+
+  static bool IsLoadedBefore(const Entry& lhs, const Entry& rhs);
+
+  void InsertEntry(ezResource* pResource, float fPriority, ezTime queuedTime, ezUInt32 uiFrontOrder);
+  void MoveToIndex(Entry&& entry, ezUInt32 uiIndex);
+  void SiftUp(ezUInt32 uiIndex);
+  void SiftDown(ezUInt32 uiIndex);
+  void RemoveAt(ezUInt32 uiIndex);
+
+  ezDynamicArray<Entry> m_Heap;
+  ezUInt32 m_uiNextFrontOrder = 1;
+};
@@ -504,6 +504,8 @@ void ezResourceManager::PerFrameUpdate()
   {
     FreeUnusedResources(s_State->m_AutoFreeUnusedTimeout, s_State->m_AutoFreeUnusedThreshold);
   }
+
+  UpdateLoadingQueueStats();
 }
 
 const ezEvent<const ezResourceEvent&, ezMutex>& ezResourceManager::GetResourceEvents()
@@ -577,9 +579,9 @@ void ezResourceManager::EngineAboutToShutdown()
   {
     EZ_LOCK(s_ResourceMutex);
 
-    for (auto entry : s_State->s_LoadingQueue)
+    for (ezUInt32 i = 0; i < s_State->s_LoadingQueue.GetCount(); ++i)
     {
-      entry.m_pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      s_State->s_LoadingQueue[i].m_pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     }
 
     s_State->s_LoadingQueue.Clear();
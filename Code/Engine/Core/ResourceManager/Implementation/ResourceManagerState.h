@@ -3,6 +3,7 @@
 #include <Core/CoreInternal.h>
 EZ_CORE_INTERNAL_HEADER
 
+#include <Core/ResourceManager/Implementation/ResourceLoadingQueue.h>
 #include <Core/ResourceManager/ResourceManager.h>
 
 class ezResourceManagerState
@@ -51,7 +52,7 @@ private:
   ezUInt32 s_uiForceNoFallbackAcquisition = 0;
 
   // resources in this queue are waiting for a task to load them
-  ezDeque<ezResourceManager::LoadingInfo> s_LoadingQueue;
+  ezResourceLoadingQueue s_LoadingQueue;
 
   ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources> s_LoadedResources;
 
@@ -64,6 +65,13 @@ private:
   ezTime s_LastFrameUpdate;
   ezUInt32 s_uiLastResourcePriorityUpdateIdx = 0;
 
+  // Loading statistics
+
+  ezResourceManager::LoadingQueueStats s_LoadingQueueStats;             // finished stats of the previous frame
+  ezResourceManager::LoadingQueueStats s_LoadingQueueStatsCurrentFrame; // the averages are only computed in UpdateLoadingQueueStats()
+  ezTime s_TimeInQueueSum;
+  ezTime s_TimeToLoadSum;
+
   ezDynamicArray<ezResource*> s_LoadedResourceOfTypeTempContainer;
   ezHashTable<ezTempHashedString, const ezRTTI*> s_ResourcesToUnloadOnMainThread;
 
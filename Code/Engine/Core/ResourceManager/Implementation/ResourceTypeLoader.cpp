@@ -8,11 +8,44 @@
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
 
-struct FileResourceLoadData
+namespace
 {
-  ezBlob m_Storage;
-  ezRawMemoryStreamReader m_Reader;
-};
+  /// Reads the header that ezResourceLoaderFromFile puts in front of the file data and then continues with the file content, which
+  /// stays in the memory of its data directory.
+  class MappedFileStreamReader : public ezStreamReader
+  {
+  public:
+    virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+    {
+      ezUInt64 uiBytesRead = m_Header.ReadBytes(pReadBuffer, uiBytesToRead);
+
+      if (uiBytesRead < uiBytesToRead)
+      {
+        uiBytesRead += m_Content.ReadBytes(static_cast<ezUInt8*>(pReadBuffer) + uiBytesRead, uiBytesToRead - uiBytesRead);
+      }
+
+      return uiBytesRead;
+    }
+
+    virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override
+    {
+      const ezUInt64 uiBytesSkipped = m_Header.SkipBytes(uiBytesToSkip);
+      return uiBytesSkipped + m_Content.SkipBytes(uiBytesToSkip - uiBytesSkipped);
+    }
+
+    ezRawMemoryStreamReader m_Header;
+    ezRawMemoryStreamReader m_Content;
+  };
+
+  struct FileResourceLoadData
+  {
+    ezBlob m_Storage;
+    ezRawMemoryStreamReader m_Reader;
+
+    ezFileReader m_File;
+    MappedFileStreamReader m_MappedReader;
+  };
+} // namespace
 
 ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pResource)
 {
@@ -20,9 +53,14 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   ezResourceLoadData res;
 
-  ezFileReader File;
+  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
+
+  ezFileReader& File = pData->m_File;
   if (File.Open(pResource->GetResourceID().GetData()).Failed())
+  {
+    EZ_DEFAULT_DELETE(pData);
     return res;
+  }
 
   res.m_sResourceDescription = File.GetFilePathRelative().GetData();
 
@@ -35,11 +73,12 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
 #endif
 
-  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
-
+  // files that are already in memory (e.g. uncompressed archive entries) are read in place, everything else is copied into the blob
+  const ezArrayPtr<const ezUInt8> mappedData = File.GetMappedData();
   const ezUInt64 uiFileSize = File.GetFileSize();
+  const ezUInt64 uiCopiedSize = mappedData.IsEmpty() ? uiFileSize : 0;
 
-  const ezUInt64 uiBlobCapacity = uiFileSize + File.GetFilePathAbsolute().GetElementCount() + 8; // +8 for the string overhead
+  const ezUInt64 uiBlobCapacity = uiCopiedSize + File.GetFilePathAbsolute().GetElementCount() + 8; // +8 for the string overhead
   pData->m_Storage.SetCountUninitialized(uiBlobCapacity);
 
   ezUInt8* pBlobPtr = pData->m_Storage.GetBlobPtr<ezUInt8>().GetPtr();
@@ -51,10 +90,22 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   const ezUInt64 uiOffset = w.GetNumWrittenBytes();
 
-  File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+  if (mappedData.IsEmpty())
+  {
+    File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+    File.Close();
+
+    pData->m_Reader.Reset(pBlobPtr, uiOffset + uiFileSize);
+    res.m_pDataStream = &pData->m_Reader;
+  }
+  else
+  {
+    // the mapped data is only valid while the file is open, so it is kept open until CloseDataStream()
+    pData->m_MappedReader.m_Header.Reset(pBlobPtr, uiOffset);
+    pData->m_MappedReader.m_Content.Reset(mappedData.GetPtr(), mappedData.GetCount());
+    res.m_pDataStream = &pData->m_MappedReader;
+  }
 
-  pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
-  res.m_pDataStream = &pData->m_Reader;
   res.m_pCustomLoaderData = pData;
 
   return res;
@@ -15,6 +15,7 @@ void ezResourceManagerWorkerDataLoad::Execute()
   ezResource* pResourceToLoad = nullptr;
   ezResourceTypeLoader* pLoader = nullptr;
   ezUniquePtr<ezResourceTypeLoader> pCustomLoader;
+  ezTime queuedTime;
 
   {
     EZ_LOCK(ezResourceManager::s_ResourceMutex);
@@ -27,10 +28,20 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
     ezResourceManager::UpdateLoadingDeadlines();
 
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
+    const ezResourceLoadingQueue::Entry& entry = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
+    pResourceToLoad = entry.m_pResource;
+    queuedTime = entry.m_QueuedTime;
     ezResourceManager::s_State->s_LoadingQueue.PopFront();
 
+    {
+      const ezTime timeInQueue = ezTime::Now() - queuedTime;
+
+      ezResourceManager::LoadingQueueStats& stats = ezResourceManager::s_State->s_LoadingQueueStatsCurrentFrame;
+      ++stats.m_uiNumLoadsStarted;
+      stats.m_MaxTimeInQueue = ezMath::Max(stats.m_MaxTimeInQueue, timeInQueue);
+      ezResourceManager::s_State->s_TimeInQueueSum += timeInQueue;
+    }
+
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
       pCustomLoader = std::move(ezResourceManager::s_State->s_CustomLoaders[pResourceToLoad]);
@@ -94,6 +105,7 @@ void ezResourceManagerWorkerDataLoad::Execute()
     pUpdateContentTask->m_pLoader = pLoader;
     pUpdateContentTask->m_pCustomLoader = std::move(pCustomLoader);
     pUpdateContentTask->m_pResourceToLoad = pResourceToLoad;
+    pUpdateContentTask->m_QueuedTime = queuedTime;
 
     // schedule the task to run, either on the main thread or on some other thread
     *pUpdateContentGroup = ezTaskSystem::StartSingleTask(pUpdateContentTask, bResourceIsLoadedOnMainThread ? ezTaskPriority::SomeFrameMainThread : ezTaskPriority::LateNextFrame);
@@ -151,6 +163,13 @@ void ezResourceManagerWorkerUpdateContent::Execute()
     EZ_ASSERT_DEV(ezResourceManager::IsQueuedForLoading(m_pResourceToLoad), "Multi-threaded access detected");
     m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     m_pResourceToLoad->m_LastAcquire = ezResourceManager::GetLastFrameUpdate();
+
+    const ezTime timeToLoad = ezTime::Now() - m_QueuedTime;
+
+    ezResourceManager::LoadingQueueStats& stats = ezResourceManager::s_State->s_LoadingQueueStatsCurrentFrame;
+    ++stats.m_uiNumLoadsFinished;
+    stats.m_MaxTimeToLoad = ezMath::Max(stats.m_MaxTimeToLoad, timeToLoad);
+    ezResourceManager::s_State->s_TimeToLoadSum += timeToLoad;
   }
 
   m_pLoader = nullptr;
@@ -135,6 +135,7 @@ private:
   friend class ezResourceManager;
   friend class ezResourceManagerWorkerDataLoad;
   friend class ezResourceManagerWorkerUpdateContent;
+  friend class ezResourceLoadingQueue;
 
   /// \brief Called by ezResourceManager shortly after resource creation.
   void SetUniqueID(const char* szUniqueID, bool bIsReloadable);
@@ -229,6 +230,9 @@ private:
   ezResourcePriority m_Priority = ezResourcePriority::Medium;
   ezTimestamp m_LoadedFileModificationTime;
 
+  // position in the resource manager's loading queue, ezInvalidIndex while the resource is not waiting in it
+  ezUInt32 m_uiLoadingQueueIndex = ezInvalidIndex;
+
 private:
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   static const ezResource* GetCurrentlyUpdatingContent();
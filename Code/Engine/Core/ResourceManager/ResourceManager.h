@@ -217,6 +217,24 @@ public:
   /// \brief Must be called once per frame for some bookkeeping.
   static void PerFrameUpdate();
 
+  /// \brief Statistics about the resource loading queue, gathered between two calls to PerFrameUpdate().
+  struct LoadingQueueStats
+  {
+    ezUInt32 m_uiQueueDepth = 0;       ///< Number of resources that were waiting to be loaded at the end of the frame.
+    ezUInt32 m_uiMaxQueueDepth = 0;    ///< Largest number of resources that were waiting to be loaded at the same time during the frame.
+    ezUInt32 m_uiNumLoadsStarted = 0;  ///< Number of resources that a loading task took out of the queue.
+    ezUInt32 m_uiNumLoadsFinished = 0; ///< Number of resources whose content was updated.
+    ezTime m_AverageTimeInQueue;       ///< Average time between queuing a resource and a loading task picking it up.
+    ezTime m_MaxTimeInQueue;
+    ezTime m_AverageTimeToLoad;        ///< Average time between queuing a resource and its content being updated.
+    ezTime m_MaxTimeToLoad;
+  };
+
+  /// \brief Returns the loading queue statistics of the previous frame.
+  ///
+  /// The same values are also published through ezStats under 'Resource Manager/Loading Queue'.
+  static LoadingQueueStats GetLoadingQueueStats();
+
   /// \brief Makes sure that no further resource loading will take place.
   static void EngineAboutToShutdown();
 
@@ -420,14 +438,6 @@ private:
     ezHashTable<ezTempHashedString, ezResource*> m_Resources;
   };
 
-  struct LoadingInfo
-  {
-    float m_fPriority = 0;
-    ezResource* m_pResource = nullptr;
-
-    EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
-    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
-  };
   static void EnsureResourceLoadingState(ezResource* pResource, const ezResourceState RequestedState);
   static void PreloadResource(ezResource* pResource);
   static void InternalPreloadResource(ezResource* pResource, bool bHighestPriority);
@@ -437,7 +447,7 @@ private:
   static ezResource* GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
   static void RunWorkerTask(ezResource* pResource);
   static void UpdateLoadingDeadlines();
-  static void ReverseBubbleSortStep(ezDeque<LoadingInfo>& data);
+  static void UpdateLoadingQueueStats();
   static bool ReloadResource(ezResource* pResource, bool bForce);
 
   static void SetupWorkerTasks();
@@ -54,6 +54,7 @@ public:
 /// \brief A default implementation of ezResourceTypeLoader for standard file loading.
 ///
 /// The loader will interpret the ezResource 'resource ID' as a path, read that full file into a memory stream.
+/// Files that their data directory already holds in memory (see ezFileReaderBase::GetMappedData()) are not copied, but read in place.
 /// The file modification data is stored as well.
 /// Resources that use this loader can update their data as if they were reading the file directly.
 class EZ_CORE_DLL ezResourceLoaderFromFile : public ezResourceTypeLoader
@@ -223,6 +223,9 @@ private:
   bool SendMessageInternal(ezMessage& msg, bool bWasPostedMsg);
   bool SendMessageInternal(ezMessage& msg, bool bWasPostedMsg) const;
 
+  // same as SendMessageInternal but with a handler that was already looked up in m_pMessageDispatchType, see ezComponentManagerBase::DeliverQueuedMessages
+  bool SendMessageInternal(ezMessage& msg, bool bWasPostedMsg, ezAbstractMessageHandler* pHandler);
+
   ezComponentId m_InternalId;
   ezBitflags<ezObjectFlags> m_ComponentFlags;
   ezUInt32 m_uiUniqueID;
@@ -59,6 +59,24 @@ public:
   /// Prefer to use more efficient methods on derived classes, only use this if you need to go through a ezComponentManagerBase pointer.
   virtual void CollectAllComponents(ezDynamicArray<ezComponent*>& out_AllComponents, bool bOnlyActive) = 0;
 
+  /// \brief A queued message and the component it is addressed to.
+  struct QueuedMessage
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezComponentHandle m_hReceiver;
+    ezMessage* m_pMessage;
+  };
+
+  /// \brief Called by the world while processing its message queues with all queued messages of one type that are addressed to
+  /// components of this manager.
+  ///
+  /// The messages are passed in the deterministic order of the queue. The default implementation resolves the message handler once
+  /// per dispatch type and then sends the messages to the individual components, just like ezComponent::SendMessage would.
+  /// Derived managers can override this to process all messages of one type at once, e.g. to gather them into their own data structures.
+  /// Receivers that do not exist anymore have to be skipped.
+  virtual void DeliverQueuedMessages(ezArrayPtr<const QueuedMessage> messages);
+
 protected:
   /// \cond
   // internal methods
@@ -81,6 +99,9 @@ protected:
   /// \endcond
 
   ezIdTable<ezComponentId, ezComponent*> m_Components;
+
+  /// \brief Number of components that fit into one block of the component storage. Asynchronous updates are split at multiples of it.
+  ezUInt32 m_uiComponentsPerBlock = 1;
 };
 
 template <typename T, ezBlockStorageType::Enum StorageType>
@@ -4,6 +4,7 @@
 
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/AtomicUtils.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Types/TagSet.h>
 
@@ -506,6 +507,16 @@ private:
 
     void UpdateLocalTransform();
 
+    /// \brief Marks this object for the transform and bounds update of the next world update.
+    ///
+    /// Transformation data is stored in blocks of ezInternal::DEFAULT_BLOCK_SIZE bytes that are aligned to their size. The unused space
+    /// at the end of each block holds a bitmask with one bit per element of the block, which is set by this function. The world only
+    /// updates the elements whose bit is set and marks their children in turn.
+    void MarkDirty();
+
+    /// \brief Returns the dirty bitmask of the block that contains the given transformation data.
+    static volatile ezInt32& GetBlockDirtyMask(const TransformationData* pData);
+
     void ConditionalUpdateGlobalTransform();
     void UpdateGlobalTransform();
     void UpdateGlobalTransformWithParent();
@@ -113,6 +113,11 @@ void ezComponent::EnsureSimulationStarted()
 }
 
 bool ezComponent::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg)
+{
+  return SendMessageInternal(msg, bWasPostedMsg, m_pMessageDispatchType->FindMessageHandler(msg.GetId()));
+}
+
+bool ezComponent::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg, ezAbstractMessageHandler* pHandler)
 {
   if (!IsActiveAndInitialized() && !IsInitializing())
   {
@@ -125,8 +130,11 @@ bool ezComponent::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg)
     return false;
   }
 
-  if (m_pMessageDispatchType->DispatchMessage(this, msg))
+  if (pHandler != nullptr)
+  {
+    (*pHandler)(this, msg);
     return true;
+  }
 
   if (m_ComponentFlags.IsSet(ezObjectFlags::UnhandledMessageHandler) && OnUnhandledMessage(msg, bWasPostedMsg))
     return true;
@@ -45,6 +45,37 @@ void ezComponentManagerBase::DeleteComponent(ezComponent* pComponent)
   GetWorld()->m_Data.m_DeadComponents.Insert(pComponent);
 }
 
+void ezComponentManagerBase::DeliverQueuedMessages(ezArrayPtr<const QueuedMessage> messages)
+{
+  const ezRTTI* pDispatchType = nullptr;
+  ezAbstractMessageHandler* pHandler = nullptr;
+
+  for (const QueuedMessage& queuedMsg : messages)
+  {
+    ezComponent* pReceiverComponent = nullptr;
+    if (!m_Components.TryGetValue(queuedMsg.m_hReceiver, pReceiverComponent))
+    {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+      if (queuedMsg.m_pMessage->GetDebugMessageRouting())
+      {
+        ezLog::Warning("ezWorld::ProcessQueuedMessage: Receiver ezComponent for message of type '{0}' does not exist anymore.",
+          queuedMsg.m_pMessage->GetId());
+      }
+#endif
+      continue;
+    }
+
+    // all components of a manager usually share the same dispatch type, so the handler only needs to be looked up once per batch
+    if (pReceiverComponent->m_pMessageDispatchType != pDispatchType)
+    {
+      pDispatchType = pReceiverComponent->m_pMessageDispatchType;
+      pHandler = pDispatchType->FindMessageHandler(queuedMsg.m_pMessage->GetId());
+    }
+
+    pReceiverComponent->SendMessageInternal(*queuedMsg.m_pMessage, true, pHandler);
+  }
+}
+
 void ezComponentManagerBase::Deinitialize()
 {
   for (auto it = m_Components.GetIterator(); it.IsValid(); ++it)
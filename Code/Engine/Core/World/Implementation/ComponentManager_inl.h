@@ -45,6 +45,8 @@ ezComponentManager<T, StorageType>::ezComponentManager(ezWorld* pWorld)
     , m_ComponentStorage(GetBlockAllocator(), GetAllocator())
 {
   EZ_CHECK_AT_COMPILETIME_MSG(EZ_IS_DERIVED_FROM_STATIC(ezComponent, ComponentType), "Not a valid component type");
+
+  m_uiComponentsPerBlock = ezDataBlock<ComponentType, ezInternal::DEFAULT_BLOCK_SIZE>::CAPACITY;
 }
 
 template <typename T, ezBlockStorageType::Enum StorageType>
@@ -156,6 +158,10 @@ EZ_FORCE_INLINE void ezComponentManager<T, StorageType>::RegisterUpdateFunction(
     desc.m_uiGranularity =
         ezMath::RoundUp((ezInt32)desc.m_uiGranularity, ezDataBlock<ComponentType, ezInternal::DEFAULT_BLOCK_SIZE>::CAPACITY);
 
+  // a manager always writes to its own components
+  if (!desc.m_ReadAccess.IsEmpty() || !desc.m_WriteAccess.IsEmpty())
+    desc.m_WriteAccess.PushBack(ezGetStaticRTTI<ComponentType>());
+
   ezComponentManagerBase::RegisterUpdateFunction(desc);
 }
 
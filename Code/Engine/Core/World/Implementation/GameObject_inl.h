@@ -245,6 +245,7 @@ EZ_ALWAYS_INLINE ezTransform ezGameObject::GetGlobalTransform() const
 EZ_ALWAYS_INLINE void ezGameObject::SetLocalPosition(const ezSimdVec4f& position, UpdateBehaviorIfStatic updateBehavior)
 {
   m_pTransformationData->m_localPosition = position;
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -261,6 +262,7 @@ EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetLocalPositionSimd() const
 EZ_ALWAYS_INLINE void ezGameObject::SetLocalRotation(const ezSimdQuat& rotation, UpdateBehaviorIfStatic updateBehavior)
 {
   m_pTransformationData->m_localRotation = rotation;
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -279,6 +281,7 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalScaling(const ezSimdVec4f& scaling,
   ezSimdFloat uniformScale = m_pTransformationData->m_localScaling.w();
   m_pTransformationData->m_localScaling = scaling;
   m_pTransformationData->m_localScaling.SetW(uniformScale);
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -295,6 +298,7 @@ EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetLocalScalingSimd() const
 EZ_ALWAYS_INLINE void ezGameObject::SetLocalUniformScaling(const ezSimdFloat& scaling, UpdateBehaviorIfStatic updateBehavior)
 {
   m_pTransformationData->m_localScaling.SetW(scaling);
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -319,6 +323,7 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalPosition(const ezSimdVec4f& positio
   m_pTransformationData->m_globalTransform.m_Position = position;
 
   m_pTransformationData->UpdateLocalTransform();
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic())
   {
@@ -337,6 +342,7 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalRotation(const ezSimdQuat& rotation
   m_pTransformationData->m_globalTransform.m_Rotation = rotation;
 
   m_pTransformationData->UpdateLocalTransform();
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic())
   {
@@ -355,6 +361,7 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalScaling(const ezSimdVec4f& scaling)
   m_pTransformationData->m_globalTransform.m_Scale = scaling;
 
   m_pTransformationData->UpdateLocalTransform();
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic())
   {
@@ -377,6 +384,7 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalTransform(const ezSimdTransform& tr
   // use EZ_SIMD_IMPLEMENTATION_FPU, e.g. arm atm.
   m_pTransformationData->m_globalTransform.m_Scale.SetW(1.0f);
   m_pTransformationData->UpdateLocalTransform();
+  m_pTransformationData->MarkDirty();
 
   if (IsStatic())
   {
@@ -393,6 +401,7 @@ EZ_ALWAYS_INLINE const ezSimdTransform& ezGameObject::GetGlobalTransformSimd() c
 EZ_ALWAYS_INLINE void ezGameObject::SetVelocity(const ezVec3& vVelocity)
 {
   m_pTransformationData->m_velocity = ezSimdVec4f(vVelocity.x, vVelocity.y, vVelocity.z, 1.0f);
+  m_pTransformationData->MarkDirty();
 }
 
 EZ_ALWAYS_INLINE ezVec3 ezGameObject::GetVelocity() const
@@ -536,6 +545,27 @@ EZ_ALWAYS_INLINE bool ezGameObject::SendMessageRecursive(ezMessage& msg) const
 
 //////////////////////////////////////////////////////////////////////////
 
+// static
+EZ_ALWAYS_INLINE volatile ezInt32& ezGameObject::TransformationData::GetBlockDirtyMask(const TransformationData* pData)
+{
+  const size_t uiBlockAddress = reinterpret_cast<size_t>(pData) & ~static_cast<size_t>(ezInternal::DEFAULT_BLOCK_SIZE - 1);
+  return *reinterpret_cast<volatile ezInt32*>(uiBlockAddress + ezInternal::DEFAULT_BLOCK_SIZE - sizeof(ezInt32));
+}
+
+EZ_FORCE_INLINE void ezGameObject::TransformationData::MarkDirty()
+{
+  const size_t uiOffsetInBlock = reinterpret_cast<size_t>(this) & static_cast<size_t>(ezInternal::DEFAULT_BLOCK_SIZE - 1);
+  const ezInt32 iBit = 1 << static_cast<ezUInt32>(uiOffsetInBlock / sizeof(TransformationData));
+
+  volatile ezInt32& iDirtyMask = GetBlockDirtyMask(this);
+
+  // objects are often moved every frame, so avoid the atomic operation if the bit is already set
+  if ((iDirtyMask & iBit) == 0)
+  {
+    ezAtomicUtils::Or(iDirtyMask, iBit);
+  }
+}
+
 EZ_ALWAYS_INLINE void ezGameObject::TransformationData::UpdateGlobalTransform()
 {
   m_globalTransform.m_Position = m_localPosition;
@@ -113,6 +113,51 @@ void ezSpatialSystem::UpdateSpatialData(const ezSpatialDataHandle& hData, const
   }
 }
 
+void ezSpatialSystem::UpdateSpatialDataBatch(ezArrayPtr<const SpatialDataUpdate> updates)
+{
+  m_PendingChanges.Clear();
+
+  for (const SpatialDataUpdate& update : updates)
+  {
+    ezSpatialData* pData = nullptr;
+    if (!m_DataTable.TryGetValue(update.m_hData.GetInternalID(), pData))
+      continue;
+
+    pData->m_pObject = update.m_pObject;
+
+    if (!pData->m_Flags.IsSet(ezSpatialData::Flags::AlwaysVisible))
+    {
+      if (update.m_uiCategoryBitmask != pData->m_uiCategoryBitmask || update.m_Bounds != pData->m_Bounds)
+      {
+        auto& change = m_PendingChanges.ExpandAndGetRef();
+        change.m_OldBounds = pData->m_Bounds;
+        change.m_pData = pData;
+        change.m_uiOldCategoryBitmask = pData->m_uiCategoryBitmask;
+
+        pData->m_uiCategoryBitmask = update.m_uiCategoryBitmask;
+        pData->m_Bounds = update.m_Bounds;
+      }
+    }
+    else
+    {
+      pData->m_uiCategoryBitmask = update.m_uiCategoryBitmask;
+    }
+  }
+
+  if (!m_PendingChanges.IsEmpty())
+  {
+    SpatialDataChangedBatch(m_PendingChanges);
+  }
+}
+
+void ezSpatialSystem::SpatialDataChangedBatch(ezArrayPtr<const SpatialDataChange> changes)
+{
+  for (const SpatialDataChange& change : changes)
+  {
+    SpatialDataChanged(change.m_pData, change.m_OldBounds, change.m_uiOldCategoryBitmask);
+  }
+}
+
 void ezSpatialSystem::FindObjectsInSphere(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, ezDynamicArray<ezGameObject*>& out_Objects,
   QueryStats* pStats /*= nullptr*/) const
 {
@@ -0,0 +1,649 @@
+#include <CorePCH.h>
+
+#include <Core/World/Implementation/SpatialSystemUtils.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+
+namespace
+{
+  EZ_ALWAYS_INLINE ezUInt32 ToChildMask(const ezSimdVec4b& children0123, const ezSimdVec4b& children4567)
+  {
+    ezUInt32 uiMask = 0;
+    uiMask |= children0123.x() ? EZ_BIT(0) : 0;
+    uiMask |= children0123.y() ? EZ_BIT(1) : 0;
+    uiMask |= children0123.z() ? EZ_BIT(2) : 0;
+    uiMask |= children0123.w() ? EZ_BIT(3) : 0;
+    uiMask |= children4567.x() ? EZ_BIT(4) : 0;
+    uiMask |= children4567.y() ? EZ_BIT(5) : 0;
+    uiMask |= children4567.z() ? EZ_BIT(6) : 0;
+    uiMask |= children4567.w() ? EZ_BIT(7) : 0;
+    return uiMask;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::SpatialUserData
+{
+  Node* m_pNode = nullptr;
+  ezUInt32 m_uiDataIndex = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::Node
+{
+  Node(Node* pParent, ezUInt32 uiChildIndex, const ezSimdVec4f& vCenter, float fHalfExtent, ezAllocatorBase* pAlignedAllocator,
+    ezAllocatorBase* pAllocator)
+    : m_Center(vCenter)
+    , m_fHalfExtent(fHalfExtent)
+    , m_pParent(pParent)
+    , m_uiChildIndex(uiChildIndex)
+    , m_uiDepth(pParent != nullptr ? pParent->m_uiDepth + 1 : 0)
+    , m_BoundingSpheres(pAlignedAllocator)
+    , m_DataPointers(pAllocator)
+    , m_CategoryBitmasks(pAllocator)
+  {
+    // The child centers are stored in SoA layout, so four children can be tested with one SIMD operation.
+    float fChildCenters[3][8];
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      const ezSimdVec4f vChildCenter = GetChildCenter(i);
+      fChildCenters[0][i] = vChildCenter.x();
+      fChildCenters[1][i] = vChildCenter.y();
+      fChildCenters[2][i] = vChildCenter.z();
+    }
+
+    for (ezUInt32 k = 0; k < 2; ++k)
+    {
+      m_ChildCenterX[k].Load<4>(&fChildCenters[0][k * 4]);
+      m_ChildCenterY[k].Load<4>(&fChildCenters[1][k * 4]);
+      m_ChildCenterZ[k].Load<4>(&fChildCenters[2][k * 4]);
+    }
+  }
+
+  EZ_FORCE_INLINE ezSimdVec4f GetChildCenter(ezUInt32 uiChildIndex) const
+  {
+    const float fOffset = m_fHalfExtent * 0.5f;
+    ezSimdVec4f vOffset((uiChildIndex & 1) ? fOffset : -fOffset, (uiChildIndex & 2) ? fOffset : -fOffset, (uiChildIndex & 4) ? fOffset : -fOffset, 0.0f);
+    return m_Center + vOffset;
+  }
+
+  EZ_FORCE_INLINE ezUInt32 GetChildIndex(const ezSimdVec4f& vPosition) const
+  {
+    ezSimdVec4b cmp = vPosition >= m_Center;
+    return (cmp.x() ? 1 : 0) | (cmp.y() ? 2 : 0) | (cmp.z() ? 4 : 0);
+  }
+
+  EZ_FORCE_INLINE bool ContainsCenter(const ezSimdVec4f& vPosition) const
+  {
+    return ((vPosition - m_Center).Abs() <= ezSimdVec4f(m_fHalfExtent)).AllSet<3>();
+  }
+
+  EZ_ALWAYS_INLINE ezSimdBBox GetLooseBoundingBox() const
+  {
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(m_Center, ezSimdVec4f(m_fHalfExtent * 2.0f));
+    return box;
+  }
+
+  /// \brief Returns a bitmask of all existing children whose loose bounds overlap the given sphere.
+  EZ_FORCE_INLINE ezUInt32 GetChildrenOverlappingSphere(const ezSimdBSphere& sphere) const
+  {
+    // the loose half extent of a child is twice its own half extent, which is the half extent of this node
+    const ezSimdVec4f vChildHalfExtent(m_fHalfExtent);
+    const ezSimdVec4f sphereX(sphere.m_CenterAndRadius.x());
+    const ezSimdVec4f sphereY(sphere.m_CenterAndRadius.y());
+    const ezSimdVec4f sphereZ(sphere.m_CenterAndRadius.z());
+    const ezSimdVec4f sphereR(sphere.m_CenterAndRadius.w());
+    const ezSimdVec4f sphereR2 = sphereR.CompMul(sphereR);
+    const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+
+    ezSimdVec4b overlaps[2];
+    for (ezUInt32 k = 0; k < 2; ++k)
+    {
+      ezSimdVec4f dx = ((m_ChildCenterX[k] - sphereX).Abs() - vChildHalfExtent).CompMax(zero);
+      ezSimdVec4f dy = ((m_ChildCenterY[k] - sphereY).Abs() - vChildHalfExtent).CompMax(zero);
+      ezSimdVec4f dz = ((m_ChildCenterZ[k] - sphereZ).Abs() - vChildHalfExtent).CompMax(zero);
+
+      ezSimdVec4f distSquared = dx.CompMul(dx);
+      distSquared = ezSimdVec4f::MulAdd(dy, dy, distSquared);
+      distSquared = ezSimdVec4f::MulAdd(dz, dz, distSquared);
+
+      overlaps[k] = distSquared <= sphereR2;
+    }
+
+    return ToChildMask(overlaps[0], overlaps[1]) & m_uiChildMask;
+  }
+
+  /// \brief Returns a bitmask of all existing children whose loose bounds overlap the given box.
+  EZ_FORCE_INLINE ezUInt32 GetChildrenOverlappingBox(const ezSimdBBox& box) const
+  {
+    const ezSimdVec4f vChildHalfExtent(m_fHalfExtent);
+    const ezSimdVec4f boxCenter = box.GetCenter();
+    const ezSimdVec4f boxHalfExtents = box.GetHalfExtents();
+
+    const ezSimdVec4f maxDistX = vChildHalfExtent + ezSimdVec4f(boxHalfExtents.x());
+    const ezSimdVec4f maxDistY = vChildHalfExtent + ezSimdVec4f(boxHalfExtents.y());
+    const ezSimdVec4f maxDistZ = vChildHalfExtent + ezSimdVec4f(boxHalfExtents.z());
+    const ezSimdVec4f boxX(boxCenter.x());
+    const ezSimdVec4f boxY(boxCenter.y());
+    const ezSimdVec4f boxZ(boxCenter.z());
+
+    ezSimdVec4b overlaps[2];
+    for (ezUInt32 k = 0; k < 2; ++k)
+    {
+      ezSimdVec4b overlapX = (m_ChildCenterX[k] - boxX).Abs() <= maxDistX;
+      ezSimdVec4b overlapY = (m_ChildCenterY[k] - boxY).Abs() <= maxDistY;
+      ezSimdVec4b overlapZ = (m_ChildCenterZ[k] - boxZ).Abs() <= maxDistZ;
+
+      overlaps[k] = overlapX && overlapY && overlapZ;
+    }
+
+    return ToChildMask(overlaps[0], overlaps[1]) & m_uiChildMask;
+  }
+
+  /// \brief Returns a bitmask of all existing children whose loose bounds intersect the frustum
+  /// and a bitmask of the children that are completely inside of it.
+  EZ_FORCE_INLINE ezUInt32 GetChildrenInFrustum(const ezSpatialSystemUtils::PlaneData& planeData, ezUInt32& out_uiFullyInsideMask) const
+  {
+    // conservatively test the bounding spheres of the loose child boxes
+    const ezSimdVec4f vChildRadius(m_fHalfExtent * 1.7320508f);
+    const ezSimdVec4f vNegChildRadius = -vChildRadius;
+
+    ezSimdVec4b outside[2];
+    ezSimdVec4b inside[2];
+    for (ezUInt32 k = 0; k < 2; ++k)
+    {
+      outside[k] = ezSimdVec4b(false);
+      inside[k] = ezSimdVec4b(true);
+
+      for (ezUInt32 p = 0; p < 6; ++p)
+      {
+        ezSimdVec4f dist = ezSimdVec4f::MulAdd(m_ChildCenterX[k], planeData.m_PlaneX[p], planeData.m_PlaneW[p]);
+        dist = ezSimdVec4f::MulAdd(m_ChildCenterY[k], planeData.m_PlaneY[p], dist);
+        dist = ezSimdVec4f::MulAdd(m_ChildCenterZ[k], planeData.m_PlaneZ[p], dist);
+
+        outside[k] = outside[k] || (dist > vChildRadius);
+        inside[k] = inside[k] && (dist < vNegChildRadius);
+      }
+    }
+
+    out_uiFullyInsideMask = ToChildMask(inside[0], inside[1]) & m_uiChildMask;
+    return ToChildMask(!outside[0], !outside[1]) & m_uiChildMask;
+  }
+
+  EZ_FORCE_INLINE void AddData(ezSpatialData* pData)
+  {
+    auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+    EZ_ASSERT_DEBUG(pUserData->m_pNode == nullptr, "Data can't be in multiple nodes");
+
+    pUserData->m_pNode = this;
+    pUserData->m_uiDataIndex = m_DataPointers.GetCount();
+
+    m_BoundingSpheres.PushBack(pData->m_Bounds.GetSphere());
+    m_DataPointers.PushBack(pData);
+    m_CategoryBitmasks.PushBack(pData->m_uiCategoryBitmask);
+
+    for (Node* pNode = this; pNode != nullptr; pNode = pNode->m_pParent)
+    {
+      ++pNode->m_uiNumObjectsInSubtree;
+      pNode->m_uiSubtreeCategoryBitmask |= pData->m_uiCategoryBitmask;
+    }
+  }
+
+  EZ_FORCE_INLINE void RemoveData(ezSpatialData* pData)
+  {
+    auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+    EZ_ASSERT_DEBUG(pUserData->m_pNode == this, "Implementation error");
+
+    const ezUInt32 uiDataIndex = pUserData->m_uiDataIndex;
+    if (uiDataIndex != m_DataPointers.GetCount() - 1)
+    {
+      ezSpatialData* pLastData = m_DataPointers.PeekBack();
+      reinterpret_cast<SpatialUserData*>(&pLastData->m_uiUserData[0])->m_uiDataIndex = uiDataIndex;
+    }
+
+    m_BoundingSpheres.RemoveAtAndSwap(uiDataIndex);
+    m_DataPointers.RemoveAtAndSwap(uiDataIndex);
+    m_CategoryBitmasks.RemoveAtAndSwap(uiDataIndex);
+
+    pUserData->m_pNode = nullptr;
+    pUserData->m_uiDataIndex = ezInvalidIndex;
+
+    for (Node* pNode = this; pNode != nullptr; pNode = pNode->m_pParent)
+    {
+      --pNode->m_uiNumObjectsInSubtree;
+
+      // the category bitmask is only a conservative superset, it can only be reset once the subtree is empty
+      if (pNode->m_uiNumObjectsInSubtree == 0)
+      {
+        pNode->m_uiSubtreeCategoryBitmask = 0;
+      }
+    }
+  }
+
+  EZ_FORCE_INLINE void UpdateData(ezSpatialData* pData)
+  {
+    auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+    EZ_ASSERT_DEBUG(pUserData->m_pNode == this, "Implementation error");
+
+    const ezUInt32 uiDataIndex = pUserData->m_uiDataIndex;
+    m_BoundingSpheres[uiDataIndex] = pData->m_Bounds.GetSphere();
+
+    if (m_CategoryBitmasks[uiDataIndex] != pData->m_uiCategoryBitmask)
+    {
+      m_CategoryBitmasks[uiDataIndex] = pData->m_uiCategoryBitmask;
+
+      for (Node* pNode = this; pNode != nullptr; pNode = pNode->m_pParent)
+      {
+        pNode->m_uiSubtreeCategoryBitmask |= pData->m_uiCategoryBitmask;
+      }
+    }
+  }
+
+  ezSimdVec4f m_Center;
+  float m_fHalfExtent; ///< The loose bounds of the node are twice as large.
+
+  Node* m_pParent;
+  ezUInt32 m_uiChildIndex;
+  ezUInt32 m_uiDepth;
+
+  ezUInt32 m_uiNumObjectsInSubtree = 0;
+  ezUInt32 m_uiSubtreeCategoryBitmask = 0;
+
+  ezUInt32 m_uiChildMask = 0;
+  Node* m_pChildren[8] = {};
+
+  ezSimdVec4f m_ChildCenterX[2];
+  ezSimdVec4f m_ChildCenterY[2];
+  ezSimdVec4f m_ChildCenterZ[2];
+
+  ezDynamicArray<ezSimdBSphere> m_BoundingSpheres;
+  ezDynamicArray<ezSpatialData*> m_DataPointers;
+  ezDynamicArray<ezUInt32> m_CategoryBitmasks;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_LooseOctree, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_LooseOctree::ezSpatialSystem_LooseOctree(float fWorldHalfExtent /*= 16384.0f*/, float fMinNodeHalfExtent /*= 64.0f*/)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_fWorldHalfExtent(fWorldHalfExtent)
+  , m_uiMaxDepth(0)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezSpatialSystem_LooseOctree::SpatialUserData) <= sizeof(ezSpatialData::m_uiUserData));
+  EZ_ASSERT_DEV(fWorldHalfExtent > 0.0f && fMinNodeHalfExtent > 0.0f, "Invalid octree extents");
+
+  for (float fHalfExtent = fWorldHalfExtent; fHalfExtent * 0.5f >= fMinNodeHalfExtent; fHalfExtent *= 0.5f)
+  {
+    ++m_uiMaxDepth;
+  }
+
+  m_pRoot = EZ_NEW(&m_AlignedAllocator, Node, nullptr, 0, ezSimdVec4f::ZeroVector(), m_fWorldHalfExtent, &m_AlignedAllocator, &m_Allocator);
+}
+
+ezSpatialSystem_LooseOctree::~ezSpatialSystem_LooseOctree()
+{
+  for (Node* pChild : m_pRoot->m_pChildren)
+  {
+    if (pChild != nullptr)
+    {
+      DeleteNode(pChild);
+    }
+  }
+}
+
+ezResult ezSpatialSystem_LooseOctree::GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const
+{
+  ezSpatialData* pData;
+  if (!m_DataTable.TryGetValue(hData.GetInternalID(), pData))
+    return EZ_FAILURE;
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  if (pUserData->m_pNode != nullptr)
+  {
+    out_BoundingBox = ezSimdConversion::ToBBox(pUserData->m_pNode->GetLooseBoundingBox());
+    return EZ_SUCCESS;
+  }
+
+  return EZ_FAILURE;
+}
+
+void ezSpatialSystem_LooseOctree::GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory) const
+{
+  const ezUInt32 uiCategoryBitmask = filterCategory == ezInvalidSpatialDataCategory ? 0xFFFFFFFF : filterCategory.GetBitmask();
+
+  ForEachNode(uiCategoryBitmask, [&](const Node& node, bool bFullyInside, ezUInt32& out_uiChildMask, ezUInt32& out_uiFullyInsideChildMask) {
+    if (!node.m_DataPointers.IsEmpty())
+    {
+      out_BoundingBoxes.ExpandAndGetRef() = ezSimdConversion::ToBBox(node.GetLooseBoundingBox());
+    }
+
+    out_uiChildMask = node.m_uiChildMask;
+    return true;
+  });
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+  QueryStats* pStats) const
+{
+  ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+
+  ForEachNode(uiCategoryBitmask, [&](const Node& node, bool bFullyInside, ezUInt32& out_uiChildMask, ezUInt32& out_uiFullyInsideChildMask) {
+    const ezUInt32 numSpheres = node.m_BoundingSpheres.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested += numSpheres;
+    }
+#endif
+
+    for (ezUInt32 i = 0; i < numSpheres; ++i)
+    {
+      if ((node.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0)
+        continue;
+
+      if (!simdSphere.Overlaps(node.m_BoundingSpheres[i]))
+        continue;
+
+      if (callback(node.m_DataPointers[i]->m_pObject) == ezVisitorExecution::Stop)
+        return false;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsPassed++;
+      }
+#endif
+    }
+
+    out_uiChildMask = node.GetChildrenOverlappingSphere(simdSphere);
+    return true;
+  });
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const
+{
+  ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  ForEachNode(uiCategoryBitmask, [&](const Node& node, bool bFullyInside, ezUInt32& out_uiChildMask, ezUInt32& out_uiFullyInsideChildMask) {
+    const ezUInt32 numSpheres = node.m_BoundingSpheres.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested += numSpheres;
+    }
+#endif
+
+    for (ezUInt32 i = 0; i < numSpheres; ++i)
+    {
+      if ((node.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0)
+        continue;
+
+      if (!simdBox.Overlaps(node.m_BoundingSpheres[i]))
+        continue;
+
+      const ezSpatialData* pData = node.m_DataPointers[i];
+      if (!simdBox.Overlaps(pData->m_Bounds.GetBox()))
+        continue;
+
+      if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+        return false;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsPassed++;
+      }
+#endif
+    }
+
+    out_uiChildMask = node.GetChildrenOverlappingBox(simdBox);
+    return true;
+  });
+}
+
+void ezSpatialSystem_LooseOctree::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask,
+  ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats) const
+{
+  ezSpatialSystemUtils::PlaneData planeData;
+  ezSpatialSystemUtils::SetupPlaneData(frustum, planeData);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+#endif
+
+  ForEachNode(uiCategoryBitmask, [&](const Node& node, bool bFullyInside, ezUInt32& out_uiChildMask, ezUInt32& out_uiFullyInsideChildMask) {
+    auto& boundingSpheres = node.m_BoundingSpheres;
+    auto& dataPointers = node.m_DataPointers;
+    auto& categoryBitmasks = node.m_CategoryBitmasks;
+
+    const ezUInt32 numSpheres = boundingSpheres.GetCount();
+
+    if (bFullyInside)
+    {
+      // the whole node is visible, so there is no need to test its objects or children individually
+      for (ezUInt32 i = 0; i < numSpheres; ++i)
+      {
+        if ((categoryBitmasks[i] & uiCategoryBitmask) != 0)
+        {
+          out_Objects.PushBack(dataPointers[i]->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+          uiNumObjectsPassed++;
+#endif
+        }
+      }
+
+      out_uiChildMask = node.m_uiChildMask;
+      out_uiFullyInsideChildMask = node.m_uiChildMask;
+      return true;
+    }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    uiNumObjectsTested += numSpheres;
+#endif
+
+    ezUInt32 i = 0;
+    for (; i + 3 < numSpheres; i += 4)
+    {
+      ezUInt32 mask =
+        ezSpatialSystemUtils::SphereFrustumIntersect(boundingSpheres[i], boundingSpheres[i + 1], boundingSpheres[i + 2], boundingSpheres[i + 3], planeData);
+
+      while (mask > 0)
+      {
+        const ezUInt32 j = i + ezMath::FirstBitLow(mask);
+        mask &= mask - 1;
+
+        if ((categoryBitmasks[j] & uiCategoryBitmask) != 0)
+        {
+          out_Objects.PushBack(dataPointers[j]->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+          uiNumObjectsPassed++;
+#endif
+        }
+      }
+    }
+
+    for (; i < numSpheres; ++i)
+    {
+      if ((categoryBitmasks[i] & uiCategoryBitmask) != 0 && ezSpatialSystemUtils::SphereFrustumIntersect(boundingSpheres[i], planeData))
+      {
+        out_Objects.PushBack(dataPointers[i]->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        uiNumObjectsPassed++;
+#endif
+      }
+    }
+
+    out_uiChildMask = node.GetChildrenInFrustum(planeData, out_uiFullyInsideChildMask);
+    return true;
+  });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsTested = uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataAdded(ezSpatialData* pData)
+{
+  Node* pNode = GetOrCreateNode(pData->m_Bounds);
+  pNode->AddData(pData);
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataRemoved(ezSpatialData* pData)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+  Node* pNode = pUserData->m_pNode;
+  if (pNode == nullptr)
+    return;
+
+  pNode->RemoveData(pData);
+
+  // delete nodes that became empty, the root is always kept
+  while (pNode->m_pParent != nullptr && pNode->m_uiNumObjectsInSubtree == 0)
+  {
+    Node* pParent = pNode->m_pParent;
+    pParent->m_pChildren[pNode->m_uiChildIndex] = nullptr;
+    pParent->m_uiChildMask &= ~EZ_BIT(pNode->m_uiChildIndex);
+
+    DeleteNode(pNode);
+    pNode = pParent;
+  }
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  Node* pNode = pUserData->m_pNode;
+
+  // most changes are small movements which keep the object in the same node
+  if (pNode->m_uiDepth == ComputeDepth(pData->m_Bounds) && (pNode->m_uiDepth == 0 || pNode->ContainsCenter(pData->m_Bounds.m_CenterAndRadius)))
+  {
+    pNode->UpdateData(pData);
+  }
+  else
+  {
+    // remove first, since removing might delete nodes
+    SpatialDataRemoved(pData);
+    SpatialDataAdded(pData);
+  }
+}
+
+void ezSpatialSystem_LooseOctree::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
+  pUserData->m_pNode->m_DataPointers[pUserData->m_uiDataIndex] = pNewPtr;
+}
+
+ezUInt32 ezSpatialSystem_LooseOctree::ComputeDepth(const ezSimdBBoxSphere& bounds) const
+{
+  // objects outside of the octree are stored in the root
+  if (!(bounds.m_CenterAndRadius.Abs() <= ezSimdVec4f(m_fWorldHalfExtent)).AllSet<3>())
+    return 0;
+
+  // The bounding sphere of the object has to fit into the node, so that it is contained in the loose bounds no matter where its center lies
+  // inside the node. All queries cull nodes by their loose bounds and test objects by their bounding spheres.
+  const float fExtent = bounds.m_CenterAndRadius.w();
+
+  ezUInt32 uiDepth = 0;
+  for (float fHalfExtent = m_fWorldHalfExtent * 0.5f; uiDepth < m_uiMaxDepth && fHalfExtent >= fExtent; fHalfExtent *= 0.5f)
+  {
+    ++uiDepth;
+  }
+
+  return uiDepth;
+}
+
+ezSpatialSystem_LooseOctree::Node* ezSpatialSystem_LooseOctree::GetOrCreateNode(const ezSimdBBoxSphere& bounds)
+{
+  const ezUInt32 uiDepth = ComputeDepth(bounds);
+
+  Node* pNode = m_pRoot.Borrow();
+  while (pNode->m_uiDepth < uiDepth)
+  {
+    const ezUInt32 uiChildIndex = pNode->GetChildIndex(bounds.m_CenterAndRadius);
+
+    Node* pChild = pNode->m_pChildren[uiChildIndex];
+    if (pChild == nullptr)
+    {
+      pChild = EZ_NEW(&m_AlignedAllocator, Node, pNode, uiChildIndex, pNode->GetChildCenter(uiChildIndex), pNode->m_fHalfExtent * 0.5f,
+        &m_AlignedAllocator, &m_Allocator);
+
+      pNode->m_pChildren[uiChildIndex] = pChild;
+      pNode->m_uiChildMask |= EZ_BIT(uiChildIndex);
+    }
+
+    pNode = pChild;
+  }
+
+  return pNode;
+}
+
+void ezSpatialSystem_LooseOctree::DeleteNode(Node* pNode)
+{
+  for (Node* pChild : pNode->m_pChildren)
+  {
+    if (pChild != nullptr)
+    {
+      DeleteNode(pChild);
+    }
+  }
+
+  EZ_DELETE(&m_AlignedAllocator, pNode);
+}
+
+template <typename Functor>
+EZ_FORCE_INLINE void ezSpatialSystem_LooseOctree::ForEachNode(ezUInt32 uiCategoryBitmask, Functor func) const
+{
+  struct StackEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const Node* m_pNode;
+    bool m_bFullyInside;
+  };
+
+  ezHybridArray<StackEntry, 64> stack;
+  stack.PushBack({m_pRoot.Borrow(), false});
+
+  while (!stack.IsEmpty())
+  {
+    const StackEntry entry = stack.PeekBack();
+    stack.PopBack();
+
+    const Node& node = *entry.m_pNode;
+    if ((node.m_uiSubtreeCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    ezUInt32 uiChildMask = 0;
+    ezUInt32 uiFullyInsideChildMask = 0;
+    if (!func(node, entry.m_bFullyInside, uiChildMask, uiFullyInsideChildMask))
+      return;
+
+    while (uiChildMask > 0)
+    {
+      const ezUInt32 uiChildIndex = ezMath::FirstBitLow(uiChildMask);
+      uiChildMask &= uiChildMask - 1;
+
+      stack.PushBack({node.m_pChildren[uiChildIndex], (uiFullyInsideChildMask & EZ_BIT(uiChildIndex)) != 0});
+    }
+  }
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_LooseOctree);
@@ -1,15 +1,34 @@
 #include <CorePCH.h>
 
+#include <Core/World/Implementation/SpatialSystemUtils.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 namespace
 {
   enum
   {
     MAX_CELL_INDEX = (1 << 20) - 1,
-    CELL_INDEX_MASK = (1 << 21) - 1
+    CELL_INDEX_MASK = (1 << 21) - 1,
+
+    // most cells inside of the frustum bounding box are empty, so every culling task should look at a reasonable number of cells
+    CELLS_PER_CULLING_TASK = 4096,
+    MAX_CULLING_TASKS = 64,
+
+    // updating the bounds of an object that stays inside its cell is cheap, so every task should handle a reasonable number of them
+    CHANGES_PER_UPDATE_TASK = 256
+  };
+
+  // cell keys only use the lower 63 bits, see GetCellKey
+  static constexpr ezUInt64 OVERFLOW_CELL_KEY = 0xFFFFFFFFFFFFFFFFull;
+
+  struct CullingTaskData
+  {
+    ezDynamicArray<const ezGameObject*> m_Objects;
+    ezUInt32 m_uiNumObjectsTested = 0;
+    ezUInt32 m_uiNumObjectsPassed = 0;
   };
 
   EZ_ALWAYS_INLINE ezSimdVec4f ToVec3(const ezSimdVec4i& v) { return v.ToFloat(); }
@@ -29,6 +48,15 @@ namespace
     return (sx << 42) | (sy << 21) | sz;
   }
 
+  EZ_ALWAYS_INLINE ezSimdVec4i GetCellIndex(ezUInt64 cellKey)
+  {
+    ezInt32 x = static_cast<ezInt32>((cellKey >> 42) & CELL_INDEX_MASK) - MAX_CELL_INDEX;
+    ezInt32 y = static_cast<ezInt32>((cellKey >> 21) & CELL_INDEX_MASK) - MAX_CELL_INDEX;
+    ezInt32 z = static_cast<ezInt32>(cellKey & CELL_INDEX_MASK) - MAX_CELL_INDEX;
+
+    return ezSimdVec4i(x, y, z);
+  }
+
   EZ_ALWAYS_INLINE ezSimdBBox ComputeCellBoundingBox(const ezSimdVec4i& cellIndex, const ezSimdVec4i& iCellSize)
   {
     ezSimdVec4i overlapSize = iCellSize >> 2;
@@ -39,86 +67,6 @@ namespace
 
     return ezSimdBBox(bmin, bmax);
   }
-
-  struct PlaneData
-  {
-    ezSimdVec4f m_x0x1x2x3;
-    ezSimdVec4f m_y0y1y2y3;
-    ezSimdVec4f m_z0z1z2z3;
-    ezSimdVec4f m_w0w1w2w3;
-
-    ezSimdVec4f m_x4x5x4x5;
-    ezSimdVec4f m_y4y5y4y5;
-    ezSimdVec4f m_z4z5z4z5;
-    ezSimdVec4f m_w4w5w4w5;
-  };
-
-  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
-  {
-    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
-    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
-    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
-    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
-
-    ezSimdVec4f dot_0123;
-    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
-
-    ezSimdVec4f dot_4545;
-    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
-
-    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
-    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
-    return (cmp_0123 || cmp_4545).NoneSet<4>();
-  }
-
-  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
-  {
-    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
-    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
-    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
-    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotA_0123;
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
-
-    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
-    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
-    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
-    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotB_0123;
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
-
-    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
-    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
-    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
-    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
-
-    ezSimdVec4f dot_A45B45;
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
-
-    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
-    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
-    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
-
-    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
-    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
-
-    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
-    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
-
-    return result;
-  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -464,40 +412,13 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
   ezSimdBBox simdBox;
   simdBox.SetFromPoints(simdCornerPoints, 8);
 
-  PlaneData planeData;
-  {
-    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
-    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
-    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
-    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
-    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
-    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
-    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
-
-    ezSimdMat4f helperMat;
-    helperMat.SetRows(plane0, plane1, plane2, plane3);
-
-    planeData.m_x0x1x2x3 = helperMat.m_col0;
-    planeData.m_y0y1y2y3 = helperMat.m_col1;
-    planeData.m_z0z1z2z3 = helperMat.m_col2;
-    planeData.m_w0w1w2w3 = helperMat.m_col3;
-
-    helperMat.SetRows(plane4, plane5, plane4, plane5);
-
-    planeData.m_x4x5x4x5 = helperMat.m_col0;
-    planeData.m_y4y5y4y5 = helperMat.m_col1;
-    planeData.m_z4z5z4z5 = helperMat.m_col2;
-    planeData.m_w4w5w4w5 = helperMat.m_col3;
-  }
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  ezUInt32 uiNumObjectsTested = 0;
-  ezUInt32 uiNumObjectsPassed = 0;
-#endif
+  ezSpatialSystemUtils::PlaneData planeData;
+  ezSpatialSystemUtils::SetupPlaneData(frustum, planeData);
 
-  ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+  auto cullCell = [&](const Cell& cell, ezUInt32 uiFilteredCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_CellObjects,
+                    ezUInt32& inout_uiNumObjectsTested, ezUInt32& inout_uiNumObjectsPassed) {
     ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
-    if (!SphereFrustumIntersect(cellSphere, planeData))
+    if (!ezSpatialSystemUtils::SphereFrustumIntersect(cellSphere, planeData))
       return;
 
     ezUInt32 filteredMask = uiFilteredCategoryBitmask;
@@ -510,10 +431,8 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
       auto& dataPointers = cell.m_DataPointers[category];
 
       const ezUInt32 numSpheres = boundingSpheres.GetCount();
+      inout_uiNumObjectsTested += numSpheres;
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-      uiNumObjectsTested += numSpheres;
-#endif
       ezUInt32 currentIndex = 0;
 
       while (currentIndex < numSpheres)
@@ -522,25 +441,25 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
         {
           ezUInt32 mask = 0;
 
-          for (ezUInt32 i = 0; i < 32; i += 2)
+          for (ezUInt32 i = 0; i < 32; i += 4)
           {
             auto& objectSphereA = boundingSpheres[currentIndex + i + 0];
             auto& objectSphereB = boundingSpheres[currentIndex + i + 1];
+            auto& objectSphereC = boundingSpheres[currentIndex + i + 2];
+            auto& objectSphereD = boundingSpheres[currentIndex + i + 3];
 
-            mask |= SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
+            mask |= ezSpatialSystemUtils::SphereFrustumIntersect(objectSphereA, objectSphereB, objectSphereC, objectSphereD, planeData) << i;
           }
 
+          inout_uiNumObjectsPassed += ezMath::CountBits(mask);
+
           while (mask > 0)
           {
             ezUInt32 i = ezMath::FirstBitLow(mask);
             mask &= mask - 1;
 
             ezSpatialData* pData = dataPointers[currentIndex + i];
-            out_Objects.PushBack(pData->m_pObject);
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-            uiNumObjectsPassed++;
-#endif
+            out_CellObjects.PushBack(pData->m_pObject);
           }
 
           currentIndex += 32;
@@ -551,19 +470,80 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
           ++currentIndex;
 
           auto& objectSphere = boundingSpheres[i];
-          if (!SphereFrustumIntersect(objectSphere, planeData))
+          if (!ezSpatialSystemUtils::SphereFrustumIntersect(objectSphere, planeData))
             continue;
 
           ezSpatialData* pData = dataPointers[i];
-          out_Objects.PushBack(pData->m_pObject);
+          out_CellObjects.PushBack(pData->m_pObject);
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-          uiNumObjectsPassed++;
-#endif
+          inout_uiNumObjectsPassed++;
         }
       }
     }
-  });
+  };
+
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+
+  const ezUInt32 uiNumCells = GetNumCellsInBox(simdBox);
+  const ezUInt32 uiNumTasks = ezMath::Min((uiNumCells + CELLS_PER_CULLING_TASK - 1) / CELLS_PER_CULLING_TASK, (ezUInt32)MAX_CULLING_TASKS);
+
+  if (uiNumTasks > 1)
+  {
+    // Every task culls a contiguous range of cells into its own array, so no synchronization is needed.
+    // The arrays are appended in task order afterwards, which keeps the result deterministic.
+    ezHybridArray<CullingTaskData, MAX_CULLING_TASKS> taskData;
+    taskData.SetCount(uiNumTasks);
+
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.uiMaxTasksPerThread = 4;
+
+    ezTaskSystem::ParallelForIndexed(0, uiNumTasks, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 uiTask = uiStartIndex; uiTask < uiEndIndex; ++uiTask)
+      {
+        const ezUInt32 uiFirstCell = static_cast<ezUInt32>((static_cast<ezUInt64>(uiNumCells) * uiTask) / uiNumTasks);
+        const ezUInt32 uiEndCell = static_cast<ezUInt32>((static_cast<ezUInt64>(uiNumCells) * (uiTask + 1)) / uiNumTasks);
+
+        CullingTaskData& data = taskData[uiTask];
+
+        ForEachCellInBoxRange(simdBox, uiFirstCell, uiEndCell, uiCategoryBitmask,
+          [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+            cullCell(cell, uiFilteredCategoryBitmask, data.m_Objects, data.m_uiNumObjectsTested, data.m_uiNumObjectsPassed);
+          });
+      }
+    },
+      "FindVisibleObjects", params);
+
+    ezUInt32 uiNumVisibleObjects = out_Objects.GetCount();
+    for (const CullingTaskData& data : taskData)
+    {
+      uiNumVisibleObjects += data.m_Objects.GetCount();
+    }
+
+    out_Objects.Reserve(uiNumVisibleObjects);
+
+    for (const CullingTaskData& data : taskData)
+    {
+      out_Objects.PushBackRange(data.m_Objects);
+
+      uiNumObjectsTested += data.m_uiNumObjectsTested;
+      uiNumObjectsPassed += data.m_uiNumObjectsPassed;
+    }
+  }
+  else
+  {
+    ForEachCellInBoxRange(simdBox, 0, uiNumCells, uiCategoryBitmask,
+      [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+        cullCell(cell, uiFilteredCategoryBitmask, out_Objects, uiNumObjectsTested, uiNumObjectsPassed);
+      });
+  }
+
+  ezUInt32 uiFilteredCategoryBitmask = m_pOverflowCell->m_uiCategoryBitmask & uiCategoryBitmask;
+  if (uiFilteredCategoryBitmask != 0)
+  {
+    cullCell(*m_pOverflowCell, uiFilteredCategoryBitmask, out_Objects, uiNumObjectsTested, uiNumObjectsPassed);
+  }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   if (pStats != nullptr)
@@ -631,6 +611,96 @@ void ezSpatialSystem_RegularGrid::SpatialDataChanged(ezSpatialData* pData, const
   }
 }
 
+void ezSpatialSystem_RegularGrid::SpatialDataChangedBatch(ezArrayPtr<const SpatialDataChange> changes)
+{
+  const ezUInt32 uiNumChanges = changes.GetCount();
+  m_ChangeRequiresMove.SetCountUninitialized(uiNumChanges);
+
+  // Most objects stay inside of their cell, which only overwrites their bounding spheres. Every change writes to different array
+  // elements and the cells themselves are not modified, so this can be done in parallel.
+  ezParallelForParams params;
+  params.uiBinSize = CHANGES_PER_UPDATE_TASK;
+
+  ezTaskSystem::ParallelForIndexed(0, uiNumChanges, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+    for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+    {
+      const SpatialDataChange& change = changes[i];
+      ezSpatialData* pData = change.m_pData;
+
+      bool bRequiresMove = true;
+
+      if (pData->m_uiCategoryBitmask == change.m_uiOldCategoryBitmask)
+      {
+        auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+        Cell* pOldCell = pUserData->m_pCell;
+        if (pOldCell != nullptr && pOldCell->m_Bounds.GetBox().Contains(pData->m_Bounds.GetBox()))
+        {
+          pOldCell->UpdateData(pData);
+          bRequiresMove = false;
+        }
+      }
+
+      m_ChangeRequiresMove[i] = bRequiresMove ? 1 : 0;
+    }
+  },
+    "SpatialDataChangedBatch", params);
+
+  // The remaining changes modify the cells, so they are applied serially. They are sorted by their new cell, so every cell is only
+  // looked up once and all additions to one cell happen right after each other.
+  m_CellMoves.Clear();
+
+  for (ezUInt32 i = 0; i < uiNumChanges; ++i)
+  {
+    if (m_ChangeRequiresMove[i] == 0)
+      continue;
+
+    const SpatialDataChange& change = changes[i];
+    if (change.m_pData->m_uiCategoryBitmask != change.m_uiOldCategoryBitmask)
+    {
+      SpatialDataChanged(change.m_pData, change.m_OldBounds, change.m_uiOldCategoryBitmask);
+    }
+    else
+    {
+      auto& move = m_CellMoves.ExpandAndGetRef();
+      move.m_uiNewCellKey = GetCellKeyForBounds(change.m_pData->m_Bounds);
+      move.m_uiChangeIndex = i;
+    }
+  }
+
+  m_CellMoves.Sort();
+
+  Cell* pNewCell = nullptr;
+  ezUInt64 uiNewCellKey = 0;
+
+  for (const CellMove& move : m_CellMoves)
+  {
+    if (pNewCell == nullptr || move.m_uiNewCellKey != uiNewCellKey)
+    {
+      pNewCell = GetOrCreateCell(move.m_uiNewCellKey);
+      uiNewCellKey = move.m_uiNewCellKey;
+    }
+
+    ezSpatialData* pData = changes[move.m_uiChangeIndex].m_pData;
+    auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+    Cell* pOldCell = pUserData->m_pCell;
+    if (pOldCell == pNewCell)
+    {
+      pOldCell->UpdateData(pData);
+    }
+    else
+    {
+      if (pOldCell != nullptr)
+      {
+        pOldCell->RemoveData(pData);
+      }
+
+      pNewCell->AddData(pData, &m_AlignedAllocator);
+    }
+  }
+}
+
 void ezSpatialSystem_RegularGrid::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
 {
   auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
@@ -655,8 +725,30 @@ void ezSpatialSystem_RegularGrid::FixSpatialDataPointer(ezSpatialData* pOldPtr,
   }
 }
 
+ezUInt32 ezSpatialSystem_RegularGrid::GetNumCellsInBox(const ezSimdBBox& box) const
+{
+  ezSimdVec4i minIndex = ToVec3I32((box.m_Min - m_fOverlapSize) * m_fInvCellSize);
+  ezSimdVec4i maxIndex = ToVec3I32((box.m_Max + m_fOverlapSize) * m_fInvCellSize);
+
+  const ezSimdVec4i diff = maxIndex - minIndex + ezSimdVec4i(1);
+  return diff.x() * diff.y() * diff.z();
+}
+
 template <typename Functor>
 EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachCellInBox(const ezSimdBBox& box, ezUInt32 uiCategoryBitmask, Functor func) const
+{
+  ForEachCellInBoxRange(box, 0, GetNumCellsInBox(box), uiCategoryBitmask, func);
+
+  ezUInt32 uiFilteredCategoryBitmask = m_pOverflowCell->m_uiCategoryBitmask & uiCategoryBitmask;
+  if (uiFilteredCategoryBitmask != 0)
+  {
+    func(ezSimdVec4i::ZeroVector(), 0, *(m_pOverflowCell), uiFilteredCategoryBitmask);
+  }
+}
+
+template <typename Functor>
+EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachCellInBoxRange(
+  const ezSimdBBox& box, ezUInt32 uiFirstCell, ezUInt32 uiEndCell, ezUInt32 uiCategoryBitmask, Functor func) const
 {
   ezSimdVec4i minIndex = ToVec3I32((box.m_Min - m_fOverlapSize) * m_fInvCellSize);
   ezSimdVec4i maxIndex = ToVec3I32((box.m_Max + m_fOverlapSize) * m_fInvCellSize);
@@ -668,38 +760,11 @@ EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachCellInBox(const ezSimdB
   const ezInt32 iMinY = minIndex.y();
   const ezInt32 iMinZ = minIndex.z();
 
-#if 0
-
-  const ezInt32 iMaxX = maxIndex.x();
-  const ezInt32 iMaxY = maxIndex.y();
-  const ezInt32 iMaxZ = maxIndex.z();
-
-  for (ezInt32 z = iMinZ; z <= iMaxZ; ++z)
-  {
-    for (ezInt32 y = iMinY; y <= iMaxY; ++y)
-    {
-      for (ezInt32 x = iMinX; x <= iMaxX; ++x)
-      {
-        ezUInt64 cellKey = GetCellKey(x, y, z);
-
-        Cell* pCell = nullptr;
-        m_Cells.TryGetValue(cellKey, pCell);
-
-        ezSimdVec4i cellIndex(x, y, z);
-        func(cellIndex, cellKey, pCell);
-      }
-    }
-  }
-
-#else
-
   const ezSimdVec4i diff = maxIndex - minIndex + ezSimdVec4i(1);
   const ezInt32 iDiffX = diff.x();
   const ezInt32 iDiffY = diff.y();
-  const ezInt32 iDiffZ = diff.z();
-  const ezInt32 iNumIterations = iDiffX * iDiffY * iDiffZ;
 
-  for (ezInt32 i = 0; i < iNumIterations; ++i)
+  for (ezInt32 i = static_cast<ezInt32>(uiFirstCell); i < static_cast<ezInt32>(uiEndCell); ++i)
   {
     ezInt32 index = i;
     ezInt32 z = i / (iDiffX * iDiffY);
@@ -724,41 +789,45 @@ EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachCellInBox(const ezSimdB
       }
     }
   }
-
-  ezUInt32 uiFilteredCategoryBitmask = m_pOverflowCell->m_uiCategoryBitmask & uiCategoryBitmask;
-  if (uiFilteredCategoryBitmask != 0)
-  {
-    func(ezSimdVec4i::ZeroVector(), 0, *(m_pOverflowCell), uiFilteredCategoryBitmask);
-  }
-#endif
 }
 
-ezSpatialSystem_RegularGrid::Cell* ezSpatialSystem_RegularGrid::GetOrCreateCell(const ezSimdBBoxSphere& bounds)
+ezUInt64 ezSpatialSystem_RegularGrid::GetCellKeyForBounds(const ezSimdBBoxSphere& bounds) const
 {
   ezSimdVec4i cellIndex = ToVec3I32(bounds.m_CenterAndRadius * m_fInvCellSize);
   ezSimdBBox cellBox = ComputeCellBoundingBox(cellIndex, m_iCellSize);
 
   if (cellBox.Contains(bounds.GetBox()))
   {
-    ezUInt64 cellKey = GetCellKey(cellIndex.x(), cellIndex.y(), cellIndex.z());
-
-    if (auto ppCell = m_Cells.GetValue(cellKey))
-    {
-      return ppCell->Borrow();
-    }
+    return GetCellKey(cellIndex.x(), cellIndex.y(), cellIndex.z());
+  }
 
-    ezUniquePtr<Cell> pNewCell = EZ_NEW(&m_AlignedAllocator, Cell, &m_Allocator);
-    pNewCell->m_Bounds = cellBox;
+  return OVERFLOW_CELL_KEY;
+}
 
-    Cell* pCell = pNewCell.Borrow();
-    m_Cells.Insert(cellKey, std::move(pNewCell));
+ezSpatialSystem_RegularGrid::Cell* ezSpatialSystem_RegularGrid::GetOrCreateCell(const ezSimdBBoxSphere& bounds)
+{
+  return GetOrCreateCell(GetCellKeyForBounds(bounds));
+}
 
-    return pCell;
-  }
-  else
+ezSpatialSystem_RegularGrid::Cell* ezSpatialSystem_RegularGrid::GetOrCreateCell(ezUInt64 cellKey)
+{
+  if (cellKey == OVERFLOW_CELL_KEY)
   {
     return m_pOverflowCell.Borrow();
   }
+
+  if (auto ppCell = m_Cells.GetValue(cellKey))
+  {
+    return ppCell->Borrow();
+  }
+
+  ezUniquePtr<Cell> pNewCell = EZ_NEW(&m_AlignedAllocator, Cell, &m_Allocator);
+  pNewCell->m_Bounds = ComputeCellBoundingBox(GetCellIndex(cellKey), m_iCellSize);
+
+  Cell* pCell = pNewCell.Borrow();
+  m_Cells.Insert(cellKey, std::move(pNewCell));
+
+  return pCell;
 }
 
 
@@ -7,6 +7,7 @@
 #include <Core/World/WorldModule.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/DGMLWriter.h>
 #include <Foundation/Utilities/Stats.h>
 
 ezStaticArray<ezWorld*, ezWorld::GetMaxNumWorlds()> ezWorld::s_Worlds;
@@ -467,30 +468,22 @@ void ezWorld::Update()
     ProcessQueuedMessages(ezObjectMsgQueueType::AfterInitialized);
   }
 
-  // pre-async phase
+  // the schedule is kept until the next update for debug output
+  m_Data.m_UpdateSchedule.Clear();
+  m_Data.m_UpdateScheduleDependencies.Clear();
+
+  // pre-async and async phase, async functions are scheduled together with the pre-async functions
   {
     EZ_PROFILE_SCOPE("Pre-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::NextFrame);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync]);
-  }
-
-  // async phase
-  {
-    // remove write marker but keep the read marker. Thus no one can mark the world for writing now. Only reading is allowed in async phase.
-    m_Data.m_WriteThreadID = (ezThreadID)0;
-
-    EZ_PROFILE_SCOPE("Async Phase");
-    UpdateAsynchronous();
-
-    // restore write marker
-    m_Data.m_WriteThreadID = ezThreadUtils::GetCurrentThreadID();
+    UpdatePhase(ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync);
   }
 
   // post-async phase
   {
     EZ_PROFILE_SCOPE("Post-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostAsync);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync]);
+    UpdatePhase(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync);
   }
 
   // delete dead objects and update the object hierarchy
@@ -511,13 +504,20 @@ void ezWorld::Update()
 
     EZ_PROFILE_SCOPE("Update Transforms");
     m_Data.UpdateGlobalTransforms(fInvDelta);
+
+    ezStringBuilder sStatName;
+    sStatName.Format("World Update/{0}/Visited Transforms", m_Data.m_sName);
+    ezStats::SetStat(sStatName, m_Data.m_uiVisitedTransformCount);
+
+    sStatName.Format("World Update/{0}/Updated Transforms", m_Data.m_sName);
+    ezStats::SetStat(sStatName, m_Data.m_uiUpdatedTransformCount);
   }
 
   // post-transform phase
   {
     EZ_PROFILE_SCOPE("Post-Transform Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostTransform);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform]);
+    UpdatePhase(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform);
   }
 
   // Process again so new component can receive render messages, otherwise we introduce a frame delay.
@@ -658,6 +658,7 @@ void ezWorld::LinkToParent(ezGameObject* pObject)
     pParentObject->m_ChildCount++;
 
     pObject->m_pTransformationData->m_pParentData = pParentObject->m_pTransformationData;
+    pObject->m_pTransformationData->MarkDirty();
 
     if (pParentObject->m_Flags.IsSet(ezObjectFlags::ChildChangesNotifications))
     {
@@ -692,6 +693,7 @@ void ezWorld::UnlinkFromParent(ezGameObject* pObject)
     pParentObject->m_ChildCount--;
     pObject->m_ParentIndex = 0;
     pObject->m_pTransformationData->m_pParentData = nullptr;
+    pObject->m_pTransformationData->MarkDirty();
 
     // Note that the sibling indices must not be set to 0 here.
     // They are still needed if we currently iterate over child objects.
@@ -753,6 +755,115 @@ const char* ezWorld::GetObjectGlobalKey(const ezGameObject* pObject) const
   return "";
 }
 
+namespace
+{
+  // The type key holds the message sorting key in its upper and the message id in its lower bits, so that ordering the type keys
+  // is the same as ordering by sorting key first and message id second.
+  EZ_ALWAYS_INLINE ezUInt64 GetQueuedMsgTypeKey(const ezMessage& msg)
+  {
+    const ezUInt32 uiSortingKey = static_cast<ezUInt32>(msg.GetSortingKey()) ^ 0x80000000u;
+    return (static_cast<ezUInt64>(uiSortingKey) << 16) | msg.GetId();
+  }
+
+  // the lower 8 bytes are the receiver data, the upper 6 bytes are the type key
+  constexpr ezUInt32 s_uiNumQueuedMsgRadixDigits = 14;
+
+  template <typename SortedMsg>
+  EZ_ALWAYS_INLINE ezUInt32 GetQueuedMsgRadixDigit(const SortedMsg& msg, ezUInt32 uiDigit)
+  {
+    return uiDigit < 8 ? static_cast<ezUInt32>(msg.m_uiReceiverData >> (uiDigit * 8)) & 0xFF
+                       : static_cast<ezUInt32>(msg.m_uiTypeKey >> ((uiDigit - 8) * 8)) & 0xFF;
+  }
+
+  /// Sorts the messages by type key, then by receiver and then by message hash. The two keys are sorted with a stable LSD radix sort,
+  /// where all digits that are the same for every message are skipped. Since most messages share the sorting key, the world index
+  /// and often the type of their receiver, usually only a few passes are needed. The hash is only computed for messages with the same
+  /// type and receiver and those runs are short, so they are sorted by insertion.
+  template <typename SortedMsg, typename Allocator>
+  void SortQueuedMessages(ezDynamicArray<SortedMsg, Allocator>& messages, ezDynamicArray<SortedMsg, Allocator>& temp)
+  {
+    const ezUInt32 uiCount = messages.GetCount();
+    if (uiCount <= 1)
+      return;
+
+    ezUInt32 histograms[s_uiNumQueuedMsgRadixDigits][256];
+    ezMemoryUtils::ZeroFill(&histograms[0][0], EZ_ARRAY_SIZE(histograms) * 256);
+
+    for (const SortedMsg& msg : messages)
+    {
+      for (ezUInt32 uiDigit = 0; uiDigit < s_uiNumQueuedMsgRadixDigits; ++uiDigit)
+      {
+        ++histograms[uiDigit][GetQueuedMsgRadixDigit(msg, uiDigit)];
+      }
+    }
+
+    temp.SetCountUninitialized(uiCount);
+    SortedMsg* pSource = messages.GetData();
+    SortedMsg* pTarget = temp.GetData();
+
+    for (ezUInt32 uiDigit = 0; uiDigit < s_uiNumQueuedMsgRadixDigits; ++uiDigit)
+    {
+      ezUInt32* pHistogram = histograms[uiDigit];
+      if (pHistogram[GetQueuedMsgRadixDigit(pSource[0], uiDigit)] == uiCount)
+        continue;
+
+      ezUInt32 uiOffset = 0;
+      for (ezUInt32 i = 0; i < 256; ++i)
+      {
+        const ezUInt32 uiBucketSize = pHistogram[i];
+        pHistogram[i] = uiOffset;
+        uiOffset += uiBucketSize;
+      }
+
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        pTarget[pHistogram[GetQueuedMsgRadixDigit(pSource[i], uiDigit)]++] = pSource[i];
+      }
+
+      ezMath::Swap(pSource, pTarget);
+    }
+
+    if (pSource != messages.GetData())
+    {
+      messages.Swap(temp);
+    }
+
+    for (ezUInt32 uiStart = 0; uiStart < uiCount;)
+    {
+      const SortedMsg& first = messages[uiStart];
+
+      ezUInt32 uiEnd = uiStart + 1;
+      while (uiEnd < uiCount && messages[uiEnd].m_uiTypeKey == first.m_uiTypeKey && messages[uiEnd].m_uiReceiverData == first.m_uiReceiverData)
+      {
+        ++uiEnd;
+      }
+
+      if (uiEnd - uiStart > 1)
+      {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          messages[i].m_uiMessageHash = messages[i].m_pMessage->GetHash();
+        }
+
+        for (ezUInt32 i = uiStart + 1; i < uiEnd; ++i)
+        {
+          const SortedMsg msg = messages[i];
+
+          ezUInt32 j = i;
+          for (; j > uiStart && messages[j - 1].m_uiMessageHash > msg.m_uiMessageHash; --j)
+          {
+            messages[j] = messages[j - 1];
+          }
+
+          messages[j] = msg;
+        }
+      }
+
+      uiStart = uiEnd;
+    }
+  }
+} // namespace
+
 void ezWorld::ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::Entry& entry)
 {
   if (entry.m_MetaData.m_uiReceiverIsComponent)
@@ -777,86 +888,184 @@ void ezWorld::ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::En
   }
   else
   {
-    ezGameObjectHandle hObject(ezGameObjectId(entry.m_MetaData.m_uiReceiverObjectOrComponent));
+    ProcessQueuedObjectMessage(entry.m_MetaData, *entry.m_pMessage);
+  }
+}
+
+void ezWorld::ProcessQueuedObjectMessage(const ezInternal::WorldData::QueuedMsgMetaData& metaData, ezMessage& msg)
+{
+  ezGameObjectHandle hObject(ezGameObjectId(metaData.m_uiReceiverObjectOrComponent));
 
-    ezGameObject* pReceiverObject = nullptr;
-    if (TryGetObject(hObject, pReceiverObject))
+  ezGameObject* pReceiverObject = nullptr;
+  if (TryGetObject(hObject, pReceiverObject))
+  {
+    if (metaData.m_uiRecursive)
     {
-      if (entry.m_MetaData.m_uiRecursive)
-      {
-        pReceiverObject->SendMessageRecursiveInternal(*entry.m_pMessage, true);
-      }
-      else
-      {
-        pReceiverObject->SendMessageInternal(*entry.m_pMessage, true);
-      }
+      pReceiverObject->SendMessageRecursiveInternal(msg, true);
     }
     else
     {
+      pReceiverObject->SendMessageInternal(msg, true);
+    }
+  }
+  else
+  {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
-      if (entry.m_pMessage->GetDebugMessageRouting())
-      {
-        ezLog::Warning("ezWorld::ProcessQueuedMessage: Receiver ezGameObject for message of type '{0}' does not exist anymore.",
-          entry.m_pMessage->GetId());
-      }
-#endif
+    if (msg.GetDebugMessageRouting())
+    {
+      ezLog::Warning("ezWorld::ProcessQueuedMessage: Receiver ezGameObject for message of type '{0}' does not exist anymore.", msg.GetId());
     }
+#endif
   }
 }
 
-void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
+void ezWorld::ProcessQueuedMessageBatch(ezArrayPtr<const ezInternal::WorldData::SortedQueuedMsg> messages)
 {
-  EZ_PROFILE_SCOPE("Process Queued Messages");
-
-  struct MessageComparer
+  // All messages have the same type and are sorted by receiver. Since the component type id is stored in the upper bits of the receiver
+  // data, all messages to components of the same type follow each other and are handed to their manager in one go.
+  const ezUInt32 uiCount = messages.GetCount();
+  for (ezUInt32 uiStart = 0; uiStart < uiCount;)
   {
-    EZ_FORCE_INLINE bool Less(const ezInternal::WorldData::MessageQueue::Entry& a, const ezInternal::WorldData::MessageQueue::Entry& b) const
+    ezInternal::WorldData::QueuedMsgMetaData metaData;
+    metaData.m_uiReceiverData = messages[uiStart].m_uiReceiverData;
+
+    if (!metaData.m_uiReceiverIsComponent)
+    {
+      ProcessQueuedObjectMessage(metaData, *messages[uiStart].m_pMessage);
+      ++uiStart;
+      continue;
+    }
+
+    const ezWorldModuleTypeId uiTypeId = ezComponentId(metaData.m_uiReceiverObjectOrComponent).m_TypeId;
+
+    auto& componentMessages = m_Data.m_QueuedComponentMessages;
+    componentMessages.Clear();
+
+    ezUInt32 uiEnd = uiStart;
+    for (; uiEnd < uiCount; ++uiEnd)
     {
-      if (a.m_MetaData.m_Due != b.m_MetaData.m_Due)
-        return a.m_MetaData.m_Due < b.m_MetaData.m_Due;
+      metaData.m_uiReceiverData = messages[uiEnd].m_uiReceiverData;
 
-      const ezInt32 iKeyA = a.m_pMessage->GetSortingKey();
-      const ezInt32 iKeyB = b.m_pMessage->GetSortingKey();
-      if (iKeyA != iKeyB)
-        return iKeyA < iKeyB;
+      const ezComponentId componentId(metaData.m_uiReceiverObjectOrComponent);
+      if (!metaData.m_uiReceiverIsComponent || componentId.m_TypeId != uiTypeId)
+        break;
 
-      if (a.m_pMessage->GetId() != b.m_pMessage->GetId())
-        return a.m_pMessage->GetId() < b.m_pMessage->GetId();
+      auto& componentMsg = componentMessages.ExpandAndGetRef();
+      componentMsg.m_hReceiver = ezComponentHandle(componentId);
+      componentMsg.m_pMessage = messages[uiEnd].m_pMessage;
+    }
 
-      if (a.m_MetaData.m_uiReceiverData != b.m_MetaData.m_uiReceiverData)
-        return a.m_MetaData.m_uiReceiverData < b.m_MetaData.m_uiReceiverData;
+    uiStart = uiEnd;
 
-      if (a.m_uiMessageHash == 0)
+    if (uiTypeId < m_Data.m_Modules.GetCount())
+    {
+      if (ezWorldModule* pModule = m_Data.m_Modules[uiTypeId])
       {
-        a.m_uiMessageHash = a.m_pMessage->GetHash();
+        static_cast<ezComponentManagerBase*>(pModule)->DeliverQueuedMessages(componentMessages);
+        continue;
       }
+    }
 
-      if (b.m_uiMessageHash == 0)
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    for (const auto& componentMsg : componentMessages)
+    {
+      if (componentMsg.m_pMessage->GetDebugMessageRouting())
       {
-        b.m_uiMessageHash = b.m_pMessage->GetHash();
+        ezLog::Warning("ezWorld::ProcessQueuedMessage: Receiver ezComponent for message of type '{0}' does not exist anymore.",
+          componentMsg.m_pMessage->GetId());
       }
-
-      return a.m_uiMessageHash < b.m_uiMessageHash;
     }
-  };
+#endif
+  }
+}
+
+void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
+{
+  EZ_PROFILE_SCOPE("Process Queued Messages");
 
   // regular messages
   {
     ezInternal::WorldData::MessageQueue& queue = m_Data.m_MessageQueues[queueType];
-    queue.Sort(MessageComparer());
+    auto& sortedMessages = m_Data.m_SortedQueuedMessages;
 
-    for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
+    // messages that are posted while the queue is processed are handled in another round
+    for (ezUInt32 uiFirst = 0; uiFirst < queue.GetCount();)
     {
-      ProcessQueuedMessage(queue[i]);
+      const ezUInt32 uiCount = queue.GetCount() - uiFirst;
+      sortedMessages.SetCountUninitialized(uiCount);
+
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        const auto& entry = queue[uiFirst + i];
+
+        auto& sortedMsg = sortedMessages[i];
+        sortedMsg.m_uiTypeKey = GetQueuedMsgTypeKey(*entry.m_pMessage);
+        sortedMsg.m_uiReceiverData = entry.m_MetaData.m_uiReceiverData;
+        sortedMsg.m_pMessage = entry.m_pMessage;
+        sortedMsg.m_uiMessageHash = 0;
+      }
+
+      uiFirst += uiCount;
+
+      SortQueuedMessages(sortedMessages, m_Data.m_SortedQueuedMessagesTemp);
+
+      // dispatch all messages of the same type together
+      for (ezUInt32 uiStart = 0; uiStart < uiCount;)
+      {
+        const ezUInt64 uiTypeKey = sortedMessages[uiStart].m_uiTypeKey;
+
+        ezUInt32 uiEnd = uiStart + 1;
+        while (uiEnd < uiCount && sortedMessages[uiEnd].m_uiTypeKey == uiTypeKey)
+        {
+          ++uiEnd;
+        }
+
+        ProcessQueuedMessageBatch(sortedMessages.GetArrayPtr().GetSubArray(uiStart, uiEnd - uiStart));
+
+        uiStart = uiEnd;
+      }
 
       // no need to deallocate these messages, they are allocated through a frame allocator
     }
 
     queue.Clear();
+    sortedMessages.Clear();
   }
 
   // timed messages
   {
+    struct MessageComparer
+    {
+      EZ_FORCE_INLINE bool Less(const ezInternal::WorldData::MessageQueue::Entry& a, const ezInternal::WorldData::MessageQueue::Entry& b) const
+      {
+        if (a.m_MetaData.m_Due != b.m_MetaData.m_Due)
+          return a.m_MetaData.m_Due < b.m_MetaData.m_Due;
+
+        const ezInt32 iKeyA = a.m_pMessage->GetSortingKey();
+        const ezInt32 iKeyB = b.m_pMessage->GetSortingKey();
+        if (iKeyA != iKeyB)
+          return iKeyA < iKeyB;
+
+        if (a.m_pMessage->GetId() != b.m_pMessage->GetId())
+          return a.m_pMessage->GetId() < b.m_pMessage->GetId();
+
+        if (a.m_MetaData.m_uiReceiverData != b.m_MetaData.m_uiReceiverData)
+          return a.m_MetaData.m_uiReceiverData < b.m_MetaData.m_uiReceiverData;
+
+        if (a.m_uiMessageHash == 0)
+        {
+          a.m_uiMessageHash = a.m_pMessage->GetHash();
+        }
+
+        if (b.m_uiMessageHash == 0)
+        {
+          b.m_uiMessageHash = b.m_pMessage->GetHash();
+        }
+
+        return a.m_uiMessageHash < b.m_uiMessageHash;
+      }
+    };
+
     ezInternal::WorldData::MessageQueue& queue = m_Data.m_TimedMessageQueues[queueType];
     queue.Sort(MessageComparer());
 
@@ -884,6 +1093,7 @@ void ezWorld::RegisterUpdateFunction(const ezComponentManagerBase::UpdateFunctio
   CheckForWriteAccess();
 
   EZ_ASSERT_DEV(desc.m_Phase == ezComponentManagerBase::UpdateFunctionDesc::Phase::Async || desc.m_uiGranularity == 0, "Granularity must be 0 for synchronous update functions");
+  EZ_ASSERT_DEV(desc.m_Phase == ezComponentManagerBase::UpdateFunctionDesc::Phase::Async || !desc.m_bAutoGranularity, "Automatic granularity is only supported for asynchronous update functions");
   EZ_ASSERT_DEV(desc.m_Phase != ezComponentManagerBase::UpdateFunctionDesc::Phase::Async || desc.m_DependsOn.GetCount() == 0, "Asynchronous update functions must not have dependencies");
   EZ_ASSERT_DEV(desc.m_Function.IsComparable(), "Delegates with captures are not allowed as ezWorld update functions.");
 
@@ -936,45 +1146,197 @@ void ezWorld::UpdateFromThread()
   Update();
 }
 
-void ezWorld::UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions)
+void ezWorld::UpdatePhase(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase)
 {
+  auto& schedule = m_Data.m_UpdateSchedule;
+  const ezUInt32 uiFirstScheduledFunction = schedule.GetCount();
+
+  ScheduleUpdateFunctions(m_Data.m_UpdateFunctions[phase], phase, uiFirstScheduledFunction);
+
+  if (phase == ezWorldModule::UpdateFunctionDesc::Phase::PreAsync)
+  {
+    // async functions are appended to the last segment of the pre-async phase, thus they only have to wait for the pre-async functions
+    // they conflict with
+    ScheduleUpdateFunctions(m_Data.m_UpdateFunctions[ezWorldModule::UpdateFunctionDesc::Phase::Async],
+      ezWorldModule::UpdateFunctionDesc::Phase::Async, uiFirstScheduledFunction);
+  }
+
   ezWorldModule::UpdateContext context;
   context.m_uiFirstComponentIndex = 0;
   context.m_uiComponentCount = ezInvalidIndex;
 
+  // exclusive functions split the schedule into segments, everything in between is called concurrently
+  ezUInt32 uiSegmentStart = uiFirstScheduledFunction;
+  for (ezUInt32 i = uiFirstScheduledFunction; i < schedule.GetCount(); ++i)
+  {
+    if (!schedule[i].m_bExclusive)
+      continue;
+
+    UpdateConcurrently(uiSegmentStart, i);
+    uiSegmentStart = i + 1;
+
+    {
+      EZ_PROFILE_SCOPE(schedule[i].m_sFunctionName);
+      schedule[i].m_Function(context);
+    }
+  }
+
+  UpdateConcurrently(uiSegmentStart, schedule.GetCount());
+}
+
+void ezWorld::ScheduleUpdateFunctions(ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction> updateFunctions,
+  ezWorldModule::UpdateFunctionDesc::Phase::Enum phase, ezUInt32 uiFirstScheduledFunction)
+{
+  auto& schedule = m_Data.m_UpdateSchedule;
+  auto& dependencies = m_Data.m_UpdateScheduleDependencies;
+
+  const bool bAsync = (phase == ezWorldModule::UpdateFunctionDesc::Phase::Async);
+
   for (auto& updateFunction : updateFunctions)
   {
     if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
       continue;
 
+    const ezUInt32 uiIndex = schedule.GetCount();
+
+    auto& scheduledFunction = schedule.ExpandAndGetRef();
+    scheduledFunction.m_pFunction = &updateFunction;
+    scheduledFunction.m_Function = updateFunction.m_Function;
+    scheduledFunction.m_sFunctionName = updateFunction.m_sFunctionName;
+    scheduledFunction.m_uiFirstDependency = dependencies.GetCount();
+    scheduledFunction.m_uiFirstTask = 0;
+    scheduledFunction.m_uiTaskCount = 0;
+    scheduledFunction.m_uiGranularity = updateFunction.m_uiGranularity;
+    scheduledFunction.m_Phase = phase;
+    scheduledFunction.m_bExclusive = !bAsync && !updateFunction.HasDeclaredAccess();
+    scheduledFunction.m_bHasSuccessor = false;
+
+    for (ezUInt32 j = uiIndex; j-- > uiFirstScheduledFunction;)
     {
-      EZ_PROFILE_SCOPE(updateFunction.m_sFunctionName);
-      updateFunction.m_Function(context);
+      auto& otherFunction = schedule[j];
+
+      if (otherFunction.m_bExclusive)
+      {
+        // everything before an exclusive function has finished when it returns, so an edge is only needed if nothing else was found
+        if (dependencies.GetCount() == scheduledFunction.m_uiFirstDependency)
+        {
+          dependencies.PushBack(j);
+          otherFunction.m_bHasSuccessor = true;
+        }
+        break;
+      }
+
+      bool bDependsOnOther = false;
+      if (scheduledFunction.m_bExclusive)
+      {
+        // functions that already have a successor are covered transitively
+        bDependsOnOther = !otherFunction.m_bHasSuccessor;
+      }
+      else if (bAsync && otherFunction.m_Phase == ezWorldModule::UpdateFunctionDesc::Phase::Async)
+      {
+        // async functions are never ordered among each other
+        bDependsOnOther = false;
+      }
+      else
+      {
+        bDependsOnOther = updateFunction.ConflictsWith(*otherFunction.m_pFunction) || updateFunction.m_DependsOn.Contains(otherFunction.m_sFunctionName);
+      }
+
+      if (bDependsOnOther)
+      {
+        dependencies.PushBack(j);
+        otherFunction.m_bHasSuccessor = true;
+      }
     }
+
+    scheduledFunction.m_uiDependencyCount = dependencies.GetCount() - scheduledFunction.m_uiFirstDependency;
   }
 }
 
-void ezWorld::UpdateAsynchronous()
+namespace
+{
+  // Tasks shorter than this are not worth their scheduling overhead.
+  constexpr ezTime s_MinAutoGranularityTaskDuration = ezTime::Microseconds(50);
+
+  // Weight of the last frame in the smoothed per component update cost.
+  constexpr double s_fComponentUpdateCostSmoothing = 0.2;
+
+  /// Splits the components into as many batches as there are workers, unless the measured cost says that the batches would become too
+  /// short. Batches always consist of whole storage blocks, so two tasks never write to the same block and thus the same cache lines.
+  ezUInt32 ComputeAutoGranularity(ezTime componentUpdateCost, ezUInt32 uiTotalCount, ezUInt32 uiComponentsPerBlock)
+  {
+    ezUInt32 uiTaskCount = ezMath::Max(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u);
+
+    // nothing measured yet, e.g. in the first frame, start with one batch per worker
+    if (componentUpdateCost.IsPositive())
+    {
+      const double fMaxTaskCount = (componentUpdateCost * uiTotalCount).GetSeconds() / s_MinAutoGranularityTaskDuration.GetSeconds();
+      uiTaskCount = ezMath::Clamp(static_cast<ezUInt32>(fMaxTaskCount), 1u, uiTaskCount);
+    }
+
+    const ezUInt32 uiBlockCount = (uiTotalCount + uiComponentsPerBlock - 1) / uiComponentsPerBlock;
+    const ezUInt32 uiBlocksPerTask = ezMath::Max((uiBlockCount + uiTaskCount - 1) / uiTaskCount, 1u);
+
+    return uiBlocksPerTask * uiComponentsPerBlock;
+  }
+} // namespace
+
+void ezWorld::UpdateConcurrently(ezUInt32 uiFirstScheduledFunction, ezUInt32 uiEndScheduledFunction)
 {
-  ezTaskGroupID taskGroupId = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+  if (uiFirstScheduledFunction == uiEndScheduledFunction)
+    return;
+
+  auto& schedule = m_Data.m_UpdateSchedule;
 
-  ezDynamicArrayBase<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions =
-    m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::Async];
+  // a single synchronous function is simply called on this thread
+  if (uiFirstScheduledFunction + 1 == uiEndScheduledFunction &&
+      schedule[uiFirstScheduledFunction].m_Phase != ezWorldModule::UpdateFunctionDesc::Phase::Async)
+  {
+    ezWorldModule::UpdateContext context;
+    context.m_uiFirstComponentIndex = 0;
+    context.m_uiComponentCount = ezInvalidIndex;
+
+    EZ_PROFILE_SCOPE(schedule[uiFirstScheduledFunction].m_sFunctionName);
+    schedule[uiFirstScheduledFunction].m_Function(context);
+    return;
+  }
+
+  auto& taskGroups = m_Data.m_UpdateScheduleTaskGroups;
+  auto& taskGroupDependencies = m_Data.m_UpdateScheduleTaskGroupDependencies;
+  taskGroups.Clear();
+  taskGroupDependencies.Clear();
 
   ezUInt32 uiCurrentTaskIndex = 0;
 
-  for (auto& updateFunction : updateFunctions)
+  for (ezUInt32 i = uiFirstScheduledFunction; i < uiEndScheduledFunction; ++i)
   {
-    if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
-      continue;
+    auto& scheduledFunction = schedule[i];
+    scheduledFunction.m_TaskGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+    taskGroups.PushBack(scheduledFunction.m_TaskGroup);
 
-    ezComponentManagerBase* pManager = static_cast<ezComponentManagerBase*>(updateFunction.m_Function.GetClassInstance());
+    // synchronous functions are called once for all components, async functions in batches
+    ezUInt32 uiTotalCount = 1;
+    ezUInt32 uiGranularity = 1;
+    if (scheduledFunction.m_Phase == ezWorldModule::UpdateFunctionDesc::Phase::Async)
+    {
+      ezComponentManagerBase* pManager = static_cast<ezComponentManagerBase*>(scheduledFunction.m_Function.GetClassInstance());
+
+      uiTotalCount = pManager->GetComponentCount();
+      uiGranularity = (scheduledFunction.m_uiGranularity != 0) ? scheduledFunction.m_uiGranularity : uiTotalCount;
+
+      if (scheduledFunction.m_pFunction->m_bAutoGranularity)
+      {
+        uiGranularity = ComputeAutoGranularity(scheduledFunction.m_pFunction->m_ComponentUpdateCost, uiTotalCount, pManager->m_uiComponentsPerBlock);
 
-    const ezUInt32 uiTotalCount = pManager->GetComponentCount();
-    ezUInt32 uiStartIndex = 0;
-    ezUInt32 uiGranularity = (updateFunction.m_uiGranularity != 0) ? updateFunction.m_uiGranularity : uiTotalCount;
+        ezStringBuilder sStatName;
+        sStatName.Format("World Update/{0}/Granularity/{1}", m_Data.m_sName, scheduledFunction.m_sFunctionName);
+        ezStats::SetStat(sStatName, uiGranularity);
+      }
+    }
 
-    while (uiStartIndex < uiTotalCount)
+    scheduledFunction.m_uiFirstTask = uiCurrentTaskIndex;
+
+    for (ezUInt32 uiStartIndex = 0; uiStartIndex < uiTotalCount; uiStartIndex += uiGranularity)
     {
       ezSharedPtr<ezInternal::WorldData::UpdateTask> pTask;
       if (uiCurrentTaskIndex < m_Data.m_UpdateTasks.GetCount())
@@ -987,19 +1349,140 @@ void ezWorld::UpdateAsynchronous()
         m_Data.m_UpdateTasks.PushBack(pTask);
       }
 
-      pTask->ConfigureTask(updateFunction.m_sFunctionName, ezTaskNesting::Maybe);
-      pTask->m_Function = updateFunction.m_Function;
+      pTask->ConfigureTask(scheduledFunction.m_sFunctionName, ezTaskNesting::Maybe);
+      pTask->m_Function = scheduledFunction.m_Function;
       pTask->m_uiStartIndex = uiStartIndex;
       pTask->m_uiCount = (uiStartIndex + uiGranularity < uiTotalCount) ? uiGranularity : ezInvalidIndex;
-      ezTaskSystem::AddTaskToGroup(taskGroupId, pTask);
+      ezTaskSystem::AddTaskToGroup(scheduledFunction.m_TaskGroup, pTask);
 
       ++uiCurrentTaskIndex;
-      uiStartIndex += uiGranularity;
     }
+
+    scheduledFunction.m_uiTaskCount = uiCurrentTaskIndex - scheduledFunction.m_uiFirstTask;
+
+    for (ezUInt32 d = 0; d < scheduledFunction.m_uiDependencyCount; ++d)
+    {
+      const ezUInt32 uiPredecessor = m_Data.m_UpdateScheduleDependencies[scheduledFunction.m_uiFirstDependency + d];
+
+      // predecessors in earlier segments have already finished
+      if (uiPredecessor >= uiFirstScheduledFunction)
+      {
+        auto& dependency = taskGroupDependencies.ExpandAndGetRef();
+        dependency.m_TaskGroup = scheduledFunction.m_TaskGroup;
+        dependency.m_DependsOn = schedule[uiPredecessor].m_TaskGroup;
+      }
+    }
+  }
+
+  // remove write marker but keep the read marker. Thus no one can mark the world for writing now. Only reading is allowed while update
+  // functions are called concurrently.
+  m_Data.m_WriteThreadID = (ezThreadID)0;
+
+  ezTaskSystem::AddTaskGroupDependencyBatch(taskGroupDependencies);
+  ezTaskSystem::StartTaskGroupBatch(taskGroups);
+
+  for (const ezTaskGroupID& taskGroup : taskGroups)
+  {
+    ezTaskSystem::WaitForGroup(taskGroup);
   }
 
-  ezTaskSystem::StartTaskGroup(taskGroupId);
-  ezTaskSystem::WaitForGroup(taskGroupId);
+  // restore write marker
+  m_Data.m_WriteThreadID = ezThreadUtils::GetCurrentThreadID();
+
+  // feed the time the tasks took back into the granularity of the next frame
+  for (ezUInt32 i = uiFirstScheduledFunction; i < uiEndScheduledFunction; ++i)
+  {
+    const auto& scheduledFunction = schedule[i];
+    if (scheduledFunction.m_uiTaskCount == 0 || !scheduledFunction.m_pFunction->m_bAutoGranularity)
+      continue;
+
+    ezTime duration;
+    for (ezUInt32 t = 0; t < scheduledFunction.m_uiTaskCount; ++t)
+    {
+      duration += m_Data.m_UpdateTasks[scheduledFunction.m_uiFirstTask + t]->m_Duration;
+    }
+
+    // the component count can't have changed while the functions were running
+    const ezComponentManagerBase* pManager = static_cast<const ezComponentManagerBase*>(scheduledFunction.m_Function.GetClassInstance());
+    const ezTime componentCost = duration / pManager->GetComponentCount();
+
+    ezTime& smoothedCost = scheduledFunction.m_pFunction->m_ComponentUpdateCost;
+    smoothedCost = smoothedCost.IsPositive() ? ezMath::Lerp(smoothedCost, componentCost, s_fComponentUpdateCostSmoothing) : componentCost;
+  }
+}
+
+void ezWorld::WriteUpdateScheduleToDGML(ezDGMLGraph& graph) const
+{
+  CheckForReadAccess();
+
+  const char* szPhaseNames[ezWorldModule::UpdateFunctionDesc::Phase::COUNT] = {"Pre-Async Phase", "Async Phase", "Post-Async Phase", "Post-Transform Phase"};
+
+  ezDGMLGraph::NodeDesc phaseND;
+  phaseND.m_Color = ezColor::CornflowerBlue;
+  phaseND.m_Shape = ezDGMLGraph::NodeShape::Rectangle;
+
+  ezDGMLGraph::NodeDesc exclusiveND;
+  exclusiveND.m_Color = ezColor::OrangeRed;
+  exclusiveND.m_Shape = ezDGMLGraph::NodeShape::Rectangle;
+
+  ezDGMLGraph::NodeDesc concurrentND;
+  concurrentND.m_Color = ezColor::LightGreen;
+  concurrentND.m_Shape = ezDGMLGraph::NodeShape::RoundedRectangle;
+
+  ezDGMLGraph::NodeDesc asyncND;
+  asyncND.m_Color = ezColor::Gold;
+  asyncND.m_Shape = ezDGMLGraph::NodeShape::RoundedRectangle;
+
+  const ezDGMLGraph::PropertyId executionId = graph.AddPropertyType("Execution");
+  const ezDGMLGraph::PropertyId orderId = graph.AddPropertyType("Order");
+
+  ezStringBuilder title("World '", m_Data.m_sName.GetData(), "'");
+  const ezDGMLGraph::NodeId worldGroupId = graph.AddGroup(title, ezDGMLGraph::GroupType::Expanded);
+
+  ezDGMLGraph::NodeId phaseGroupIds[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
+  bool bPhaseGroupCreated[ezWorldModule::UpdateFunctionDesc::Phase::COUNT] = {};
+
+  const auto& schedule = m_Data.m_UpdateSchedule;
+
+  ezHybridArray<ezDGMLGraph::NodeId, 64> nodeIds;
+  nodeIds.SetCountUninitialized(schedule.GetCount());
+
+  for (ezUInt32 i = 0; i < schedule.GetCount(); ++i)
+  {
+    const auto& scheduledFunction = schedule[i];
+    const ezUInt32 uiPhase = scheduledFunction.m_Phase.GetValue();
+
+    if (!bPhaseGroupCreated[uiPhase])
+    {
+      phaseGroupIds[uiPhase] = graph.AddGroup(szPhaseNames[uiPhase], ezDGMLGraph::GroupType::Expanded, &phaseND);
+      graph.AddNodeToGroup(phaseGroupIds[uiPhase], worldGroupId);
+      bPhaseGroupCreated[uiPhase] = true;
+    }
+
+    const char* szExecution = "Task";
+    const ezDGMLGraph::NodeDesc* pNodeDesc = &concurrentND;
+    if (scheduledFunction.m_bExclusive)
+    {
+      szExecution = "Exclusive";
+      pNodeDesc = &exclusiveND;
+    }
+    else if (scheduledFunction.m_Phase == ezWorldModule::UpdateFunctionDesc::Phase::Async)
+    {
+      szExecution = "Async Batches";
+      pNodeDesc = &asyncND;
+    }
+
+    nodeIds[i] = graph.AddNode(scheduledFunction.m_sFunctionName, pNodeDesc);
+    graph.AddNodeToGroup(nodeIds[i], phaseGroupIds[uiPhase]);
+    graph.AddNodeProperty(nodeIds[i], executionId, szExecution);
+    graph.AddNodeProperty(nodeIds[i], orderId, ezFmt("{}", i));
+
+    for (ezUInt32 d = 0; d < scheduledFunction.m_uiDependencyCount; ++d)
+    {
+      const ezUInt32 uiPredecessor = m_Data.m_UpdateScheduleDependencies[scheduledFunction.m_uiFirstDependency + d];
+      graph.AddConnection(nodeIds[uiPredecessor], nodeIds[i]);
+    }
+  }
 }
 
 bool ezWorld::ProcessInitializationBatch(ezInternal::WorldData::InitBatch& batch, ezTime endTime)
@@ -1189,6 +1672,16 @@ ezResult ezWorld::RegisterUpdateFunctionInternal(const ezWorldModule::UpdateFunc
   ezInternal::WorldData::RegisteredUpdateFunction newFunction;
   newFunction.FillFromDesc(desc);
 
+  // a function always writes to its own module, component managers add their component type instead since they share the same rtti
+  if (newFunction.HasDeclaredAccess())
+  {
+    const ezWorldModule* pModule = static_cast<const ezWorldModule*>(desc.m_Function.GetClassInstance());
+    if (!pModule->IsInstanceOf<ezComponentManagerBase>())
+    {
+      newFunction.m_WriteAccess.PushBack(pModule->GetDynamicRTTI());
+    }
+  }
+
   while (uiInsertionIndex < updateFunctions.GetCount())
   {
     const auto& existingFunction = updateFunctions[uiInsertionIndex];
@@ -1288,6 +1781,7 @@ void ezWorld::PatchHierarchyData(ezGameObject* pObject, ezGameObject::TransformP
   else
   {
     pObject->UpdateGlobalTransform();
+    pObject->m_pTransformationData->MarkDirty();
   }
 
   for (auto it = pObject->GetChildren(); it.IsValid(); ++it)
@@ -7,6 +7,9 @@
 
 namespace ezInternal
 {
+  // minimum number of data blocks that are updated by one task in UpdateGlobalTransformsMultiThreaded
+  static constexpr ezUInt32 s_uiMinTransformBlocksPerTask = 16;
+
   class DefaultCoordinateSystemProvider : public ezCoordinateSystemProvider
   {
   public:
@@ -25,13 +28,92 @@ namespace ezInternal
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+  static bool WriteAccessOverlaps(ezArrayPtr<const ezRTTI* const> writeAccess, ezArrayPtr<const ezRTTI* const> otherAccess)
+  {
+    for (const ezRTTI* pWriteType : writeAccess)
+    {
+      for (const ezRTTI* pOtherType : otherAccess)
+      {
+        if (pWriteType->IsDerivedFrom(pOtherType) || pOtherType->IsDerivedFrom(pWriteType))
+          return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool WorldData::RegisteredUpdateFunction::ConflictsWith(const RegisteredUpdateFunction& other) const
+  {
+    if (!HasDeclaredAccess() || !other.HasDeclaredAccess())
+      return true;
+
+    // functions of the same module always write to the same data
+    if (m_Function.GetClassInstance() == other.m_Function.GetClassInstance())
+      return true;
+
+    return WriteAccessOverlaps(m_WriteAccess, other.m_WriteAccess) || WriteAccessOverlaps(m_WriteAccess, other.m_ReadAccess) ||
+           WriteAccessOverlaps(other.m_WriteAccess, m_ReadAccess);
+  }
+
   void WorldData::UpdateTask::Execute()
   {
     ezWorldModule::UpdateContext context;
     context.m_uiFirstComponentIndex = m_uiStartIndex;
     context.m_uiComponentCount = m_uiCount;
 
+    const ezTime startTime = ezTime::Now();
     m_Function(context);
+    m_Duration = ezTime::Now() - startTime;
+  }
+
+  void WorldData::UpdateTransformsTask::Execute()
+  {
+    const ezSimdFloat fInvDeltaSeconds = m_fInvDeltaSeconds;
+
+    m_uiVisitedCount = 0;
+    m_uiUpdatedCount = 0;
+
+    if (m_bRecordSpatialData)
+    {
+      SpatialDataChangeLog& changeLog = m_SpatialDataChangeLog;
+
+      if (m_bRootLevel)
+      {
+        UpdateDirtyTransforms(
+          m_pBlocks, m_uiBlockCount,
+          [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransformAndRecordSpatialData(pData, fInvDeltaSeconds, changeLog); },
+          m_uiVisitedCount, m_uiUpdatedCount);
+      }
+      else
+      {
+        UpdateDirtyTransforms(
+          m_pBlocks, m_uiBlockCount,
+          [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransformWithParentAndRecordSpatialData(pData, fInvDeltaSeconds, changeLog); },
+          m_uiVisitedCount, m_uiUpdatedCount);
+      }
+    }
+    else
+    {
+      if (m_bRootLevel)
+      {
+        UpdateDirtyTransforms(
+          m_pBlocks, m_uiBlockCount, [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransform(pData, fInvDeltaSeconds); },
+          m_uiVisitedCount, m_uiUpdatedCount);
+      }
+      else
+      {
+        UpdateDirtyTransforms(
+          m_pBlocks, m_uiBlockCount,
+          [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransformWithParent(pData, fInvDeltaSeconds); },
+          m_uiVisitedCount, m_uiUpdatedCount);
+      }
+    }
+  }
+
+  void WorldData::SpatialDataChangeLog::Clear()
+  {
+    m_Updates.Clear();
+    m_StructuralChanges.Clear();
   }
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -73,6 +155,10 @@ namespace ezInternal
     EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject::TransformationData) == 192);
 #endif
 
+    // the dirty mask of a transformation data block is stored in the unused space at the end of the block
+    EZ_CHECK_AT_COMPILETIME(TRANSFORMATION_DATA_PER_BLOCK <= 32);
+    EZ_CHECK_AT_COMPILETIME(TRANSFORMATION_DATA_PER_BLOCK * sizeof(ezGameObject::TransformationData) + sizeof(ezInt32) <= DEFAULT_BLOCK_SIZE);
+
     EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject) == 168); /// \todo get game object size back to 128
     EZ_CHECK_AT_COMPILETIME(sizeof(QueuedMsgMetaData) == 16);
 
@@ -128,6 +214,7 @@ namespace ezInternal
 
     // delete task storage
     m_UpdateTasks.Clear();
+    m_UpdateTransformsTasks.Clear();
 
     // delete queued messages
     for (ezUInt32 i = 0; i < ezObjectMsgQueueType::COUNT; ++i)
@@ -173,9 +260,15 @@ namespace ezInternal
     {
       blocks.PushBack(m_BlockAllocator.AllocateBlock<ezGameObject::TransformationData>());
       pBlock = &blocks.PeekBack();
+
+      EZ_CHECK_ALIGNMENT(pBlock->m_pData, DEFAULT_BLOCK_SIZE);
+      ezGameObject::TransformationData::GetBlockDirtyMask(pBlock->m_pData) = 0;
     }
 
-    return pBlock->ReserveBack();
+    ezGameObject::TransformationData* pData = pBlock->ReserveBack();
+    pData->MarkDirty();
+
+    return pData;
   }
 
   void WorldData::DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData)
@@ -190,6 +283,7 @@ namespace ezInternal
     {
       ezMemoryUtils::Copy(pData, pLast, 1);
       pData->m_pObject->m_pTransformationData = pData;
+      pData->MarkDirty();
 
       // fix parent transform data for children as well
       auto it = pData->m_pObject->GetChildren();
@@ -279,79 +373,228 @@ namespace ezInternal
 
   void WorldData::UpdateGlobalTransforms(float fInvDeltaSeconds)
   {
-    struct UserData
-    {
-      ezSimdFloat m_fInvDt;
-      ezSpatialSystem* m_pSpatialSystem;
-    };
+    const ezSimdFloat fInvDt = fInvDeltaSeconds;
 
-    UserData userData;
-    userData.m_fInvDt = fInvDeltaSeconds;
-    userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
+    m_uiVisitedTransformCount = 0;
+    m_uiUpdatedTransformCount = 0;
 
-    struct RootLevel
+    Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
+    if (!hierarchy.m_Data.IsEmpty())
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      auto dataPtr = hierarchy.m_Data.GetData();
+
+      ezUInt32 uiNumBlocks = 0;
+      for (ezUInt32 i = 0; i < hierarchy.m_Data.GetCount(); ++i)
       {
-        WorldData::UpdateGlobalTransform(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
+        uiNumBlocks += dataPtr[i]->GetCount();
       }
-    };
 
-    struct WithParent
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      // Changes to the spatial system are only recorded during the update and applied afterwards,
+      // so the update can always be multi-threaded.
+      if (uiNumBlocks > s_uiMinTransformBlocksPerTask)
       {
-        WorldData::UpdateGlobalTransformWithParent(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
+        UpdateGlobalTransformsMultiThreaded(hierarchy, fInvDeltaSeconds);
       }
-    };
+      else if (m_pSpatialSystem == nullptr)
+      {
+        UpdateDirtyTransforms(
+          dataPtr[0]->GetData(), dataPtr[0]->GetCount(), [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransform(pData, fInvDt); },
+          m_uiVisitedTransformCount, m_uiUpdatedTransformCount);
 
-    struct RootLevelWithSpatialData
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
+        {
+          UpdateDirtyTransforms(
+            dataPtr[i]->GetData(), dataPtr[i]->GetCount(),
+            [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransformWithParent(pData, fInvDt); },
+            m_uiVisitedTransformCount, m_uiUpdatedTransformCount);
+        }
+      }
+      else
       {
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        SpatialDataChangeLog& changeLog = m_SpatialDataChangeLog;
+        changeLog.Clear();
+
+        UpdateDirtyTransforms(
+          dataPtr[0]->GetData(), dataPtr[0]->GetCount(),
+          [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransformAndRecordSpatialData(pData, fInvDt, changeLog); },
+          m_uiVisitedTransformCount, m_uiUpdatedTransformCount);
+
+        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
+        {
+          UpdateDirtyTransforms(
+            dataPtr[i]->GetData(), dataPtr[i]->GetCount(),
+            [&](ezGameObject::TransformationData* pData) { WorldData::UpdateGlobalTransformWithParentAndRecordSpatialData(pData, fInvDt, changeLog); },
+            m_uiVisitedTransformCount, m_uiUpdatedTransformCount);
+        }
+
+        SpatialDataChangeLog* pChangeLog = &changeLog;
+        ApplySpatialDataChanges(ezMakeArrayPtr(&pChangeLog, 1));
       }
-    };
+    }
+  }
+
+  void WorldData::ApplySpatialDataChanges(ezArrayPtr<SpatialDataChangeLog* const> changeLogs)
+  {
+    ezSpatialSystem& spatialSystem = *m_pSpatialSystem;
 
-    struct WithParentWithSpatialData
+    // creating or deleting spatial data is rare, so these changes are applied one by one in the deterministic order of the logs
+    for (SpatialDataChangeLog* pChangeLog : changeLogs)
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      for (const SpatialDataChangeLog::StructuralChange& change : pChangeLog->m_StructuralChanges)
       {
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        ezGameObject::TransformationData* pData = change.m_pData;
+        const bool bIsAlwaysVisible = pData->m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+
+        pData->UpdateSpatialData(spatialSystem, change.m_bWasAlwaysVisible, bIsAlwaysVisible);
       }
-    };
+    }
 
-    Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
-    if (!hierarchy.m_Data.IsEmpty())
+    if (changeLogs.GetCount() == 1)
     {
-      auto dataPtr = hierarchy.m_Data.GetData();
+      spatialSystem.UpdateSpatialDataBatch(changeLogs[0]->m_Updates);
+      return;
+    }
+
+    auto& updates = m_SpatialDataChangeLog.m_Updates;
+    updates.Clear();
+
+    for (SpatialDataChangeLog* pChangeLog : changeLogs)
+    {
+      updates.PushBackRange(pChangeLog->m_Updates);
+    }
+
+    spatialSystem.UpdateSpatialDataBatch(updates);
+  }
+
+  void WorldData::UpdateGlobalTransformsMultiThreaded(Hierarchy& hierarchy, float fInvDeltaSeconds)
+  {
+    // Every task updates a range of data blocks of one hierarchy level and is put into its own task group. Instead of waiting for a
+    // whole level to finish before the next one is started, each task group only depends on the task groups of the parent level that
+    // contain the parents of its objects. That way the update of a level can already start while other parts of the parent level are
+    // still being processed.
+
+    const ezUInt32 uiMaxTasksPerLevel = ezMath::Max(2 * ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u);
+
+    auto& taskGroups = m_UpdateTransformsTaskGroups;
+    auto& stamps = m_UpdateTransformsDependencyStamps;
+    auto& dependencies = m_UpdateTransformsDependencies;
+    taskGroups.Clear();
+    stamps.Clear();
+    dependencies.Clear();
+    m_ParentBlockLookup.Clear();
+
+    for (ezUInt32 uiLevel = 0; uiLevel < hierarchy.m_Data.GetCount(); ++uiLevel)
+    {
+      Hierarchy::DataBlockArray& blocks = *hierarchy.m_Data[uiLevel];
+      const ezUInt32 uiNumBlocks = blocks.GetCount();
 
-      // If we have no spatial system, we perform multi-threaded update as we do not
-      // have to acquire a write lock in the process.
-      if (m_pSpatialSystem == nullptr)
+      const ezUInt32 uiBlocksPerTask = ezMath::Max((uiNumBlocks + uiMaxTasksPerLevel - 1) / uiMaxTasksPerLevel, s_uiMinTransformBlocksPerTask);
+
+      m_ChildBlockLookup.Clear();
+
+      for (ezUInt32 uiFirstBlock = 0; uiFirstBlock < uiNumBlocks; uiFirstBlock += uiBlocksPerTask)
       {
-        TraverseHierarchyLevelMultiThreaded<RootLevel>(*dataPtr[0], &userData);
+        const ezUInt32 uiTaskIndex = taskGroups.GetCount();
 
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
+        if (uiTaskIndex == m_UpdateTransformsTasks.GetCount())
         {
-          TraverseHierarchyLevelMultiThreaded<WithParent>(*dataPtr[i], &userData);
+          m_UpdateTransformsTasks.PushBack(EZ_NEW(&m_Allocator, UpdateTransformsTask));
+          m_UpdateTransformsTasks.PeekBack()->ConfigureTask("Update Global Transforms", ezTaskNesting::Never);
         }
-      }
-      else
-      {
-        TraverseHierarchyLevel<RootLevelWithSpatialData>(*dataPtr[0], &userData);
 
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
+        UpdateTransformsTask* pTask = m_UpdateTransformsTasks[uiTaskIndex].Borrow();
+        pTask->m_pBlocks = blocks.GetData() + uiFirstBlock;
+        pTask->m_uiBlockCount = ezMath::Min(uiBlocksPerTask, uiNumBlocks - uiFirstBlock);
+        pTask->m_bRootLevel = uiLevel == 0;
+        pTask->m_bRecordSpatialData = m_pSpatialSystem != nullptr;
+        pTask->m_fInvDeltaSeconds = fInvDeltaSeconds;
+        pTask->m_SpatialDataChangeLog.Clear();
+
+        const ezTaskGroupID taskGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+        ezTaskSystem::AddTaskToGroup(taskGroup, m_UpdateTransformsTasks[uiTaskIndex]);
+        taskGroups.PushBack(taskGroup);
+        stamps.PushBack(0);
+
+        for (ezUInt32 uiBlock = 0; uiBlock < pTask->m_uiBlockCount; ++uiBlock)
         {
-          TraverseHierarchyLevel<WithParentWithSpatialData>(*dataPtr[i], &userData);
+          auto& lookup = m_ChildBlockLookup.ExpandAndGetRef();
+          lookup.m_pData = pTask->m_pBlocks[uiBlock].m_pData;
+          lookup.m_uiTaskIndex = uiTaskIndex;
+        }
+
+        if (uiLevel == 0)
+          continue;
+
+        // find the tasks that update the parents of the objects in this range
+        const TransformBlockLookup* pParentBlock = nullptr;
+
+        for (ezUInt32 uiBlock = 0; uiBlock < pTask->m_uiBlockCount; ++uiBlock)
+        {
+          const Hierarchy::DataBlock& block = pTask->m_pBlocks[uiBlock];
+
+          for (ezUInt32 i = 0; i < block.m_uiCount; ++i)
+          {
+            const ezGameObject::TransformationData* pParentData = block.m_pData[i].m_pParentData;
+
+            // siblings are usually created together, so most objects share their parent's block with the previous object
+            if (pParentBlock == nullptr || pParentData < pParentBlock->m_pData || pParentData >= pParentBlock->m_pData + TRANSFORMATION_DATA_PER_BLOCK)
+            {
+              // binary search for the last block that starts at or before the parent data
+              ezUInt32 uiLow = 0;
+              ezUInt32 uiHigh = m_ParentBlockLookup.GetCount();
+              while (uiLow < uiHigh)
+              {
+                const ezUInt32 uiMid = (uiLow + uiHigh) / 2;
+                if (m_ParentBlockLookup[uiMid].m_pData <= pParentData)
+                  uiLow = uiMid + 1;
+                else
+                  uiHigh = uiMid;
+              }
+
+              EZ_ASSERT_DEBUG(uiLow > 0, "Parent transformation data is not in the parent hierarchy level");
+              pParentBlock = &m_ParentBlockLookup[uiLow - 1];
+            }
+
+            if (stamps[pParentBlock->m_uiTaskIndex] != uiTaskIndex + 1)
+            {
+              stamps[pParentBlock->m_uiTaskIndex] = uiTaskIndex + 1;
+
+              auto& dependency = dependencies.ExpandAndGetRef();
+              dependency.m_TaskGroup = taskGroup;
+              dependency.m_DependsOn = taskGroups[pParentBlock->m_uiTaskIndex];
+            }
+          }
         }
       }
+
+      m_ChildBlockLookup.Sort();
+      m_ParentBlockLookup.Swap(m_ChildBlockLookup);
+    }
+
+    ezTaskSystem::AddTaskGroupDependencyBatch(dependencies);
+    ezTaskSystem::StartTaskGroupBatch(taskGroups);
+
+    for (const ezTaskGroupID& taskGroup : taskGroups)
+    {
+      ezTaskSystem::WaitForGroup(taskGroup);
+    }
+
+    for (ezUInt32 uiTaskIndex = 0; uiTaskIndex < taskGroups.GetCount(); ++uiTaskIndex)
+    {
+      m_uiVisitedTransformCount += m_UpdateTransformsTasks[uiTaskIndex]->m_uiVisitedCount;
+      m_uiUpdatedTransformCount += m_UpdateTransformsTasks[uiTaskIndex]->m_uiUpdatedCount;
+    }
+
+    if (m_pSpatialSystem != nullptr)
+    {
+      m_SpatialDataChangeLogs.Clear();
+
+      for (ezUInt32 uiTaskIndex = 0; uiTaskIndex < taskGroups.GetCount(); ++uiTaskIndex)
+      {
+        m_SpatialDataChangeLogs.PushBack(&m_UpdateTransformsTasks[uiTaskIndex]->m_SpatialDataChangeLog);
+      }
+
+      ApplySpatialDataChanges(m_SpatialDataChangeLogs);
     }
   }
 
@@ -122,8 +122,6 @@ namespace ezInternal
 
     template <typename VISITOR>
     static ezVisitorExecution::Enum TraverseHierarchyLevel(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
-    template <typename VISITOR>
-    ezVisitorExecution::Enum TraverseHierarchyLevelMultiThreaded(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
 
     typedef ezDelegate<ezVisitorExecution::Enum(ezGameObject*)> VisitorFunc;
     void TraverseBreadthFirst(VisitorFunc& func);
@@ -133,10 +131,82 @@ namespace ezInternal
     static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
     static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
+    /// Spatial data changes that are recorded during the transform update and applied afterwards by ApplySpatialDataChanges. That way the
+    /// transform update does not have to write to the spatial system and can run in parallel.
+    struct SpatialDataChangeLog
+    {
+      /// An object whose spatial data has to be created or deleted, which is rare and applied one by one.
+      struct StructuralChange
+      {
+        EZ_DECLARE_POD_TYPE();
+
+        ezGameObject::TransformationData* m_pData;
+        bool m_bWasAlwaysVisible;
+      };
+
+      void Clear();
+
+      ezDynamicArray<ezSpatialSystem::SpatialDataUpdate, ezAlignedAllocatorWrapper> m_Updates;
+      ezDynamicArray<StructuralChange> m_StructuralChanges;
+    };
+
+    static void UpdateGlobalBoundsAndRecordSpatialData(ezGameObject::TransformationData* pData, SpatialDataChangeLog& changeLog);
+
+    static void UpdateGlobalTransformAndRecordSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataChangeLog& changeLog);
+    static void UpdateGlobalTransformWithParentAndRecordSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataChangeLog& changeLog);
+
+    void ApplySpatialDataChanges(ezArrayPtr<SpatialDataChangeLog* const> changeLogs);
+
+    /// Calls func for all objects in the given blocks that are marked as dirty, see ezGameObject::TransformationData::MarkDirty, and marks
+    /// their children as dirty in turn. Objects in blocks without any dirty object are skipped entirely.
+    template <typename UPDATE_FUNC>
+    static void UpdateDirtyTransforms(Hierarchy::DataBlock* pBlocks, ezUInt32 uiBlockCount, UPDATE_FUNC func, ezUInt32& inout_uiVisitedCount, ezUInt32& inout_uiUpdatedCount);
 
     void UpdateGlobalTransforms(float fInvDeltaSeconds);
+    void UpdateGlobalTransformsMultiThreaded(Hierarchy& hierarchy, float fInvDeltaSeconds);
+
+    // used by the single-threaded transform update and to merge the change logs of all tasks
+    SpatialDataChangeLog m_SpatialDataChangeLog;
+    ezDynamicArray<SpatialDataChangeLog*, ezLocalAllocatorWrapper> m_SpatialDataChangeLogs;
+
+    // number of objects in dirty blocks and number of objects whose transform was actually recomputed during the last transform update
+    ezUInt32 m_uiVisitedTransformCount = 0;
+    ezUInt32 m_uiUpdatedTransformCount = 0;
+
+    /// Updates the global transforms of a range of data blocks within one hierarchy level.
+    struct UpdateTransformsTask final : public ezTask
+    {
+      virtual void Execute() override;
+
+      Hierarchy::DataBlock* m_pBlocks;
+      ezUInt32 m_uiBlockCount;
+      bool m_bRootLevel;
+      bool m_bRecordSpatialData;
+      float m_fInvDeltaSeconds;
+
+      SpatialDataChangeLog m_SpatialDataChangeLog;
+
+      ezUInt32 m_uiVisitedCount;
+      ezUInt32 m_uiUpdatedCount;
+    };
+
+    struct TransformBlockLookup
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      const ezGameObject::TransformationData* m_pData;
+      ezUInt32 m_uiTaskIndex;
+
+      EZ_ALWAYS_INLINE bool operator<(const TransformBlockLookup& other) const { return m_pData < other.m_pData; }
+    };
+
+    // all of these are only used inside UpdateGlobalTransformsMultiThreaded, they are kept around to not allocate every frame
+    ezDynamicArray<ezSharedPtr<UpdateTransformsTask>, ezLocalAllocatorWrapper> m_UpdateTransformsTasks;
+    ezDynamicArray<ezTaskGroupID, ezLocalAllocatorWrapper> m_UpdateTransformsTaskGroups;
+    ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_UpdateTransformsDependencyStamps;
+    ezDynamicArray<ezTaskGroupDependency, ezLocalAllocatorWrapper> m_UpdateTransformsDependencies;
+    ezDynamicArray<TransformBlockLookup, ezLocalAllocatorWrapper> m_ParentBlockLookup;
+    ezDynamicArray<TransformBlockLookup, ezLocalAllocatorWrapper> m_ChildBlockLookup;
 
     // game object lookups
     ezHashTable<ezUInt32, ezGameObjectId, ezHashHelper<ezUInt32>, ezLocalAllocatorWrapper> m_GlobalKeyToIdTable;
@@ -174,10 +244,21 @@ namespace ezInternal
       ezHashedString m_sFunctionName;
       float m_fPriority;
       ezUInt16 m_uiGranularity;
+      bool m_bAutoGranularity;
       bool m_bOnlyUpdateWhenSimulating;
+      ezTime m_ComponentUpdateCost; ///< Smoothed time one component took to update, only measured for functions with automatic granularity.
+      ezHybridArray<ezHashedString, 4> m_DependsOn;
+      ezHybridArray<const ezRTTI*, 4> m_ReadAccess;
+      ezHybridArray<const ezRTTI*, 4> m_WriteAccess;
 
       void FillFromDesc(const ezWorldModule::UpdateFunctionDesc& desc);
       bool operator<(const RegisteredUpdateFunction& other) const;
+
+      /// \brief Returns whether the function declared which types it accesses and thus may be called concurrently with other functions.
+      bool HasDeclaredAccess() const;
+
+      /// \brief Returns whether the declared access of both functions overlaps in a way that they must not be called concurrently.
+      bool ConflictsWith(const RegisteredUpdateFunction& other) const;
     };
 
     struct UpdateTask final : public ezTask
@@ -187,6 +268,7 @@ namespace ezInternal
       ezWorldModule::UpdateFunction m_Function;
       ezUInt32 m_uiStartIndex;
       ezUInt32 m_uiCount;
+      ezTime m_Duration;
     };
 
     ezDynamicArray<RegisteredUpdateFunction, ezLocalAllocatorWrapper> m_UpdateFunctions[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
@@ -194,6 +276,32 @@ namespace ezInternal
 
     ezDynamicArray<ezSharedPtr<UpdateTask>, ezLocalAllocatorWrapper> m_UpdateTasks;
 
+    /// \brief An update function as it is called in the current frame.
+    ///
+    /// Functions without declared access are exclusive and act as a barrier: they are called on the main thread while nothing else
+    /// is running. All other functions between two exclusive ones are called as a graph of task groups following the dependencies.
+    struct ScheduledUpdateFunction
+    {
+      RegisteredUpdateFunction* m_pFunction; ///< Only valid while the phase of this function is executed.
+      ezWorldModule::UpdateFunction m_Function;
+      ezHashedString m_sFunctionName;
+      ezTaskGroupID m_TaskGroup;
+      ezUInt32 m_uiFirstDependency;
+      ezUInt32 m_uiDependencyCount;
+      ezUInt32 m_uiFirstTask;
+      ezUInt32 m_uiTaskCount;
+      ezUInt16 m_uiGranularity;
+      ezEnum<ezWorldModule::UpdateFunctionDesc::Phase> m_Phase;
+      bool m_bExclusive;
+      bool m_bHasSuccessor;
+    };
+
+    /// \brief The schedule of the last update, kept around to not allocate every frame and for debug output.
+    ezDynamicArray<ScheduledUpdateFunction, ezLocalAllocatorWrapper> m_UpdateSchedule;
+    ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_UpdateScheduleDependencies; ///< Indices of the predecessors of each scheduled function.
+    ezDynamicArray<ezTaskGroupID, ezLocalAllocatorWrapper> m_UpdateScheduleTaskGroups;
+    ezDynamicArray<ezTaskGroupDependency, ezLocalAllocatorWrapper> m_UpdateScheduleTaskGroupDependencies;
+
     ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
     ezSharedPtr<ezCoordinateSystemProvider> m_pCoordinateSystemProvider;
     ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing;
@@ -228,6 +336,21 @@ namespace ezInternal
     mutable MessageQueue m_MessageQueues[ezObjectMsgQueueType::COUNT];
     mutable MessageQueue m_TimedMessageQueues[ezObjectMsgQueueType::COUNT];
 
+    struct SortedQueuedMsg
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezUInt64 m_uiTypeKey; ///< message sorting key and message id, see ezWorld::ProcessQueuedMessages
+      ezUInt64 m_uiReceiverData;
+      ezMessage* m_pMessage;
+      ezUInt32 m_uiMessageHash;
+    };
+
+    // scratch memory for sorting and dispatching queued messages, kept around to not allocate every frame
+    ezDynamicArray<SortedQueuedMsg, ezLocalAllocatorWrapper> m_SortedQueuedMessages;
+    ezDynamicArray<SortedQueuedMsg, ezLocalAllocatorWrapper> m_SortedQueuedMessagesTemp;
+    ezDynamicArray<ezComponentManagerBase::QueuedMessage, ezLocalAllocatorWrapper> m_QueuedComponentMessages;
+
     ezThreadID m_WriteThreadID;
     ezInt32 m_iWriteCounter;
     mutable ezAtomicInteger32 m_iReadCounter;
@@ -30,31 +30,47 @@ namespace ezInternal
   }
 
   // static
-  template <typename VISITOR>
-  EZ_FORCE_INLINE ezVisitorExecution::Enum WorldData::TraverseHierarchyLevelMultiThreaded(Hierarchy::DataBlockArray& blocks, void* pUserData /* = nullptr*/)
+  template <typename UPDATE_FUNC>
+  void WorldData::UpdateDirtyTransforms(Hierarchy::DataBlock* pBlocks, ezUInt32 uiBlockCount, UPDATE_FUNC func, ezUInt32& inout_uiVisitedCount, ezUInt32& inout_uiUpdatedCount)
   {
-    ezParallelForParams parallelForParams;
-    parallelForParams.uiBinSize = 100;
-    parallelForParams.uiMaxTasksPerThread = 2;
-    parallelForParams.pTaskAllocator = m_StackAllocator.GetCurrentAllocator();
-
-    ezTaskSystem::ParallelFor(blocks.GetArrayPtr(),
-      [pUserData](ezArrayPtr<WorldData::Hierarchy::DataBlock> blocksSlice) {
-        for (WorldData::Hierarchy::DataBlock& block : blocksSlice)
-        {
-          ezGameObject::TransformationData* pCurrentData = block.m_pData;
-          ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
+    for (ezUInt32 uiBlock = 0; uiBlock < uiBlockCount; ++uiBlock)
+    {
+      Hierarchy::DataBlock& block = pBlocks[uiBlock];
+
+      volatile ezInt32& iDirtyMask = ezGameObject::TransformationData::GetBlockDirtyMask(block.m_pData);
+      if (iDirtyMask == 0)
+        continue;
+
+      // bits of elements that have been removed from the block are ignored
+      ezUInt32 uiDirtyMask = static_cast<ezUInt32>(ezAtomicUtils::Set(iDirtyMask, 0)) & ((1u << block.m_uiCount) - 1);
+
+      inout_uiVisitedCount += block.m_uiCount;
+
+      while (uiDirtyMask != 0)
+      {
+        ezGameObject::TransformationData* pData = block.m_pData + ezMath::FirstBitLow(uiDirtyMask);
+        uiDirtyMask &= uiDirtyMask - 1;
 
-          while (pCurrentData < pEndData)
+        func(pData);
+        ++inout_uiUpdatedCount;
+
+        if (pData->m_pObject->m_ChildCount > 0)
+        {
+          for (auto it = pData->m_pObject->GetChildren(); it.IsValid(); ++it)
           {
-            VISITOR::Visit(pCurrentData, pUserData);
-            ++pCurrentData;
+            it->m_pTransformationData->MarkDirty();
           }
         }
-      },
-      "World DataBlock Traversal Task", parallelForParams);
 
-    return ezVisitorExecution::Continue;
+#if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
+        // the velocity is only reset to zero when the object is updated again, so keep it dirty until it has come to rest
+        if (!pData->m_velocity.IsZero<3>())
+        {
+          pData->MarkDirty();
+        }
+#endif
+      }
+    }
   }
 
   // static
@@ -74,20 +90,53 @@ namespace ezInternal
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
-    ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalBoundsAndRecordSpatialData(ezGameObject::TransformationData* pData, SpatialDataChangeLog& changeLog)
+  {
+    ezSimdBBoxSphere oldGlobalBounds = pData->m_globalBounds;
+
+    pData->UpdateGlobalBounds();
+
+    // same check as in ezGameObject::TransformationData::UpdateGlobalBoundsAndSpatialData
+    if ((pData->m_globalBounds.m_CenterAndRadius != oldGlobalBounds.m_CenterAndRadius ||
+          pData->m_globalBounds.m_BoxHalfExtents != oldGlobalBounds.m_BoxHalfExtents)
+          .AnySet<4>())
+    {
+      bool bWasAlwaysVisible = oldGlobalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+      bool bIsAlwaysVisible = pData->m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+
+      if (!bWasAlwaysVisible && !bIsAlwaysVisible && pData->m_globalBounds.IsValid() && !pData->m_hSpatialData.IsInvalidated())
+      {
+        auto& update = changeLog.m_Updates.ExpandAndGetRef();
+        update.m_Bounds = pData->m_globalBounds;
+        update.m_hData = pData->m_hSpatialData;
+        update.m_pObject = pData->m_pObject;
+        update.m_uiCategoryBitmask = pData->m_uiSpatialDataCategoryBitmask;
+      }
+      else
+      {
+        auto& change = changeLog.m_StructuralChanges.ExpandAndGetRef();
+        change.m_pData = pData;
+        change.m_bWasAlwaysVisible = bWasAlwaysVisible;
+      }
+    }
+  }
+
+  // static
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndRecordSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
+    SpatialDataChangeLog& changeLog)
   {
     pData->UpdateGlobalTransform();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+    UpdateGlobalBoundsAndRecordSpatialData(pData, changeLog);
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndRecordSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
+    SpatialDataChangeLog& changeLog)
   {
     pData->UpdateGlobalTransformWithParent();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+    UpdateGlobalBoundsAndRecordSpatialData(pData, changeLog);
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -200,7 +249,12 @@ namespace ezInternal
     m_sFunctionName = desc.m_sFunctionName;
     m_fPriority = desc.m_fPriority;
     m_uiGranularity = desc.m_uiGranularity;
+    m_bAutoGranularity = desc.m_bAutoGranularity;
+    m_ComponentUpdateCost.SetZero();
     m_bOnlyUpdateWhenSimulating = desc.m_bOnlyUpdateWhenSimulating;
+    m_DependsOn = desc.m_DependsOn;
+    m_ReadAccess = desc.m_ReadAccess;
+    m_WriteAccess = desc.m_WriteAccess;
   }
 
   EZ_FORCE_INLINE bool WorldData::RegisteredUpdateFunction::operator<(const RegisteredUpdateFunction& other) const
@@ -216,6 +270,11 @@ namespace ezInternal
     return iNameComp < 0;
   }
 
+  EZ_ALWAYS_INLINE bool WorldData::RegisteredUpdateFunction::HasDeclaredAccess() const
+  {
+    return !m_ReadAccess.IsEmpty() || !m_WriteAccess.IsEmpty();
+  }
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
 
   EZ_ALWAYS_INLINE WorldData::ReadMarker::ReadMarker(const WorldData& data)
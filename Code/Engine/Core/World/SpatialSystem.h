@@ -25,6 +25,23 @@ public:
 
   void UpdateSpatialData(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask);
 
+  /// \brief The arguments of one UpdateSpatialData call, recorded to be applied later with UpdateSpatialDataBatch.
+  struct SpatialDataUpdate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezSimdBBoxSphere m_Bounds;
+    ezSpatialDataHandle m_hData;
+    ezGameObject* m_pObject;
+    ezUInt32 m_uiCategoryBitmask;
+  };
+
+  /// \brief Has the same effect as calling UpdateSpatialData for every element of the given array.
+  ///
+  /// Every spatial data must be contained at most once. Since all changes are known up front, implementations are free to reorder them,
+  /// e.g. to touch every cell of the acceleration structure only once, and to apply parts of them in parallel.
+  void UpdateSpatialDataBatch(ezArrayPtr<const SpatialDataUpdate> updates);
+
   ///@}
   /// \name Simple Queries
   ///@{
@@ -70,6 +87,19 @@ protected:
   virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) = 0;
   virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) = 0;
 
+  struct SpatialDataChange
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezSimdBBoxSphere m_OldBounds;
+    ezSpatialData* m_pData;
+    ezUInt32 m_uiOldCategoryBitmask;
+  };
+
+  /// \brief Called by UpdateSpatialDataBatch with all spatial data that has actually changed. The spatial data already contains the new
+  /// bounds and category bitmask. The default implementation calls SpatialDataChanged for every element.
+  virtual void SpatialDataChangedBatch(ezArrayPtr<const SpatialDataChange> changes);
+
   ezProxyAllocator m_Allocator;
   ezLocalAllocatorWrapper m_AllocatorWrapper;
   ezInternal::WorldLargeBlockAllocator m_BlockAllocator;
@@ -79,4 +109,7 @@ protected:
   DataStorage m_DataStorage;
 
   ezDynamicArray<ezSpatialData*> m_DataAlwaysVisible;
+
+  // only used inside UpdateSpatialDataBatch, kept around to not allocate every frame
+  ezDynamicArray<SpatialDataChange, ezAlignedAllocatorWrapper> m_PendingChanges;
 };
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Types/UniquePtr.h>
+
+/// \brief A spatial system that sorts objects into a loose octree.
+///
+/// In contrast to ezSpatialSystem_RegularGrid, objects are stored at the tree level that matches their size, so huge objects and small dense
+/// clutter are both handled well. Every node has loose bounds of twice its size, so an object always goes into exactly one node, selected by
+/// its center and its size. Objects that are larger than the root or lie outside of it are stored in the root node.
+///
+/// To use it instead of the default spatial system, pass it to the world through ezWorldDesc::m_pSpatialSystem.
+class EZ_CORE_DLL ezSpatialSystem_LooseOctree : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_LooseOctree, ezSpatialSystem);
+
+public:
+  /// \brief The octree covers a cube around the origin with the given half extent. Nodes are not subdivided below the given min half extent.
+  ezSpatialSystem_LooseOctree(float fWorldHalfExtent = 16384.0f, float fMinNodeHalfExtent = 64.0f);
+  ~ezSpatialSystem_LooseOctree();
+
+  /// \brief Returns the loose bounding box of the node associated with the given spatial data. Useful for debug visualizations.
+  ezResult GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const;
+
+  /// \brief Returns the loose bounding boxes of all nodes that contain objects.
+  void GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory) const;
+
+private:
+  // ezSpatialSystem implementation
+  virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+    QueryStats* pStats = nullptr) const override;
+  virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats = nullptr) const override;
+
+  virtual void SpatialDataAdded(ezSpatialData* pData) override;
+  virtual void SpatialDataRemoved(ezSpatialData* pData) override;
+  virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
+
+  struct SpatialUserData;
+  struct Node;
+
+  ezUInt32 ComputeDepth(const ezSimdBBoxSphere& bounds) const;
+  Node* GetOrCreateNode(const ezSimdBBoxSphere& bounds);
+  void DeleteNode(Node* pNode);
+
+  template <typename Functor>
+  void ForEachNode(ezUInt32 uiCategoryBitmask, Functor func) const;
+
+  ezProxyAllocator m_AlignedAllocator;
+  float m_fWorldHalfExtent;
+  ezUInt32 m_uiMaxDepth;
+
+  ezUniquePtr<Node> m_pRoot;
+};
@@ -31,6 +31,7 @@ private:
   virtual void SpatialDataRemoved(ezSpatialData* pData) override;
   virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
   virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
+  virtual void SpatialDataChangedBatch(ezArrayPtr<const SpatialDataChange> changes) override;
 
   ezProxyAllocator m_AlignedAllocator;
   ezSimdVec4i m_iCellSize;
@@ -44,8 +45,35 @@ private:
   ezHashTable<ezUInt64, ezUniquePtr<Cell>, CellKeyHashHelper, ezLocalAllocatorWrapper> m_Cells;
   ezUniquePtr<Cell> m_pOverflowCell;
 
+  ezUInt32 GetNumCellsInBox(const ezSimdBBox& box) const;
+
   template <typename Functor>
   void ForEachCellInBox(const ezSimdBBox& box, ezUInt32 uiCategoryBitmask, Functor func) const;
 
+  /// \brief Only iterates the given range of cells inside the box, so the work can be split up. Does not include the overflow cell.
+  template <typename Functor>
+  void ForEachCellInBoxRange(const ezSimdBBox& box, ezUInt32 uiFirstCell, ezUInt32 uiEndCell, ezUInt32 uiCategoryBitmask, Functor func) const;
+
+  /// \brief Returns the key of the cell that fully contains the given bounds or a special key for the overflow cell.
+  ezUInt64 GetCellKeyForBounds(const ezSimdBBoxSphere& bounds) const;
+
   Cell* GetOrCreateCell(const ezSimdBBoxSphere& bounds);
+  Cell* GetOrCreateCell(ezUInt64 cellKey);
+
+  struct CellMove
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiNewCellKey;
+    ezUInt32 m_uiChangeIndex;
+
+    EZ_ALWAYS_INLINE bool operator<(const CellMove& other) const
+    {
+      return m_uiNewCellKey < other.m_uiNewCellKey || (m_uiNewCellKey == other.m_uiNewCellKey && m_uiChangeIndex < other.m_uiChangeIndex);
+    }
+  };
+
+  // only used inside SpatialDataChangedBatch, kept around to not allocate every frame
+  ezDynamicArray<ezUInt8> m_ChangeRequiresMove;
+  ezDynamicArray<CellMove> m_CellMoves;
 };
@@ -4,6 +4,7 @@
 
 struct ezEventMessage;
 class ezEventMessageHandlerComponent;
+class ezDGMLGraph;
 
 /// \brief A world encapsulates a scene graph of game objects and various component managers and their components.
 ///
@@ -11,9 +12,12 @@ class ezEventMessageHandlerComponent;
 /// in memory. Thus it is not allowed to store pointers to objects. They should be referenced by handles.\n The world has a multi-phase
 /// update mechanism which is divided in the following phases:\n
 /// * Pre-async phase: The corresponding component manager update functions are called synchronously in the order of their dependencies.
+///   Functions that declare their read and write access (see ezWorldModule::UpdateFunctionDesc::m_ReadAccess) are called concurrently on
+///   multiple threads as long as their access does not conflict.
 /// * Async phase: The update functions are called in batches asynchronously on multiple threads. There is absolutely no guarantee in which
 /// order the functions are called.
-///   Thus it is not allowed to access any data other than the components own data during that phase.
+///   Thus it is not allowed to access any data other than the components own data during that phase. Functions with declared access
+///   may already start while non-conflicting pre-async functions are still running.
 /// * Post-async phase: Another synchronous phase like the pre-async phase.
 /// * Actual deletion of dead objects and components are done now.
 /// * Transform update: The global transformation of dynamic objects is updated.
@@ -239,6 +243,11 @@ public:
   /// \brief Returns a task implementation that calls Update on this world.
   const ezSharedPtr<ezTask>& GetUpdateTask();
 
+  /// \brief Writes the update functions that were called during the last Update() and the dependencies between them to the given graph.
+  ///
+  /// Useful to inspect which update functions were able to run concurrently and which ones acted as a barrier.
+  void WriteUpdateScheduleToDGML(ezDGMLGraph& graph) const;
+
 
   /// \brief Returns the spatial system that is associated with this world.
   ezSpatialSystem* GetSpatialSystem();
@@ -349,6 +358,8 @@ private:
 
   void PostMessage(const ezGameObjectHandle& receiverObject, const ezMessage& msg, ezObjectMsgQueueType::Enum queueType, ezTime delay, bool bRecursive) const;
   void ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::Entry& entry);
+  void ProcessQueuedObjectMessage(const ezInternal::WorldData::QueuedMsgMetaData& metaData, ezMessage& msg);
+  void ProcessQueuedMessageBatch(ezArrayPtr<const ezInternal::WorldData::SortedQueuedMsg> messages);
   void ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType);
 
   void RegisterUpdateFunction(const ezWorldModule::UpdateFunctionDesc& desc);
@@ -359,8 +370,10 @@ private:
   void AddComponentToInitialize(ezComponentHandle hComponent);
 
   void UpdateFromThread();
-  void UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions);
-  void UpdateAsynchronous();
+  void UpdatePhase(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase);
+  void ScheduleUpdateFunctions(ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction> updateFunctions,
+    ezWorldModule::UpdateFunctionDesc::Phase::Enum phase, ezUInt32 uiFirstScheduledFunction);
+  void UpdateConcurrently(ezUInt32 uiFirstScheduledFunction, ezUInt32 uiEndScheduledFunction);
 
   // returns if the batch was completely initialized
   bool ProcessInitializationBatch(ezInternal::WorldData::InitBatch& batch, ezTime endTime);
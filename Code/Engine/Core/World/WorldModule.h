@@ -73,7 +73,23 @@ protected:
     bool m_bOnlyUpdateWhenSimulating = false;     ///< The update function is only called when the world simulation is enabled.
     ezUInt16 m_uiGranularity = 0;                 ///< The granularity in which batch updates should happen during the asynchronous phase. Has to be 0 for
                                                   ///< synchronous functions.
+    bool m_bAutoGranularity = false;              ///< Lets the world choose the granularity of an asynchronous function from the time its components took to
+                                                  ///< update in the previous frames. Batches then start at storage block boundaries and m_uiGranularity is ignored.
+                                                  ///< The function has to respect the component range passed in the update context.
     float m_fPriority = 0.0f;                     ///< Higher priority (higher number) means that this function is called earlier than a function with lower priority.
+
+    /// \brief Component, world module or game object types that this function reads from.
+    ///
+    /// If neither m_ReadAccess nor m_WriteAccess are set, the function is assumed to access the entire world. Synchronous functions of that
+    /// kind are called on the main thread and nothing else is updated at the same time. If at least one access type is declared, the world
+    /// is free to call the function on a worker thread concurrently with other functions of the same phase that don't conflict with it.
+    /// Such a function must follow the same rules as an asynchronous update function, i.e. the world must not be modified structurally
+    /// (no objects or components created or deleted, use messages instead), only the declared types may be written to and the write
+    /// marker of the world is not set while it is running. The module that owns the function is implicitly part of m_WriteAccess, for
+    /// component managers their component type.
+    /// Asynchronous functions with declared access types may additionally start while non-conflicting pre-async functions are still running.
+    ezHybridArray<const ezRTTI*, 4> m_ReadAccess;
+    ezHybridArray<const ezRTTI*, 4> m_WriteAccess; ///< Component, world module or game object types that this function writes to. See m_ReadAccess.
   };
 
   /// \brief Registers the given update function at the world.
@@ -25,6 +25,9 @@ bool ezDefaultAssertHandler(
     szExpression, szFunction, szSourceFile, uiLine, szAssertMsg);
   szTemp[1024 * 4 - 1] = '\0';
 
+  // make sure all messages that led up to the assert have been written before the application may stop
+  ezGlobalLog::FlushAsyncLogging();
+
   ezLog::Print(szTemp);
   
   if (ezSystemInformation::IsDebuggerAttached())
@@ -31,19 +31,25 @@ void ezProcessingStream::SetSize(ezUInt64 uiNumElements)
     return;
   }
 
+  // SIMD kernels process full blocks of elements, the padding is zeroed so that they don't operate on garbage
+  const ezUInt64 uiPaddedNumElements = (uiNumElements + ElementPadding - 1) / ElementPadding * ElementPadding;
+  const size_t uiDataSize = static_cast<size_t>(uiPaddedNumElements * GetDataTypeSize(m_Type));
+
   /// \todo Allow to reuse memory from a pool ?
   if (m_uiAlignment > 0)
   {
-    m_pData = ezFoundation::GetAlignedAllocator()->Allocate(static_cast<size_t>(uiNumElements * GetDataTypeSize(m_Type)),
-                                                            static_cast<size_t>(m_uiAlignment));
+    m_pData = ezFoundation::GetAlignedAllocator()->Allocate(uiDataSize, static_cast<size_t>(m_uiAlignment));
   }
   else
   {
-    m_pData = ezFoundation::GetDefaultAllocator()->Allocate(static_cast<size_t>(uiNumElements * GetDataTypeSize(m_Type)), 0);
+    m_pData = ezFoundation::GetDefaultAllocator()->Allocate(uiDataSize, 0);
   }
 
   EZ_ASSERT_DEV(m_pData != nullptr, "Allocating {0} elements of {1} bytes each, with {2} bytes alignment, failed", uiNumElements,
                 ((ezUInt32)GetDataTypeSize(m_Type)), m_uiAlignment);
+  const size_t uiElementsSize = static_cast<size_t>(uiNumElements * GetDataTypeSize(m_Type));
+  ezMemoryUtils::ZeroFill(static_cast<ezUInt8*>(m_pData) + uiElementsSize, uiDataSize - uiElementsSize);
+
   m_uiNumElements = uiNumElements;
 }
 
@@ -6,6 +6,15 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/MemoryUtils.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+namespace
+{
+  // both are multiples of ezProcessingStream::ElementPadding, so SIMD kernels never touch the elements of another range
+  constexpr ezUInt64 s_uiElementsPerRange = 1024;
+  constexpr ezUInt64 s_uiMinElementsForParallelProcessing = 4096;
+} // namespace
 
 ezProcessingStreamGroup::ezProcessingStreamGroup()
 {
@@ -158,9 +167,24 @@ void ezProcessingStreamGroup::Process()
   EnsureStreamAssignmentValid();
 
   // TODO: Identify which processors work on which streams and find independent groups and use separate tasks for them?
-  for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
+  for (ezUInt32 uiProcessor = 0; uiProcessor < m_Processors.GetCount();)
   {
-    pStreamProcessor->Process(m_uiNumActiveElements);
+    ezUInt32 uiEndProcessor = uiProcessor;
+    while (uiEndProcessor < m_Processors.GetCount() && m_Processors[uiEndProcessor]->m_bSupportsParallelProcessing)
+    {
+      ++uiEndProcessor;
+    }
+
+    if (uiEndProcessor > uiProcessor && m_uiNumActiveElements >= s_uiMinElementsForParallelProcessing)
+    {
+      ProcessInParallel(uiProcessor, uiEndProcessor);
+      uiProcessor = uiEndProcessor;
+    }
+    else
+    {
+      m_Processors[uiProcessor]->Process(m_uiNumActiveElements);
+      ++uiProcessor;
+    }
   }
 
   // Run any pending deletions which happened due to stream processor execution
@@ -172,6 +196,31 @@ void ezProcessingStreamGroup::Process()
 }
 
 
+void ezProcessingStreamGroup::ProcessInParallel(ezUInt32 uiFirstProcessor, ezUInt32 uiEndProcessor)
+{
+  EZ_PROFILE_SCOPE("ProcessingStreamGroup: Parallel");
+
+  const ezUInt64 uiNumElements = m_uiNumActiveElements;
+  const ezUInt32 uiNumRanges = static_cast<ezUInt32>((uiNumElements + s_uiElementsPerRange - 1) / s_uiElementsPerRange);
+
+  // all processors run on one range before moving on to the next, so the data of the range is still in the cache for the next processor
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumRanges,
+    [&](ezUInt32 uiStartRange, ezUInt32 uiEndRange) {
+      for (ezUInt32 uiRange = uiStartRange; uiRange < uiEndRange; ++uiRange)
+      {
+        const ezUInt64 uiStartIndex = static_cast<ezUInt64>(uiRange) * s_uiElementsPerRange;
+        const ezUInt64 uiCount = ezMath::Min<ezUInt64>(s_uiElementsPerRange, uiNumElements - uiStartIndex);
+
+        for (ezUInt32 uiProcessor = uiFirstProcessor; uiProcessor < uiEndProcessor; ++uiProcessor)
+        {
+          m_Processors[uiProcessor]->ProcessRange(uiStartIndex, uiCount);
+        }
+      }
+    },
+    "ProcessingStreamGroup");
+}
+
 void ezProcessingStreamGroup::RunPendingDeletions()
 {
   ezStreamGroupElementRemovedEvent e;
@@ -42,6 +42,14 @@ public:
     Int4
   };
 
+  enum
+  {
+    /// \brief The storage of every stream is padded to a multiple of this number of elements.
+    /// Together with the 64 byte alignment of the streams in a stream group, this allows SIMD kernels to always load and store full blocks of
+    /// four elements. Elements behind the number of active elements are unused and may be overwritten by such kernels.
+    ElementPadding = 4
+  };
+
   /// \brief Returns a const pointer to the data casted to the type T, note that no type check is done!
   template <typename T>
   const T* GetData() const
@@ -62,6 +62,9 @@ public:
   void InitializeElements(ezUInt64 uiNumElements);
 
   /// \brief Runs the stream processors which have been added to the stream group.
+  ///
+  /// Consecutive processors that support parallel processing are run together on ranges of elements, which are distributed across the task
+  /// system when there are enough active elements.
   void Process();
 
   /// \brief Returns the number of elements the streams store.
@@ -93,6 +96,8 @@ private:
 
   void RunPendingSpawns();
 
+  void ProcessInParallel(ezUInt32 uiFirstProcessor, ezUInt32 uiEndProcessor);
+
   void SortProcessorsByPriority();
 
   ezHybridArray<ezProcessingStreamProcessor*, 8> m_Processors;
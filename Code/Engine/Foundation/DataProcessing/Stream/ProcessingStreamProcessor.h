@@ -34,6 +34,16 @@ protected:
   /// \brief The actual method which processes the data, will be called with the number of elements to process.
   virtual void Process(ezUInt64 uiNumElements) = 0;
 
+  /// \brief Processes the elements in the range [uiStartIndex; uiStartIndex + uiNumElements), only called when m_bSupportsParallelProcessing is set.
+  ///
+  /// The stream group splits large numbers of elements into ranges that are processed on multiple threads at the same time, instead of calling Process().
+  /// Implementations may therefore only access the elements of the given range and must neither remove nor spawn elements.
+  /// Ranges always start at a multiple of ezProcessingStream::ElementPadding.
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) { EZ_ASSERT_NOT_IMPLEMENTED; }
+
+  /// \brief Set this to true in processors that implement ProcessRange().
+  bool m_bSupportsParallelProcessing = false;
+
   /// \brief Back pointer to the stream group - will be set to the owner stream group when adding the stream processor to the group.
   /// Can be used to get stream pointers in UpdateStreamBindings();
   ezProcessingStreamGroup* m_pStreamGroup;
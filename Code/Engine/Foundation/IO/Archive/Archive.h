@@ -12,6 +12,7 @@ enum class ezArchiveCompressionMode : ezUInt8
   Uncompressed,
   Compressed_zstd,
   Compressed_zip,
+  Compressed_zstd_framed, ///< Split into independently compressed zstd frames with a seek table, see ezArchiveFramedReaderZstd
 };
 
 /// \brief Data for a single file entry in an ezArchive file
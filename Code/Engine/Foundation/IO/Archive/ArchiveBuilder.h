@@ -8,6 +8,11 @@
 /// \brief Utility class to build an ezArchive file from files/folders on disk
 ///
 /// All functionality for writing an ezArchive file is available through ezArchiveUtils.
+///
+/// The files are read and compressed in frames of m_uiCompressionFrameSize bytes, which are processed in parallel on the ezTaskSystem.
+/// Compressed files that span multiple frames are stored with ezArchiveCompressionMode::Compressed_zstd_framed, which allows readers
+/// to seek within the file without decompressing everything before the target position.
+/// Whether such a file is compressed at all is decided from its first 64 KB, files that don't compress well are stored uncompressed.
 class EZ_FOUNDATION_DLL ezArchiveBuilder
 {
 public:
@@ -21,6 +26,11 @@ public:
   // all the source files from disk that should be put into the ezArchive
   ezDeque<SourceEntry> m_Entries;
 
+  /// \brief The uncompressed size of the frames that files are split into for compression.
+  ///
+  /// Smaller frames allow finer grained seeking, larger frames compress slightly better.
+  ezUInt32 m_uiCompressionFrameSize = 1024 * 1024;
+
   enum class InclusionMode
   {
     Exclude,       ///< Do not add this file to the archive
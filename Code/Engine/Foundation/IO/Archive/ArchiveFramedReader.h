@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/MemoryStream.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+/// \brief A stream reader for ezArchive entries that were stored with ezArchiveCompressionMode::Compressed_zstd_framed.
+///
+/// Such entries are split into frames of a fixed uncompressed size, which are compressed independently of each other.
+/// Frames that did not compress well are stored uncompressed. A seek table at the end of the entry stores the size of every frame,
+/// which allows SkipBytes() to jump directly to the frame that contains the target position, instead of decompressing everything before it.
+///
+/// The stored data of an entry looks like this:
+///   frame data 0 ... frame data N-1
+///   ezUInt32 stored size of each frame (the highest bit is set, if the frame is stored uncompressed)
+///   ezUInt32 uncompressed frame size
+///   ezUInt32 number of frames
+class EZ_FOUNDATION_DLL ezArchiveFramedReaderZstd : public ezStreamReader
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezArchiveFramedReaderZstd);
+
+public:
+  ezArchiveFramedReaderZstd();
+  ~ezArchiveFramedReaderZstd();
+
+  /// \brief Sets up the reader to decode the stored entry data. Fails, if the seek table is corrupted.
+  ///
+  /// Calling this a second time on the same instance is valid and allows to reuse the decoder.
+  ezResult Configure(const void* pStoredData, ezUInt64 uiStoredSize, ezUInt64 uiUncompressedSize);
+
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override;
+
+  /// \brief Skips to the frame that contains the target position and only decompresses the remainder within that frame.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override;
+
+  /// \brief Returns the current (uncompressed) read position.
+  ezUInt64 GetReadPosition() const { return m_uiReadPosition; }
+
+private:
+  void OpenFrame(ezUInt32 uiFrame);
+  ezUInt32 GetStoredFrameInfo(ezUInt32 uiFrame) const;
+
+  const ezUInt8* m_pStoredData = nullptr;
+  const ezUInt8* m_pSeekTable = nullptr;
+  ezUInt64 m_uiUncompressedSize = 0;
+  ezUInt64 m_uiReadPosition = 0;
+  ezUInt32 m_uiFrameSize = 0;
+  ezUInt32 m_uiCurFrame = 0;
+  bool m_bFrameOpen = false;
+  bool m_bFrameIsRaw = false;
+
+  /// byte offset of each frame into the stored data, plus one entry for the end of the last frame
+  ezDynamicArray<ezUInt64> m_FrameOffsets;
+  ezRawMemoryStreamReader m_FrameData;
+  ezCompressedStreamReaderZstd m_FrameDecoder;
+};
+
+#endif
@@ -30,7 +30,10 @@ public:
   /// \brief Sets up \a memReader for reading the raw (potentially compressed) data that is stored for the given entry in the archive.
   void ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawMemoryStreamReader& memReader) const;
 
-  /// \brief Creates a reader that will decompress the given file entry.
+  /// \brief Returns a pointer to the raw (potentially compressed) data that is stored for the given entry in the archive.
+  const void* GetEntryData(ezUInt32 uiEntryIdx) const;
+
+  /// \brief Creates a reader that will decompress the given file entry. Returns nullptr, if the entry data is corrupted.
   ezUniquePtr<ezStreamReader> CreateEntryReader(ezUInt32 uiEntryIdx) const;
 
 protected:
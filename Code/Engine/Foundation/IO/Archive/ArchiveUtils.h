@@ -26,7 +26,9 @@ namespace ezArchiveUtils
   EZ_FOUNDATION_DLL bool IsAcceptedArchiveFileExtensions(ezStringView extension);
 
   /// \brief Writes the header that identifies the ezArchive file and version to the stream
-  EZ_FOUNDATION_DLL ezResult WriteHeader(ezStreamWriter& stream);
+  ///
+  /// Archives that contain ezArchiveCompressionMode::Compressed_zstd_framed entries need version 3, all others are written as version 2.
+  EZ_FOUNDATION_DLL ezResult WriteHeader(ezStreamWriter& stream, bool bHasFramedEntries = false);
 
   /// \brief Reads the ezArchive header. Returns success and the version, if the stream is a valid ezArchive file.
   EZ_FOUNDATION_DLL ezResult ReadHeader(ezStreamReader& stream, ezUInt8& out_uiVersion);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/IO/Archive/ArchiveFramedReader.h>
 #include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/CompressedStreamZlib.h>
@@ -15,6 +16,7 @@ namespace ezDataDirectory
 {
   class ArchiveReaderUncompressed;
   class ArchiveReaderZstd;
+  class ArchiveReaderZstdFramed;
   class ArchiveReaderZip;
 
   class EZ_FOUNDATION_DLL ArchiveType : public ezDataDirectoryType
@@ -29,11 +31,11 @@ namespace ezDataDirectory
     virtual const ezString128& GetRedirectedDataDirectoryPath() const override { return m_sRedirectedDataDirPath; }
 
   protected:
-    virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir) override;
+    virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir, ezUInt64 uiFileKey) override;
 
     virtual void RemoveDataDirectory() override;
 
-    virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir) override;
+    virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey) override;
 
     virtual ezResult GetFileStats(const char* szFileOrFolder, bool bOneSpecificDataDir, ezFileStats& out_Stats) override;
 
@@ -53,6 +55,8 @@ namespace ezDataDirectory
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZstd>, 4> m_ReadersZstd;
     ezHybridArray<ArchiveReaderZstd*, 4> m_FreeReadersZstd;
+    ezHybridArray<ezUniquePtr<ArchiveReaderZstdFramed>, 4> m_ReadersZstdFramed;
+    ezHybridArray<ArchiveReaderZstdFramed*, 4> m_FreeReadersZstdFramed;
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZip>, 4> m_ReadersZip;
@@ -69,7 +73,9 @@ namespace ezDataDirectory
     ~ArchiveReaderUncompressed();
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
     virtual ezUInt64 GetFileSize() const override;
+    virtual ezArrayPtr<const ezUInt8> GetMappedData() const override;
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
@@ -80,6 +86,7 @@ namespace ezDataDirectory
     ezUInt64 m_uiUncompressedSize = 0;
     ezUInt64 m_uiCompressedSize = 0;
     ezRawMemoryStreamReader m_MemStreamReader;
+    ezArrayPtr<const ezUInt8> m_MappedData; ///< Only set for uncompressed entries, readers for compressed entries never expose their data.
   };
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -92,6 +99,7 @@ namespace ezDataDirectory
     ~ArchiveReaderZstd();
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
@@ -100,6 +108,27 @@ namespace ezDataDirectory
 
     ezCompressedStreamReaderZstd m_CompressedStreamReader;
   };
+
+  /// \brief Reads entries that are stored as independently compressed zstd frames. Skipping jumps directly to the target frame.
+  class EZ_FOUNDATION_DLL ArchiveReaderZstdFramed : public ArchiveReaderUncompressed
+  {
+    EZ_DISALLOW_COPY_AND_ASSIGN(ArchiveReaderZstdFramed);
+
+  public:
+    ArchiveReaderZstdFramed(ezInt32 iDataDirUserData);
+    ~ArchiveReaderZstdFramed();
+
+    virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
+
+  protected:
+    virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
+
+    friend class ArchiveType;
+
+    const void* m_pEntryData = nullptr;
+    ezArchiveFramedReaderZstd m_FramedReader;
+  };
 #endif
 
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
@@ -112,6 +141,7 @@ namespace ezDataDirectory
     ~ArchiveReaderZip();
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
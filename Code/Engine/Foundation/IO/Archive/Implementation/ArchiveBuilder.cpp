@@ -2,9 +2,13 @@
 
 #include <Foundation/IO/Archive/ArchiveBuilder.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 void ezArchiveBuilder::AddFolder(const char* szAbsFolderPath,
   ezArchiveCompressionMode defaultMode /*= ezArchiveCompressionMode::Uncompressed*/, InclusionCallback callback /*= InclusionCallback()*/)
@@ -75,16 +79,85 @@ ezResult ezArchiveBuilder::WriteArchive(const char* szFile) const
   return WriteArchive(file);
 }
 
-ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
+namespace
 {
-  EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteHeader(stream));
+  struct ArchiveFrame
+  {
+    ezUInt32 m_uiEntry = 0;
+    ezUInt32 m_uiFrame = 0;
+    bool m_bCompress = false;
+    bool m_bFailed = false;
+    ezDynamicArray<ezUInt8> m_RawData;
+    ezMemoryStreamStorage m_CompressedData;
+  };
+
+  // only zstd supports frames, without it everything is stored uncompressed
+  bool IsCompressionRequested(ezArchiveCompressionMode mode)
+  {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    return mode == ezArchiveCompressionMode::Compressed_zstd || mode == ezArchiveCompressionMode::Compressed_zstd_framed;
+#else
+    return false;
+#endif
+  }
+
+  // less than 20% size saving is not worth the decompression cost
+  bool IsCompressionWorthIt(ezUInt64 uiCompressedSize, ezUInt64 uiRawSize)
+  {
+    return uiCompressedSize * 12 < uiRawSize * 10;
+  }
+
+  ezResult CompressData(const void* pData, ezUInt64 uiSize, ezMemoryStreamStorage& out_Compressed)
+  {
+    out_Compressed.Clear();
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    ezMemoryStreamWriter writer(&out_Compressed);
+    ezCompressedStreamWriterZstd zstdWriter(&writer);
 
+    EZ_SUCCEED_OR_RETURN(zstdWriter.WriteBytes(pData, uiSize));
+    EZ_SUCCEED_OR_RETURN(zstdWriter.FinishCompressedStream());
+    return EZ_SUCCESS;
+#else
+    return EZ_FAILURE;
+#endif
+  }
+
+  // compresses the start of the file to decide whether a file that spans several frames is stored framed or uncompressed
+  bool IsFileCompressible(const char* szAbsSourcePath, ezUInt64 uiProbeSize)
+  {
+    ezFileReader file;
+    if (file.Open(szAbsSourcePath).Failed())
+      return false;
+
+    ezDynamicArray<ezUInt8> rawData;
+    rawData.SetCountUninitialized(static_cast<ezUInt32>(uiProbeSize));
+    if (file.ReadBytes(rawData.GetData(), uiProbeSize) != uiProbeSize)
+      return false;
+
+    ezMemoryStreamStorage compressedData;
+    if (CompressData(rawData.GetData(), uiProbeSize, compressedData).Failed())
+      return false;
+
+    return IsCompressionWorthIt(compressedData.GetStorageSize(), uiProbeSize);
+  }
+} // namespace
+
+ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
+{
   ezArchiveTOC toc;
 
   ezStringBuilder sHashablePath;
 
-  ezUInt64 uiStreamSize = 0;
   const ezUInt32 uiNumEntries = m_Entries.GetCount();
+  const ezUInt64 uiFrameSize = ezMath::Clamp<ezUInt32>(m_uiCompressionFrameSize, 1024 * 4, 1024 * 1024 * 256);
+
+  ezDynamicArray<ezUInt64> fileSizes;
+  fileSizes.SetCountUninitialized(uiNumEntries);
+  ezDynamicArray<bool> compressEntry;
+  compressEntry.SetCount(uiNumEntries);
+  ezDynamicArray<ezUInt32> multiFrameEntries;
+  ezUInt64 uiTotalFrames = 0;
 
   for (ezUInt32 i = 0; i < uiNumEntries; ++i)
   {
@@ -99,11 +172,194 @@ ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
 
     toc.m_PathToEntryIndex[ezArchiveStoredString(ezTempHashedString::ComputeHash(sHashablePath.GetData()), uiPathStringOffset)] = toc.m_Entries.GetCount();
 
-    if (!WriteNextFileCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath))
+    ezArchiveEntry& tocEntry = toc.m_Entries.ExpandAndGetRef();
+    tocEntry.m_uiPathStringOffset = uiPathStringOffset;
+    tocEntry.m_CompressionMode = ezArchiveCompressionMode::Uncompressed;
+
+    ezFileStats stats;
+    if (ezFileSystem::GetFileStats(e.m_sAbsSourcePath, stats).Failed())
+    {
+      ezLog::Error("Could not read file stats of '{}'", e.m_sAbsSourcePath);
       return EZ_FAILURE;
+    }
+
+    fileSizes[i] = stats.m_uiFileSize;
+    uiTotalFrames += ezMath::Max<ezUInt64>(1, (stats.m_uiFileSize + uiFrameSize - 1) / uiFrameSize);
+
+    compressEntry[i] = IsCompressionRequested(e.m_CompressionMode) && stats.m_uiFileSize > 0;
+
+    if (compressEntry[i] && stats.m_uiFileSize > uiFrameSize)
+    {
+      multiFrameEntries.PushBack(i);
+    }
+  }
+
+  // Whether a file that spans several frames gets compressed at all is decided up front, so that the archive version is known before
+  // anything is written. Archives without framed entries stay at the previous version and can still be read by older versions.
+  bool bHasFramedEntries = false;
+  {
+    const ezUInt64 uiProbeSize = ezMath::Min<ezUInt64>(uiFrameSize, 1024 * 64);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, multiFrameEntries.GetCount(),
+      [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          const ezUInt32 uiEntry = multiFrameEntries[i];
+          compressEntry[uiEntry] = IsFileCompressible(m_Entries[uiEntry].m_sAbsSourcePath, uiProbeSize);
+        }
+      },
+      "ezArchiveBuilder::ProbeCompression");
+
+    for (ezUInt32 uiEntry : multiFrameEntries)
+    {
+      if (compressEntry[uiEntry])
+      {
+        toc.m_Entries[uiEntry].m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd_framed;
+        bHasFramedEntries = true;
+      }
+    }
+  }
+
+  EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteHeader(stream, bHasFramedEntries));
+
+  // the frames are read in order on this thread, compressed in parallel, one batch at a time, and then written in order
+  const ezUInt32 uiFramesPerBatch = static_cast<ezUInt32>(ezMath::Max<ezUInt64>(1, (1024 * 1024 * 64) / uiFrameSize));
+
+  ezDeque<ArchiveFrame> frames;
+  frames.SetCount(static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiFramesPerBatch, uiTotalFrames)));
 
-    EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(stream, e.m_sAbsSourcePath, uiPathStringOffset, e.m_CompressionMode,
-      toc.m_Entries.ExpandAndGetRef(), uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this)));
+  ezFileReader sourceFile;
+  ezHybridArray<ezUInt32, 64> frameInfos;
+  ezUInt64 uiStreamSize = 0;
+  ezUInt32 uiNextEntry = 0;
+  ezUInt32 uiNextFrame = 0;
+
+  ezParallelForParams parallelForParams;
+  parallelForParams.uiMaxTasksPerThread = 4;
+
+  while (uiNextEntry < uiNumEntries)
+  {
+    ezUInt32 uiBatchFrames = 0;
+
+    for (; uiBatchFrames < frames.GetCount() && uiNextEntry < uiNumEntries; ++uiBatchFrames)
+    {
+      const SourceEntry& e = m_Entries[uiNextEntry];
+      const ezUInt64 uiOffset = uiNextFrame * uiFrameSize;
+      const ezUInt64 uiSize = ezMath::Min(uiFrameSize, fileSizes[uiNextEntry] - uiOffset);
+
+      ArchiveFrame& frame = frames[uiBatchFrames];
+      frame.m_uiEntry = uiNextEntry;
+      frame.m_uiFrame = uiNextFrame;
+      frame.m_bCompress = compressEntry[uiNextEntry];
+      frame.m_RawData.SetCountUninitialized(static_cast<ezUInt32>(uiSize));
+
+      if (uiSize > 0)
+      {
+        // the source file stays open across batches until all of its frames are read
+        if (uiNextFrame == 0 && sourceFile.Open(e.m_sAbsSourcePath).Failed())
+        {
+          ezLog::Error("Could not open '{}' for reading", e.m_sAbsSourcePath);
+          return EZ_FAILURE;
+        }
+
+        if (sourceFile.ReadBytes(frame.m_RawData.GetData(), uiSize) != uiSize)
+        {
+          ezLog::Error("Failed to read '{}'", e.m_sAbsSourcePath);
+          return EZ_FAILURE;
+        }
+      }
+
+      if (uiOffset + uiFrameSize >= fileSizes[uiNextEntry])
+      {
+        sourceFile.Close();
+
+        ++uiNextEntry;
+        uiNextFrame = 0;
+      }
+      else
+      {
+        ++uiNextFrame;
+      }
+    }
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiBatchFrames,
+      [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+        for (ezUInt32 f = uiStart; f < uiEnd; ++f)
+        {
+          ArchiveFrame& frame = frames[f];
+          frame.m_bFailed = frame.m_bCompress && CompressData(frame.m_RawData.GetData(), frame.m_RawData.GetCount(), frame.m_CompressedData).Failed();
+        }
+      },
+      "ezArchiveBuilder::CompressFrames", parallelForParams);
+
+    for (ezUInt32 f = 0; f < uiBatchFrames; ++f)
+    {
+      const ArchiveFrame& frame = frames[f];
+      const SourceEntry& e = m_Entries[frame.m_uiEntry];
+      ezArchiveEntry& tocEntry = toc.m_Entries[frame.m_uiEntry];
+      const ezUInt64 uiFileSize = fileSizes[frame.m_uiEntry];
+      const ezUInt32 uiNumFrames = static_cast<ezUInt32>(ezMath::Max<ezUInt64>(1, (uiFileSize + uiFrameSize - 1) / uiFrameSize));
+
+      if (frame.m_bFailed)
+      {
+        ezLog::Error("Failed to compress '{}'", e.m_sAbsSourcePath);
+        return EZ_FAILURE;
+      }
+
+      const ezUInt64 uiRawSize = frame.m_RawData.GetCount();
+      const bool bUseCompressed = frame.m_bCompress && IsCompressionWorthIt(frame.m_CompressedData.GetStorageSize(), uiRawSize);
+
+      if (frame.m_uiFrame == 0)
+      {
+        if (!WriteNextFileCallback(frame.m_uiEntry + 1, uiNumEntries, e.m_sAbsSourcePath))
+          return EZ_FAILURE;
+
+        tocEntry.m_uiDataStartOffset = uiStreamSize;
+        tocEntry.m_uiUncompressedDataSize = 0;
+        frameInfos.Clear();
+
+        // the mode of framed entries was already decided, single frames are simply stored the way that is smaller
+        if (uiNumFrames == 1 && bUseCompressed)
+          tocEntry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+      }
+
+      const bool bFramed = tocEntry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_framed;
+
+      if (bUseCompressed && tocEntry.m_CompressionMode != ezArchiveCompressionMode::Uncompressed)
+      {
+        EZ_SUCCEED_OR_RETURN(stream.WriteBytes(frame.m_CompressedData.GetData(), frame.m_CompressedData.GetStorageSize()));
+        uiStreamSize += frame.m_CompressedData.GetStorageSize();
+        frameInfos.PushBack(frame.m_CompressedData.GetStorageSize());
+      }
+      else
+      {
+        // frames of a framed entry that don't compress well are stored raw, see ezArchiveFramedReaderZstd
+        EZ_SUCCEED_OR_RETURN(stream.WriteBytes(frame.m_RawData.GetData(), uiRawSize));
+        uiStreamSize += uiRawSize;
+        frameInfos.PushBack(static_cast<ezUInt32>(uiRawSize) | 0x80000000u);
+      }
+
+      tocEntry.m_uiUncompressedDataSize += uiRawSize;
+
+      if (!WriteFileProgressCallback(tocEntry.m_uiUncompressedDataSize, uiFileSize))
+        return EZ_FAILURE;
+
+      if (frame.m_uiFrame + 1 == uiNumFrames)
+      {
+        if (bFramed)
+        {
+          // append the seek table, see ezArchiveFramedReaderZstd
+          EZ_SUCCEED_OR_RETURN(stream.WriteBytes(frameInfos.GetData(), frameInfos.GetCount() * sizeof(ezUInt32)));
+          stream << static_cast<ezUInt32>(uiFrameSize);
+          stream << uiNumFrames;
+          uiStreamSize += (frameInfos.GetCount() + 2) * sizeof(ezUInt32);
+        }
+
+        tocEntry.m_uiStoredDataSize = uiStreamSize - tocEntry.m_uiDataStartOffset;
+      }
+    }
   }
 
   EZ_SUCCEED_OR_RETURN(ezArchiveUtils::AppendTOC(stream, toc));
@@ -0,0 +1,150 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/IO/Archive/ArchiveFramedReader.h>
+#include <Foundation/Logging/Log.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+static constexpr ezUInt32 s_uiRawFrameFlag = 0x80000000u;
+
+ezArchiveFramedReaderZstd::ezArchiveFramedReaderZstd() = default;
+ezArchiveFramedReaderZstd::~ezArchiveFramedReaderZstd() = default;
+
+ezResult ezArchiveFramedReaderZstd::Configure(const void* pStoredData, ezUInt64 uiStoredSize, ezUInt64 uiUncompressedSize)
+{
+  m_pStoredData = static_cast<const ezUInt8*>(pStoredData);
+  m_pSeekTable = nullptr;
+  m_uiUncompressedSize = uiUncompressedSize;
+  m_uiReadPosition = 0;
+  m_uiFrameSize = 0;
+  m_uiCurFrame = 0;
+  m_bFrameOpen = false;
+  m_FrameOffsets.Clear();
+
+  if (uiStoredSize < 2 * sizeof(ezUInt32))
+  {
+    ezLog::Error("Archive entry is corrupt. Missing frame seek table.");
+    return EZ_FAILURE;
+  }
+
+  // the trailer is not necessarily aligned
+  ezUInt32 uiNumFrames = 0;
+  ezMemoryUtils::RawByteCopy(&m_uiFrameSize, m_pStoredData + uiStoredSize - 2 * sizeof(ezUInt32), sizeof(ezUInt32));
+  ezMemoryUtils::RawByteCopy(&uiNumFrames, m_pStoredData + uiStoredSize - sizeof(ezUInt32), sizeof(ezUInt32));
+
+  const ezUInt64 uiTrailerSize = (ezUInt64)(uiNumFrames + 2) * sizeof(ezUInt32);
+
+  if (m_uiFrameSize == 0 || uiTrailerSize > uiStoredSize || uiNumFrames != ezMath::Max<ezUInt64>(1, (uiUncompressedSize + m_uiFrameSize - 1) / m_uiFrameSize))
+  {
+    ezLog::Error("Archive entry is corrupt. Invalid frame seek table.");
+    return EZ_FAILURE;
+  }
+
+  m_pSeekTable = m_pStoredData + uiStoredSize - uiTrailerSize;
+
+  m_FrameOffsets.SetCountUninitialized(uiNumFrames + 1);
+  m_FrameOffsets[0] = 0;
+
+  for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+  {
+    m_FrameOffsets[i + 1] = m_FrameOffsets[i] + (GetStoredFrameInfo(i) & ~s_uiRawFrameFlag);
+  }
+
+  if (m_FrameOffsets.PeekBack() != uiStoredSize - uiTrailerSize)
+  {
+    ezLog::Error("Archive entry is corrupt. Frame sizes do not match the stored data.");
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt32 ezArchiveFramedReaderZstd::GetStoredFrameInfo(ezUInt32 uiFrame) const
+{
+  ezUInt32 uiInfo = 0;
+  ezMemoryUtils::RawByteCopy(&uiInfo, m_pSeekTable + uiFrame * sizeof(ezUInt32), sizeof(ezUInt32));
+  return uiInfo;
+}
+
+void ezArchiveFramedReaderZstd::OpenFrame(ezUInt32 uiFrame)
+{
+  m_uiCurFrame = uiFrame;
+  m_bFrameOpen = true;
+  m_bFrameIsRaw = (GetStoredFrameInfo(uiFrame) & s_uiRawFrameFlag) != 0;
+
+  m_FrameData.Reset(m_pStoredData + m_FrameOffsets[uiFrame], m_FrameOffsets[uiFrame + 1] - m_FrameOffsets[uiFrame]);
+
+  if (!m_bFrameIsRaw)
+  {
+    m_FrameDecoder.SetInputStream(&m_FrameData);
+  }
+}
+
+ezUInt64 ezArchiveFramedReaderZstd::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
+{
+  ezUInt8* pBuffer = static_cast<ezUInt8*>(pReadBuffer);
+  ezUInt64 uiBytesRead = 0;
+
+  uiBytesToRead = ezMath::Min(uiBytesToRead, m_uiUncompressedSize - m_uiReadPosition);
+
+  while (uiBytesToRead > 0)
+  {
+    const ezUInt32 uiFrame = static_cast<ezUInt32>(m_uiReadPosition / m_uiFrameSize);
+
+    if (!m_bFrameOpen || m_uiCurFrame != uiFrame)
+    {
+      OpenFrame(uiFrame);
+    }
+
+    const ezUInt64 uiFrameEnd = ezMath::Min<ezUInt64>((ezUInt64)(uiFrame + 1) * m_uiFrameSize, m_uiUncompressedSize);
+    const ezUInt64 uiChunk = ezMath::Min(uiBytesToRead, uiFrameEnd - m_uiReadPosition);
+
+    ezUInt64 uiGot = 0;
+    if (m_bFrameIsRaw)
+      uiGot = m_FrameData.ReadBytes(pBuffer, uiChunk);
+    else
+      uiGot = m_FrameDecoder.ReadBytes(pBuffer, uiChunk);
+
+    m_uiReadPosition += uiGot;
+    uiBytesRead += uiGot;
+    uiBytesToRead -= uiGot;
+
+    if (pBuffer != nullptr)
+      pBuffer += uiGot;
+
+    if (uiGot < uiChunk)
+      break;
+  }
+
+  return uiBytesRead;
+}
+
+ezUInt64 ezArchiveFramedReaderZstd::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  const ezUInt64 uiStartPosition = m_uiReadPosition;
+  const ezUInt64 uiTarget = ezMath::Min(m_uiReadPosition + uiBytesToSkip, m_uiUncompressedSize);
+
+  if (uiTarget == m_uiUncompressedSize)
+  {
+    m_uiReadPosition = uiTarget;
+    m_bFrameOpen = false;
+    return uiTarget - uiStartPosition;
+  }
+
+  const ezUInt32 uiTargetFrame = static_cast<ezUInt32>(uiTarget / m_uiFrameSize);
+
+  if (!m_bFrameOpen || m_uiCurFrame != uiTargetFrame)
+  {
+    // jump directly to the start of the target frame, nothing in between has to be decoded
+    OpenFrame(uiTargetFrame);
+    m_uiReadPosition = (ezUInt64)uiTargetFrame * m_uiFrameSize;
+  }
+
+  ReadBytes(nullptr, uiTarget - m_uiReadPosition);
+
+  return m_uiReadPosition - uiStartPosition;
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Archive_Implementation_ArchiveFramedReader);
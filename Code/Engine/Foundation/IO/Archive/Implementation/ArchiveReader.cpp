@@ -70,7 +70,8 @@ ezResult ezArchiveReader::OpenArchive(const char* szPath)
         return EZ_FAILURE;
       }
 
-      if (e.m_uiUncompressedDataSize < e.m_uiStoredDataSize)
+      // framed entries store a seek table and may contain uncompressed frames, so they can be slightly larger than the original data
+      if (e.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd_framed && e.m_uiUncompressedDataSize < e.m_uiStoredDataSize)
       {
         ezLog::Error("Archive is corrupt. Invalid compression info.");
         return EZ_FAILURE;
@@ -120,6 +121,11 @@ void ezArchiveReader::ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawM
   ezArchiveUtils::ConfigureRawMemoryStreamReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart, memReader);
 }
 
+const void* ezArchiveReader::GetEntryData(ezUInt32 uiEntryIdx) const
+{
+  return ezMemoryUtils::AddByteOffset(m_pDataStart, m_ArchiveTOC.m_Entries[uiEntryIdx].m_uiDataStartOffset);
+}
+
 ezUniquePtr<ezStreamReader> ezArchiveReader::CreateEntryReader(ezUInt32 uiEntryIdx) const
 {
   return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart);
@@ -132,6 +138,9 @@ ezResult ezArchiveReader::ExtractFile(ezUInt32 uiEntryIdx, const char* szTargetF
 
   ezUniquePtr<ezStreamReader> pReader = CreateEntryReader(uiEntryIdx);
 
+  if (pReader == nullptr)
+    return EZ_FAILURE;
+
   ezStringBuilder sOutputFile = szTargetFolder;
   sOutputFile.AppendPath(szFilePath);
 
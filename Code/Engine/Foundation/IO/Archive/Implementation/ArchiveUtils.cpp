@@ -1,5 +1,6 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/IO/Archive/ArchiveFramedReader.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 
 #include <Foundation/IO/CompressedStreamZlib.h>
@@ -32,13 +33,14 @@ bool ezArchiveUtils::IsAcceptedArchiveFileExtensions(ezStringView extension)
   return false;
 }
 
-ezResult ezArchiveUtils::WriteHeader(ezStreamWriter& stream)
+ezResult ezArchiveUtils::WriteHeader(ezStreamWriter& stream, bool bHasFramedEntries)
 {
   const char* szTag = "EZARCHIVE";
   EZ_SUCCEED_OR_RETURN(stream.WriteBytes(szTag, 10));
 
-  const ezUInt8 uiArchiveVersion = 2;
+  const ezUInt8 uiArchiveVersion = bHasFramedEntries ? 3 : 2;
   // Version 2: Added end-of-file marker for file corruption (cutoff) detection
+  // Version 3: Large entries may be stored as independently compressed zstd frames
   stream << uiArchiveVersion;
 
   const ezUInt8 uiPadding[5] = {0, 0, 0, 0, 0};
@@ -59,7 +61,7 @@ ezResult ezArchiveUtils::ReadHeader(ezStreamReader& stream, ezUInt8& out_uiVersi
   out_uiVersion = 0;
   stream >> out_uiVersion;
 
-  if (out_uiVersion != 1 && out_uiVersion != 2)
+  if (out_uiVersion < 1 || out_uiVersion > 3)
   {
     ezLog::Error("Unsupported archive version '{}'.", out_uiVersion);
     return EZ_FAILURE;
@@ -238,6 +240,19 @@ ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEnt
       pRawReader->SetInputStream(&pRawReader->m_Source);
       break;
     }
+
+    case ezArchiveCompressionMode::Compressed_zstd_framed:
+    {
+      reader = EZ_DEFAULT_NEW(ezArchiveFramedReaderZstd);
+      ezArchiveFramedReaderZstd* pFramedReader = static_cast<ezArchiveFramedReaderZstd*>(reader.Borrow());
+      if (pFramedReader->Configure(ezMemoryUtils::AddByteOffset(pStartOfArchiveData, entry.m_uiDataStartOffset), entry.m_uiStoredDataSize,
+            entry.m_uiUncompressedDataSize)
+            .Failed())
+      {
+        reader.Clear();
+      }
+      break;
+    }
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
     case ezArchiveCompressionMode::Compressed_zip:
@@ -37,7 +37,7 @@ ezDataDirectoryType* ezDataDirectory::ArchiveType::Factory(
   return nullptr;
 }
 
-ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir)
+ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir, ezUInt64 uiFileKey)
 {
   const ezArchiveTOC& toc = m_ArchiveReader.GetArchiveTOC();
   ezStringBuilder sArchivePath = m_sArchiveSubFolder;
@@ -69,6 +69,17 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char*
           m_ReadersUncompressed.PushBack(EZ_DEFAULT_NEW(ArchiveReaderUncompressed, 0));
           pReader = m_ReadersUncompressed.PeekBack().Borrow();
         }
+
+        // ezArrayPtr can't address more than 4GB, such entries can only be read
+        if (pEntry->m_uiUncompressedDataSize <= ezMath::MaxValue<ezUInt32>())
+        {
+          const ezUInt8* pEntryData = static_cast<const ezUInt8*>(m_ArchiveReader.GetEntryData(uiEntryIndex));
+          pReader->m_MappedData = ezArrayPtr<const ezUInt8>(pEntryData, static_cast<ezUInt32>(pEntry->m_uiUncompressedDataSize));
+        }
+        else
+        {
+          pReader->m_MappedData.Clear();
+        }
         break;
       }
 
@@ -87,6 +98,26 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char*
         }
         break;
       }
+
+      case ezArchiveCompressionMode::Compressed_zstd_framed:
+      {
+        ArchiveReaderZstdFramed* pFramedReader = nullptr;
+
+        if (!m_FreeReadersZstdFramed.IsEmpty())
+        {
+          pFramedReader = m_FreeReadersZstdFramed.PeekBack();
+          m_FreeReadersZstdFramed.PopBack();
+        }
+        else
+        {
+          m_ReadersZstdFramed.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstdFramed, 3));
+          pFramedReader = m_ReadersZstdFramed.PeekBack().Borrow();
+        }
+
+        pFramedReader->m_pEntryData = m_ArchiveReader.GetEntryData(uiEntryIndex);
+        pReader = pFramedReader;
+        break;
+      }
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
       case ezArchiveCompressionMode::Compressed_zip:
@@ -118,7 +149,8 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char*
 
   if (pReader->Open(sArchivePath, this, FileShareMode).Failed())
   {
-    EZ_DEFAULT_DELETE(pReader);
+    // the reader is owned by the pool, so just make it available again
+    OnReaderWriterClose(pReader);
     return nullptr;
   }
 
@@ -131,7 +163,7 @@ void ezDataDirectory::ArchiveType::RemoveDataDirectory()
   EZ_DEFAULT_DELETE(pThis);
 }
 
-bool ezDataDirectory::ArchiveType::ExistsFile(const char* szFile, bool bOneSpecificDataDir)
+bool ezDataDirectory::ArchiveType::ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey)
 {
   ezStringBuilder sArchivePath = m_sArchiveSubFolder;
   sArchivePath.AppendPath(szFile);
@@ -240,6 +272,12 @@ void ezDataDirectory::ArchiveType::OnReaderWriterClose(ezDataDirectoryReaderWrit
     m_FreeReadersZstd.PushBack(static_cast<ArchiveReaderZstd*>(pClosed));
     return;
   }
+
+  if (pClosed->GetDataDirUserData() == 3)
+  {
+    m_FreeReadersZstdFramed.PushBack(static_cast<ArchiveReaderZstdFramed*>(pClosed));
+    return;
+  }
 #endif
 
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
@@ -267,11 +305,21 @@ ezUInt64 ezDataDirectory::ArchiveReaderUncompressed::Read(void* pBuffer, ezUInt6
   return m_MemStreamReader.ReadBytes(pBuffer, uiBytes);
 }
 
+ezUInt64 ezDataDirectory::ArchiveReaderUncompressed::Skip(ezUInt64 uiBytes)
+{
+  return m_MemStreamReader.SkipBytes(uiBytes);
+}
+
 ezUInt64 ezDataDirectory::ArchiveReaderUncompressed::GetFileSize() const
 {
   return m_uiUncompressedSize;
 }
 
+ezArrayPtr<const ezUInt8> ezDataDirectory::ArchiveReaderUncompressed::GetMappedData() const
+{
+  return m_MappedData;
+}
+
 ezResult ezDataDirectory::ArchiveReaderUncompressed::InternalOpen(ezFileShareMode::Enum FileShareMode)
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
@@ -301,6 +349,11 @@ ezUInt64 ezDataDirectory::ArchiveReaderZstd::Read(void* pBuffer, ezUInt64 uiByte
   return m_CompressedStreamReader.ReadBytes(pBuffer, uiBytes);
 }
 
+ezUInt64 ezDataDirectory::ArchiveReaderZstd::Skip(ezUInt64 uiBytes)
+{
+  return m_CompressedStreamReader.ReadBytes(nullptr, uiBytes);
+}
+
 ezResult ezDataDirectory::ArchiveReaderZstd::InternalOpen(ezFileShareMode::Enum FileShareMode)
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
@@ -309,6 +362,32 @@ ezResult ezDataDirectory::ArchiveReaderZstd::InternalOpen(ezFileShareMode::Enum
   return EZ_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+ezDataDirectory::ArchiveReaderZstdFramed::ArchiveReaderZstdFramed(ezInt32 iDataDirUserData)
+  : ArchiveReaderUncompressed(iDataDirUserData)
+{
+}
+
+ezDataDirectory::ArchiveReaderZstdFramed::~ArchiveReaderZstdFramed() = default;
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdFramed::Read(void* pBuffer, ezUInt64 uiBytes)
+{
+  return m_FramedReader.ReadBytes(pBuffer, uiBytes);
+}
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdFramed::Skip(ezUInt64 uiBytes)
+{
+  return m_FramedReader.SkipBytes(uiBytes);
+}
+
+ezResult ezDataDirectory::ArchiveReaderZstdFramed::InternalOpen(ezFileShareMode::Enum FileShareMode)
+{
+  EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
+
+  return m_FramedReader.Configure(m_pEntryData, m_uiCompressedSize, m_uiUncompressedSize);
+}
+
 #endif
 
 //////////////////////////////////////////////////////////////////////////
@@ -327,6 +406,11 @@ ezUInt64 ezDataDirectory::ArchiveReaderZip::Read(void* pBuffer, ezUInt64 uiBytes
   return m_CompressedStreamReader.ReadBytes(pBuffer, uiBytes);
 }
 
+ezUInt64 ezDataDirectory::ArchiveReaderZip::Skip(ezUInt64 uiBytes)
+{
+  return m_CompressedStreamReader.ReadBytes(nullptr, uiBytes);
+}
+
 ezResult ezDataDirectory::ArchiveReaderZip::InternalOpen(ezFileShareMode::Enum FileShareMode)
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/Time/Time.h>
+
+class ezDirectoryWatcher;
 
 namespace ezDataDirectory
 {
@@ -35,6 +39,19 @@ namespace ezDataDirectory
     /// access.
     static ezString s_sRedirectionPrefix;
 
+    /// If enabled, every folder data directory that gets mounted afterwards builds an index of all the files that it contains.
+    /// Looking up a file that is not in the index then doesn't need to touch the disk at all, which makes searching for a file through
+    /// many data directories a lot cheaper. Files that are written or deleted through ezFileSystem update the index immediately, all
+    /// other changes are picked up through an ezDirectoryWatcher, which is polled at most every 100 milliseconds. The index is only
+    /// built on platforms that support both, file iteration and directory watching, everywhere else lookups always go to the disk.
+    static bool s_bUseFileIndex;
+
+    /// \brief Returns whether file indices can be built on this platform. See s_bUseFileIndex.
+    static bool IsFileIndexSupported();
+
+    /// \brief Returns whether this data directory has a file index. See s_bUseFileIndex.
+    bool HasFileIndex() const { return m_bHasFileIndex; }
+
     /// \brief When s_sRedirectionFile and s_sRedirectionPrefix are used to enable file redirection, this will reload those config files.
     virtual void ReloadExternalConfigs() override;
 
@@ -43,13 +60,13 @@ namespace ezDataDirectory
   protected:
     // The implementations of the abstract functions.
 
-    virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir) override;
+    virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir, ezUInt64 uiFileKey) override;
 
     virtual bool ResolveAssetRedirection(const char* szPathOrAssetGuid, ezStringBuilder& out_sRedirection) override;
     virtual ezDataDirectoryWriter* OpenFileToWrite(const char* szFile, ezFileShareMode::Enum FileShareMode) override;
     virtual void RemoveDataDirectory() override;
     virtual void DeleteFile(const char* szFile) override;
-    virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir) override;
+    virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey) override;
     virtual ezResult GetFileStats(const char* szFileOrFolder, bool bOneSpecificDataDir, ezFileStats& out_Stats) override;
     virtual FolderReader* CreateFolderReader() const;
     virtual FolderWriter* CreateFolderWriter() const;
@@ -62,6 +79,22 @@ namespace ezDataDirectory
 
     void LoadRedirectionFile();
 
+    enum class IndexLookup
+    {
+      NoIndex,
+      Found,
+      NotFound,
+    };
+
+    void BuildFileIndex();
+    void ClearFileIndex();
+    void UpdateFileIndex();
+    IndexLookup LookupFileIndex(const char* szFile, ezUInt64 uiFileKey);
+
+    /// \brief Updates the file index of every folder data directory that contains the given absolute path.
+    static void AddToFileIndices(const char* szAbsolutePath);
+    static void RemoveFromFileIndices(const char* szAbsolutePath);
+
     mutable ezMutex m_ReaderWriterMutex; ///< Locks m_Readers / m_Writers as well as the m_bIsInUse flag of each reader / writer.
     ezHybridArray<ezDataDirectory::FolderReader*, 4> m_Readers;
     ezHybridArray<ezDataDirectory::FolderWriter*, 4> m_Writers;
@@ -69,6 +102,15 @@ namespace ezDataDirectory
     mutable ezMutex m_RedirectionMutex;
     ezMap<ezString, ezString> m_FileRedirection;
     ezString128 m_sRedirectedDataDirPath;
+
+    mutable ezMutex m_FileIndexMutex; ///< Locks the file index and the directory watcher.
+    bool m_bHasFileIndex = false;
+    bool m_bFileIndexOutdated = false;
+    ezTime m_LastFileIndexUpdate;
+    ezHashSet<ezUInt64> m_FileIndex;   ///< Hashes of the lower case, data directory relative paths of all files.
+    ezHashSet<ezUInt64> m_FolderIndex; ///< Same for all folders, to detect when a folder with files in it is removed.
+    ezDirectoryWatcher* m_pFileIndexWatcher = nullptr;
+    FolderType* m_pNextIndexedDataDir = nullptr;
   };
 
 
@@ -85,6 +127,7 @@ namespace ezDataDirectory
     }
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
     virtual ezUInt64 GetFileSize() const override;
 
   protected:
@@ -7,6 +7,7 @@
 /// \brief The default class to use to read data from a file, implements the ezStreamReader interface.
 ///
 /// This file reader buffers reads up to a certain amount of bytes (configurable).
+/// Files that are already in memory (see GetMappedData()) are read directly without a cache.
 /// It closes the file automatically once it goes out of scope.
 class EZ_FOUNDATION_DLL ezFileReader : public ezFileReaderBase
 {
@@ -36,6 +37,9 @@ public:
   /// \brief Attempts to read the given number of bytes into the buffer. Returns the actual number of bytes read.
   virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override;
 
+  /// \brief Skips the given number of bytes. Data that is not cached is skipped by the data directory reader, which may be able to seek.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override;
+
 private:
   ezUInt64 m_uiBytesCached;
   ezUInt64 m_uiCacheReadPosition;
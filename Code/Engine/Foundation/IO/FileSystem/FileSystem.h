@@ -4,7 +4,10 @@
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Mutex.h>
+#include <Foundation/Types/RefCounted.h>
+#include <Foundation/Types/SharedPtr.h>
 
 /// \brief The ezFileSystem provides high-level functionality to manage files in a virtual file system.
 ///
@@ -225,6 +228,22 @@ public:
   /// Returns EZ_FAILURE if nothing is found. Otherwise \a result is the absolute path to the existing folder that has a given sub-folder.
   static ezResult FindFolderWithSubPath(const char* szStartDirectory, const char* szSubPath, ezStringBuilder& result); // [tested]
 
+  /// \brief How often data directories were asked for a file by ExistsFile() and when opening files for reading.
+  struct ProbeStats
+  {
+    ezUInt64 m_uiHits = 0;   ///< How often a data directory had the requested file.
+    ezUInt64 m_uiMisses = 0; ///< How often a data directory did not have the requested file.
+  };
+
+  /// \brief Returns how many data directory probes were hits and misses since startup or the last call to ResetProbeStats().
+  ///
+  /// Since the last added data directory is searched first, a high number of misses means that many files are found in data
+  /// directories that were added early.
+  static ProbeStats GetProbeStats();
+
+  /// \brief Resets the counters returned by GetProbeStats().
+  static void ResetProbeStats();
+
   /// \brief Returns true, if any data directory knows how to redirect the given path. Otherwise the original string is returned in out_sRedirection.
   static bool ResolveAssetRedirection(const char* szPathOrAssetGuid, ezStringBuilder& out_sRedirection);
 
@@ -271,6 +290,18 @@ private:
     ezDataDirectoryType* m_pDataDirectory;
   };
 
+  /// \brief An immutable copy of the data directory list. ExistsFile() and GetFileReader() search it without holding the file system mutex.
+  ///
+  /// Removed data directories are only deleted, once no snapshot that may still contain them is in use anymore.
+  struct DataDirectorySnapshot : public ezRefCounted
+  {
+    ~DataDirectorySnapshot();
+
+    ezHybridArray<DataDirectory, 16> m_DataDirectories;
+    ezHybridArray<ezDataDirectoryType*, 4> m_RemovedDataDirectories; ///< Deleted together with this snapshot.
+    ezSharedPtr<DataDirectorySnapshot> m_pNewerSnapshot;             ///< Keeps the directories that get removed later alive.
+  };
+
   struct Factory
   {
     EZ_DECLARE_POD_TYPE();
@@ -283,16 +314,28 @@ private:
   {
     ezHybridArray<Factory, 4> m_DataDirFactories;
     ezHybridArray<DataDirectory, 16> m_DataDirectories;
+    ezSharedPtr<DataDirectorySnapshot> m_pDataDirSnapshot;
 
     ezEvent<const FileEvent&, ezMutex> m_Event;
     ezMutex m_FsMutex;
+
+    ezAtomicInteger64 m_ProbeHits;
+    ezAtomicInteger64 m_ProbeMisses;
   };
 
   /// \brief Returns a list of data directory categories that were embedded in the path.
   static const char* ExtractRootName(const char* szPath, ezString& rootName);
 
   /// \brief Returns the given path relative to its data directory. The path must be inside the given data directory.
-  static const char* GetDataDirRelativePath(const char* szPath, ezUInt32 uiDataDir);
+  static const char* GetDataDirRelativePath(const char* szPath, const ezDataDirectoryType* pDataDir);
+
+  /// \brief Returns the current snapshot of the data directory list.
+  static ezSharedPtr<DataDirectorySnapshot> GetDataDirectorySnapshot();
+
+  /// \brief Replaces the snapshot after m_DataDirectories was modified.
+  ///
+  /// The removed data directories are deleted once the old snapshot is not used anymore.
+  static void UpdateDataDirectorySnapshot(const ezArrayPtr<ezDataDirectoryType* const>& removedDataDirs);
 
   static DataDirectory* GetDataDirForRoot(const ezString& sRoot);
 
@@ -1,5 +1,6 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/OSFile.h>
 
@@ -15,7 +16,18 @@ ezResult ezDataDirectoryType::InitializeDataDirectory(const char* szDataDirPath)
   return InternalInitializeDataDirectory(m_sDataDirectoryPath.GetData());
 }
 
-bool ezDataDirectoryType::ExistsFile(const char* szFile, bool bOneSpecificDataDir)
+// static
+ezUInt64 ezDataDirectoryType::ComputeFileKey(const char* szFile)
+{
+  // paths are compared case insensitive, a wrong match only results in a failed attempt to open the file
+  ezStringBuilder sKey = szFile;
+  sKey.MakeCleanPath();
+  sKey.ToLower();
+
+  return ezHashingUtils::xxHash64(sKey.GetData(), sKey.GetElementCount());
+}
+
+bool ezDataDirectoryType::ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey)
 {
   ezStringBuilder sRedirectedAsset;
   ResolveAssetRedirection(szFile, sRedirectedAsset);
@@ -38,6 +50,25 @@ void ezDataDirectoryReaderWriterBase::Close()
   m_pDataDirectory->OnReaderWriterClose(this);
 }
 
+ezUInt64 ezDataDirectoryReader::Skip(ezUInt64 uiBytes)
+{
+  ezUInt8 uiTemp[1024 * 4];
+
+  ezUInt64 uiSkipped = 0;
+  while (uiSkipped < uiBytes)
+  {
+    const ezUInt64 uiToRead = ezMath::Min<ezUInt64>(uiBytes - uiSkipped, EZ_ARRAY_SIZE(uiTemp));
+    const ezUInt64 uiRead = Read(uiTemp, uiToRead);
+
+    uiSkipped += uiRead;
+
+    if (uiRead < uiToRead)
+      break;
+  }
+
+  return uiSkipped;
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_IO_FileSystem_Implementation_DataDirType);
@@ -3,6 +3,7 @@
 #include <Foundation/Basics.h>
 #include <Foundation/IO/FileEnums.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Types/ArrayPtr.h>
 
 class ezDataDirectoryReaderWriterBase;
 class ezDataDirectoryReader;
@@ -36,6 +37,12 @@ public:
   ///        reloading and reapplying of configurations, without dismounting and remounting the data directory.
   virtual void ReloadExternalConfigs(){};
 
+  /// \brief Returns the key of a data directory relative file path, which data directories can use to look the file up in an index.
+  ///
+  /// The path is cleaned up and compared case insensitive. ezFileSystem computes the key only once, when it searches multiple data
+  /// directories for a file, and passes it to OpenFileToRead() and ExistsFile().
+  static ezUInt64 ComputeFileKey(const char* szFile);
+
 protected:
   friend class ezFileSystem;
 
@@ -53,7 +60,8 @@ protected:
   /// by using a rooted path.
   /// If an absolute path is used, which incidentally matches the prefix of this data directory, bSpecificallyThisDataDir is NOT set to
   /// true, as there might be other data directories that also match.
-  virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir) = 0;
+  /// \param uiFileKey is ComputeFileKey(szFile) or zero, if it was not computed.
+  virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir, ezUInt64 uiFileKey) = 0;
 
   /// \brief Must be implemented to create a ezDataDirectoryWriter for accessing the given file. Returns nullptr if the file could not be
   /// opened.
@@ -72,8 +80,8 @@ protected:
   /// \brief This function checks whether the given file exists in this data directory.
   ///
   /// The default implementation simply calls ezOSFile::ExistsFile
-  /// An optimized implementation might look this information up in some hash-map.
-  virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir);
+  /// An optimized implementation might look this information up in some hash-map, using uiFileKey (see OpenFileToRead()).
+  virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey);
 
   /// \brief Upon success returns the ezFileStats for a file in this data directory.
   virtual ezResult GetFileStats(const char* szFileOrFolder, bool bOneSpecificDataDir, ezFileStats& out_Stats) = 0;
@@ -163,6 +171,17 @@ public:
   }
 
   virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) = 0;
+
+  /// \brief Advances the read position by the given number of bytes and returns how many bytes were actually skipped.
+  ///
+  /// The default implementation reads and discards the data. Derived types should override this, if they can seek more efficiently.
+  virtual ezUInt64 Skip(ezUInt64 uiBytes);
+
+  /// \brief Returns the entire content of the file, if it can be accessed directly in memory, e.g. an uncompressed entry in a memory mapped
+  /// archive. Returns an empty array otherwise, in which case the data has to be read through Read().
+  ///
+  /// The memory stays valid while the reader is open. It is independent of the read position.
+  virtual ezArrayPtr<const ezUInt8> GetMappedData() const { return ezArrayPtr<const ezUInt8>(); }
 };
 
 /// \brief A base class for writers that handle writing to a (virtual) file inside a data directory.
@@ -1,8 +1,17 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/DirectoryWatcher.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/Logging/Log.h>
-#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Profiling/Profiling.h>
+
+// the file index needs to be built by iterating over all files and must be kept up to date through a directory watcher
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP) && EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+#  define EZ_FOLDER_FILE_INDEX EZ_ON
+#else
+#  define EZ_FOLDER_FILE_INDEX EZ_OFF
+#endif
 
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, FolderDataDirectory)
@@ -19,10 +28,21 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, FolderDataDirectory)
 EZ_END_SUBSYSTEM_DECLARATION;
 // clang-format on
 
+namespace
+{
+  // all folder data directories that have a file index, to update them when files are written or deleted through any of them
+  ezMutex s_IndexedDataDirsMutex;
+  ezDataDirectory::FolderType* s_pFirstIndexedDataDir = nullptr;
+
+  // polling the directory watcher on every lookup would cost more than the index saves
+  constexpr ezTime s_FileIndexUpdateInterval = ezTime::Milliseconds(100);
+} // namespace
+
 namespace ezDataDirectory
 {
   ezString FolderType::s_sRedirectionFile;
   ezString FolderType::s_sRedirectionPrefix;
+  bool FolderType::s_bUseFileIndex = false;
 
   ezResult FolderReader::InternalOpen(ezFileShareMode::Enum FileShareMode)
   {
@@ -36,6 +56,16 @@ namespace ezDataDirectory
 
   ezUInt64 FolderReader::Read(void* pBuffer, ezUInt64 uiBytes) { return m_File.Read(pBuffer, uiBytes); }
 
+  ezUInt64 FolderReader::Skip(ezUInt64 uiBytes)
+  {
+    const ezUInt64 uiFileSize = m_File.GetFileSize();
+    const ezUInt64 uiPosition = ezMath::Min(m_File.GetFilePosition(), uiFileSize);
+    const ezUInt64 uiSkip = ezMath::Min(uiBytes, uiFileSize - uiPosition);
+
+    m_File.SetFilePosition(static_cast<ezInt64>(uiSkip), ezFileSeekMode::FromCurrent);
+    return uiSkip;
+  }
+
   ezUInt64 FolderReader::GetFileSize() const { return m_File.GetFileSize(); }
 
   ezResult FolderWriter::InternalOpen(ezFileShareMode::Enum FileShareMode)
@@ -88,10 +118,14 @@ namespace ezDataDirectory
     sPath.AppendPath(szFile);
 
     ezOSFile::DeleteFile(sPath.GetData());
+
+    RemoveFromFileIndices(sPath);
   }
 
   FolderType::~FolderType()
   {
+    ClearFileIndex();
+
     EZ_LOCK(m_ReaderWriterMutex);
     for (ezUInt32 i = 0; i < m_Readers.GetCount(); ++i)
       EZ_DEFAULT_DELETE(m_Readers[i]);
@@ -160,10 +194,15 @@ namespace ezDataDirectory
   }
 
 
-  bool FolderType::ExistsFile(const char* szFile, bool bOneSpecificDataDir)
+  bool FolderType::ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey)
   {
     ezStringBuilder sRedirectedAsset;
-    ResolveAssetRedirection(szFile, sRedirectedAsset);
+    if (ResolveAssetRedirection(szFile, sRedirectedAsset))
+      uiFileKey = 0;
+
+    // a file that is in the index still needs to be checked, it might have been deleted without going through ezFileSystem
+    if (LookupFileIndex(sRedirectedAsset, uiFileKey) == IndexLookup::NotFound)
+      return false;
 
     ezStringBuilder sPath = GetRedirectedDataDirectoryPath();
     sPath.AppendPath(sRedirectedAsset);
@@ -214,9 +253,210 @@ namespace ezDataDirectory
 
     ReloadExternalConfigs();
 
+    if (s_bUseFileIndex)
+    {
+      BuildFileIndex();
+
+      if (m_bHasFileIndex)
+      {
+        EZ_LOCK(s_IndexedDataDirsMutex);
+        m_pNextIndexedDataDir = s_pFirstIndexedDataDir;
+        s_pFirstIndexedDataDir = this;
+      }
+    }
+
     return EZ_SUCCESS;
   }
 
+  void FolderType::BuildFileIndex()
+  {
+#if EZ_ENABLED(EZ_FOLDER_FILE_INDEX)
+    EZ_LOCK(m_FileIndexMutex);
+
+    if (m_pFileIndexWatcher == nullptr)
+    {
+      // start watching before the files are gathered, so that no change can get lost
+      m_pFileIndexWatcher = EZ_DEFAULT_NEW(ezDirectoryWatcher);
+
+      const ezBitflags<ezDirectoryWatcher::Watch> watch =
+        ezDirectoryWatcher::Watch::Creates | ezDirectoryWatcher::Watch::Renames | ezDirectoryWatcher::Watch::Subdirectories;
+
+      if (m_pFileIndexWatcher->OpenDirectory(m_sRedirectedDataDirPath.GetData(), watch).Failed())
+      {
+        EZ_DEFAULT_DELETE(m_pFileIndexWatcher);
+        return;
+      }
+    }
+
+    EZ_PROFILE_SCOPE("BuildFileIndex");
+
+    m_FileIndex.Clear();
+    m_FolderIndex.Clear();
+    m_bFileIndexOutdated = false;
+    m_LastFileIndexUpdate = ezTime::Now();
+
+    ezFileSystemIterator iterator;
+    if (iterator.StartSearch(m_sRedirectedDataDirPath, ezFileSystemIteratorFlags::ReportFilesAndFoldersRecursive).Succeeded())
+    {
+      ezStringBuilder sPath;
+
+      do
+      {
+        sPath = iterator.GetCurrentPath();
+        sPath.AppendPath(iterator.GetStats().m_sName);
+        sPath.MakeRelativeTo(m_sRedirectedDataDirPath).IgnoreResult();
+
+        if (iterator.GetStats().m_bIsDirectory)
+          m_FolderIndex.Insert(ComputeFileKey(sPath));
+        else
+          m_FileIndex.Insert(ComputeFileKey(sPath));
+
+      } while (iterator.Next().Succeeded());
+    }
+
+    m_bHasFileIndex = true;
+#endif
+  }
+
+  void FolderType::ClearFileIndex()
+  {
+    if (!m_bHasFileIndex)
+      return;
+
+    {
+      EZ_LOCK(s_IndexedDataDirsMutex);
+
+      for (FolderType** ppDataDir = &s_pFirstIndexedDataDir; *ppDataDir != nullptr; ppDataDir = &(*ppDataDir)->m_pNextIndexedDataDir)
+      {
+        if (*ppDataDir == this)
+        {
+          *ppDataDir = m_pNextIndexedDataDir;
+          break;
+        }
+      }
+    }
+
+    EZ_LOCK(m_FileIndexMutex);
+    m_bHasFileIndex = false;
+    m_FileIndex.Clear();
+    m_FolderIndex.Clear();
+    EZ_DEFAULT_DELETE(m_pFileIndexWatcher);
+  }
+
+  void FolderType::UpdateFileIndex()
+  {
+#if EZ_ENABLED(EZ_FOLDER_FILE_INDEX)
+    m_pFileIndexWatcher->EnumerateChanges([this](const char* szFile, ezDirectoryWatcherAction action) {
+      const ezUInt64 uiKey = ComputeFileKey(szFile);
+
+      switch (action)
+      {
+        case ezDirectoryWatcherAction::Added:
+        case ezDirectoryWatcherAction::RenamedNewName:
+        {
+          ezStringBuilder sPath = m_sRedirectedDataDirPath;
+          sPath.AppendPath(szFile);
+
+          if (ezOSFile::ExistsFile(sPath))
+          {
+            m_FileIndex.Insert(uiKey);
+          }
+          else if (ezOSFile::ExistsDirectory(sPath))
+          {
+            m_FolderIndex.Insert(uiKey);
+
+            // a folder that was moved here may already contain files
+            if (action == ezDirectoryWatcherAction::RenamedNewName)
+              m_bFileIndexOutdated = true;
+          }
+        }
+        break;
+
+        case ezDirectoryWatcherAction::Removed:
+        case ezDirectoryWatcherAction::RenamedOldName:
+        {
+          // for folders only a single change is reported, all the files inside them are gone as well
+          if (!m_FileIndex.Remove(uiKey) && m_FolderIndex.Remove(uiKey))
+            m_bFileIndexOutdated = true;
+        }
+        break;
+
+        default:
+          break;
+      }
+    });
+
+    if (m_bFileIndexOutdated)
+    {
+      BuildFileIndex();
+    }
+#endif
+  }
+
+  // static
+  bool FolderType::IsFileIndexSupported()
+  {
+    return EZ_ENABLED(EZ_FOLDER_FILE_INDEX);
+  }
+
+  FolderType::IndexLookup FolderType::LookupFileIndex(const char* szFile, ezUInt64 uiFileKey)
+  {
+    if (!m_bHasFileIndex)
+      return IndexLookup::NoIndex;
+
+    const ezUInt64 uiKey = uiFileKey != 0 ? uiFileKey : ComputeFileKey(szFile);
+
+    EZ_LOCK(m_FileIndexMutex);
+
+    // changes that don't go through ezFileSystem are picked up with a short delay
+    const ezTime tNow = ezTime::Now();
+    if (tNow - m_LastFileIndexUpdate >= s_FileIndexUpdateInterval)
+    {
+      m_LastFileIndexUpdate = tNow;
+      UpdateFileIndex();
+    }
+
+    return m_FileIndex.Contains(uiKey) ? IndexLookup::Found : IndexLookup::NotFound;
+  }
+
+  void FolderType::AddToFileIndices(const char* szAbsolutePath)
+  {
+    EZ_LOCK(s_IndexedDataDirsMutex);
+
+    ezStringBuilder sRelativePath;
+
+    for (FolderType* pDataDir = s_pFirstIndexedDataDir; pDataDir != nullptr; pDataDir = pDataDir->m_pNextIndexedDataDir)
+    {
+      if (!ezPathUtils::IsSubPath(pDataDir->m_sRedirectedDataDirPath, szAbsolutePath))
+        continue;
+
+      sRelativePath = szAbsolutePath;
+      sRelativePath.MakeRelativeTo(pDataDir->m_sRedirectedDataDirPath).IgnoreResult();
+
+      EZ_LOCK(pDataDir->m_FileIndexMutex);
+      pDataDir->m_FileIndex.Insert(ComputeFileKey(sRelativePath));
+    }
+  }
+
+  void FolderType::RemoveFromFileIndices(const char* szAbsolutePath)
+  {
+    EZ_LOCK(s_IndexedDataDirsMutex);
+
+    ezStringBuilder sRelativePath;
+
+    for (FolderType* pDataDir = s_pFirstIndexedDataDir; pDataDir != nullptr; pDataDir = pDataDir->m_pNextIndexedDataDir)
+    {
+      if (!ezPathUtils::IsSubPath(pDataDir->m_sRedirectedDataDirPath, szAbsolutePath))
+        continue;
+
+      sRelativePath = szAbsolutePath;
+      sRelativePath.MakeRelativeTo(pDataDir->m_sRedirectedDataDirPath).IgnoreResult();
+
+      EZ_LOCK(pDataDir->m_FileIndexMutex);
+      pDataDir->m_FileIndex.Remove(ComputeFileKey(sRelativePath));
+    }
+  }
+
   void FolderType::OnReaderWriterClose(ezDataDirectoryReaderWriterBase* pClosed)
   {
     EZ_LOCK(m_ReaderWriterMutex);
@@ -236,15 +476,19 @@ namespace ezDataDirectory
 
   ezDataDirectory::FolderWriter* FolderType::CreateFolderWriter() const { return EZ_DEFAULT_NEW(FolderWriter, 0); }
 
-  ezDataDirectoryReader* FolderType::OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir)
+  ezDataDirectoryReader* FolderType::OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir, ezUInt64 uiFileKey)
   {
     ezStringBuilder sFileToOpen;
-    ResolveAssetRedirection(szFile, sFileToOpen);
+    if (ResolveAssetRedirection(szFile, sFileToOpen))
+      uiFileKey = 0;
 
     // we know that these files cannot be opened, so don't even try
     if (ezConversionUtils::IsStringUuid(sFileToOpen))
       return nullptr;
 
+    if (LookupFileIndex(sFileToOpen, uiFileKey) == IndexLookup::NotFound)
+      return nullptr;
+
     FolderReader* pReader = nullptr;
     {
       EZ_LOCK(m_ReaderWriterMutex);
@@ -330,6 +574,13 @@ namespace ezDataDirectory
       return nullptr;
     }
 
+    {
+      ezStringBuilder sPath = GetRedirectedDataDirectoryPath();
+      sPath.AppendPath(szFile);
+
+      AddToFileIndices(sPath);
+    }
+
     // if it succeeds, we return the reader
     return pWriter;
   }
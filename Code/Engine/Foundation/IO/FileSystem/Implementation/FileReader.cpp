@@ -13,6 +13,16 @@ ezResult ezFileReader::Open(const char* szFile, ezUInt32 uiCacheSize /*= 1024 *
   if (!m_pDataDirReader)
     return EZ_FAILURE;
 
+  // the data is already in memory, copying it through the cache would only add a second copy, an empty cache means direct reads
+  if (!m_pDataDirReader->GetMappedData().IsEmpty())
+  {
+    m_Cache.Clear();
+    m_uiCacheReadPosition = 0;
+    m_uiBytesCached = 0;
+    m_bEOF = false;
+    return EZ_SUCCESS;
+  }
+
   m_Cache.SetCountUninitialized(uiCacheSize);
 
   m_uiCacheReadPosition = 0;
@@ -37,6 +47,9 @@ ezUInt64 ezFileReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
   if (m_bEOF)
     return 0;
 
+  if (m_Cache.IsEmpty())
+    return m_pDataDirReader->Read(pReadBuffer, uiBytesToRead);
+
   ezUInt64 uiBufferPosition = 0; //how much was read, yet
   ezUInt8* pBuffer = (ezUInt8*)pReadBuffer;
 
@@ -82,6 +95,33 @@ ezUInt64 ezFileReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
   return uiBufferPosition;
 }
 
+ezUInt64 ezFileReader::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  EZ_ASSERT_DEV(m_pDataDirReader != nullptr, "The file has not been opened (successfully).");
+  if (m_bEOF)
+    return 0;
+
+  if (m_Cache.IsEmpty())
+    return m_pDataDirReader->Skip(uiBytesToSkip);
+
+  const ezUInt64 uiCachedBytesLeft = m_uiBytesCached - m_uiCacheReadPosition;
+
+  if (uiBytesToSkip < uiCachedBytesLeft)
+  {
+    m_uiCacheReadPosition += uiBytesToSkip;
+    return uiBytesToSkip;
+  }
+
+  // everything that is still cached is skipped, the rest is skipped by the data directory reader without reading it
+  const ezUInt64 uiBytesSkipped = uiCachedBytesLeft + m_pDataDirReader->Skip(uiBytesToSkip - uiCachedBytesLeft);
+
+  m_uiBytesCached = m_pDataDirReader->Read(&m_Cache[0], m_Cache.GetCount());
+  m_uiCacheReadPosition = 0;
+  m_bEOF = m_uiBytesCached == 0;
+
+  return uiBytesSkipped;
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_IO_FileSystem_Implementation_FileReader);
@@ -36,6 +36,10 @@ public:
   /// \brief Returns the current total size of the file.
   ezUInt64 GetFileSize() const { return m_pDataDirReader->GetFileSize(); }
 
+  /// \brief Returns the entire file content without copying it, if the data directory keeps it in memory (e.g. uncompressed entries in
+  /// ezArchive files). Returns an empty array otherwise. The memory stays valid until the file is closed.
+  ezArrayPtr<const ezUInt8> GetMappedData() const { return m_pDataDirReader->GetMappedData(); }
+
 protected:
   ezDataDirectoryReader* GetFileReader(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bAllowFileEvents)
   {
@@ -114,6 +114,7 @@ ezResult ezFileSystem::AddDataDirectory(const char* szDataDirectory, const char*
         dd.m_sGroup = szGroup;
 
         s_Data->m_DataDirectories.PushBack(dd);
+        UpdateDataDirectorySnapshot(ezArrayPtr<ezDataDirectoryType* const>());
 
         {
           // Broadcast that a data directory was added
@@ -165,8 +166,9 @@ bool ezFileSystem::RemoveDataDirectory(const char* szRootName)
         s_Data->m_Event.Broadcast(fe);
       }
 
-      s_Data->m_DataDirectories[i].m_pDataDirectory->RemoveDataDirectory();
+      ezDataDirectoryType* pRemovedDataDir = s_Data->m_DataDirectories[i].m_pDataDirectory;
       s_Data->m_DataDirectories.RemoveAtAndCopy(i);
+      UpdateDataDirectorySnapshot(ezMakeArrayPtr(&pRemovedDataDir, 1));
 
       return true;
     }
@@ -184,6 +186,7 @@ ezUInt32 ezFileSystem::RemoveDataDirectoryGroup(const char* szGroup)
   EZ_LOCK(s_Data->m_FsMutex);
 
   ezUInt32 uiRemoved = 0;
+  ezHybridArray<ezDataDirectoryType*, 4> removedDataDirs;
 
   for (ezUInt32 i = 0; i < s_Data->m_DataDirectories.GetCount();)
   {
@@ -201,13 +204,18 @@ ezUInt32 ezFileSystem::RemoveDataDirectoryGroup(const char* szGroup)
 
       ++uiRemoved;
 
-      s_Data->m_DataDirectories[i].m_pDataDirectory->RemoveDataDirectory();
+      removedDataDirs.PushBack(s_Data->m_DataDirectories[i].m_pDataDirectory);
       s_Data->m_DataDirectories.RemoveAtAndCopy(i);
     }
     else
       ++i;
   }
 
+  if (uiRemoved > 0)
+  {
+    UpdateDataDirectorySnapshot(removedDataDirs);
+  }
+
   return uiRemoved;
 }
 
@@ -217,6 +225,8 @@ void ezFileSystem::ClearAllDataDirectories()
 
   EZ_LOCK(s_Data->m_FsMutex);
 
+  ezHybridArray<ezDataDirectoryType*, 16> removedDataDirs;
+
   for (ezInt32 i = s_Data->m_DataDirectories.GetCount() - 1; i >= 0; --i)
   {
     {
@@ -229,10 +239,11 @@ void ezFileSystem::ClearAllDataDirectories()
       s_Data->m_Event.Broadcast(fe);
     }
 
-    s_Data->m_DataDirectories[i].m_pDataDirectory->RemoveDataDirectory();
+    removedDataDirs.PushBack(s_Data->m_DataDirectories[i].m_pDataDirectory);
   }
 
   s_Data->m_DataDirectories.Clear();
+  UpdateDataDirectorySnapshot(removedDataDirs);
 }
 
 ezDataDirectoryType* ezFileSystem::FindDataDirectoryWithRoot(const char* szRootName)
@@ -267,16 +278,14 @@ ezDataDirectoryType* ezFileSystem::GetDataDirectory(ezUInt32 uiDataDirIndex)
   return s_Data->m_DataDirectories[uiDataDirIndex].m_pDataDirectory;
 }
 
-const char* ezFileSystem::GetDataDirRelativePath(const char* szPath, ezUInt32 uiDataDir)
+const char* ezFileSystem::GetDataDirRelativePath(const char* szPath, const ezDataDirectoryType* pDataDir)
 {
-  EZ_LOCK(s_Data->m_FsMutex);
-
   // if an absolute path is given, this will check whether the absolute path would fall into this data directory
   // if yes, the prefix path is removed and then only the relative path is given to the data directory type
   // otherwise the data directory would prepend its own path and thus create an invalid path to work with
 
   // first check the redirected directory
-  const ezString128& sRedDirPath = s_Data->m_DataDirectories[uiDataDir].m_pDataDirectory->GetRedirectedDataDirectoryPath();
+  const ezString128& sRedDirPath = pDataDir->GetRedirectedDataDirectoryPath();
 
   if (!sRedDirPath.IsEmpty() && ezStringUtils::StartsWith_NoCase(szPath, sRedDirPath))
   {
@@ -290,7 +299,7 @@ const char* ezFileSystem::GetDataDirRelativePath(const char* szPath, ezUInt32 ui
   }
 
   // then check the original mount path
-  const ezString128& sDirPath = s_Data->m_DataDirectories[uiDataDir].m_pDataDirectory->GetDataDirectoryPath();
+  const ezString128& sDirPath = pDataDir->GetDataDirectoryPath();
 
   // If the data dir is empty we return the paths as is or the code below would remove the '/' in front of an
   // absolute path.
@@ -309,6 +318,36 @@ const char* ezFileSystem::GetDataDirRelativePath(const char* szPath, ezUInt32 ui
 }
 
 
+// static
+ezSharedPtr<ezFileSystem::DataDirectorySnapshot> ezFileSystem::GetDataDirectorySnapshot()
+{
+  EZ_LOCK(s_Data->m_FsMutex);
+  return s_Data->m_pDataDirSnapshot;
+}
+
+// static
+void ezFileSystem::UpdateDataDirectorySnapshot(const ezArrayPtr<ezDataDirectoryType* const>& removedDataDirs)
+{
+  EZ_LOCK(s_Data->m_FsMutex);
+
+  ezSharedPtr<DataDirectorySnapshot> pSnapshot = EZ_DEFAULT_NEW(DataDirectorySnapshot);
+  pSnapshot->m_DataDirectories = s_Data->m_DataDirectories;
+
+  // the old snapshot may still be searched on other threads, so the removed data directories are deleted together with it
+  // even older snapshots that are still in use reference the old one through m_pNewerSnapshot
+  s_Data->m_pDataDirSnapshot->m_RemovedDataDirectories.PushBackRange(removedDataDirs);
+  s_Data->m_pDataDirSnapshot->m_pNewerSnapshot = pSnapshot;
+  s_Data->m_pDataDirSnapshot = pSnapshot;
+}
+
+ezFileSystem::DataDirectorySnapshot::~DataDirectorySnapshot()
+{
+  for (ezDataDirectoryType* pDataDir : m_RemovedDataDirectories)
+  {
+    pDataDir->RemoveDataDirectory();
+  }
+}
+
 ezFileSystem::DataDirectory* ezFileSystem::GetDataDirForRoot(const ezString& sRoot)
 {
   EZ_LOCK(s_Data->m_FsMutex);
@@ -352,7 +391,7 @@ void ezFileSystem::DeleteFile(const char* szFile)
     if (s_Data->m_DataDirectories[i].m_sRootName != sRootName)
       continue;
 
-    const char* szRelPath = GetDataDirRelativePath(szFile, i);
+    const char* szRelPath = GetDataDirRelativePath(szFile, s_Data->m_DataDirectories[i].m_pDataDirectory);
 
     {
       // Broadcast that a file is about to be deleted
@@ -378,17 +417,28 @@ bool ezFileSystem::ExistsFile(const char* szFile)
 
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
-  EZ_LOCK(s_Data->m_FsMutex);
+  // only needs to be computed once, unless the path has to be made relative to each data directory
+  const ezUInt64 uiFileKey = ezDataDirectoryType::ComputeFileKey(szFile);
 
-  for (ezInt32 i = (ezInt32)s_Data->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  // other threads may add and remove data directories meanwhile, the snapshot keeps all the ones it contains alive
+  ezSharedPtr<DataDirectorySnapshot> pDataDirs = GetDataDirectorySnapshot();
+
+  for (ezInt32 i = (ezInt32)pDataDirs->m_DataDirectories.GetCount() - 1; i >= 0; --i)
   {
-    if (!sRootName.IsEmpty() && s_Data->m_DataDirectories[i].m_sRootName != sRootName)
+    const DataDirectory& dd = pDataDirs->m_DataDirectories[i];
+
+    if (!sRootName.IsEmpty() && dd.m_sRootName != sRootName)
       continue;
 
-    const char* szRelPath = GetDataDirRelativePath(szFile, i);
+    const char* szRelPath = GetDataDirRelativePath(szFile, dd.m_pDataDirectory);
 
-    if (s_Data->m_DataDirectories[i].m_pDataDirectory->ExistsFile(szRelPath, bOneSpecificDataDir))
+    if (dd.m_pDataDirectory->ExistsFile(szRelPath, bOneSpecificDataDir, szRelPath == szFile ? uiFileKey : 0))
+    {
+      s_Data->m_ProbeHits.Increment();
       return true;
+    }
+
+    s_Data->m_ProbeMisses.Increment();
   }
 
   return false;
@@ -411,7 +461,7 @@ ezResult ezFileSystem::GetFileStats(const char* szFileOrFolder, ezFileStats& out
     if (!sRootName.IsEmpty() && s_Data->m_DataDirectories[i].m_sRootName != sRootName)
       continue;
 
-    const char* szRelPath = GetDataDirRelativePath(szFileOrFolder, i);
+    const char* szRelPath = GetDataDirRelativePath(szFileOrFolder, s_Data->m_DataDirectories[i].m_pDataDirectory);
 
     if (s_Data->m_DataDirectories[i].m_pDataDirectory->GetFileStats(szRelPath, bOneSpecificDataDir, out_Stats).Succeeded())
       return EZ_SUCCESS;
@@ -455,8 +505,6 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(const char* szFile, ezFileSha
   if (ezStringUtils::IsNullOrEmpty(szFile))
     return nullptr;
 
-  EZ_LOCK(s_Data->m_FsMutex);
-
   ezString sRootName;
   szFile = ExtractRootName(szFile, sRootName);
 
@@ -466,14 +514,22 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(const char* szFile, ezFileSha
 
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
+  // only needs to be computed once, unless the path has to be made relative to each data directory
+  const ezUInt64 uiFileKey = ezDataDirectoryType::ComputeFileKey(sPath);
+
+  // other threads may add and remove data directories meanwhile, the snapshot keeps all the ones it contains alive
+  ezSharedPtr<DataDirectorySnapshot> pDataDirs = GetDataDirectorySnapshot();
+
   // the last added data directory has the highest priority
-  for (ezInt32 i = (ezInt32)s_Data->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  for (ezInt32 i = (ezInt32)pDataDirs->m_DataDirectories.GetCount() - 1; i >= 0; --i)
   {
+    const DataDirectory& dd = pDataDirs->m_DataDirectories[i];
+
     // if a root is used, ignore all directories that do not have the same root name
-    if (bOneSpecificDataDir && s_Data->m_DataDirectories[i].m_sRootName != sRootName)
+    if (bOneSpecificDataDir && dd.m_sRootName != sRootName)
       continue;
 
-    const char* szRelPath = GetDataDirRelativePath(sPath, i);
+    const char* szRelPath = GetDataDirRelativePath(sPath, dd.m_pDataDirectory);
 
     if (bAllowFileEvents)
     {
@@ -483,25 +539,33 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(const char* szFile, ezFileSha
       fe.m_EventType = FileEventType::OpenFileAttempt;
       fe.m_szFileOrDirectory = szRelPath;
       fe.m_szOther = sRootName;
-      fe.m_pDataDir = s_Data->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dd.m_pDataDirectory;
       s_Data->m_Event.Broadcast(fe);
     }
 
     // Let the data directory try to open the file.
-    ezDataDirectoryReader* pReader = s_Data->m_DataDirectories[i].m_pDataDirectory->OpenFileToRead(szRelPath, FileShareMode, bOneSpecificDataDir);
+    ezDataDirectoryReader* pReader = dd.m_pDataDirectory->OpenFileToRead(szRelPath, FileShareMode, bOneSpecificDataDir, szRelPath == sPath.GetData() ? uiFileKey : 0);
 
-    if (bAllowFileEvents && pReader != nullptr)
+    if (pReader == nullptr)
+    {
+      s_Data->m_ProbeMisses.Increment();
+      continue;
+    }
+
+    s_Data->m_ProbeHits.Increment();
+
+    if (bAllowFileEvents)
     {
       // Broadcast that this file has been opened.
       FileEvent fe;
       fe.m_EventType = FileEventType::OpenFileSucceeded;
       fe.m_szFileOrDirectory = szRelPath;
       fe.m_szOther = sRootName;
-      fe.m_pDataDir = s_Data->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dd.m_pDataDirectory;
       s_Data->m_Event.Broadcast(fe);
-
-      return pReader;
     }
+
+    return pReader;
   }
 
   if (bAllowFileEvents)
@@ -550,7 +614,7 @@ ezDataDirectoryWriter* ezFileSystem::GetFileWriter(const char* szFile, ezFileSha
     if (s_Data->m_DataDirectories[i].m_sRootName != sRootName)
       continue;
 
-    const char* szRelPath = GetDataDirRelativePath(szFile, i);
+    const char* szRelPath = GetDataDirRelativePath(szFile, s_Data->m_DataDirectories[i].m_pDataDirectory);
 
     if (bAllowFileEvents)
     {
@@ -734,6 +798,24 @@ bool ezFileSystem::ResolveAssetRedirection(const char* szPathOrAssetGuid, ezStri
   return false;
 }
 
+ezFileSystem::ProbeStats ezFileSystem::GetProbeStats()
+{
+  EZ_ASSERT_DEV(s_Data != nullptr, "FileSystem is not initialized.");
+
+  ProbeStats stats;
+  stats.m_uiHits = static_cast<ezUInt64>(s_Data->m_ProbeHits);
+  stats.m_uiMisses = static_cast<ezUInt64>(s_Data->m_ProbeMisses);
+  return stats;
+}
+
+void ezFileSystem::ResetProbeStats()
+{
+  EZ_ASSERT_DEV(s_Data != nullptr, "FileSystem is not initialized.");
+
+  s_Data->m_ProbeHits.Set(0);
+  s_Data->m_ProbeMisses.Set(0);
+}
+
 void ezFileSystem::ReloadAllExternalDataDirectoryConfigs()
 {
   EZ_LOG_BLOCK("ReloadAllExternalDataDirectoryConfigs");
@@ -749,6 +831,7 @@ void ezFileSystem::ReloadAllExternalDataDirectoryConfigs()
 void ezFileSystem::Startup()
 {
   s_Data = EZ_DEFAULT_NEW(FileSystemData);
+  s_Data->m_pDataDirSnapshot = EZ_DEFAULT_NEW(DataDirectorySnapshot);
 }
 
 void ezFileSystem::Shutdown()
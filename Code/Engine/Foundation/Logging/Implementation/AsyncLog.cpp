@@ -0,0 +1,404 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, AsyncLog)
+
+  // no dependencies
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezGlobalLog::DisableAsyncLogging();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+namespace
+{
+  /// \brief Header of a message in an ezAsyncLogRingBuffer, followed by the zero terminated tag and text.
+  struct ezAsyncLogRecord
+  {
+    ezUInt64 m_uiSequence;
+    double m_fSeconds;
+    ezUInt32 m_uiSize; ///< Size of the whole record including the header, always a multiple of RECORD_ALIGNMENT.
+    ezUInt16 m_uiTagLength;
+    ezInt8 m_EventType;
+    ezUInt8 m_uiIndentation;
+    bool m_bIsPadding; ///< Fills up the remaining space at the end of the buffer when a record does not fit there anymore.
+    bool m_bHasText;
+  };
+
+  // every record starts at a multiple of this, so the space at the end of the buffer is always large enough for a padding record
+  static constexpr ezUInt32 RECORD_ALIGNMENT = 64;
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezAsyncLogRecord) <= RECORD_ALIGNMENT);
+
+  /// \brief Lock-free single producer / single consumer ring buffer of log messages.
+  ///
+  /// Every thread that logs owns one buffer and is the only producer. Consumers are serialized through s_DrainMutex.
+  /// The read and write positions only ever increase, the actual offset in the buffer is the position modulo the buffer size.
+  struct ezAsyncLogRingBuffer
+  {
+    ezAsyncLogRingBuffer(ezUInt32 uiSize)
+    {
+      m_uiSize = uiSize;
+
+      // use new, not EZ_DEFAULT_NEW, to prevent tracking, the buffers live as long as the threads that may log to them
+      m_pData = new ezUInt8[m_uiSize];
+    }
+
+    bool Push(const ezLoggingEventData& le, ezUInt64 uiSequence)
+    {
+      const ezUInt32 uiTagLength = ezMath::Min(ezStringUtils::GetStringElementCount(le.m_szTag), 255u);
+      ezUInt32 uiTextLength = (le.m_szText != nullptr) ? ezStringUtils::GetStringElementCount(le.m_szText) : 0;
+
+      // overly long messages are cut off, so that a single message can never take up more than a quarter of the buffer
+      const ezUInt32 uiMaxTextLength = m_uiSize / 4 - sizeof(ezAsyncLogRecord) - uiTagLength - 2;
+      uiTextLength = ezMath::Min(uiTextLength, uiMaxTextLength);
+
+      const ezUInt32 uiRecordSize = ezMemoryUtils::AlignSize<ezUInt32>(sizeof(ezAsyncLogRecord) + uiTagLength + 1 + uiTextLength + 1, RECORD_ALIGNMENT);
+
+      const ezUInt64 uiWritePos = static_cast<ezUInt64>(static_cast<ezInt64>(m_iWritePos));
+      const ezUInt64 uiReadPos = static_cast<ezUInt64>(static_cast<ezInt64>(m_iReadPos));
+
+      const ezUInt32 uiOffset = static_cast<ezUInt32>(uiWritePos & (m_uiSize - 1));
+      const ezUInt32 uiSpaceToEnd = m_uiSize - uiOffset;
+      const ezUInt32 uiPaddingSize = (uiSpaceToEnd < uiRecordSize) ? uiSpaceToEnd : 0;
+
+      if (uiWritePos + uiPaddingSize + uiRecordSize - uiReadPos > m_uiSize)
+      {
+        m_iDroppedMessages.Increment();
+        return false;
+      }
+
+      ezUInt64 uiNewWritePos = uiWritePos;
+
+      if (uiPaddingSize > 0)
+      {
+        ezAsyncLogRecord* pPadding = reinterpret_cast<ezAsyncLogRecord*>(m_pData + uiOffset);
+        pPadding->m_uiSize = uiPaddingSize;
+        pPadding->m_bIsPadding = true;
+
+        uiNewWritePos += uiPaddingSize;
+      }
+
+      ezUInt8* pRecordData = m_pData + (uiNewWritePos & (m_uiSize - 1));
+
+      ezAsyncLogRecord* pRecord = reinterpret_cast<ezAsyncLogRecord*>(pRecordData);
+      pRecord->m_uiSequence = uiSequence;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      pRecord->m_fSeconds = le.m_fSeconds;
+#else
+      pRecord->m_fSeconds = 0;
+#endif
+      pRecord->m_uiSize = uiRecordSize;
+      pRecord->m_uiTagLength = static_cast<ezUInt16>(uiTagLength);
+      pRecord->m_EventType = le.m_EventType;
+      pRecord->m_uiIndentation = le.m_uiIndentation;
+      pRecord->m_bIsPadding = false;
+      pRecord->m_bHasText = (le.m_szText != nullptr);
+
+      char* szTag = reinterpret_cast<char*>(pRecordData + sizeof(ezAsyncLogRecord));
+      ezMemoryUtils::Copy(szTag, le.m_szTag, uiTagLength);
+      szTag[uiTagLength] = '\0';
+
+      char* szText = szTag + uiTagLength + 1;
+      ezMemoryUtils::Copy(szText, le.m_szText, uiTextLength);
+      szText[uiTextLength] = '\0';
+
+      uiNewWritePos += uiRecordSize;
+
+      // publishes the record to the consumer
+      m_iWritePos = static_cast<ezInt64>(uiNewWritePos);
+      return true;
+    }
+
+    /// \brief Returns the oldest record or nullptr if the buffer is empty. Only called by the consumer.
+    const ezAsyncLogRecord* Peek()
+    {
+      ezUInt64 uiReadPos = static_cast<ezUInt64>(static_cast<ezInt64>(m_iReadPos));
+      const ezUInt64 uiWritePos = static_cast<ezUInt64>(static_cast<ezInt64>(m_iWritePos));
+
+      while (uiReadPos < uiWritePos)
+      {
+        const ezAsyncLogRecord* pRecord = reinterpret_cast<const ezAsyncLogRecord*>(m_pData + (uiReadPos & (m_uiSize - 1)));
+        if (!pRecord->m_bIsPadding)
+          return pRecord;
+
+        uiReadPos += pRecord->m_uiSize;
+        m_iReadPos = static_cast<ezInt64>(uiReadPos);
+      }
+
+      return nullptr;
+    }
+
+    /// \brief Removes the record returned by Peek(). Only called by the consumer.
+    void Pop(const ezAsyncLogRecord* pRecord)
+    {
+      m_iReadPos = static_cast<ezInt64>(m_iReadPos) + pRecord->m_uiSize;
+    }
+
+    ezUInt32 GetUsedSize() const { return static_cast<ezUInt32>(static_cast<ezInt64>(m_iWritePos) - static_cast<ezInt64>(m_iReadPos)); }
+
+    ezUInt8* m_pData = nullptr;
+    ezUInt32 m_uiSize = 0;
+    ezAtomicInteger64 m_iWritePos;
+    ezAtomicInteger64 m_iReadPos;
+    ezAtomicInteger32 m_iDroppedMessages;
+    ezAtomicBool m_bInUse;
+
+    ezAsyncLogRingBuffer* m_pNext = nullptr;
+  };
+
+  /// \brief Hands the buffer of a thread back for reuse when the thread ends, so that short lived threads don't accumulate memory.
+  struct ezAsyncLogThreadBuffer
+  {
+    ~ezAsyncLogThreadBuffer()
+    {
+      if (m_pBuffer != nullptr)
+      {
+        m_pBuffer->m_bInUse = false;
+      }
+    }
+
+    ezAsyncLogRingBuffer* m_pBuffer = nullptr;
+  };
+
+  static ezAtomicBool s_bAsyncLoggingEnabled;
+  static ezAtomicInteger64 s_iNextSequence;
+  static ezAtomicInteger32 s_iDroppedMessages;
+  static ezUInt32 s_uiRingBufferSize = 64 * 1024; ///< Always a power of two.
+
+  // protects the list of buffers and serializes all consumers
+  static ezMutex s_DrainMutex;
+  static ezAsyncLogRingBuffer* s_pFirstBuffer = nullptr;
+
+  static thread_local ezAsyncLogThreadBuffer s_ThreadBuffer;
+  static thread_local bool s_bIsDraining = false;
+  static thread_local bool s_bIsAsyncLogThread = false;
+} // namespace
+
+/// \brief The background thread that passes the asynchronously logged messages to the log writers.
+class ezAsyncLogThread : public ezThread
+{
+public:
+  ezAsyncLogThread()
+    : ezThread("ezAsyncLog")
+  {
+  }
+
+  virtual ezUInt32 Run() override
+  {
+    // messages that the log writers log themselves are broadcast right away
+    s_bIsAsyncLogThread = true;
+
+    while (!m_bStop)
+    {
+      // producers never wait for this thread, so it regularly checks for new messages on its own and is only woken up early when a
+      // buffer is getting full
+      m_WakeUp.WaitForSignal(ezTime::Milliseconds(10));
+
+      ezGlobalLog::DrainAsyncLogMessages();
+    }
+
+    return 0;
+  }
+
+  ezAtomicBool m_bStop;
+  ezThreadSignal m_WakeUp;
+};
+
+static ezAsyncLogThread* s_pAsyncLogThread = nullptr;
+
+void ezGlobalLog::EnableAsyncLogging(ezUInt32 uiRingBufferSizePerThread /*= 64 * 1024*/)
+{
+  EZ_LOCK(s_DrainMutex);
+
+  s_uiRingBufferSize = ezMath::PowerOfTwo_Ceil(ezMath::Max(uiRingBufferSizePerThread, 16 * RECORD_ALIGNMENT));
+
+  if (s_pAsyncLogThread == nullptr)
+  {
+    // use new, not EZ_DEFAULT_NEW, to prevent tracking, logging may be enabled before any allocators are set up
+    s_pAsyncLogThread = new ezAsyncLogThread();
+    s_pAsyncLogThread->Start();
+  }
+
+  s_bAsyncLoggingEnabled = true;
+}
+
+void ezGlobalLog::DisableAsyncLogging()
+{
+  ezAsyncLogThread* pThread = nullptr;
+
+  {
+    EZ_LOCK(s_DrainMutex);
+
+    if (!s_bAsyncLoggingEnabled)
+      return;
+
+    s_bAsyncLoggingEnabled = false;
+
+    pThread = s_pAsyncLogThread;
+    s_pAsyncLogThread = nullptr;
+  }
+
+  // join outside of the lock, the thread may currently wait for it
+  pThread->m_bStop = true;
+  pThread->m_WakeUp.RaiseSignal();
+  pThread->Join();
+  delete pThread;
+
+  // pass on everything that was logged before logging became synchronous again, threads that were just pushing a message while the flag
+  // got cleared drain it themselves afterwards
+  DrainAsyncLogMessages();
+}
+
+bool ezGlobalLog::IsAsyncLoggingEnabled()
+{
+  return s_bAsyncLoggingEnabled;
+}
+
+void ezGlobalLog::FlushAsyncLogging()
+{
+  if (!s_bAsyncLoggingEnabled)
+    return;
+
+  DrainAsyncLogMessages();
+}
+
+ezUInt32 ezGlobalLog::GetDroppedAsyncMessageCount()
+{
+  return s_iDroppedMessages;
+}
+
+bool ezGlobalLog::EnqueueAsyncLogMessage(const ezLoggingEventData& le)
+{
+  if (!s_bAsyncLoggingEnabled || s_bIsDraining || s_bIsAsyncLogThread)
+    return false;
+
+  ezAsyncLogRingBuffer* pBuffer = s_ThreadBuffer.m_pBuffer;
+
+  if (pBuffer == nullptr)
+  {
+    EZ_LOCK(s_DrainMutex);
+
+    // take over the buffer of a thread that has ended, pending messages in it are still drained in order
+    for (ezAsyncLogRingBuffer* pFreeBuffer = s_pFirstBuffer; pFreeBuffer != nullptr; pFreeBuffer = pFreeBuffer->m_pNext)
+    {
+      if (!pFreeBuffer->m_bInUse && pFreeBuffer->m_uiSize == s_uiRingBufferSize)
+      {
+        pBuffer = pFreeBuffer;
+        break;
+      }
+    }
+
+    if (pBuffer == nullptr)
+    {
+      // use new, not EZ_DEFAULT_NEW, to prevent tracking, the buffer is kept alive until the process ends
+      pBuffer = new ezAsyncLogRingBuffer(s_uiRingBufferSize);
+      pBuffer->m_pNext = s_pFirstBuffer;
+      s_pFirstBuffer = pBuffer;
+    }
+
+    pBuffer->m_bInUse = true;
+    s_ThreadBuffer.m_pBuffer = pBuffer;
+  }
+
+  const bool bPushed = pBuffer->Push(le, static_cast<ezUInt64>(s_iNextSequence.Increment()));
+
+  // DisableAsyncLogging() may have done its final drain between the check above and the push, in that case nobody else would ever
+  // pass on this message. Either this check sees the flag still set, then the final drain comes after the push and picks it up,
+  // or it sees it cleared and the message is drained right here.
+  if (!s_bAsyncLoggingEnabled)
+  {
+    DrainAsyncLogMessages();
+    return true;
+  }
+
+  if (bPushed && pBuffer->GetUsedSize() > pBuffer->m_uiSize / 2)
+  {
+    if (ezAsyncLogThread* pThread = s_pAsyncLogThread)
+    {
+      pThread->m_WakeUp.RaiseSignal();
+    }
+  }
+
+  return true;
+}
+
+void ezGlobalLog::DrainAsyncLogMessages()
+{
+  // an assert or crash while the log writers are called must not drain recursively
+  if (s_bIsDraining)
+    return;
+
+  EZ_LOCK(s_DrainMutex);
+
+  s_bIsDraining = true;
+
+  ezLoggingEventData le;
+
+  while (true)
+  {
+    // always pass on the oldest message of all buffers first
+    ezAsyncLogRingBuffer* pOldestBuffer = nullptr;
+    const ezAsyncLogRecord* pOldestRecord = nullptr;
+
+    for (ezAsyncLogRingBuffer* pBuffer = s_pFirstBuffer; pBuffer != nullptr; pBuffer = pBuffer->m_pNext)
+    {
+      const ezAsyncLogRecord* pRecord = pBuffer->Peek();
+
+      if (pRecord == nullptr)
+      {
+        const ezInt32 iDroppedMessages = pBuffer->m_iDroppedMessages.Set(0);
+        if (iDroppedMessages > 0)
+        {
+          s_iDroppedMessages.Add(iDroppedMessages);
+
+          ezStringBuilder sText;
+          sText.Format("{0} log messages were dropped because the asynchronous log buffer of a thread was full.", iDroppedMessages);
+
+          le.m_EventType = ezLogMsgType::WarningMsg;
+          le.m_uiIndentation = 0;
+          le.m_szText = sText;
+          le.m_szTag = "";
+          s_LoggingEvent.Broadcast(le);
+        }
+
+        continue;
+      }
+
+      if (pOldestRecord == nullptr || pRecord->m_uiSequence < pOldestRecord->m_uiSequence)
+      {
+        pOldestBuffer = pBuffer;
+        pOldestRecord = pRecord;
+      }
+    }
+
+    if (pOldestRecord == nullptr)
+      break;
+
+    const char* szTag = reinterpret_cast<const char*>(pOldestRecord) + sizeof(ezAsyncLogRecord);
+
+    le.m_EventType = static_cast<ezLogMsgType::Enum>(pOldestRecord->m_EventType);
+    le.m_uiIndentation = pOldestRecord->m_uiIndentation;
+    le.m_szTag = szTag;
+    le.m_szText = pOldestRecord->m_bHasText ? szTag + pOldestRecord->m_uiTagLength + 1 : nullptr;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    le.m_fSeconds = pOldestRecord->m_fSeconds;
+#endif
+
+    s_LoggingEvent.Broadcast(le);
+
+    pOldestBuffer->Pop(pOldestRecord);
+  }
+
+  s_bIsDraining = false;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Logging_Implementation_AsyncLog);
@@ -76,6 +76,9 @@ void ezGlobalLog::HandleLogMessage(const ezLoggingEventData& le)
     if ((ThisType > ezLogMsgType::None) && (ThisType < ezLogMsgType::All))
       s_uiMessageCount[ThisType].Increment();
 
+    if (EnqueueAsyncLogMessage(le))
+      return;
+
     s_LoggingEvent.Broadcast(le);
   }
 }
@@ -117,7 +117,38 @@ public:
   /// override is set at the moment.
   static void SetGlobalLogOverride(ezLogInterface* pInterface);
 
+  /// \brief Switches the log writers to an asynchronous backend.
+  ///
+  /// By default every message is passed to all log writers on the thread that logged it, which includes file I/O. With asynchronous
+  /// logging enabled, each thread copies its messages into its own lock-free ring buffer of \a uiRingBufferSizePerThread bytes instead.
+  /// A background thread drains the buffers of all threads in the order in which the messages were logged and passes them on to the log
+  /// writers, so log writers get called from that thread or from FlushAsyncLogging(). If the buffer of a thread is full, its messages are
+  /// dropped and the number of dropped messages is reported through a warning once the buffer was drained.
+  /// Message counts and the global log override are still handled synchronously. Threads that already logged keep their buffer size.
+  static void EnableAsyncLogging(ezUInt32 uiRingBufferSizePerThread = 64 * 1024);
+
+  /// \brief Passes all pending messages to the log writers, stops the background thread and switches back to synchronous logging.
+  ///
+  /// This is called automatically when the core systems are shut down.
+  static void DisableAsyncLogging();
+
+  /// \brief Returns whether EnableAsyncLogging() is active.
+  static bool IsAsyncLoggingEnabled();
+
+  /// \brief Blocks until all messages that were logged so far have been passed to the log writers.
+  ///
+  /// Called by the default assert and crash handlers, so that no messages are lost. Does nothing if asynchronous logging is disabled.
+  static void FlushAsyncLogging();
+
+  /// \brief Returns how many messages were dropped in total because the ring buffer of the logging thread was full.
+  static ezUInt32 GetDroppedAsyncMessageCount();
+
 private:
+  friend class ezAsyncLogThread;
+
+  static bool EnqueueAsyncLogMessage(const ezLoggingEventData& le);
+  static void DrainAsyncLogMessages();
+
   /// \brief Counts the number of messages of each type.
   static ezAtomicInteger32 s_uiMessageCount[ezLogMsgType::ENUM_COUNT];
 
@@ -9,6 +9,7 @@
 #include <Foundation/Memory/Policies/GuardedAllocation.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Memory/Policies/ProxyAllocation.h>
+#include <Foundation/Memory/Policies/SizeClassAllocation.h>
 
 
 /// \brief Default heap allocator
@@ -20,6 +21,9 @@ typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation> ezHeapAllocator;
 /// \brief Guarded allocator
 typedef ezAllocator<ezMemoryPolicies::ezGuardedAllocation> ezGuardedAllocator;
 
+/// \brief Size class allocator with thread local caches, well suited for many small and short-lived allocations
+typedef ezAllocator<ezMemoryPolicies::ezSizeClassAllocation> ezSizeClassAllocator;
+
 /// \brief Proxy allocator
 typedef ezAllocator<ezMemoryPolicies::ezProxyAllocation> ezProxyAllocator;
 
@@ -1,5 +1,25 @@
 namespace ezInternal
 {
+  /// \brief Stored in front of every allocation of allocators with the EnableSampling flag, since the tracker does not know the size of allocations
+  /// that were not sampled.
+  struct SampledAllocationHeader
+  {
+    ezUInt32 m_uiOffset; ///< distance from the start of the allocation to the user pointer
+    ezUInt32 m_bSampled;
+    size_t m_uiSize;
+
+    EZ_ALWAYS_INLINE static size_t GetOffset(size_t uiAlign)
+    {
+      // the offset is a multiple of the alignment, so the user pointer keeps the alignment of the allocation
+      return ezMath::Max<size_t>(uiAlign, 16);
+    }
+
+    EZ_ALWAYS_INLINE static SampledAllocationHeader* Get(void* ptr)
+    {
+      return static_cast<SampledAllocationHeader*>(ezMemoryUtils::AddByteOffset(ptr, -static_cast<ptrdiff_t>(sizeof(SampledAllocationHeader))));
+    }
+  };
+
   template <typename AllocationPolicy, ezUInt32 TrackingFlags>
   class ezAllocatorImpl : public ezAllocatorBase
   {
@@ -17,6 +37,8 @@ namespace ezInternal
     ezAllocatorBase* GetParent() const;
 
   protected:
+    static constexpr bool UseSampling = (TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0 && (TrackingFlags & ezMemoryTrackingFlags::EnableSampling) != 0;
+
     AllocationPolicy m_allocator;
 
     ezAllocatorId m_Id;
@@ -46,7 +68,7 @@ EZ_FORCE_INLINE ezInternal::ezAllocatorImpl<A, TrackingFlags>::ezAllocatorImpl(c
 {
   if ((TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0)
   {
-    EZ_CHECK_AT_COMPILETIME_MSG((TrackingFlags & ~ezMemoryTrackingFlags::All) == 0, "Invalid tracking flags");
+    EZ_CHECK_AT_COMPILETIME_MSG((TrackingFlags & ~(ezMemoryTrackingFlags::All | ezMemoryTrackingFlags::EnableSampling)) == 0, "Invalid tracking flags");
     const ezUInt32 uiTrackingFlags = TrackingFlags;
     ezBitflags<ezMemoryTrackingFlags> flags = *reinterpret_cast<const ezBitflags<ezMemoryTrackingFlags>*>(&uiTrackingFlags);
     this->m_Id = ezMemoryTracker::RegisterAllocator(szName, flags, pParent != nullptr ? pParent->GetId() : ezAllocatorId());
@@ -73,7 +95,28 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
 
   EZ_ASSERT_DEBUG(ezMath::IsPowerOf2((ezUInt32)uiAlign), "Alignment must be power of two");
 
-  ezTime fAllocationTime = ezTime::Now();
+  // reading the time is not free, only do it when the allocation time is actually tracked
+  const ezTime fAllocationTime = (TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0 ? ezTime::Now() : ezTime();
+
+  if (UseSampling)
+  {
+    const size_t uiOffset = SampledAllocationHeader::GetOffset(uiAlign);
+
+    void* ptr = m_allocator.Allocate(uiSize + uiOffset, uiAlign);
+    EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate {0} bytes. Out of memory?", uiSize);
+
+    ptr = ezMemoryUtils::AddByteOffset(ptr, uiOffset);
+
+    ezBitflags<ezMemoryTrackingFlags> flags;
+    flags.SetValue(TrackingFlags);
+
+    SampledAllocationHeader* pHeader = SampledAllocationHeader::Get(ptr);
+    pHeader->m_uiOffset = static_cast<ezUInt32>(uiOffset);
+    pHeader->m_uiSize = uiSize;
+    pHeader->m_bSampled = ezMemoryTracker::AddSampledAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+
+    return ptr;
+  }
 
   void* ptr = m_allocator.Allocate(uiSize, uiAlign);
   EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate {0} bytes. Out of memory?", uiSize);
@@ -92,6 +135,18 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
 template <typename A, ezUInt32 TrackingFlags>
 void ezInternal::ezAllocatorImpl<A, TrackingFlags>::Deallocate(void* ptr)
 {
+  if (UseSampling)
+  {
+    if (ptr == nullptr)
+      return;
+
+    const SampledAllocationHeader* pHeader = SampledAllocationHeader::Get(ptr);
+    ezMemoryTracker::RemoveSampledAllocation(this->m_Id, ptr, pHeader->m_uiSize, pHeader->m_bSampled != 0);
+
+    m_allocator.Deallocate(ezMemoryUtils::AddByteOffset(ptr, -static_cast<ptrdiff_t>(pHeader->m_uiOffset)));
+    return;
+  }
+
   if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
   {
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
@@ -103,6 +158,11 @@ void ezInternal::ezAllocatorImpl<A, TrackingFlags>::Deallocate(void* ptr)
 template <typename A, ezUInt32 TrackingFlags>
 size_t ezInternal::ezAllocatorImpl<A, TrackingFlags>::AllocatedSize(const void* ptr)
 {
+  if (UseSampling)
+  {
+    return SampledAllocationHeader::Get(const_cast<void*>(ptr))->m_uiSize;
+  }
+
   if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
   {
     return ezMemoryTracker::GetAllocationInfo(this->m_Id, ptr).m_uiSize;
@@ -149,12 +209,35 @@ ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::ezAllocatorMixin
 template <typename A, ezUInt32 TrackingFlags>
 void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate(void* ptr, size_t uiCurrentSize, size_t uiNewSize, size_t uiAlign)
 {
+  if (ezAllocatorImpl<A, TrackingFlags>::UseSampling)
+  {
+    SampledAllocationHeader* pHeader = SampledAllocationHeader::Get(ptr);
+    ezMemoryTracker::RemoveSampledAllocation(this->m_Id, ptr, pHeader->m_uiSize, pHeader->m_bSampled != 0);
+
+    // the offset only depends on the alignment, so the header stays in front of the user pointer
+    const size_t uiOffset = pHeader->m_uiOffset;
+
+    ezTime fAllocationTime = ezTime::Now();
+
+    void* pNewMem = this->m_allocator.Reallocate(ezMemoryUtils::AddByteOffset(ptr, -static_cast<ptrdiff_t>(uiOffset)), uiCurrentSize + uiOffset, uiNewSize + uiOffset, uiAlign);
+    pNewMem = ezMemoryUtils::AddByteOffset(pNewMem, uiOffset);
+
+    ezBitflags<ezMemoryTrackingFlags> flags;
+    flags.SetValue(TrackingFlags);
+
+    pHeader = SampledAllocationHeader::Get(pNewMem);
+    pHeader->m_uiSize = uiNewSize;
+    pHeader->m_bSampled = ezMemoryTracker::AddSampledAllocation(this->m_Id, flags, pNewMem, uiNewSize, uiAlign, ezTime::Now() - fAllocationTime);
+
+    return pNewMem;
+  }
+
   if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
   {
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
 
-  ezTime fAllocationTime = ezTime::Now();
+  const ezTime fAllocationTime = (TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0 ? ezTime::Now() : ezTime();
 
   void* pNewMem = this->m_allocator.Reallocate(ptr, uiCurrentSize, uiNewSize, uiAlign);
 
@@ -7,6 +7,7 @@
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Strings/String.h>
 #include <Foundation/System/StackTracer.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
@@ -27,6 +28,43 @@ namespace
   };
 
 
+  enum
+  {
+    NUM_COUNTER_STRIPES = 8,
+    COUNTERS_PER_PAGE = 256,
+    MAX_COUNTER_PAGES = 256,
+  };
+
+  /// \brief Allocation counters of one allocator for a subset of all threads. Padded to a cache line, so that threads don't share it.
+  struct CounterStripe
+  {
+    ezAtomicInteger64 m_iNumAllocations;
+    ezAtomicInteger64 m_iNumDeallocations;
+    ezAtomicInteger64 m_iAllocatedBytes;
+    ezAtomicInteger64 m_iDeallocatedBytes;
+    ezAtomicInteger64 m_iAllocationTimeNs;
+
+    ezUInt8 m_Padding[64 - 5 * sizeof(ezInt64)];
+  };
+
+  struct AllocatorCounters
+  {
+    CounterStripe m_Stripes[NUM_COUNTER_STRIPES];
+  };
+
+  /// \brief The counters are sums over all stripes.
+  struct CounterTotals
+  {
+    ezInt64 m_iNumAllocations = 0;
+    ezInt64 m_iNumDeallocations = 0;
+    ezInt64 m_iAllocatedBytes = 0;
+    ezInt64 m_iDeallocatedBytes = 0;
+    ezInt64 m_iAllocationTimeNs = 0;
+  };
+
+  // The counters are addressed by the allocator index, so that they can be found without locking. Pages are never freed.
+  static AllocatorCounters* s_CounterPages[MAX_COUNTER_PAGES];
+
   struct AllocatorData
   {
     EZ_ALWAYS_INLINE AllocatorData() {}
@@ -36,7 +74,11 @@ namespace
 
     ezAllocatorId m_ParentId;
 
-    ezAllocatorBase::Stats m_Stats;
+    ezAllocatorBase::Stats m_Stats; ///< Set explicitly through SetAllocatorStats, the counters are added on top.
+    ezAllocatorBase::Stats m_CombinedStats;
+
+    ezInt64 m_iPerFrameAllocatedBytesStart = 0;
+    ezInt64 m_iPerFrameAllocationTimeNsStart = 0;
 
     ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
   };
@@ -58,6 +100,93 @@ namespace
   static bool s_bIsInitialized = false;
   static bool s_bIsInitializing = false;
 
+  static ezUInt32 s_uiSampleAllocations = 64;
+  static ezUInt64 s_uiSampleBytes = 0;
+
+  static ezAtomicInteger32 s_iNextCounterStripe;
+  static thread_local ezUInt32 s_uiCounterStripe = 0xFFFFFFFF;
+  static thread_local ezInt64 s_iSamplingCountdown = 0;
+
+  EZ_ALWAYS_INLINE AllocatorCounters& GetCounters(ezAllocatorId allocatorId)
+  {
+    const ezUInt32 uiIndex = allocatorId.m_InstanceIndex;
+    return s_CounterPages[uiIndex / COUNTERS_PER_PAGE][uiIndex % COUNTERS_PER_PAGE];
+  }
+
+  EZ_ALWAYS_INLINE CounterStripe& GetCounterStripe(ezAllocatorId allocatorId)
+  {
+    // threads are distributed over the stripes round robin, ideally every thread gets its own stripe
+    ezUInt32 uiStripe = s_uiCounterStripe;
+    if (uiStripe == 0xFFFFFFFF)
+    {
+      uiStripe = static_cast<ezUInt32>(s_iNextCounterStripe.PostIncrement()) % NUM_COUNTER_STRIPES;
+      s_uiCounterStripe = uiStripe;
+    }
+
+    return GetCounters(allocatorId).m_Stripes[uiStripe];
+  }
+
+  EZ_ALWAYS_INLINE void CountAllocation(ezAllocatorId allocatorId, size_t uiSize, ezTime allocationTime)
+  {
+    CounterStripe& stripe = GetCounterStripe(allocatorId);
+    stripe.m_iNumAllocations.Increment();
+    stripe.m_iAllocatedBytes.Add(static_cast<ezInt64>(uiSize));
+    stripe.m_iAllocationTimeNs.Add(static_cast<ezInt64>(allocationTime.GetNanoseconds()));
+  }
+
+  EZ_ALWAYS_INLINE void CountDeallocation(ezAllocatorId allocatorId, size_t uiSize)
+  {
+    CounterStripe& stripe = GetCounterStripe(allocatorId);
+    stripe.m_iNumDeallocations.Increment();
+    stripe.m_iDeallocatedBytes.Add(static_cast<ezInt64>(uiSize));
+  }
+
+  CounterTotals GetCounterTotals(ezAllocatorId allocatorId)
+  {
+    CounterTotals totals;
+    for (const CounterStripe& stripe : GetCounters(allocatorId).m_Stripes)
+    {
+      totals.m_iNumAllocations += stripe.m_iNumAllocations;
+      totals.m_iNumDeallocations += stripe.m_iNumDeallocations;
+      totals.m_iAllocatedBytes += stripe.m_iAllocatedBytes;
+      totals.m_iDeallocatedBytes += stripe.m_iDeallocatedBytes;
+      totals.m_iAllocationTimeNs += stripe.m_iAllocationTimeNs;
+    }
+
+    return totals;
+  }
+
+  /// \brief Combines the explicitly set stats with the counters. s_pTrackerData has to be locked.
+  const ezAllocatorBase::Stats& UpdateCombinedStats(ezAllocatorId allocatorId, AllocatorData& data)
+  {
+    const CounterTotals totals = GetCounterTotals(allocatorId);
+
+    ezAllocatorBase::Stats& stats = data.m_CombinedStats;
+    stats = data.m_Stats;
+    stats.m_uiNumAllocations += totals.m_iNumAllocations;
+    stats.m_uiNumDeallocations += totals.m_iNumDeallocations;
+    stats.m_uiAllocationSize += totals.m_iAllocatedBytes - totals.m_iDeallocatedBytes;
+    stats.m_uiPerFrameAllocationSize += totals.m_iAllocatedBytes - data.m_iPerFrameAllocatedBytesStart;
+    stats.m_PerFrameAllocationTime += ezTime::Nanoseconds(static_cast<double>(totals.m_iAllocationTimeNs - data.m_iPerFrameAllocationTimeNsStart));
+
+    return stats;
+  }
+
+  /// \brief Returns whether the current allocation should be recorded individually, based on a per-thread countdown.
+  EZ_ALWAYS_INLINE bool ShouldSampleAllocation(size_t uiSize)
+  {
+    s_iSamplingCountdown -= s_uiSampleBytes != 0 ? static_cast<ezInt64>(uiSize) : 1;
+
+    if (s_iSamplingCountdown > 0)
+      return false;
+
+    const ezInt64 iInterval = s_uiSampleBytes != 0 ? static_cast<ezInt64>(s_uiSampleBytes) : static_cast<ezInt64>(s_uiSampleAllocations);
+
+    // a single allocation can be larger than several intervals
+    s_iSamplingCountdown = ezMath::Max<ezInt64>(s_iSamplingCountdown + iInterval, 1);
+    return true;
+  }
+
   static void Initialize()
   {
     if (s_bIsInitialized)
@@ -121,7 +250,7 @@ ezAllocatorId ezMemoryTracker::Iterator::ParentId() const
 
 const ezAllocatorBase::Stats& ezMemoryTracker::Iterator::Stats() const
 {
-  return CAST_ITER(m_pData)->Value().m_Stats;
+  return UpdateCombinedStats(CAST_ITER(m_pData)->Id(), CAST_ITER(m_pData)->Value());
 }
 
 void ezMemoryTracker::Iterator::Next()
@@ -156,6 +285,20 @@ ezAllocatorId ezMemoryTracker::RegisterAllocator(const char* szName, ezBitflags<
 
   ezAllocatorId id = s_pTrackerData->m_AllocatorData.Insert(data);
 
+  EZ_ASSERT_RELEASE(id.m_InstanceIndex < MAX_COUNTER_PAGES * COUNTERS_PER_PAGE, "Too many allocators");
+
+  AllocatorCounters*& pCounterPage = s_CounterPages[id.m_InstanceIndex / COUNTERS_PER_PAGE];
+  if (pCounterPage == nullptr)
+  {
+    pCounterPage = EZ_NEW_RAW_BUFFER(s_pTrackerDataAllocator, AllocatorCounters, COUNTERS_PER_PAGE);
+    ezMemoryUtils::ZeroFill(pCounterPage, COUNTERS_PER_PAGE);
+  }
+  else
+  {
+    // the index might have been used by an allocator that is deregistered already
+    ezMemoryUtils::ZeroFill(&GetCounters(id), 1);
+  }
+
   if (data.m_sName == EZ_STATIC_ALLOCATOR_NAME)
   {
     s_pTrackerData->m_StaticAllocatorId = id;
@@ -169,9 +312,16 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+
+  ezUInt64 uiLiveAllocations = data.m_Allocations.GetCount();
+  if (data.m_Flags.IsSet(ezMemoryTrackingFlags::EnableSampling))
+  {
+    // only a sample of the allocations is known individually
+    const ezAllocatorBase::Stats& stats = UpdateCombinedStats(allocatorId, data);
+    uiLiveAllocations = stats.m_uiNumAllocations - stats.m_uiNumDeallocations;
+  }
 
-  ezUInt32 uiLiveAllocations = data.m_Allocations.GetCount();
   if (uiLiveAllocations != 0)
   {
     for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
@@ -202,14 +352,12 @@ void ezMemoryTracker::AddAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemo
     ezMemoryUtils::Copy(stackTrace.GetPtr(), pBuffer, uiNumTraces);
   }
 
+  CountAllocation(allocatorId, uiSize, allocationTime);
+
   {
     EZ_LOCK(*s_pTrackerData);
 
     AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-    data.m_Stats.m_uiNumAllocations++;
-    data.m_Stats.m_uiAllocationSize += uiSize;
-    data.m_Stats.m_uiPerFrameAllocationSize += uiSize;
-    data.m_Stats.m_PerFrameAllocationTime += allocationTime;
 
     EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
     auto pInfo = &data.m_Allocations[ptr];
@@ -232,8 +380,7 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
     AllocationInfo info;
     if (data.m_Allocations.Remove(ptr, &info))
     {
-      data.m_Stats.m_uiNumDeallocations++;
-      data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+      CountDeallocation(allocatorId, info.m_uiSize);
 
       stackTrace = info.GetStackTrace();
     }
@@ -251,23 +398,68 @@ void ezMemoryTracker::RemoveAllAllocations(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
   AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+
+  // with sampling not all allocations are known, so the stats are adjusted as a whole
+  const ezAllocatorBase::Stats& stats = UpdateCombinedStats(allocatorId, data);
+  data.m_Stats.m_uiNumDeallocations += stats.m_uiNumAllocations - stats.m_uiNumDeallocations;
+  data.m_Stats.m_uiAllocationSize -= stats.m_uiAllocationSize;
+
   for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
   {
-    auto& info = it.Value();
-    data.m_Stats.m_uiNumDeallocations++;
-    data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
-
-    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
+    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, it.Value().GetStackTrace());
   }
   data.m_Allocations.Clear();
 }
 
+// static
+bool ezMemoryTracker::AddSampledAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemoryTrackingFlags> flags, const void* ptr, size_t uiSize,
+  size_t uiAlign, ezTime allocationTime)
+{
+  if (!ShouldSampleAllocation(uiSize))
+  {
+    CountAllocation(allocatorId, uiSize, allocationTime);
+    return false;
+  }
+
+  AddAllocation(allocatorId, flags, ptr, uiSize, uiAlign, allocationTime);
+  return true;
+}
+
+// static
+void ezMemoryTracker::RemoveSampledAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize, bool bSampled)
+{
+  if (bSampled)
+  {
+    RemoveAllocation(allocatorId, ptr);
+  }
+  else
+  {
+    CountDeallocation(allocatorId, uiSize);
+  }
+}
+
+// static
+void ezMemoryTracker::SetSamplingInterval(ezUInt32 uiSampleAllocations, ezUInt64 uiSampleBytes)
+{
+  s_uiSampleAllocations = ezMath::Max(uiSampleAllocations, 1u);
+  s_uiSampleBytes = uiSampleBytes;
+}
+
 // static
 void ezMemoryTracker::SetAllocatorStats(ezAllocatorId allocatorId, const ezAllocatorBase::Stats& stats)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  s_pTrackerData->m_AllocatorData[allocatorId].m_Stats = stats;
+  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+  data.m_Stats = stats;
+
+  // the given stats replace everything that was counted so far
+  const CounterTotals totals = GetCounterTotals(allocatorId);
+  data.m_Stats.m_uiNumAllocations -= totals.m_iNumAllocations;
+  data.m_Stats.m_uiNumDeallocations -= totals.m_iNumDeallocations;
+  data.m_Stats.m_uiAllocationSize -= totals.m_iAllocatedBytes - totals.m_iDeallocatedBytes;
+  data.m_Stats.m_uiPerFrameAllocationSize -= totals.m_iAllocatedBytes - data.m_iPerFrameAllocatedBytesStart;
+  data.m_Stats.m_PerFrameAllocationTime -= ezTime::Nanoseconds(static_cast<double>(totals.m_iAllocationTimeNs - data.m_iPerFrameAllocationTimeNsStart));
 }
 
 // static
@@ -280,6 +472,10 @@ void ezMemoryTracker::ResetPerFrameAllocatorStats()
     AllocatorData& data = it.Value();
     data.m_Stats.m_uiPerFrameAllocationSize = 0;
     data.m_Stats.m_PerFrameAllocationTime.SetZero();
+
+    const CounterTotals totals = GetCounterTotals(it.Id());
+    data.m_iPerFrameAllocatedBytesStart = totals.m_iAllocatedBytes;
+    data.m_iPerFrameAllocationTimeNsStart = totals.m_iAllocationTimeNs;
   }
 }
 
@@ -296,7 +492,7 @@ const ezAllocatorBase::Stats& ezMemoryTracker::GetAllocatorStats(ezAllocatorId a
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_Stats;
+  return UpdateCombinedStats(allocatorId, s_pTrackerData->m_AllocatorData[allocatorId]);
 }
 
 // static
@@ -14,6 +14,7 @@ struct ezMemoryTrackingFlags
     RegisterAllocator = EZ_BIT(0), ///< Register the allocator with the memory tracker. If EnableAllocationTracking is not set as well it is up to the allocator implementation whether it collects usable stats or not.
     EnableAllocationTracking = EZ_BIT(1), ///< Enable tracking of individual allocations
     EnableStackTrace = EZ_BIT(2), ///< Enable stack traces for each allocation
+    EnableSampling = EZ_BIT(3), ///< Only record some allocations individually, see ezMemoryTracker::SetSamplingInterval. The allocator stats stay exact. Requires EnableAllocationTracking.
 
     All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace,
 
@@ -23,6 +24,9 @@ struct ezMemoryTrackingFlags
 #endif
 #if EZ_ENABLED(EZ_USE_ALLOCATION_STACK_TRACING)
               | EnableStackTrace
+#endif
+#if EZ_ENABLED(EZ_USE_ALLOCATION_SAMPLING)
+              | EnableSampling
 #endif
   };
 
@@ -31,6 +35,7 @@ struct ezMemoryTrackingFlags
     StorageType RegisterAllocator : 1;
     StorageType EnableAllocationTracking : 1;
     StorageType EnableStackTrace : 1;
+    StorageType EnableSampling : 1;
   };
 };
 
@@ -39,6 +44,10 @@ struct ezMemoryTrackingFlags
 #define EZ_STATIC_ALLOCATOR_NAME "Statics"
 
 /// \brief Memory tracker which keeps track of all allocations and constructions
+///
+/// The allocator stats are kept in eight cache line sized stripes of atomic counters per allocator. Threads are assigned to the stripes round robin,
+/// so updating the stats needs no lock and rarely contends. Only recording individual allocations, which is needed for leak reports and
+/// stack traces, requires a global lock. Allocators with the EnableSampling flag only record a fraction of their allocations to reduce that cost.
 class EZ_FOUNDATION_DLL ezMemoryTracker
 {
 public:
@@ -107,6 +116,20 @@ public:
     ezTime allocationTime);
   static void RemoveAllocation(ezAllocatorId allocatorId, const void* ptr);
   static void RemoveAllAllocations(ezAllocatorId allocatorId);
+
+  /// \brief Counts the allocation of an allocator with the EnableSampling flag and records it individually if it is selected for sampling.
+  ///
+  /// Returns whether the allocation was recorded. The allocator has to pass this on to RemoveSampledAllocation.
+  static bool AddSampledAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemoryTrackingFlags> flags, const void* ptr, size_t uiSize,
+    size_t uiAlign, ezTime allocationTime);
+  static void RemoveSampledAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize, bool bSampled);
+
+  /// \brief Sets how often allocators with the EnableSampling flag record allocations individually.
+  ///
+  /// If uiSampleBytes is zero, every uiSampleAllocations-th allocation of a thread is recorded. Otherwise one allocation per uiSampleBytes
+  /// allocated bytes is recorded, which prefers large allocations. The default is to record every 64th allocation.
+  static void SetSamplingInterval(ezUInt32 uiSampleAllocations, ezUInt64 uiSampleBytes = 0);
+
   static void SetAllocatorStats(ezAllocatorId allocatorId, const ezAllocatorBase::Stats& stats);
 
   static void ResetPerFrameAllocatorStats();
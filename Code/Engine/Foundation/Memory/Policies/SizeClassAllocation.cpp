@@ -0,0 +1,654 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Memory/Policies/SizeClassAllocation.h>
+#include <Foundation/Threading/Lock.h>
+
+using namespace ezMemoryPolicies;
+
+namespace
+{
+  enum
+  {
+    SpanSizeShift = 15,
+    SpanSize = 1 << SpanSizeShift,
+    ChunkSizeShift = 18,
+    ChunkSize = 1 << ChunkSizeShift,
+    SpanHeaderSize = 64,
+
+    AddressBits = sizeof(void*) * 8 > 48 ? 48 : sizeof(void*) * 8,
+
+    // with 32 bit addresses all chunks fit into a single leaf and the root only has one entry
+    ChunkMapLeafBits = AddressBits - ChunkSizeShift < 16 ? AddressBits - ChunkSizeShift : 16,
+    ChunkMapLeafSize = 1 << ChunkMapLeafBits,
+    ChunkMapRootBits = AddressBits - ChunkSizeShift - ChunkMapLeafBits,
+    ChunkMapRootSize = 1 << ChunkMapRootBits,
+  };
+
+  EZ_CHECK_AT_COMPILETIME_MSG(ChunkMapRootBits + ChunkMapLeafBits + ChunkSizeShift == AddressBits, "The chunk map has to cover the whole address space");
+
+  // One byte per chunk of the address space that tells whether the chunk belongs to a size class allocator.
+  // This is how deallocations distinguish small blocks from large allocations that were forwarded to the heap.
+  // The leaves are allocated on demand and never freed.
+  ezUInt8* s_ChunkMap[ChunkMapRootSize];
+
+  EZ_ALWAYS_INLINE bool IsInChunk(const void* ptr)
+  {
+    const size_t uiChunk = reinterpret_cast<size_t>(ptr) >> ChunkSizeShift;
+    const size_t uiRoot = uiChunk >> ChunkMapLeafBits;
+    if (uiRoot >= ChunkMapRootSize)
+      return false;
+
+    const ezUInt8* pLeaf = s_ChunkMap[uiRoot];
+    return pLeaf != nullptr && pLeaf[uiChunk & (ChunkMapLeafSize - 1)] != 0;
+  }
+
+  void SetInChunk(const void* pChunk, bool bInChunk)
+  {
+    const size_t uiChunk = reinterpret_cast<size_t>(pChunk) >> ChunkSizeShift;
+    const size_t uiRoot = uiChunk >> ChunkMapLeafBits;
+    EZ_ASSERT_DEV(uiRoot < ChunkMapRootSize, "Chunk address is outside of the supported address space");
+
+    if (s_ChunkMap[uiRoot] == nullptr)
+    {
+      void* pNewLeaf = calloc(ChunkMapLeafSize, 1);
+      if (!ezAtomicUtils::TestAndSet(reinterpret_cast<void**>(&s_ChunkMap[uiRoot]), nullptr, pNewLeaf))
+      {
+        free(pNewLeaf);
+      }
+    }
+
+    s_ChunkMap[uiRoot][uiChunk & (ChunkMapLeafSize - 1)] = bInChunk ? 1 : 0;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetBatchSize(ezUInt32 uiSizeClass)
+  {
+    // roughly 8 KB per batch, but at least a few blocks for the large size classes
+    return ezMath::Clamp<ezUInt32>(8192 / ezSizeClassAllocation::GetSizeClassSize(uiSizeClass), 4, 64);
+  }
+
+  EZ_ALWAYS_INLINE void*& NextBlock(void* pBlock)
+  {
+    return static_cast<void**>(pBlock)[0];
+  }
+
+  ezMutex& GetLiveAllocatorsMutex()
+  {
+    static ezMutex s_Mutex;
+    return s_Mutex;
+  }
+
+  ezSizeClassAllocation* s_pLiveAllocators = nullptr;
+  ezInt64 s_iNextAllocatorId = 0;
+} // namespace
+
+
+/// Stored at the start of every span, all blocks of a span belong to the same size class.
+struct ezSizeClassAllocation::Span
+{
+  ezUInt32 m_uiSizeClass;
+  ezUInt32 m_uiNumUsedBlocks; ///< blocks that are in use or in a thread cache
+  void* m_pFreeBlocks;        ///< blocks that were returned to the span
+  ezUInt8* m_pUnusedBlocks;   ///< the blocks from here to the end of the span were never handed out
+  Span* m_pNext;              ///< in the list of spans of the size class that have blocks left, or in the list of free spans
+  Span* m_pPrev;
+
+  // only used in the first span of a chunk
+  ezUInt32 m_uiNumUsedSpans;
+  Span* m_pNextChunk;
+  Span* m_pPrevChunk;
+
+  EZ_ALWAYS_INLINE bool HasBlocksLeft(ezUInt32 uiBlockSize) const
+  {
+    return m_pFreeBlocks != nullptr || m_pUnusedBlocks + uiBlockSize <= reinterpret_cast<const ezUInt8*>(this) + SpanSize;
+  }
+
+  static void Link(Span*& pHead, Span* pSpan)
+  {
+    pSpan->m_pPrev = nullptr;
+    pSpan->m_pNext = pHead;
+    if (pHead != nullptr)
+    {
+      pHead->m_pPrev = pSpan;
+    }
+    pHead = pSpan;
+  }
+
+  static void Unlink(Span*& pHead, Span* pSpan)
+  {
+    if (pSpan->m_pPrev != nullptr)
+    {
+      pSpan->m_pPrev->m_pNext = pSpan->m_pNext;
+    }
+    else
+    {
+      pHead = pSpan->m_pNext;
+    }
+
+    if (pSpan->m_pNext != nullptr)
+    {
+      pSpan->m_pNext->m_pPrev = pSpan->m_pPrev;
+    }
+  }
+};
+
+struct ezSizeClassAllocation::ThreadCache
+{
+  struct FreeList
+  {
+    void* m_pHead;
+    ezUInt32 m_uiCount;
+  };
+
+  FreeList m_Lists[NumSizeClasses];
+
+  ThreadCache* m_pNext;
+  ThreadCache* m_pNextFree;
+};
+
+/// Every thread keeps its caches in a small table. An allocator is looked up in the slot its id maps to first, but can use any free slot,
+/// so allocators that map to the same slot don't evict each other. Allocators might get destroyed while other threads still reference
+/// their caches, so the id is used to check whether the cache is still valid before it is returned to its allocator.
+struct ezSizeClassAllocation::ThreadCacheTable
+{
+  enum
+  {
+    NumSlots = 16
+  };
+
+  struct Slot
+  {
+    ezUInt64 m_uiAllocatorId;
+    ThreadCache* m_pCache;
+  };
+
+  ~ThreadCacheTable()
+  {
+    for (ezUInt32 i = 0; i < NumSlots; ++i)
+    {
+      Release(m_Slots[i]);
+    }
+
+    m_bDestroyed = true;
+  }
+
+  /// \brief Must be called with the live allocators mutex locked.
+  static ezSizeClassAllocation* FindLiveAllocator(ezUInt64 uiAllocatorId)
+  {
+    for (ezSizeClassAllocation* pAllocator = s_pLiveAllocators; pAllocator != nullptr; pAllocator = pAllocator->m_pNextLiveAllocator)
+    {
+      if (pAllocator->m_uiAllocatorId == uiAllocatorId)
+        return pAllocator;
+    }
+
+    return nullptr;
+  }
+
+  static void Release(Slot& slot)
+  {
+    if (slot.m_pCache != nullptr)
+    {
+      EZ_LOCK(GetLiveAllocatorsMutex());
+
+      if (ezSizeClassAllocation* pAllocator = FindLiveAllocator(slot.m_uiAllocatorId))
+      {
+        pAllocator->ReturnThreadCache(slot.m_pCache);
+      }
+    }
+
+    slot.m_uiAllocatorId = 0;
+    slot.m_pCache = nullptr;
+  }
+
+  /// \brief Returns the slot that holds the cache of the given allocator, or an empty slot for it.
+  Slot& FindSlot(ezUInt64 uiAllocatorId)
+  {
+    Slot* pEmptySlot = nullptr;
+    for (Slot& slot : m_Slots)
+    {
+      if (slot.m_uiAllocatorId == uiAllocatorId)
+        return slot;
+
+      if (pEmptySlot == nullptr && slot.m_pCache == nullptr)
+        pEmptySlot = &slot;
+    }
+
+    if (pEmptySlot != nullptr)
+      return *pEmptySlot;
+
+    // slots of allocators that were destroyed in the meantime can be reused without evicting anything
+    {
+      EZ_LOCK(GetLiveAllocatorsMutex());
+
+      for (Slot& slot : m_Slots)
+      {
+        if (FindLiveAllocator(slot.m_uiAllocatorId) == nullptr)
+        {
+          slot.m_uiAllocatorId = 0;
+          slot.m_pCache = nullptr;
+          return slot;
+        }
+      }
+    }
+
+    // all slots are in use, only the cache in the slot that the id maps to is given back to its allocator
+    Slot& slot = m_Slots[uiAllocatorId & (NumSlots - 1)];
+    Release(slot);
+    return slot;
+  }
+
+  Slot m_Slots[NumSlots] = {};
+  bool m_bDestroyed = false;
+};
+
+ezSizeClassAllocation::ezSizeClassAllocation(ezAllocatorBase* pParent)
+    : m_Heap(pParent)
+{
+  m_uiAllocatorId = static_cast<ezUInt64>(ezAtomicUtils::Increment(s_iNextAllocatorId));
+
+  EZ_LOCK(GetLiveAllocatorsMutex());
+  m_pNextLiveAllocator = s_pLiveAllocators;
+  s_pLiveAllocators = this;
+}
+
+ezSizeClassAllocation::~ezSizeClassAllocation()
+{
+  {
+    EZ_LOCK(GetLiveAllocatorsMutex());
+
+    ezSizeClassAllocation** ppAllocator = &s_pLiveAllocators;
+    while (*ppAllocator != this)
+    {
+      ppAllocator = &(*ppAllocator)->m_pNextLiveAllocator;
+    }
+    *ppAllocator = m_pNextLiveAllocator;
+  }
+
+  while (m_pAllThreadCaches != nullptr)
+  {
+    ThreadCache* pCache = m_pAllThreadCaches;
+    m_pAllThreadCaches = pCache->m_pNext;
+    m_Heap.Deallocate(pCache);
+  }
+
+  while (m_pChunks != nullptr)
+  {
+    Span* pChunk = m_pChunks;
+    m_pChunks = pChunk->m_pNextChunk;
+
+    SetInChunk(pChunk, false);
+    m_Heap.Deallocate(pChunk);
+  }
+}
+
+void* ezSizeClassAllocation::Allocate(size_t uiSize, size_t uiAlign)
+{
+  if (uiSize > MaxSmallAllocationSize || uiAlign > 16)
+  {
+    return m_Heap.Allocate(uiSize, uiAlign);
+  }
+
+  const ezUInt32 uiSizeClass = GetSizeClass(uiSize);
+
+  ThreadCache* pCache = GetThreadCache();
+  if (pCache == nullptr)
+  {
+    // the thread is shutting down and its cache table is already gone, go through a temporary cache instead
+    ThreadCache tempCache = {};
+    void* ptr = AllocateFromCentral(&tempCache, uiSizeClass);
+    FlushThreadCache(&tempCache);
+    return ptr;
+  }
+
+  ThreadCache::FreeList& list = pCache->m_Lists[uiSizeClass];
+  if (list.m_pHead != nullptr)
+  {
+    void* ptr = list.m_pHead;
+    list.m_pHead = NextBlock(ptr);
+    --list.m_uiCount;
+    return ptr;
+  }
+
+  return AllocateFromCentral(pCache, uiSizeClass);
+}
+
+void* ezSizeClassAllocation::Reallocate(void* ptr, size_t uiCurrentSize, size_t uiNewSize, size_t uiAlign)
+{
+  if (IsInChunk(ptr) && uiNewSize <= MaxSmallAllocationSize && uiAlign <= 16 && GetSpan(ptr)->m_uiSizeClass == GetSizeClass(uiNewSize))
+  {
+    return ptr;
+  }
+
+  void* pNewMem = Allocate(uiNewSize, uiAlign);
+  ezMemoryUtils::RawByteCopy(pNewMem, ptr, ezMath::Min(uiCurrentSize, uiNewSize));
+  Deallocate(ptr);
+
+  return pNewMem;
+}
+
+void ezSizeClassAllocation::Deallocate(void* ptr)
+{
+  if (!IsInChunk(ptr))
+  {
+    m_Heap.Deallocate(ptr);
+    return;
+  }
+
+  const ezUInt32 uiSizeClass = GetSpan(ptr)->m_uiSizeClass;
+
+  ThreadCache* pCache = GetThreadCache();
+  if (pCache == nullptr)
+  {
+    NextBlock(ptr) = nullptr;
+    ReturnBlocksToCentral(ptr, uiSizeClass);
+    return;
+  }
+
+  ThreadCache::FreeList& list = pCache->m_Lists[uiSizeClass];
+  NextBlock(ptr) = list.m_pHead;
+  list.m_pHead = ptr;
+  ++list.m_uiCount;
+
+  if (list.m_uiCount >= 2 * GetBatchSize(uiSizeClass))
+  {
+    ReturnBatchToCentral(pCache, uiSizeClass);
+  }
+}
+
+// static
+ezUInt32 ezSizeClassAllocation::GetSizeClass(size_t uiSize)
+{
+  // 16 byte steps up to 256 bytes, then 32 byte steps up to 512, 64 byte steps up to 1024 and 128 byte steps up to 2048 bytes
+  uiSize = ezMath::Max<size_t>(uiSize, 1);
+
+  if (uiSize <= 256)
+    return static_cast<ezUInt32>((uiSize + 15) >> 4) - 1;
+  if (uiSize <= 512)
+    return 15 + static_cast<ezUInt32>((uiSize - 256 + 31) >> 5);
+  if (uiSize <= 1024)
+    return 23 + static_cast<ezUInt32>((uiSize - 512 + 63) >> 6);
+
+  return 31 + static_cast<ezUInt32>((uiSize - 1024 + 127) >> 7);
+}
+
+// static
+ezUInt32 ezSizeClassAllocation::GetSizeClassSize(ezUInt32 uiSizeClass)
+{
+  if (uiSizeClass < 16)
+    return (uiSizeClass + 1) * 16;
+  if (uiSizeClass < 24)
+    return 256 + (uiSizeClass - 15) * 32;
+  if (uiSizeClass < 32)
+    return 512 + (uiSizeClass - 23) * 64;
+
+  return 1024 + (uiSizeClass - 31) * 128;
+}
+
+size_t ezSizeClassAllocation::GetReservedSmallAllocationSize() const
+{
+  return static_cast<size_t>(m_uiNumChunks) * ChunkSize;
+}
+
+// static
+EZ_ALWAYS_INLINE ezSizeClassAllocation::Span* ezSizeClassAllocation::GetSpan(const void* ptr)
+{
+  return reinterpret_cast<Span*>(reinterpret_cast<size_t>(ptr) & ~static_cast<size_t>(SpanSize - 1));
+}
+
+// static
+EZ_ALWAYS_INLINE ezSizeClassAllocation::Span* ezSizeClassAllocation::GetChunk(const void* ptr)
+{
+  return reinterpret_cast<Span*>(reinterpret_cast<size_t>(ptr) & ~static_cast<size_t>(ChunkSize - 1));
+}
+
+// static
+ezSizeClassAllocation::ThreadCacheTable* ezSizeClassAllocation::GetThreadCacheTable()
+{
+  static thread_local ThreadCacheTable s_Table;
+  return s_Table.m_bDestroyed ? nullptr : &s_Table;
+}
+
+ezSizeClassAllocation::ThreadCache* ezSizeClassAllocation::GetThreadCache()
+{
+  ThreadCacheTable* pTable = GetThreadCacheTable();
+  if (pTable == nullptr)
+    return nullptr;
+
+  ThreadCacheTable::Slot& homeSlot = pTable->m_Slots[m_uiAllocatorId & (ThreadCacheTable::NumSlots - 1)];
+  if (homeSlot.m_uiAllocatorId == m_uiAllocatorId)
+    return homeSlot.m_pCache;
+
+  ThreadCacheTable::Slot& slot = pTable->FindSlot(m_uiAllocatorId);
+  if (slot.m_uiAllocatorId != m_uiAllocatorId)
+  {
+    slot.m_pCache = AcquireThreadCache();
+    slot.m_uiAllocatorId = m_uiAllocatorId;
+  }
+
+  return slot.m_pCache;
+}
+
+ezSizeClassAllocation::ThreadCache* ezSizeClassAllocation::AcquireThreadCache()
+{
+  EZ_LOCK(m_Mutex);
+
+  ThreadCache* pCache = m_pFreeThreadCaches;
+  if (pCache != nullptr)
+  {
+    m_pFreeThreadCaches = pCache->m_pNextFree;
+    return pCache;
+  }
+
+  pCache = static_cast<ThreadCache*>(m_Heap.Allocate(sizeof(ThreadCache), EZ_ALIGNMENT_OF(ThreadCache)));
+  ezMemoryUtils::ZeroFill(pCache, 1);
+
+  pCache->m_pNext = m_pAllThreadCaches;
+  m_pAllThreadCaches = pCache;
+
+  return pCache;
+}
+
+void ezSizeClassAllocation::ReturnThreadCache(ThreadCache* pCache)
+{
+  FlushThreadCache(pCache);
+
+  EZ_LOCK(m_Mutex);
+  pCache->m_pNextFree = m_pFreeThreadCaches;
+  m_pFreeThreadCaches = pCache;
+}
+
+void ezSizeClassAllocation::FlushThreadCache(ThreadCache* pCache)
+{
+  for (ezUInt32 uiSizeClass = 0; uiSizeClass < NumSizeClasses; ++uiSizeClass)
+  {
+    ThreadCache::FreeList& list = pCache->m_Lists[uiSizeClass];
+    if (list.m_pHead == nullptr)
+      continue;
+
+    ReturnBlocksToCentral(list.m_pHead, uiSizeClass);
+
+    list.m_pHead = nullptr;
+    list.m_uiCount = 0;
+  }
+}
+
+void* ezSizeClassAllocation::AllocateFromCentral(ThreadCache* pCache, ezUInt32 uiSizeClass)
+{
+  SizeClass& sizeClass = m_SizeClasses[uiSizeClass];
+  ThreadCache::FreeList& list = pCache->m_Lists[uiSizeClass];
+  const ezUInt32 uiBlockSize = GetSizeClassSize(uiSizeClass);
+  const ezUInt32 uiBatchSize = GetBatchSize(uiSizeClass);
+
+  void* pBlocks = nullptr;
+  ezUInt32 uiCount = 0;
+
+  EZ_LOCK(sizeClass.m_Mutex);
+
+  // a new span is only needed when there is no block left at all, otherwise a partial batch is fine
+  if (sizeClass.m_pSpans == nullptr)
+  {
+    Span::Link(sizeClass.m_pSpans, AllocateSpan(uiSizeClass));
+  }
+
+  while (uiCount < uiBatchSize && sizeClass.m_pSpans != nullptr)
+  {
+    Span* pSpan = sizeClass.m_pSpans;
+
+    // returned blocks are handed out first, so that spans with few used blocks get a chance to run empty
+    while (uiCount < uiBatchSize && pSpan->m_pFreeBlocks != nullptr)
+    {
+      void* pBlock = pSpan->m_pFreeBlocks;
+      pSpan->m_pFreeBlocks = NextBlock(pBlock);
+
+      NextBlock(pBlock) = pBlocks;
+      pBlocks = pBlock;
+      ++uiCount;
+      ++pSpan->m_uiNumUsedBlocks;
+    }
+
+    while (uiCount < uiBatchSize && pSpan->HasBlocksLeft(uiBlockSize))
+    {
+      void* pBlock = pSpan->m_pUnusedBlocks;
+      pSpan->m_pUnusedBlocks += uiBlockSize;
+
+      NextBlock(pBlock) = pBlocks;
+      pBlocks = pBlock;
+      ++uiCount;
+      ++pSpan->m_uiNumUsedBlocks;
+    }
+
+    if (!pSpan->HasBlocksLeft(uiBlockSize))
+    {
+      Span::Unlink(sizeClass.m_pSpans, pSpan);
+    }
+  }
+
+  list.m_pHead = NextBlock(pBlocks);
+  list.m_uiCount = uiCount - 1;
+
+  return pBlocks;
+}
+
+void ezSizeClassAllocation::ReturnBatchToCentral(ThreadCache* pCache, ezUInt32 uiSizeClass)
+{
+  ThreadCache::FreeList& list = pCache->m_Lists[uiSizeClass];
+  const ezUInt32 uiBatchSize = GetBatchSize(uiSizeClass);
+
+  void* pBatch = list.m_pHead;
+  void* pTail = pBatch;
+  for (ezUInt32 i = 1; i < uiBatchSize; ++i)
+  {
+    pTail = NextBlock(pTail);
+  }
+
+  list.m_pHead = NextBlock(pTail);
+  list.m_uiCount -= uiBatchSize;
+  NextBlock(pTail) = nullptr;
+
+  ReturnBlocksToCentral(pBatch, uiSizeClass);
+}
+
+void ezSizeClassAllocation::ReturnBlocksToCentral(void* pBlocks, ezUInt32 uiSizeClass)
+{
+  SizeClass& sizeClass = m_SizeClasses[uiSizeClass];
+  const ezUInt32 uiBlockSize = GetSizeClassSize(uiSizeClass);
+
+  EZ_LOCK(sizeClass.m_Mutex);
+
+  while (pBlocks != nullptr)
+  {
+    void* pBlock = pBlocks;
+    pBlocks = NextBlock(pBlock);
+
+    Span* pSpan = GetSpan(pBlock);
+    if (!pSpan->HasBlocksLeft(uiBlockSize))
+    {
+      Span::Link(sizeClass.m_pSpans, pSpan);
+    }
+
+    NextBlock(pBlock) = pSpan->m_pFreeBlocks;
+    pSpan->m_pFreeBlocks = pBlock;
+
+    if (--pSpan->m_uiNumUsedBlocks == 0)
+    {
+      Span::Unlink(sizeClass.m_pSpans, pSpan);
+      FreeSpan(pSpan);
+    }
+  }
+}
+
+ezSizeClassAllocation::Span* ezSizeClassAllocation::AllocateSpan(ezUInt32 uiSizeClass)
+{
+  static_assert(sizeof(Span) <= SpanHeaderSize, "The span header does not fit in front of the first block");
+
+  EZ_LOCK(m_Mutex);
+
+  if (m_pFreeSpans == nullptr)
+  {
+    Span* pChunk = static_cast<Span*>(m_Heap.Allocate(ChunkSize, ChunkSize));
+    pChunk->m_uiNumUsedSpans = 0;
+    pChunk->m_pPrevChunk = nullptr;
+    pChunk->m_pNextChunk = m_pChunks;
+    if (m_pChunks != nullptr)
+    {
+      m_pChunks->m_pPrevChunk = pChunk;
+    }
+    m_pChunks = pChunk;
+    ++m_uiNumChunks;
+
+    SetInChunk(pChunk, true);
+
+    for (ezUInt32 i = 0; i < ChunkSize / SpanSize; ++i)
+    {
+      Span::Link(m_pFreeSpans, reinterpret_cast<Span*>(reinterpret_cast<ezUInt8*>(pChunk) + i * SpanSize));
+    }
+  }
+
+  Span* pSpan = m_pFreeSpans;
+  Span::Unlink(m_pFreeSpans, pSpan);
+  ++GetChunk(pSpan)->m_uiNumUsedSpans;
+
+  pSpan->m_uiSizeClass = uiSizeClass;
+  pSpan->m_uiNumUsedBlocks = 0;
+  pSpan->m_pFreeBlocks = nullptr;
+  pSpan->m_pUnusedBlocks = reinterpret_cast<ezUInt8*>(pSpan) + SpanHeaderSize;
+
+  return pSpan;
+}
+
+void ezSizeClassAllocation::FreeSpan(Span* pSpan)
+{
+  EZ_LOCK(m_Mutex);
+
+  Span::Link(m_pFreeSpans, pSpan);
+
+  Span* pChunk = GetChunk(pSpan);
+  if (--pChunk->m_uiNumUsedSpans > 0)
+    return;
+
+  // all spans of the chunk are free, give its memory back to the heap
+  for (ezUInt32 i = 0; i < ChunkSize / SpanSize; ++i)
+  {
+    Span::Unlink(m_pFreeSpans, reinterpret_cast<Span*>(reinterpret_cast<ezUInt8*>(pChunk) + i * SpanSize));
+  }
+
+  if (pChunk->m_pPrevChunk != nullptr)
+  {
+    pChunk->m_pPrevChunk->m_pNextChunk = pChunk->m_pNextChunk;
+  }
+  else
+  {
+    m_pChunks = pChunk->m_pNextChunk;
+  }
+
+  if (pChunk->m_pNextChunk != nullptr)
+  {
+    pChunk->m_pNextChunk->m_pPrevChunk = pChunk->m_pPrevChunk;
+  }
+
+  --m_uiNumChunks;
+
+  SetInChunk(pChunk, false);
+  m_Heap.Deallocate(pChunk);
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Policies_SizeClassAllocation);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Foundation/Memory/Policies/AlignedHeapAllocation.h>
+#include <Foundation/Threading/Mutex.h>
+
+namespace ezMemoryPolicies
+{
+  /// \brief Allocation policy that serves small allocations from size classes with thread local caches.
+  ///
+  /// Allocations up to MaxSmallAllocationSize bytes with an alignment of up to 16 bytes are rounded up to one of the size classes.
+  /// Every thread has its own cache of free blocks per size class, so most allocations and deallocations don't need any synchronization.
+  /// When a thread cache runs empty it fetches a whole batch of blocks from the central pool of the size class, when it holds too many
+  /// free blocks it returns a batch to the central pool. Blocks that are freed on another thread than they were allocated on simply go
+  /// into the cache of the freeing thread.
+  ///
+  /// The central pool hands out blocks from spans. A span whose blocks have all been returned to the central pool goes back to the
+  /// allocator, where it can be reused for any size class, and the memory of a chunk is given back to the heap once all of its spans are free.
+  /// Larger allocations are forwarded to ezAlignedHeapAllocation.
+  ///
+  /// \see ezAllocator
+  class EZ_FOUNDATION_DLL ezSizeClassAllocation
+  {
+  public:
+    enum
+    {
+      NumSizeClasses = 40,
+      MaxSmallAllocationSize = 2048,
+    };
+
+    ezSizeClassAllocation(ezAllocatorBase* pParent);
+    ~ezSizeClassAllocation();
+
+    void* Allocate(size_t uiSize, size_t uiAlign);
+    void* Reallocate(void* ptr, size_t uiCurrentSize, size_t uiNewSize, size_t uiAlign);
+    void Deallocate(void* ptr);
+
+    EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return nullptr; }
+
+    /// \brief Returns the size class that is used for small allocations of the given size.
+    static ezUInt32 GetSizeClass(size_t uiSize);
+
+    /// \brief Returns the size of the blocks of the given size class.
+    static ezUInt32 GetSizeClassSize(ezUInt32 uiSizeClass);
+
+    /// \brief Returns how many bytes are currently reserved from the heap for small allocations.
+    size_t GetReservedSmallAllocationSize() const;
+
+  private:
+    struct Span;
+    struct ThreadCache;
+    struct ThreadCacheTable;
+
+    struct SizeClass
+    {
+      ezMutex m_Mutex;
+      Span* m_pSpans = nullptr; ///< The spans of this size class that have blocks left to hand out.
+    };
+
+    static Span* GetSpan(const void* ptr);
+    static Span* GetChunk(const void* ptr);
+
+    static ThreadCacheTable* GetThreadCacheTable();
+    ThreadCache* GetThreadCache();
+    ThreadCache* AcquireThreadCache();
+    void ReturnThreadCache(ThreadCache* pCache);
+    void FlushThreadCache(ThreadCache* pCache);
+
+    void* AllocateFromCentral(ThreadCache* pCache, ezUInt32 uiSizeClass);
+    void ReturnBatchToCentral(ThreadCache* pCache, ezUInt32 uiSizeClass);
+    void ReturnBlocksToCentral(void* pBlocks, ezUInt32 uiSizeClass);
+    Span* AllocateSpan(ezUInt32 uiSizeClass);
+    void FreeSpan(Span* pSpan);
+
+    ezAlignedHeapAllocation m_Heap;
+    ezUInt64 m_uiAllocatorId;
+    ezSizeClassAllocation* m_pNextLiveAllocator;
+
+    SizeClass m_SizeClasses[NumSizeClasses];
+
+    // protects the chunks, the free spans and the thread cache lists
+    ezMutex m_Mutex;
+    Span* m_pChunks = nullptr;
+    Span* m_pFreeSpans = nullptr;
+    ezUInt32 m_uiNumChunks = 0;
+
+    ThreadCache* m_pAllThreadCaches = nullptr;
+    ThreadCache* m_pFreeThreadCaches = nullptr;
+  };
+} // namespace ezMemoryPolicies
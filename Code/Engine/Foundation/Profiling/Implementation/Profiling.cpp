@@ -1,11 +1,14 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
 #include <Foundation/Communication/DataTransfer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
 #include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/Stream.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/ThreadUtils.h>
@@ -52,46 +55,65 @@ namespace
 {
   enum
   {
-    BUFFER_SIZE_OTHER_THREAD = 1024 * 1024,
-    BUFFER_SIZE_MAIN_THREAD = BUFFER_SIZE_OTHER_THREAD * 4 ///< Typically the main thread allocated a lot more profiling events than other threads
+    NUM_EVENTS_OTHER_THREAD = 32 * 1024, ///< Has to be a power of two
+    NUM_EVENTS_MAIN_THREAD = NUM_EVENTS_OTHER_THREAD * 4 ///< Typically the main thread allocated a lot more profiling events than other threads
   };
 
   enum
   {
     BUFFER_SIZE_FRAMES = 120 * 60,
+    BUFFER_SIZE_GPU_SCOPES = 1024 * 1024,
+    NAME_CACHE_SIZE = 256, ///< Has to be a power of two
   };
 
-  typedef ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)> GPUScopesBuffer;
+  typedef ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_GPU_SCOPES / sizeof(ezProfilingSystem::GPUScope)> GPUScopesBuffer;
 
-  static ezUInt64 s_MainThreadId = 0;
-
-  struct CpuScopesBufferBase
+  /// \brief Single producer ring buffer for the scopes of one thread.
+  ///
+  /// Only the owning thread writes into the buffer and it never waits for readers. Readers copy the events without any locking
+  /// and afterwards discard everything that might have been overwritten while they were copying.
+  struct CpuScopesBuffer
   {
-    virtual ~CpuScopesBufferBase() = default;
-
-    ezUInt64 m_uiThreadId = 0;
-    bool IsMainThread() const
+    explicit CpuScopesBuffer(ezUInt32 uiCapacity)
     {
-      return m_uiThreadId == s_MainThreadId;
+      m_Data.SetCountUninitialized(uiCapacity);
     }
-  };
 
-  template <ezUInt32 SizeInBytes>
-  struct CpuScopesBuffer : public CpuScopesBufferBase
-  {
-    ezStaticRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
+    ezUInt64 m_uiThreadId = 0;
+    ezDynamicArray<ezProfilingSystem::CPUScope> m_Data;
+
+    ezInt64 m_iNextWriteIndex = 0;   ///< Only accessed by the owning thread
+    ezAtomicInteger64 m_iWriteIndex; ///< Total number of events that have been written to the buffer
+    ezAtomicInteger64 m_iClearIndex; ///< Events before this index have been discarded by Clear()
+    ezInt64 m_iStreamIndex = 0;      ///< Events before this index have already been streamed, protected by s_StreamingMutex
   };
 
-  CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>* CastToMainThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
+  /// \brief Appends all events of the buffer from iFirstIndex on that are still valid and returns the index after the last copied event.
+  ezInt64 CopyEvents(const CpuScopesBuffer& buffer, ezInt64 iFirstIndex, ezDynamicArray<ezProfilingSystem::CPUScope>& out_Scopes)
   {
-    EZ_ASSERT_DEV(pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>*>(pEventBuffer);
-  }
+    const ezInt64 iCapacity = buffer.m_Data.GetCount();
+    const ezInt64 iEndIndex = buffer.m_iWriteIndex;
+    iFirstIndex = ezMath::Max(ezMath::Max(iFirstIndex, iEndIndex - iCapacity), static_cast<ezInt64>(buffer.m_iClearIndex));
 
-  CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>* CastToOtherThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
-  {
-    EZ_ASSERT_DEV(!pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>*>(pEventBuffer);
+    if (iFirstIndex >= iEndIndex)
+      return iEndIndex;
+
+    const ezUInt32 uiStartCount = out_Scopes.GetCount();
+    out_Scopes.SetCountUninitialized(uiStartCount + static_cast<ezUInt32>(iEndIndex - iFirstIndex));
+    for (ezInt64 i = iFirstIndex; i < iEndIndex; ++i)
+    {
+      out_Scopes[uiStartCount + static_cast<ezUInt32>(i - iFirstIndex)] = buffer.m_Data[static_cast<ezUInt32>(i & (iCapacity - 1))];
+    }
+
+    // The owning thread might have overwritten the oldest events in the meantime, including the one it is writing right now.
+    const ezInt64 iFirstValidIndex = buffer.m_iWriteIndex + 1 - iCapacity;
+    if (iFirstValidIndex > iFirstIndex)
+    {
+      const ezInt64 iNumInvalid = ezMath::Min(iFirstValidIndex - iFirstIndex, iEndIndex - iFirstIndex);
+      out_Scopes.RemoveAtAndCopy(uiStartCount, static_cast<ezUInt32>(iNumInvalid));
+    }
+
+    return iEndIndex;
   }
 
   ezCVarFloat CVarDiscardThresholdMs("g_ProfilingDiscardThresholdMs", 0.1f, ezCVarFlags::Default, "Discard profiling scopes if their duration is shorter than the specified threshold.");
@@ -101,33 +123,255 @@ namespace
 
   static ezHybridArray<ezProfilingSystem::ThreadInfo, 16> s_ThreadInfos;
   static ezHybridArray<ezUInt64, 16> s_DeadThreadIDs;
+  static ezUInt32 s_uiThreadInfosVersion = 0;
   static ezMutex s_ThreadInfosMutex;
 
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::CPUScope) == 24);
 #  if EZ_ENABLED(EZ_PLATFORM_64BIT)
-  EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::CPUScope) == 64);
   EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::GPUScope) == 64);
 #  endif
 
-  static thread_local CpuScopesBufferBase* s_CpuScopes = nullptr;
-  static ezDynamicArray<CpuScopesBufferBase*> s_AllCpuScopes;
+  static thread_local CpuScopesBuffer* s_CpuScopes = nullptr;
+  static ezDynamicArray<CpuScopesBuffer*> s_AllCpuScopes;
   static ezMutex s_AllCpuScopesMutex;
 
   static GPUScopesBuffer* s_GPUScopes;
+  static ezUInt64 s_uiGPUScopeCount = 0;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Scope name interning
+
+  /// \brief Maps name hashes or function name addresses to name ids, so that names only need to be looked up in the global table once per thread.
+  struct NameCache
+  {
+    ezUInt64 m_Keys[NAME_CACHE_SIZE];
+    ezUInt32 m_Ids[NAME_CACHE_SIZE];
+    ezUInt32 m_uiGeneration;
+  };
+
+  static thread_local NameCache s_ScopeNameCache;
+  static thread_local NameCache s_FunctionNameCache;
+
+  /// Incremented whenever a plugin is unloaded, since function names are cached by address and a new plugin might reuse those.
+  static volatile ezUInt32 s_uiFunctionNameCacheGeneration = 0;
+
+  static ezMutex s_ScopeNamesMutex;
+  static ezDynamicArray<ezString> s_ScopeNames;
+  static ezHashTable<ezUInt64, ezUInt32> s_ScopeNameIds;
+
+  ezUInt32 InternScopeName(ezUInt64 uiHash, const char* szName)
+  {
+    EZ_LOCK(s_ScopeNamesMutex);
+
+    ezUInt32 uiId = 0;
+    if (!s_ScopeNameIds.TryGetValue(uiHash, uiId))
+    {
+      if (s_ScopeNames.IsEmpty())
+      {
+        // id 0 is reserved for scopes without a name
+        s_ScopeNames.ExpandAndGetRef();
+      }
+
+      uiId = s_ScopeNames.GetCount();
+      s_ScopeNames.PushBack(szName);
+      s_ScopeNameIds.Insert(uiHash, uiId);
+    }
+
+    return uiId;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt64 HashScopeName(const char* szName)
+  {
+    return ezHashingUtils::xxHash64(szName, ezStringUtils::GetStringElementCount(szName));
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetScopeNameId(const char* szName)
+  {
+    if (ezStringUtils::IsNullOrEmpty(szName))
+      return 0;
+
+    // Names can be temporary strings, so they are identified by their hash
+    const ezUInt64 uiHash = HashScopeName(szName);
+    const ezUInt32 uiSlot = static_cast<ezUInt32>(uiHash) & (NAME_CACHE_SIZE - 1);
+
+    NameCache& cache = s_ScopeNameCache;
+    if (cache.m_Keys[uiSlot] != uiHash)
+    {
+      cache.m_Ids[uiSlot] = InternScopeName(uiHash, szName);
+      cache.m_Keys[uiSlot] = uiHash;
+    }
+
+    return cache.m_Ids[uiSlot];
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetFunctionNameId(const char* szFunctionName)
+  {
+    if (szFunctionName == nullptr)
+      return 0;
+
+    NameCache& cache = s_FunctionNameCache;
+    if (cache.m_uiGeneration != s_uiFunctionNameCacheGeneration)
+    {
+      ezMemoryUtils::ZeroFill(cache.m_Keys, NAME_CACHE_SIZE);
+      cache.m_uiGeneration = s_uiFunctionNameCacheGeneration;
+    }
+
+    // Function names are string literals, so hashing them is only necessary once
+    const ezUInt64 uiKey = reinterpret_cast<size_t>(szFunctionName);
+    const ezUInt32 uiSlot = static_cast<ezUInt32>(uiKey ^ (uiKey >> 8)) & (NAME_CACHE_SIZE - 1);
+
+    if (cache.m_Keys[uiSlot] != uiKey)
+    {
+      cache.m_Ids[uiSlot] = InternScopeName(HashScopeName(szFunctionName), szFunctionName);
+      cache.m_Keys[uiSlot] = uiKey;
+    }
+
+    return cache.m_Ids[uiSlot];
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Binary streaming
+
+  /// \brief The binary format is a header followed by a sequence of chunks, each starting with its chunk type.
+  enum class BinaryChunk : ezUInt8
+  {
+    End,
+    ScopeNames,  ///< first id, count, names
+    ThreadInfos, ///< count, thread id and name for every thread
+    CPUScopes,   ///< thread id, count, raw CPUScope data
+    Frames,      ///< total frame count, count, frame start times
+    GPUScopes,   ///< count, begin, end and name for every scope
+  };
+
+  static constexpr ezUInt32 BINARY_FORMAT_TAG = 0x46504345; // 'ECPF'
+  static constexpr ezUInt8 BINARY_FORMAT_VERSION = 1;
+
+  static ezMutex s_StreamingMutex;
+  static ezStreamWriter* volatile s_pStream = nullptr;
+  static ezUInt32 s_uiNumStreamedScopeNames = 0;
+  static ezUInt32 s_uiStreamedThreadInfosVersion = 0;
+  static ezUInt64 s_uiNumStreamedFrames = 0;
+  static ezUInt64 s_uiNumStreamedGPUScopes = 0;
+  static ezDynamicArray<ezProfilingSystem::CPUScope> s_StreamedScopes;
+
+  void WriteChunkType(ezStreamWriter& stream, BinaryChunk chunk)
+  {
+    stream << static_cast<ezUInt8>(chunk);
+  }
+
+  /// \brief Writes everything that was recorded since the last call. s_StreamingMutex has to be locked.
+  void WriteStreamingData(ezStreamWriter& stream)
+  {
+    {
+      EZ_LOCK(s_ScopeNamesMutex);
+
+      const ezUInt32 uiNumNames = s_ScopeNames.GetCount();
+      if (uiNumNames > s_uiNumStreamedScopeNames)
+      {
+        WriteChunkType(stream, BinaryChunk::ScopeNames);
+        stream << s_uiNumStreamedScopeNames;
+        stream << (uiNumNames - s_uiNumStreamedScopeNames);
+
+        for (ezUInt32 i = s_uiNumStreamedScopeNames; i < uiNumNames; ++i)
+        {
+          stream << s_ScopeNames[i];
+        }
+
+        s_uiNumStreamedScopeNames = uiNumNames;
+      }
+    }
+
+    {
+      EZ_LOCK(s_ThreadInfosMutex);
+
+      if (s_uiThreadInfosVersion != s_uiStreamedThreadInfosVersion)
+      {
+        WriteChunkType(stream, BinaryChunk::ThreadInfos);
+        stream << s_ThreadInfos.GetCount();
+
+        for (const auto& info : s_ThreadInfos)
+        {
+          stream << info.m_uiThreadId;
+          stream << info.m_sName;
+        }
+
+        s_uiStreamedThreadInfosVersion = s_uiThreadInfosVersion;
+      }
+    }
+
+    {
+      EZ_LOCK(s_AllCpuScopesMutex);
+
+      for (CpuScopesBuffer* pEventBuffer : s_AllCpuScopes)
+      {
+        s_StreamedScopes.Clear();
+        pEventBuffer->m_iStreamIndex = CopyEvents(*pEventBuffer, pEventBuffer->m_iStreamIndex, s_StreamedScopes);
+
+        if (s_StreamedScopes.IsEmpty())
+          continue;
+
+        WriteChunkType(stream, BinaryChunk::CPUScopes);
+        stream << pEventBuffer->m_uiThreadId;
+        stream << s_StreamedScopes.GetCount();
+
+        // CPUScope is a POD without padding, so the events are written as raw memory
+        stream.WriteBytes(s_StreamedScopes.GetData(), s_StreamedScopes.GetCount() * sizeof(ezProfilingSystem::CPUScope));
+      }
+    }
+
+    {
+      const ezUInt32 uiNumFrames = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(s_uiFrameCount - s_uiNumStreamedFrames, s_FrameStartTimes.GetCount()));
+      if (uiNumFrames > 0)
+      {
+        WriteChunkType(stream, BinaryChunk::Frames);
+        stream << s_uiFrameCount;
+        stream << uiNumFrames;
+
+        for (ezUInt32 i = s_FrameStartTimes.GetCount() - uiNumFrames; i < s_FrameStartTimes.GetCount(); ++i)
+        {
+          stream << s_FrameStartTimes[i].GetSeconds();
+        }
+
+        s_uiNumStreamedFrames = s_uiFrameCount;
+      }
+    }
+
+    if (s_GPUScopes != nullptr)
+    {
+      const ezUInt32 uiNumScopes = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(s_uiGPUScopeCount - s_uiNumStreamedGPUScopes, s_GPUScopes->GetCount()));
+      if (uiNumScopes > 0)
+      {
+        WriteChunkType(stream, BinaryChunk::GPUScopes);
+        stream << uiNumScopes;
+
+        for (ezUInt32 i = s_GPUScopes->GetCount() - uiNumScopes; i < s_GPUScopes->GetCount(); ++i)
+        {
+          const ezProfilingSystem::GPUScope& scope = (*s_GPUScopes)[i];
+          stream << scope.m_BeginTime.GetSeconds();
+          stream << scope.m_EndTime.GetSeconds();
+          stream << static_cast<const char*>(scope.m_szName);
+        }
+
+        s_uiNumStreamedGPUScopes = s_uiGPUScopeCount;
+      }
+    }
+  }
 
   static ezEventSubscriptionID s_PluginEventSubscription = 0;
   void PluginEvent(const ezPluginEvent& e)
   {
     if (e.m_EventType == ezPluginEvent::AfterUnloading)
     {
-      // When a plugin is unloaded we need to clear all profiling data
-      // since they can contain pointers to function names that don't exist anymore.
-      ezProfilingSystem::Clear();
+      // Recorded scopes only store ids of interned names, so they stay valid when a plugin is unloaded.
+      // However the addresses of the plugin's function names might be reused, so the function name caches have to be invalidated.
+      s_uiFunctionNameCacheGeneration = s_uiFunctionNameCacheGeneration + 1;
     }
   }
 } // namespace
 
 void ezProfilingSystem::ProfilingData::Clear()
 {
+  m_ScopeNames.Clear();
   m_AllEventBuffers.Clear();
   m_FrameStartTimes.Clear();
   m_GPUScopes.Clear();
@@ -252,17 +496,19 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
 
       for (const CPUScope& e : sortedScopes)
       {
+        const char* szName = e.m_uiNameId < m_ScopeNames.GetCount() ? m_ScopeNames[e.m_uiNameId].GetData() : "";
+
         writer.BeginObject();
-        writer.AddVariableString("name", e.m_szName);
+        writer.AddVariableString("name", szName);
         writer.AddVariableUInt32("pid", m_uiProcessID);
         writer.AddVariableUInt64("tid", uiThreadId);
         writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_BeginTime.GetMicroseconds()));
         writer.AddVariableString("ph", "B");
 
-        if (e.m_szFunctionName != nullptr)
+        if (e.m_uiFunctionNameId != 0 && e.m_uiFunctionNameId < m_ScopeNames.GetCount())
         {
           writer.BeginObject("args");
-          writer.AddVariableString("function", e.m_szFunctionName);
+          writer.AddVariableString("function", m_ScopeNames[e.m_uiFunctionNameId]);
           writer.EndObject();
         }
 
@@ -271,7 +517,7 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
         if (e.m_EndTime.IsPositive())
         {
           writer.BeginObject();
-          writer.AddVariableString("name", e.m_szName);
+          writer.AddVariableString("name", szName);
           writer.AddVariableUInt32("pid", m_uiProcessID);
           writer.AddVariableUInt64("tid", uiThreadId);
           writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_EndTime.GetMicroseconds()));
@@ -357,21 +603,180 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
   return writer.HadWriteError() ? EZ_FAILURE : EZ_SUCCESS;
 }
 
-// static
-void ezProfilingSystem::Clear()
+ezResult ezProfilingSystem::ProfilingData::Read(ezStreamReader& inputStream)
 {
+  Clear();
+
+  m_uiFramesThreadID = 1;
+  m_uiGPUThreadID = 0;
+  m_uiFrameCount = 0;
+
+  ezUInt32 uiTag = 0;
+  ezUInt8 uiVersion = 0;
+  inputStream >> uiTag;
+  inputStream >> uiVersion;
+
+  if (uiTag != BINARY_FORMAT_TAG || uiVersion != BINARY_FORMAT_VERSION)
   {
-    EZ_LOCK(s_AllCpuScopesMutex);
-    for (auto pEventBuffer : s_AllCpuScopes)
+    ezLog::Error("Profiling data stream has an invalid tag or an unsupported version {}", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  ezUInt64 uiProcessID = 0;
+  inputStream >> uiProcessID;
+  m_uiProcessID = static_cast<ezOsProcessID>(uiProcessID);
+
+  ezStringBuilder sTemp;
+
+  while (true)
+  {
+    ezUInt8 uiChunk = 0;
+    if (inputStream.ReadBytes(&uiChunk, sizeof(ezUInt8)) != sizeof(ezUInt8))
+    {
+      // the recording was not stopped properly, everything that was written so far is still valid
+      break;
+    }
+
+    const BinaryChunk chunk = static_cast<BinaryChunk>(uiChunk);
+    if (chunk == BinaryChunk::End)
+      break;
+
+    ezUInt32 uiCount = 0;
+
+    switch (chunk)
     {
-      if (pEventBuffer->IsMainThread())
+      case BinaryChunk::ScopeNames:
+      {
+        ezUInt32 uiFirstId = 0;
+        inputStream >> uiFirstId;
+        inputStream >> uiCount;
+
+        m_ScopeNames.SetCount(uiFirstId + uiCount);
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          inputStream >> m_ScopeNames[uiFirstId + i];
+        }
+      }
+      break;
+
+      case BinaryChunk::ThreadInfos:
+      {
+        inputStream >> uiCount;
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          ezUInt64 uiThreadId = 0;
+          inputStream >> uiThreadId;
+          inputStream >> sTemp;
+
+          // threads are only added, keep the infos of threads that have been removed in the meantime
+          ThreadInfo* pInfo = nullptr;
+          for (auto& info : m_ThreadInfos)
+          {
+            if (info.m_uiThreadId == uiThreadId)
+            {
+              pInfo = &info;
+              break;
+            }
+          }
+
+          if (pInfo == nullptr)
+          {
+            pInfo = &m_ThreadInfos.ExpandAndGetRef();
+            pInfo->m_uiThreadId = uiThreadId;
+          }
+
+          pInfo->m_sName = sTemp;
+        }
+      }
+      break;
+
+      case BinaryChunk::CPUScopes:
+      {
+        ezUInt64 uiThreadId = 0;
+        inputStream >> uiThreadId;
+        inputStream >> uiCount;
+
+        CPUScopesBufferFlat* pEventBuffer = nullptr;
+        for (auto& eventBuffer : m_AllEventBuffers)
+        {
+          if (eventBuffer.m_uiThreadId == uiThreadId)
+          {
+            pEventBuffer = &eventBuffer;
+            break;
+          }
+        }
+
+        if (pEventBuffer == nullptr)
+        {
+          pEventBuffer = &m_AllEventBuffers.ExpandAndGetRef();
+          pEventBuffer->m_uiThreadId = uiThreadId;
+        }
+
+        const ezUInt32 uiStartCount = pEventBuffer->m_Data.GetCount();
+        pEventBuffer->m_Data.SetCountUninitialized(uiStartCount + uiCount);
+
+        const ezUInt64 uiNumBytes = uiCount * sizeof(CPUScope);
+        if (inputStream.ReadBytes(pEventBuffer->m_Data.GetData() + uiStartCount, uiNumBytes) != uiNumBytes)
+        {
+          pEventBuffer->m_Data.SetCountUninitialized(uiStartCount);
+          return EZ_SUCCESS;
+        }
+      }
+      break;
+
+      case BinaryChunk::Frames:
       {
-        CastToMainThreadEventBuffer(pEventBuffer)->m_Data.Clear();
+        inputStream >> m_uiFrameCount;
+        inputStream >> uiCount;
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          double fSeconds = 0;
+          inputStream >> fSeconds;
+          m_FrameStartTimes.PushBack(ezTime::Seconds(fSeconds));
+        }
       }
-      else
+      break;
+
+      case BinaryChunk::GPUScopes:
       {
-        CastToOtherThreadEventBuffer(pEventBuffer)->m_Data.Clear();
+        inputStream >> uiCount;
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          double fBeginTime = 0;
+          double fEndTime = 0;
+          inputStream >> fBeginTime;
+          inputStream >> fEndTime;
+          inputStream >> sTemp;
+
+          GPUScope& scope = m_GPUScopes.ExpandAndGetRef();
+          scope.m_BeginTime = ezTime::Seconds(fBeginTime);
+          scope.m_EndTime = ezTime::Seconds(fEndTime);
+          ezStringUtils::Copy(scope.m_szName, GPUScope::NAME_SIZE, sTemp);
+        }
       }
+      break;
+
+      default:
+        ezLog::Error("Profiling data stream contains an unknown chunk type {}", uiChunk);
+        return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+// static
+void ezProfilingSystem::Clear()
+{
+  {
+    EZ_LOCK(s_AllCpuScopesMutex);
+    for (auto pEventBuffer : s_AllCpuScopes)
+    {
+      // the buffers are written without locking, so instead of resetting them all events written so far are marked as discarded
+      pEventBuffer->m_iClearIndex = static_cast<ezInt64>(pEventBuffer->m_iWriteIndex);
     }
   }
 
@@ -415,24 +820,19 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& profilingData,
     profilingData.m_AllEventBuffers.Reserve(s_AllCpuScopes.GetCount());
     for (ezUInt32 i = 0; i < s_AllCpuScopes.GetCount(); ++i)
     {
-      const auto& sourceEventBuffer = s_AllCpuScopes[i];
+      const CpuScopesBuffer* pSourceEventBuffer = s_AllCpuScopes[i];
       CPUScopesBufferFlat& targetEventBuffer = profilingData.m_AllEventBuffers.ExpandAndGetRef();
 
-      targetEventBuffer.m_uiThreadId = sourceEventBuffer->m_uiThreadId;
+      targetEventBuffer.m_uiThreadId = pSourceEventBuffer->m_uiThreadId;
+      CopyEvents(*pSourceEventBuffer, 0, targetEventBuffer.m_Data);
+    }
+  }
 
-      ezUInt32 uiSourceCount = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount() : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount();
-      targetEventBuffer.m_Data.SetCountUninitialized(uiSourceCount);
-      for (ezUInt32 j = 0; j < uiSourceCount; ++j)
-      {
-        const CPUScope& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[j] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[j];
+  {
+    // copy the names after the events, so that all ids that are referenced by the events are known
+    EZ_LOCK(s_ScopeNamesMutex);
 
-        CPUScope& copiedEvent = targetEventBuffer.m_Data[j];
-        copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
-        copiedEvent.m_BeginTime = sourceEvent.m_BeginTime;
-        copiedEvent.m_EndTime = sourceEvent.m_EndTime;
-        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
-      }
-    }
+    profilingData.m_ScopeNames = s_ScopeNames;
   }
 
   profilingData.m_uiFrameCount = s_uiFrameCount;
@@ -480,6 +880,71 @@ void ezProfilingSystem::StartNewFrame()
   }
 
   s_FrameStartTimes.PushBack(ezTime::Now());
+
+  if (s_pStream != nullptr)
+  {
+    FlushStreamingData();
+  }
+}
+
+// static
+void ezProfilingSystem::StartStreaming(ezStreamWriter& outputStream)
+{
+  EZ_LOCK(s_StreamingMutex);
+
+  EZ_ASSERT_DEV(s_pStream == nullptr, "Profiling data is already being streamed");
+
+  outputStream << BINARY_FORMAT_TAG;
+  outputStream << BINARY_FORMAT_VERSION;
+
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+  outputStream << static_cast<ezUInt64>(ezProcess::GetCurrentProcessID());
+#  else
+  outputStream << static_cast<ezUInt64>(0);
+#  endif
+
+  // only data that is recorded from now on is streamed
+  s_uiNumStreamedScopeNames = 0;
+  s_uiStreamedThreadInfosVersion = s_uiThreadInfosVersion - 1;
+  s_uiNumStreamedFrames = s_uiFrameCount;
+  s_uiNumStreamedGPUScopes = s_uiGPUScopeCount;
+
+  {
+    EZ_LOCK(s_AllCpuScopesMutex);
+    for (CpuScopesBuffer* pEventBuffer : s_AllCpuScopes)
+    {
+      pEventBuffer->m_iStreamIndex = pEventBuffer->m_iWriteIndex;
+    }
+  }
+
+  s_pStream = &outputStream;
+}
+
+// static
+void ezProfilingSystem::StopStreaming()
+{
+  EZ_LOCK(s_StreamingMutex);
+
+  if (s_pStream == nullptr)
+    return;
+
+  WriteStreamingData(*s_pStream);
+  WriteChunkType(*s_pStream, BinaryChunk::End);
+
+  s_pStream = nullptr;
+  s_StreamedScopes.Clear();
+  s_StreamedScopes.Compact();
+}
+
+// static
+void ezProfilingSystem::FlushStreamingData()
+{
+  EZ_LOCK(s_StreamingMutex);
+
+  if (s_pStream == nullptr)
+    return;
+
+  WriteStreamingData(*s_pStream);
 }
 
 // static
@@ -489,19 +954,11 @@ void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionNa
   if (endTime - beginTime < ezTime::Milliseconds(CVarDiscardThresholdMs))
     return;
 
-  ::CpuScopesBufferBase* pScopes = s_CpuScopes;
+  CpuScopesBuffer* pScopes = s_CpuScopes;
 
   if (pScopes == nullptr)
   {
-    if (ezThreadUtils::IsMainThread())
-    {
-      pScopes = EZ_DEFAULT_NEW(::CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>);
-    }
-    else
-    {
-      pScopes = EZ_DEFAULT_NEW(::CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>);
-    }
-
+    pScopes = EZ_DEFAULT_NEW(CpuScopesBuffer, ezThreadUtils::IsMainThread() ? NUM_EVENTS_MAIN_THREAD : NUM_EVENTS_OTHER_THREAD);
     pScopes->m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
     s_CpuScopes = pScopes;
 
@@ -511,32 +968,16 @@ void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionNa
     }
   }
 
-  CPUScope scope;
-  scope.m_szFunctionName = szFunctionName;
+  const ezInt64 iIndex = pScopes->m_iNextWriteIndex++;
+
+  CPUScope& scope = pScopes->m_Data[static_cast<ezUInt32>(iIndex) & (pScopes->m_Data.GetCount() - 1)];
+  scope.m_uiNameId = GetScopeNameId(szName);
+  scope.m_uiFunctionNameId = GetFunctionNameId(szFunctionName);
   scope.m_BeginTime = beginTime;
   scope.m_EndTime = endTime;
-  ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), szName);
-
-  if (ezThreadUtils::IsMainThread())
-  {
-    auto pMainThreadBuffer = CastToMainThreadEventBuffer(pScopes);
-    if (!pMainThreadBuffer->m_Data.CanAppend())
-    {
-      pMainThreadBuffer->m_Data.PopFront();
-    }
-
-    pMainThreadBuffer->m_Data.PushBack(scope);
-  }
-  else
-  {
-    auto pOtherThreadBuffer = CastToOtherThreadEventBuffer(pScopes);
-    if (!pOtherThreadBuffer->m_Data.CanAppend())
-    {
-      pOtherThreadBuffer->m_Data.PopFront();
-    }
 
-    pOtherThreadBuffer->m_Data.PushBack(scope);
-  }
+  // publish the event, the oldest event is overwritten if the buffer is full
+  pScopes->m_iWriteIndex = pScopes->m_iNextWriteIndex;
 }
 
 // static
@@ -544,8 +985,6 @@ void ezProfilingSystem::Initialize()
 {
   SetThreadName("Main Thread");
 
-  s_MainThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
-
   s_PluginEventSubscription = ezPlugin::s_PluginEvents.AddEventHandler(&PluginEvent);
 }
 
@@ -570,7 +1009,7 @@ void ezProfilingSystem::Reset()
     }
     for (ezUInt32 k = 0; k < s_AllCpuScopes.GetCount(); k++)
     {
-      CpuScopesBufferBase* pEventBuffer = s_AllCpuScopes[k];
+      CpuScopesBuffer* pEventBuffer = s_AllCpuScopes[k];
       if (pEventBuffer->m_uiThreadId == uiThreadId)
       {
         EZ_DEFAULT_DELETE(pEventBuffer);
@@ -580,6 +1019,7 @@ void ezProfilingSystem::Reset()
     }
   }
   s_DeadThreadIDs.Clear();
+  ++s_uiThreadInfosVersion;
 
   ezPlugin::s_PluginEvents.RemoveEventHandler(s_PluginEventSubscription);
 }
@@ -592,6 +1032,7 @@ void ezProfilingSystem::SetThreadName(const char* szThreadName)
   ThreadInfo& info = s_ThreadInfos.ExpandAndGetRef();
   info.m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
   info.m_sName = szThreadName;
+  ++s_uiThreadInfosVersion;
 }
 
 // static
@@ -628,6 +1069,7 @@ void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime
   ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), szName);
 
   s_GPUScopes->PushBack(scope);
+  ++s_uiGPUScopeCount;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -687,6 +1129,11 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
   return EZ_FAILURE;
 }
 
+ezResult ezProfilingSystem::ProfilingData::Read(ezStreamReader& inputStream)
+{
+  return EZ_FAILURE;
+}
+
 void ezProfilingSystem::Clear() {}
 
 void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& out_Capture, bool bClearAfterCapture) {}
@@ -695,6 +1142,12 @@ void ezProfilingSystem::SetDiscardThreshold(ezTime threshold) {}
 
 void ezProfilingSystem::StartNewFrame() {}
 
+void ezProfilingSystem::StartStreaming(ezStreamWriter& outputStream) {}
+
+void ezProfilingSystem::StopStreaming() {}
+
+void ezProfilingSystem::FlushStreamingData() {}
+
 void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime) {}
 
 void ezProfilingSystem::Initialize() {}
@@ -6,6 +6,7 @@
 #include <Foundation/System/Process.h>
 #include <Foundation/Time/Time.h>
 
+class ezStreamReader;
 class ezStreamWriter;
 class ezThread;
 
@@ -63,16 +64,15 @@ public:
     ezString m_sName;
   };
 
+  /// \brief A CPU profiling scope. Names are interned once by the profiling system, events only store the ids of their names.
   struct CPUScope
   {
     EZ_DECLARE_POD_TYPE();
 
-    static constexpr ezUInt32 NAME_SIZE = 40;
-
-    const char* m_szFunctionName;
+    ezUInt32 m_uiNameId;         ///< Index into ProfilingData::m_ScopeNames.
+    ezUInt32 m_uiFunctionNameId; ///< Index into ProfilingData::m_ScopeNames, 0 if the scope has no function name.
     ezTime m_BeginTime;
     ezTime m_EndTime;
-    char m_szName[NAME_SIZE];
   };
 
   struct CPUScopesBufferFlat
@@ -101,6 +101,8 @@ public:
 
     ezHybridArray<ThreadInfo, 16> m_ThreadInfos;
 
+    /// \brief All interned scope and function names, indexed by the ids stored in CPUScope. Index 0 is the empty name.
+    ezDynamicArray<ezString> m_ScopeNames;
     ezDynamicArray<CPUScopesBufferFlat> m_AllEventBuffers;
 
     ezUInt64 m_uiFrameCount;
@@ -111,6 +113,12 @@ public:
     /// \brief Writes profiling data as JSON to the output stream.
     ezResult Write(ezStreamWriter& outputStream) const;
 
+    /// \brief Reads profiling data from a binary stream that was recorded with ezProfilingSystem::StartStreaming().
+    ///
+    /// Together with Write() this converts a binary recording into the JSON format. A truncated stream, e.g. from a process that crashed
+    /// during recording, is not an error, everything up to the last complete chunk is read.
+    ezResult Read(ezStreamReader& inputStream);
+
     void Clear();
   };
 
@@ -123,9 +131,29 @@ public:
   static void SetDiscardThreshold(ezTime threshold);
 
   /// \brief Should be called once per frame to capture the timestamp of the new frame.
+  ///
+  /// If streaming is active, this also writes all data that was recorded since the last frame to the stream.
   static void StartNewFrame();
 
+  /// \brief Starts writing all profiling data continuously to the given stream in a compact binary format.
+  ///
+  /// Recording happens into lock-free per-thread ring buffers, new data is written to the stream on every StartNewFrame() or
+  /// FlushStreamingData() call. Scopes that are overwritten in the ring buffers before they were flushed are lost, so with very long frames
+  /// FlushStreamingData() should be called more often. Use ProfilingData::Read() to convert the recording into JSON.
+  ///
+  /// The stream must stay valid until StopStreaming() is called.
+  static void StartStreaming(ezStreamWriter& outputStream);
+
+  /// \brief Flushes all remaining data to the stream and ends streaming.
+  static void StopStreaming();
+
+  /// \brief Writes all data that was recorded since the last flush to the stream. Does nothing if streaming is not active.
+  static void FlushStreamingData();
+
   /// \brief Adds a new scoped event for the calling thread in the profiling system
+  ///
+  /// The name may be a temporary string, it is interned on first use. The function name is cached by its address and must therefore
+  /// be a string literal like EZ_SOURCE_FUNCTION or nullptr.
   static void AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime);
 
 private:
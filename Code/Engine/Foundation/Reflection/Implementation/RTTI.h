@@ -137,6 +137,19 @@ public:
     return uiIndex < m_DynamicMessageHandlers.GetCount() && m_DynamicMessageHandlers[uiIndex] != nullptr;
   }
 
+  /// \brief Returns the message handler of this type or one of its base types for the message type with the given id, or nullptr if there is none.
+  ///
+  /// Useful to resolve the handler only once when the same message type is dispatched to many instances of this type.
+  inline ezAbstractMessageHandler* FindMessageHandler(ezMessageId id) const
+  {
+    EZ_ASSERT_DEBUG(m_bGatheredDynamicMessageHandlers, "Message handler table should have been gathered at this point.\n"
+                                                       "If this assert is triggered for a type loaded from a dynamic plugin,\n"
+                                                       "you may have forgotten to instantiate an ezPlugin object inside your plugin DLL.");
+
+    const ezUInt32 uiIndex = id - m_uiMsgIdOffset;
+    return uiIndex < m_DynamicMessageHandlers.GetCount() ? m_DynamicMessageHandlers[uiIndex] : nullptr;
+  }
+
   EZ_ALWAYS_INLINE const ezArrayPtr<ezMessageSenderInfo>& GetMessageSender() const { return m_MessageSenders; }
 
   /// \brief Writes all types derived from \a pBaseType to the provided array. Optionally sorts the array by type name to yield a stable result.
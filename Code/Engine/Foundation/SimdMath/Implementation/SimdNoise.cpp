@@ -20,7 +20,7 @@ ezSimdPerlinNoise::ezSimdPerlinNoise(ezUInt32 uiSeed)
   }
 }
 
-ezSimdVec4f ezSimdPerlinNoise::NoiseZeroToOne(const ezSimdVec4f& inX, const ezSimdVec4f& inY, const ezSimdVec4f& inZ, ezUInt32 uiNumOctaves /*= 1*/)
+ezSimdVec4f ezSimdPerlinNoise::NoiseZeroToOne(const ezSimdVec4f& inX, const ezSimdVec4f& inY, const ezSimdVec4f& inZ, ezUInt32 uiNumOctaves /*= 1*/) const
 {
   ezSimdVec4f result = ezSimdVec4f::ZeroVector();
   ezSimdFloat amplitude = 1.0f;
@@ -68,7 +68,7 @@ namespace
 } // namespace
 
 // reference: https://mrl.nyu.edu/~perlin/noise/
-ezSimdVec4f ezSimdPerlinNoise::Noise(const ezSimdVec4f& inX, const ezSimdVec4f& inY, const ezSimdVec4f& inZ)
+ezSimdVec4f ezSimdPerlinNoise::Noise(const ezSimdVec4f& inX, const ezSimdVec4f& inY, const ezSimdVec4f& inZ) const
 {
   ezSimdVec4f x = inX;
   ezSimdVec4f y = inY;
@@ -7,17 +7,17 @@ class EZ_FOUNDATION_DLL ezSimdPerlinNoise
 public:
   ezSimdPerlinNoise(ezUInt32 uiSeed);
 
-  ezSimdVec4f NoiseZeroToOne(const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, ezUInt32 uiNumOctaves = 1);
+  ezSimdVec4f NoiseZeroToOne(const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, ezUInt32 uiNumOctaves = 1) const;
 
 private:
-  ezSimdVec4f Noise(const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z);
+  ezSimdVec4f Noise(const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z) const;
 
-  EZ_FORCE_INLINE ezSimdVec4i Permute(const ezSimdVec4i& v)
+  EZ_FORCE_INLINE ezSimdVec4i Permute(const ezSimdVec4i& v) const
   {
 #if 0
-    ezArrayPtr<ezUInt8> p = ezMakeArrayPtr(m_Permutations);
+    ezArrayPtr<const ezUInt8> p = ezMakeArrayPtr(m_Permutations);
 #else
-    ezUInt8* p = m_Permutations;
+    const ezUInt8* p = m_Permutations;
 #endif
 
     ezSimdVec4i i = v & ezSimdVec4i(EZ_ARRAY_SIZE(m_Permutations) - 1);
@@ -4,12 +4,132 @@
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
-struct HashedStringData
+namespace
 {
-  ezMutex m_Mutex;
-  ezHashedString::StringStorage m_Storage;
-  ezHashedString::HashedType m_Empty;
-};
+  enum
+  {
+    // strings are distributed over the shards by the lowest bits of their hash value,
+    // so threads that add different strings rarely have to wait for the same mutex
+    NumShardBits = 4,
+    NumShards = 1 << NumShardBits,
+
+    InitialTableSize = 256,
+    NumDataPerBlock = 256,
+  };
+
+  /// \brief An open addressing hash table (with linear probing) that only stores pointers to the hashed data.
+  ///
+  /// Entries are only ever added to a table while holding the mutex of its shard, and an entry is only published after the data it
+  /// points to was fully written. Therefore other threads can search a table at any time without locking.
+  struct HashedStringTable
+  {
+    ezUInt32 m_uiMask = 0;
+    ezHashedString::HashedData* volatile* m_pSlots = nullptr;
+  };
+
+  struct HashedStringShard
+  {
+    ezMutex m_Mutex;
+    HashedStringTable* volatile m_pTable = nullptr;
+
+    // everything below may only be accessed while holding m_Mutex
+
+    ezUInt32 m_uiCount = 0;
+
+    // The hashed data is allocated in blocks and is never moved or deallocated.
+    ezDynamicArray<ezHashedString::HashedData*, ezStaticAllocatorWrapper> m_DataBlocks;
+    ezUInt32 m_uiUsedInLastBlock = NumDataPerBlock;
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    // data that was removed by ClearUnusedStrings() and can be reused
+    ezDynamicArray<ezHashedString::HashedData*, ezStaticAllocatorWrapper> m_FreeData;
+#endif
+
+    // Threads that search without locking may still look into a table after it was replaced by a larger one,
+    // so old tables are kept alive. Since every table has twice the size of the previous one, this at most doubles the memory usage.
+    ezDynamicArray<HashedStringTable*, ezStaticAllocatorWrapper> m_AllTables;
+
+    // keep the mutexes of different shards on different cache lines
+    ezUInt8 m_Padding[64];
+  };
+
+  HashedStringTable* AllocateTable(HashedStringShard& shard, ezUInt32 uiSize)
+  {
+    ezAllocatorBase* pAllocator = ezStaticAllocatorWrapper::GetAllocator();
+
+    HashedStringTable* pTable = EZ_NEW(pAllocator, HashedStringTable);
+    pTable->m_uiMask = uiSize - 1;
+    pTable->m_pSlots = EZ_NEW_RAW_BUFFER(pAllocator, ezHashedString::HashedData*, uiSize);
+    ezMemoryUtils::ZeroFill(const_cast<ezHashedString::HashedData**>(pTable->m_pSlots), uiSize);
+
+    shard.m_AllTables.PushBack(pTable);
+    return pTable;
+  }
+
+  ezHashedString::HashedData* FindInTable(const HashedStringTable* pTable, ezUInt32 uiHash)
+  {
+    ezUInt32 uiIndex = (uiHash >> NumShardBits) & pTable->m_uiMask;
+
+    while (true)
+    {
+      ezHashedString::HashedData* pData = pTable->m_pSlots[uiIndex];
+
+      if (pData == nullptr || pData->m_uiHash == uiHash)
+        return pData;
+
+      uiIndex = (uiIndex + 1) & pTable->m_uiMask;
+    }
+  }
+
+  void InsertIntoTable(HashedStringTable* pTable, ezHashedString::HashedData* pData)
+  {
+    ezUInt32 uiIndex = (pData->m_uiHash >> NumShardBits) & pTable->m_uiMask;
+
+    while (pTable->m_pSlots[uiIndex] != nullptr)
+    {
+      uiIndex = (uiIndex + 1) & pTable->m_uiMask;
+    }
+
+    // full barrier, the data must be visible to other threads before the pointer to it
+    ezAtomicUtils::TestAndSet(const_cast<void**>(reinterpret_cast<void* volatile*>(&pTable->m_pSlots[uiIndex])), nullptr, pData);
+  }
+
+  void PublishTable(HashedStringShard& shard, HashedStringTable* pTable)
+  {
+    // full barrier, the table content must be visible to other threads before the table itself
+    ezAtomicUtils::TestAndSet(const_cast<void**>(reinterpret_cast<void* volatile*>(&shard.m_pTable)), shard.m_pTable, pTable);
+  }
+
+  ezHashedString::HashedData* AllocateData(HashedStringShard& shard)
+  {
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    if (!shard.m_FreeData.IsEmpty())
+    {
+      ezHashedString::HashedData* pData = shard.m_FreeData.PeekBack();
+      shard.m_FreeData.PopBack();
+      return pData;
+    }
+#endif
+
+    if (shard.m_uiUsedInLastBlock == NumDataPerBlock)
+    {
+      shard.m_DataBlocks.PushBack(EZ_NEW_RAW_BUFFER(ezStaticAllocatorWrapper::GetAllocator(), ezHashedString::HashedData, NumDataPerBlock));
+      shard.m_uiUsedInLastBlock = 0;
+    }
+
+    ezHashedString::HashedData* pData = shard.m_DataBlocks.PeekBack() + shard.m_uiUsedInLastBlock;
+    ++shard.m_uiUsedInLastBlock;
+
+    ezMemoryUtils::Construct(pData, 1);
+    return pData;
+  }
+
+  struct HashedStringData
+  {
+    HashedStringShard m_Shards[NumShards];
+    ezHashedString::HashedType m_Empty;
+  };
+} // namespace
 
 static HashedStringData* s_pHSData;
 
@@ -22,29 +142,59 @@ ezHashedString::HashedType ezHashedString::AddHashedString(const char* szString,
   if (s_pHSData == nullptr)
     InitHashedString();
 
-  EZ_LOCK(s_pHSData->m_Mutex);
+  HashedStringShard& shard = s_pHSData->m_Shards[uiHash & (NumShards - 1)];
+
+#if EZ_DISABLED(EZ_HASHED_STRING_REF_COUNTING)
+  // Without ref counting strings are never removed, so existing strings can be found without locking.
+  // With ref counting, ClearUnusedStrings() could remove the string right after it was found here.
+  if (HashedData* pData = FindInTable(shard.m_pTable, uiHash))
+    return pData;
+#endif
+
+  EZ_LOCK(shard.m_Mutex);
 
-  // try to find the existing string
-  bool bExisted = false;
-  auto ret = s_pHSData->m_Storage.FindOrAdd(uiHash, &bExisted);
+  // try to find the existing string (again, another thread might have added it in the meantime)
+  HashedData* pData = FindInTable(shard.m_pTable, uiHash);
 
   // if it already exists, just increase the refcount
-  if (bExisted)
+  if (pData != nullptr)
   {
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    ret.Value().m_iRefCount.Increment();
+    pData->m_iRefCount.Increment();
 #endif
+    return pData;
   }
-  else
-  {
-    ezHashedString::HashedData& d = ret.Value();
+
+  pData = AllocateData(shard);
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    d.m_iRefCount = 1;
+  pData->m_iRefCount = 1;
 #endif
-    d.m_sString = szString;
+  pData->m_uiHash = uiHash;
+  pData->m_sString = szString;
+
+  HashedStringTable* pTable = shard.m_pTable;
+
+  // keep the load factor below 50%, so that probe sequences stay short
+  if ((shard.m_uiCount + 1) * 2 > pTable->m_uiMask + 1)
+  {
+    HashedStringTable* pNewTable = AllocateTable(shard, (pTable->m_uiMask + 1) * 2);
+
+    for (ezUInt32 i = 0; i <= pTable->m_uiMask; ++i)
+    {
+      if (pTable->m_pSlots[i] != nullptr)
+      {
+        InsertIntoTable(pNewTable, pTable->m_pSlots[i]);
+      }
+    }
+
+    PublishTable(shard, pNewTable);
+    pTable = pNewTable;
   }
 
-  return ret;
+  InsertIntoTable(pTable, pData);
+  ++shard.m_uiCount;
+
+  return pData;
 }
 
 EZ_MSVC_ANALYSIS_WARNING_POP
@@ -56,33 +206,64 @@ void ezHashedString::InitHashedString()
     return;
 
   EZ_ALIGN_VARIABLE(static ezUInt8 HashedStringDataBuffer[sizeof(HashedStringData)], EZ_ALIGNMENT_OF(HashedStringData));
-  s_pHSData = new (HashedStringDataBuffer) HashedStringData();
+  HashedStringData* pHSData = new (HashedStringDataBuffer) HashedStringData();
+
+  for (HashedStringShard& shard : pHSData->m_Shards)
+  {
+    shard.m_pTable = AllocateTable(shard, InitialTableSize);
+  }
+
+  s_pHSData = pHSData;
 
   // makes sure the empty string exists for the default constructor to use
   s_pHSData->m_Empty = AddHashedString("", ezHashingUtils::MurmurHash32String(""));
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   // this one should never get deleted, so make sure its refcount is 2
-  s_pHSData->m_Empty.Value().m_iRefCount.Increment();
+  s_pHSData->m_Empty->m_iRefCount.Increment();
 #endif
 }
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
 ezUInt32 ezHashedString::ClearUnusedStrings()
 {
-  EZ_LOCK(s_pHSData->m_Mutex);
-
   ezUInt32 uiDeleted = 0;
 
-  for (auto it = s_pHSData->m_Storage.GetIterator(); it.IsValid();)
+  for (HashedStringShard& shard : s_pHSData->m_Shards)
   {
-    if (it.Value().m_iRefCount == 0)
+    EZ_LOCK(shard.m_Mutex);
+
+    // With ref counting enabled, strings are only searched while holding the mutex, so the table can be rebuilt in place.
+    HashedStringTable* pTable = shard.m_pTable;
+
+    ezHybridArray<HashedData*, 64> remaining;
+
+    for (ezUInt32 i = 0; i <= pTable->m_uiMask; ++i)
     {
-      it = s_pHSData->m_Storage.Remove(it);
-      ++uiDeleted;
+      HashedData* pData = pTable->m_pSlots[i];
+      pTable->m_pSlots[i] = nullptr;
+
+      if (pData == nullptr)
+        continue;
+
+      if (pData->m_iRefCount == 0)
+      {
+        pData->m_sString.Clear();
+        shard.m_FreeData.PushBack(pData);
+        ++uiDeleted;
+      }
+      else
+      {
+        remaining.PushBack(pData);
+      }
     }
-    else
-      ++it;
+
+    for (HashedData* pData : remaining)
+    {
+      InsertIntoTable(pTable, pData);
+    }
+
+    shard.m_uiCount = remaining.GetCount();
   }
 
   return uiDeleted;
@@ -103,7 +284,7 @@ ezHashedString::ezHashedString()
 
   m_Data = s_pHSData->m_Empty;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-  m_Data.Value().m_iRefCount.Increment();
+  m_Data->m_iRefCount.Increment();
 #endif
 }
 
@@ -122,9 +303,9 @@ void ezHashedString::Clear()
     HashedType tmp = m_Data;
 
     m_Data = s_pHSData->m_Empty;
-    m_Data.Value().m_iRefCount.Increment();
+    m_Data->m_iRefCount.Increment();
 
-    tmp.Value().m_iRefCount.Decrement();
+    tmp->m_iRefCount.Decrement();
   }
 #else
   m_Data = s_pHSData->m_Empty;
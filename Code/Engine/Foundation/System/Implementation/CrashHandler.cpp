@@ -79,6 +79,8 @@ void ezCrashHandler_WriteMiniDump::SetDumpFilePath(const char* szAppName, ezBitf
 
 void ezCrashHandler_WriteMiniDump::HandleCrash(void* pOsSpecificData)
 {
+  ezGlobalLog::FlushAsyncLogging();
+
   bool crashDumpWritten = false;
   if (!m_sDumpFilePath.IsEmpty())
   {
@@ -3,6 +3,7 @@
 #include <Foundation/Strings/String.h>
 #include <Foundation/Threading/ConditionVariable.h>
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Types/SharedPtr.h>
 
 /// \internal Represents the state of a group of tasks that can be waited on
@@ -34,6 +35,7 @@ private:
   ezUInt16 m_uiTaskGroupIndex = 0xFFFF; // only there as a debugging aid
   ezUInt32 m_uiGroupCounter = 1;
   ezHybridArray<ezSharedPtr<ezTask>, 16> m_Tasks;
+  ezDynamicArray<ezTaskSystem::TaskData> m_LocalQueueTasks; // the entries referenced from the lock-free per-thread queues
   ezHybridArray<ezTaskGroupID, 4> m_DependsOnGroups;
   ezHybridArray<ezTaskGroupID, 8> m_OthersDependingOnMe;
   ezAtomicInteger32 m_iNumActiveDependencies;
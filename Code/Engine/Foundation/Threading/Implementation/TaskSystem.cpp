@@ -38,12 +38,15 @@ void ezTaskSystem::Startup()
 
   tl_TaskWorkerInfo.m_WorkerType = ezWorkerThreadType::MainThread;
   tl_TaskWorkerInfo.m_iWorkerIndex = 0;
+  tl_TaskWorkerInfo.m_pLocalQueues = s_ThreadState->m_MainThreadQueues;
 }
 
 void ezTaskSystem::Shutdown()
 {
   StopWorkerThreads();
 
+  tl_TaskWorkerInfo.m_pLocalQueues = nullptr;
+
   s_State.Clear();
   s_ThreadState.Clear();
 }
@@ -53,4 +56,9 @@ void ezTaskSystem::SetTargetFrameTime(ezTime targetFrameTime)
   s_State->m_TargetFrameTime = targetFrameTime;
 }
 
+void ezTaskSystem::SetUseLocalTaskQueues(bool bEnable)
+{
+  s_State->m_bUseLocalTaskQueues = bEnable;
+}
+
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskSystem);
@@ -144,6 +144,16 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
     return;
   }
 
+  if (CanUseLocalTaskQueue(pGroup))
+  {
+    const ezInt32 iRemainingTasks = ScheduleGroupTasksLocal(pGroup, bHighPriority);
+
+    // the tasks are visible to other threads now, so this will find them, even if they are just about to go idle
+    // (see ezTaskWorkerThread::Run())
+    WakeUpThreads(ezWorkerThreadType::ShortTasks, iRemainingTasks);
+    return;
+  }
+
   ezInt32 iRemainingTasks = 0;
 
   // add all the tasks to the task list, so that they will be processed
@@ -181,6 +191,8 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
       }
     }
 
+    s_State->m_iNumQueuedTasks[pGroup->m_Priority].Add(iRemainingTasks);
+
     // send the proper thread signal, to make sure one of the correct worker threads is awake
     switch (pGroup->m_Priority)
     {
@@ -226,6 +238,79 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
   }
 }
 
+bool ezTaskSystem::CanUseLocalTaskQueue(const ezTaskGroup* pGroup)
+{
+  // only the main thread and the short task workers own a queue
+  if (!s_State->m_bUseLocalTaskQueues || tl_TaskWorkerInfo.m_pLocalQueues == nullptr)
+    return false;
+
+  if (!ezTaskWorkStealingDeque::IsLocalQueuePriority(pGroup->m_Priority))
+    return false;
+
+  // threads that wait for a group may only pick tasks that never wait themselves (see GetNextTask())
+  // the lock-free queues can't skip over entries, so they may only contain such tasks
+  for (const auto& pTask : pGroup->m_Tasks)
+  {
+    if (pTask->m_NestingMode != ezTaskNesting::Never)
+      return false;
+  }
+
+  return true;
+}
+
+ezInt32 ezTaskSystem::ScheduleGroupTasksLocal(ezTaskGroup* pGroup, bool bHighPriority)
+{
+  ezInt32 iRemainingTasks = 0;
+
+  for (auto pTask : pGroup->m_Tasks)
+  {
+    iRemainingTasks += ezMath::Max(1u, pTask->m_uiMultiplicity);
+    pTask->m_iRemainingRuns = ezMath::Max(1u, pTask->m_uiMultiplicity);
+  }
+
+  pGroup->m_iNumRemainingTasks = iRemainingTasks;
+
+  // the queues only store pointers, the group owns the data until all its tasks are finished
+  // this array must not be resized anymore, once the first task is queued
+  pGroup->m_LocalQueueTasks.SetCount(iRemainingTasks);
+
+  ezUInt32 uiEntry = 0;
+  for (ezUInt32 task = 0; task < pGroup->m_Tasks.GetCount(); ++task)
+  {
+    auto& pTask = pGroup->m_Tasks[task];
+    pTask->m_bTaskIsScheduled = true;
+
+    for (ezUInt32 mult = 0; mult < ezMath::Max(1u, pTask->m_uiMultiplicity); ++mult)
+    {
+      TaskData& td = pGroup->m_LocalQueueTasks[uiEntry++];
+      td.m_pBelongsToGroup = pGroup;
+      td.m_pTask = pTask;
+      td.m_uiInvocation = mult;
+    }
+  }
+
+  ezTaskWorkStealingDeque& queue = tl_TaskWorkerInfo.m_pLocalQueues[ezTaskWorkStealingDeque::GetQueueIndex(pGroup->m_Priority, bHighPriority)];
+
+  if (bHighPriority)
+  {
+    // the owner pops high priority tasks from the back, so push in reverse order to have it work through the invocations in ascending order
+    for (ezUInt32 i = pGroup->m_LocalQueueTasks.GetCount(); i > 0; --i)
+    {
+      queue.PushBack(&pGroup->m_LocalQueueTasks[i - 1]);
+    }
+  }
+  else
+  {
+    // all other tasks are taken from the front, so they end up behind everything that was scheduled before
+    for (TaskData& td : pGroup->m_LocalQueueTasks)
+    {
+      queue.PushBack(&td);
+    }
+  }
+
+  return iRemainingTasks;
+}
+
 void ezTaskSystem::DependencyHasFinished(ezTaskGroup* pGroup)
 {
   // remove one dependency from the group
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 class ezTaskSystemThreadState
@@ -16,6 +17,9 @@ private:
 
   // the maximum number of worker threads that should be non-idle (and not blocked) at any time
   ezUInt32 m_uiMaxWorkersToUse[ezWorkerThreadType::ENUM_COUNT] = {};
+
+  // The lock-free queues into which the main thread puts its 'this frame' tasks. Worker threads steal from these.
+  ezTaskWorkStealingDeque m_MainThreadQueues[ezTaskWorkStealingDeque::NumQueues];
 };
 
 class ezTaskSystemState
@@ -31,4 +35,10 @@ private:
 
   // The lists of all scheduled tasks, for each priority.
   ezList<ezTaskSystem::TaskData> m_Tasks[ezTaskPriority::ENUM_COUNT];
+
+  // The number of tasks in each of the m_Tasks lists. Can be read without holding the lock, to skip empty lists.
+  ezAtomicInteger32 m_iNumQueuedTasks[ezTaskPriority::ENUM_COUNT];
+
+  // Whether tasks may be put into the lock-free per-thread queues, see ezTaskSystem::SetUseLocalTaskQueues()
+  bool m_bUseLocalTaskQueues = true;
 };
@@ -24,17 +24,29 @@ ezTaskGroupID ezTaskSystem::StartSingleTask(const ezSharedPtr<ezTask>& pTask, ez
   return Group;
 }
 
-void ezTaskSystem::TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup* pGroup)
+void ezTaskSystem::TaskHasFinished(ezSharedPtr<ezTask>&& pTask, ezTaskGroup* pGroup)
 {
   if (pTask && pTask->m_OnTaskFinished.IsValid() && pTask->m_iRemainingRuns == 0)
   {
     pTask->m_OnTaskFinished(pTask);
   }
 
+  // once the last task of the group is finished, nothing may hold onto the task anymore, so drop this reference before that can happen
+  pTask.Clear();
+
   if (pGroup->m_iNumRemainingTasks.Decrement() == 0)
   {
     // If this was the last task that had to be finished from this group, make sure all dependent groups are started
 
+    {
+      EZ_LOCK(s_TaskSystemMutex);
+
+      // unless an outside reference is held onto a task, this will deallocate the tasks
+      // this has to happen before the waiting threads are woken up, they may free anything that the tasks still reference
+      pGroup->m_Tasks.Clear();
+      pGroup->m_LocalQueueTasks.Clear();
+    }
+
     ezUInt32 groupCounter = 0;
     {
       // see ezTaskGroup::WaitForFinish() for why we need this lock here
@@ -57,9 +69,6 @@ void ezTaskSystem::TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup
       {
         DependencyHasFinished(pGroup->m_OthersDependingOnMe[dep].m_pTaskGroup);
       }
-
-      // unless an outside reference is held onto a task, this will deallocate the tasks
-      pGroup->m_Tasks.Clear();
     }
 
     if (pGroup->m_OnFinishedCallback.IsValid())
@@ -81,11 +90,24 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
 
   EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}", FirstPriority, LastPriority);
 
-  EZ_LOCK(s_TaskSystemMutex);
-
   // go through all the task lists that this thread is willing to work on
   for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
   {
+    // the lock-free queues only contain tasks that never wait, so those are always fine to execute
+    if (ezTaskWorkStealingDeque::IsLocalQueuePriority(prio))
+    {
+      if (TaskData* pTaskData = GetLocalQueueTask((ezTaskPriority::Enum)prio))
+      {
+        return *pTaskData;
+      }
+    }
+
+    // don't bother taking the lock for empty lists
+    if (s_State->m_iNumQueuedTasks[prio] == 0)
+      continue;
+
+    EZ_LOCK(s_TaskSystemMutex);
+
     for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
     {
       if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
@@ -93,6 +115,7 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
         TaskData td = *it;
 
         s_State->m_Tasks[prio].Remove(it);
+        s_State->m_iNumQueuedTasks[prio].Decrement();
         return td;
       }
     }
@@ -106,6 +129,87 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
   return TaskData();
 }
 
+ezTaskSystem::TaskData* ezTaskSystem::GetLocalQueueTask(ezTaskPriority::Enum Priority)
+{
+  const ezUInt32 uiHighPriorityQueue = ezTaskWorkStealingDeque::GetQueueIndex(Priority, true);
+  const ezUInt32 uiQueue = ezTaskWorkStealingDeque::GetQueueIndex(Priority, false);
+
+  ezTaskWorkStealingDeque* pOwnQueues = tl_TaskWorkerInfo.m_pLocalQueues;
+
+  if (pOwnQueues != nullptr)
+  {
+    // prefer our own high priority tasks, the most recently queued ones are the most likely to still be in the cache
+    if (TaskData* pTaskData = pOwnQueues[uiHighPriorityQueue].PopBack())
+      return pTaskData;
+
+    // all other tasks are executed in the order in which they were scheduled
+    if (TaskData* pTaskData = pOwnQueues[uiQueue].StealFront())
+      return pTaskData;
+  }
+
+  // otherwise steal the oldest task from some other thread
+  // start with the next worker, so that not all threads try to steal from the same victim
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiFirstVictim = (tl_TaskWorkerInfo.m_WorkerType == ezWorkerThreadType::ShortTasks) ? tl_TaskWorkerInfo.m_iWorkerIndex + 1 : 0;
+
+  for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+  {
+    ezTaskWorkStealingDeque* pQueues = s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][(uiFirstVictim + i) % uiNumWorkers]->GetLocalQueues();
+
+    if (pQueues == pOwnQueues)
+      continue;
+
+    if (TaskData* pTaskData = pQueues[uiHighPriorityQueue].StealFront())
+      return pTaskData;
+
+    if (TaskData* pTaskData = pQueues[uiQueue].StealFront())
+      return pTaskData;
+  }
+
+  ezTaskWorkStealingDeque* pMainThreadQueues = s_ThreadState->m_MainThreadQueues;
+
+  if (pMainThreadQueues != pOwnQueues)
+  {
+    if (TaskData* pTaskData = pMainThreadQueues[uiHighPriorityQueue].StealFront())
+      return pTaskData;
+
+    if (TaskData* pTaskData = pMainThreadQueues[uiQueue].StealFront())
+      return pTaskData;
+  }
+
+  return nullptr;
+}
+
+bool ezTaskSystem::HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority)
+{
+  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+  {
+    if (s_State->m_iNumQueuedTasks[prio] > 0)
+      return true;
+
+    if (ezTaskWorkStealingDeque::IsLocalQueuePriority(prio))
+    {
+      const ezUInt32 uiHighPriorityQueue = ezTaskWorkStealingDeque::GetQueueIndex(prio, true);
+      const ezUInt32 uiQueue = ezTaskWorkStealingDeque::GetQueueIndex(prio, false);
+
+      if (!s_ThreadState->m_MainThreadQueues[uiHighPriorityQueue].IsEmpty() || !s_ThreadState->m_MainThreadQueues[uiQueue].IsEmpty())
+        return true;
+
+      const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+
+      for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+      {
+        const ezTaskWorkStealingDeque* pQueues = s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][i]->GetLocalQueues();
+
+        if (!pQueues[uiHighPriorityQueue].IsEmpty() || !pQueues[uiQueue].IsEmpty())
+          return true;
+      }
+    }
+  }
+
+  return false;
+}
+
 bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
 {
   //const ezWorkerThreadType::Enum workerType = (tl_TaskWorkerInfo.m_WorkerType == ezWorkerThreadType::Unknown) ? ezWorkerThreadType::ShortTasks : tl_TaskWorkerInfo.m_WorkerType;
@@ -127,7 +231,7 @@ bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriorit
   tl_TaskWorkerInfo.m_szTaskName = nullptr;
 
   // notify the group, that a task is finished, which might trigger other tasks to be executed
-  TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
+  TaskHasFinished(std::move(td.m_pTask), td.m_pBelongsToGroup);
 
   return true;
 }
@@ -160,6 +264,7 @@ ezResult ezTaskSystem::CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunn
 
     // check if the task has already been scheduled for execution
     // if so, remove it from the work queue
+    // tasks in the lock-free per-thread queues can't be removed, but since the cancel flag is set, they will finish right away once they get picked up
     {
       for (ezUInt32 i = 0; i < ezTaskPriority::ENUM_COUNT; ++i)
       {
@@ -169,13 +274,17 @@ ezResult ezTaskSystem::CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunn
         {
           if (it->m_pTask == pTask)
           {
+            // copy the data before removing the entry from the list, TaskHasFinished() below still needs it
+            TaskData td = *it;
+
             s_State->m_Tasks[i].Remove(it);
+            s_State->m_iNumQueuedTasks[i].Decrement();
 
             // we set the task to finished, even though it was not executed
             pTask->m_iRemainingRuns = 0;
 
             // tell the system that one task of that group is 'finished', to ensure its dependencies will get scheduled
-            TaskHasFinished(it->m_pTask, it->m_pBelongsToGroup);
+            TaskHasFinished(std::move(td.m_pTask), td.m_pBelongsToGroup);
             return EZ_SUCCESS;
           }
 
@@ -261,6 +370,11 @@ void ezTaskSystem::ReprioritizeFrameTasks()
     // remove the tasks from their current queue
     s_State->m_Tasks[i].Clear();
   }
+
+  for (ezUInt32 i = (ezUInt32)ezTaskPriority::EarlyThisFrame; i <= (ezUInt32)ezTaskPriority::In9Frames; ++i)
+  {
+    s_State->m_iNumQueuedTasks[i] = s_State->m_Tasks[i].GetCount();
+  }
 }
 
 void ezTaskSystem::ExecuteSomeFrameTasks(ezUInt32 uiSomeFrameTasks, ezTime smoothFrameTime)
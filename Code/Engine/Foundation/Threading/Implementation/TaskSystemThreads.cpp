@@ -93,6 +93,25 @@ void ezTaskSystem::StopWorkerThreads()
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_ThreadState->m_Workers[type][i]->Join();
+
+      // the thread is gone, so its queued tasks need to be moved into the shared lists, otherwise they would never get executed
+      {
+        EZ_LOCK(s_TaskSystemMutex);
+
+        ezTaskWorkStealingDeque* pQueues = s_ThreadState->m_Workers[type][i]->GetLocalQueues();
+
+        for (ezUInt32 queue = 0; queue < ezTaskWorkStealingDeque::NumQueues; ++queue)
+        {
+          const ezUInt32 prio = ezTaskWorkStealingDeque::GetQueuePriority(queue);
+
+          while (TaskData* pTaskData = pQueues[queue].PopBack())
+          {
+            s_State->m_Tasks[prio].PushFront(*pTaskData);
+            s_State->m_iNumQueuedTasks[prio].Increment();
+          }
+        }
+      }
+
       EZ_DEFAULT_DELETE(s_ThreadState->m_Workers[type][i]);
     }
 
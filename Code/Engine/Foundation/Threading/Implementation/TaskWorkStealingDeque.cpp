@@ -0,0 +1,121 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
+
+ezTaskWorkStealingDeque::ezTaskWorkStealingDeque()
+{
+  m_pBuffer = AllocateBuffer(64);
+}
+
+ezTaskWorkStealingDeque::~ezTaskWorkStealingDeque()
+{
+  for (Buffer* pBuffer : m_AllBuffers)
+  {
+    EZ_DEFAULT_DELETE_RAW_BUFFER(pBuffer->m_pSlots);
+    EZ_DEFAULT_DELETE(pBuffer);
+  }
+}
+
+ezTaskWorkStealingDeque::Buffer* ezTaskWorkStealingDeque::AllocateBuffer(ezUInt64 uiCapacity)
+{
+  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2(static_cast<ezUInt32>(uiCapacity)), "Capacity must be a power of two");
+
+  Buffer* pBuffer = EZ_DEFAULT_NEW(Buffer);
+  pBuffer->m_uiMask = uiCapacity - 1;
+  pBuffer->m_pSlots = EZ_DEFAULT_NEW_RAW_BUFFER(ezTaskSystem::TaskData*, static_cast<size_t>(uiCapacity));
+
+  m_AllBuffers.PushBack(pBuffer);
+  return pBuffer;
+}
+
+ezTaskWorkStealingDeque::Buffer* ezTaskWorkStealingDeque::Grow(Buffer* pOldBuffer, ezInt64 iTop, ezInt64 iBottom)
+{
+  Buffer* pNewBuffer = AllocateBuffer((pOldBuffer->m_uiMask + 1) * 2);
+
+  for (ezInt64 i = iTop; i < iBottom; ++i)
+  {
+    pNewBuffer->m_pSlots[i & pNewBuffer->m_uiMask] = pOldBuffer->m_pSlots[i & pOldBuffer->m_uiMask];
+  }
+
+  // the old buffer stays valid, thieves that still read from it will get the same pointers
+  m_pBuffer = pNewBuffer;
+  return pNewBuffer;
+}
+
+void ezTaskWorkStealingDeque::PushBack(ezTaskSystem::TaskData* pTaskData)
+{
+  const ezInt64 iBottom = m_iBottom;
+  const ezInt64 iTop = m_iTop;
+  Buffer* pBuffer = m_pBuffer;
+
+  if (static_cast<ezUInt64>(iBottom - iTop) > pBuffer->m_uiMask)
+  {
+    pBuffer = Grow(pBuffer, iTop, iBottom);
+  }
+
+  pBuffer->m_pSlots[iBottom & pBuffer->m_uiMask] = pTaskData;
+
+  // full barrier, the slot must be written before other threads can see the new bottom
+  m_iBottom.Set(iBottom + 1);
+}
+
+ezTaskSystem::TaskData* ezTaskWorkStealingDeque::PopBack()
+{
+  const ezInt64 iBottom = m_iBottom - 1;
+  Buffer* pBuffer = m_pBuffer;
+
+  // full barrier, thieves must see the reserved slot before we look at the top
+  m_iBottom.Set(iBottom);
+
+  const ezInt64 iTop = m_iTop;
+
+  if (iTop > iBottom)
+  {
+    // deque was empty
+    m_iBottom.Set(iBottom + 1);
+    return nullptr;
+  }
+
+  ezTaskSystem::TaskData* pTaskData = pBuffer->m_pSlots[iBottom & pBuffer->m_uiMask];
+
+  if (iTop == iBottom)
+  {
+    // this is the last element, race against the thieves for it
+    if (!m_iTop.TestAndSet(iTop, iTop + 1))
+    {
+      pTaskData = nullptr;
+    }
+
+    m_iBottom.Set(iBottom + 1);
+  }
+
+  return pTaskData;
+}
+
+ezTaskSystem::TaskData* ezTaskWorkStealingDeque::StealFront()
+{
+  const ezInt64 iTop = m_iTop;
+  const ezInt64 iBottom = m_iBottom;
+
+  if (iTop >= iBottom)
+    return nullptr;
+
+  Buffer* pBuffer = m_pBuffer;
+  ezTaskSystem::TaskData* pTaskData = pBuffer->m_pSlots[iTop & pBuffer->m_uiMask];
+
+  // if this fails, either another thief or the owner got the element first
+  if (!m_iTop.TestAndSet(iTop, iTop + 1))
+    return nullptr;
+
+  return pTaskData;
+}
+
+bool ezTaskWorkStealingDeque::IsEmpty() const
+{
+  const ezInt64 iTop = m_iTop;
+  const ezInt64 iBottom = m_iBottom;
+  return iTop >= iBottom;
+}
+
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskWorkStealingDeque);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \internal A lock-free work-stealing deque (Chase-Lev) of scheduled tasks.
+///
+/// Every deque has exactly one owner thread. Only the owner may call PushBack() and PopBack(), which operate on the 'bottom' end
+/// and thus hand out the most recently scheduled (and most likely still cached) tasks first.
+/// Any thread, including the owner, may call StealFront() at any time, which takes the oldest task from the 'top' end.
+///
+/// The deque only stores pointers, the ezTaskSystem::TaskData itself is owned by the ezTaskGroup that scheduled the task
+/// and stays valid until the task was executed.
+class ezTaskWorkStealingDeque
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskWorkStealingDeque);
+
+public:
+  ezTaskWorkStealingDeque();
+  ~ezTaskWorkStealingDeque();
+
+  /// \brief Returns whether tasks of the given priority are allowed to be put into the per-thread queues.
+  ///
+  /// Only tasks that have to be finished this frame use them. All other priorities need to be moved around between frames
+  /// (see ezTaskSystem::ReprioritizeFrameTasks()) and thus stay in the shared task lists.
+  EZ_ALWAYS_INLINE static bool IsLocalQueuePriority(ezUInt32 uiPriority) { return uiPriority <= ezTaskPriority::LateThisFrame; }
+
+  /// \brief The number of priorities for which IsLocalQueuePriority() returns true.
+  static constexpr ezUInt32 NumPriorities = ezTaskPriority::LateThisFrame + 1;
+
+  /// \brief The number of queues each thread needs, two for each priority for which IsLocalQueuePriority() returns true.
+  ///
+  /// Groups that were scheduled with high priority (e.g. because their dependencies just finished) go into the first queue, which the
+  /// owner works through newest first. All other groups go into the second queue, from which the owner also takes the oldest task first,
+  /// so that they are executed in the order in which they were started.
+  static constexpr ezUInt32 NumQueues = NumPriorities * 2;
+
+  /// \brief Returns the index of the queue (out of NumQueues) for the given priority.
+  EZ_ALWAYS_INLINE static ezUInt32 GetQueueIndex(ezUInt32 uiPriority, bool bHighPriority) { return bHighPriority ? uiPriority : NumPriorities + uiPriority; }
+
+  /// \brief Returns the task priority that the queue with the given index is used for.
+  EZ_ALWAYS_INLINE static ezUInt32 GetQueuePriority(ezUInt32 uiQueueIndex) { return uiQueueIndex % NumPriorities; }
+
+  /// \brief Adds a task at the bottom of the deque. May only be called by the owner thread.
+  void PushBack(ezTaskSystem::TaskData* pTaskData);
+
+  /// \brief Removes the most recently added task. May only be called by the owner thread (or once the owner thread has terminated).
+  ///
+  /// Returns nullptr if the deque is empty.
+  ezTaskSystem::TaskData* PopBack();
+
+  /// \brief Removes the oldest task. May be called by any thread.
+  ///
+  /// Returns nullptr if the deque is empty, or another thread won the race for the last task.
+  ezTaskSystem::TaskData* StealFront();
+
+  /// \brief Returns whether the deque currently contains no tasks. Only a snapshot, when called from a non-owner thread.
+  bool IsEmpty() const;
+
+private:
+  struct Buffer
+  {
+    ezUInt64 m_uiMask = 0;
+    ezTaskSystem::TaskData** m_pSlots = nullptr; // only accessed between atomic operations, which also act as compiler barriers
+  };
+
+  Buffer* AllocateBuffer(ezUInt64 uiCapacity);
+  Buffer* Grow(Buffer* pOldBuffer, ezInt64 iTop, ezInt64 iBottom);
+
+  ezAtomicInteger64 m_iTop;
+  Buffer* volatile m_pBuffer = nullptr;
+
+  // keep the owner's end on a different cache line than the one that thieves are modifying
+  ezUInt8 m_Padding[64];
+
+  ezAtomicInteger64 m_iBottom;
+
+  // Thieves may still read from a buffer after it was replaced by a larger one, so all buffers are kept alive until the deque is destroyed.
+  ezDynamicArray<Buffer*> m_AllBuffers;
+};
@@ -47,6 +47,7 @@ ezUInt32 ezTaskWorkerThread::Run()
   tl_TaskWorkerInfo.m_WorkerType = m_WorkerType;
   tl_TaskWorkerInfo.m_iWorkerIndex = m_uiWorkerThreadNumber;
   tl_TaskWorkerInfo.m_pWorkerState = &m_WorkerState;
+  tl_TaskWorkerInfo.m_pLocalQueues = (m_WorkerType == ezWorkerThreadType::ShortTasks) ? m_LocalQueues : nullptr;
 
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_ThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
@@ -66,6 +67,13 @@ ezUInt32 ezTaskWorkerThread::Run()
 
     if (!ezTaskSystem::ExecuteTask(FirstPriority, LastPriority, false, ezTaskGroupID(), &m_WorkerState))
     {
+      // Tasks may get scheduled without the task system mutex (see ezTaskSystem::ScheduleGroupTasks()).
+      // If that happened after we looked for work, but before we flagged ourselves as idle, the scheduling thread
+      // may have counted us as active and not woken anyone up. So check again, now that the idle state is visible.
+      // If the state can't be reset, someone has already woken us up and WaitForWork() will return right away.
+      if (ezTaskSystem::HasQueuedTasks(FirstPriority, LastPriority) && m_WorkerState.TestAndSet((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active))
+        continue;
+
       WaitForWork();
     }
     else
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
 
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
@@ -77,6 +78,21 @@ private:
   ezAtomicInteger32 m_WorkerState; // ezTaskWorkerState
 
   ///@}
+
+  /// \name Local Task Queues
+  ///@{
+
+public:
+  /// \brief Returns the lock-free queues (two per 'this frame' priority, see ezTaskWorkStealingDeque::GetQueueIndex()) into which this
+  /// thread schedules its own tasks.
+  ///
+  /// Only the worker itself pushes and pops, all other threads may only steal from these queues.
+  ezTaskWorkStealingDeque* GetLocalQueues() { return m_LocalQueues; }
+
+private:
+  ezTaskWorkStealingDeque m_LocalQueues[ezTaskWorkStealingDeque::NumQueues];
+
+  ///@}
 };
 
 /// \internal Thread local state used by the task system (and for better debugging)
@@ -87,6 +103,7 @@ struct ezTaskWorkerInfo
   bool m_bAllowNestedTasks = true;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskWorkStealingDeque* m_pLocalQueues = nullptr; // only set for threads that own lock-free task queues (short task workers and the main thread)
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
@@ -83,11 +83,20 @@ private:
   /// \brief Searches for a task of priority between \a FirstPriority and \a LastPriority (inclusive).
   static TaskData GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
+  /// \brief Takes a task of the given priority from the calling thread's own lock-free queue, or steals one from another thread's queue.
+  static TaskData* GetLocalQueueTask(ezTaskPriority::Enum Priority);
+
+  /// \brief Returns whether any task of priority between \a FirstPriority and \a LastPriority (inclusive) is currently queued. Does not lock.
+  static bool HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority);
+
   /// \brief Executes some task of priority between \a FirstPriority and \a LastPriority (inclusive). Returns true, if any such task was available.
   static bool ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
   /// \brief Called whenever a task has been finished/canceled. Makes sure that groups are marked as finished when all tasks are done.
-  static void TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup* pGroup);
+  ///
+  /// Releases the given reference to the task. All references that the task system holds onto the tasks of a group are released before threads that wait for the group are woken up,
+  /// so they may free whatever the tasks depend on right away.
+  static void TaskHasFinished(ezSharedPtr<ezTask>&& pTask, ezTaskGroup* pGroup);
 
   /// \brief Moves all 'next frame' tasks into the 'this frame' queues.
   static void ReprioritizeFrameTasks();
@@ -167,6 +176,14 @@ private:
   /// \brief Takes all the tasks in the given group and schedules them for execution, by inserting them into the proper task lists.
   static void ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority);
 
+  /// \brief Returns true, if the tasks of \a pGroup can be put into the lock-free queue of the calling thread, instead of the shared task lists.
+  static bool CanUseLocalTaskQueue(const ezTaskGroup* pGroup);
+
+  /// \brief Puts all the tasks of the given group into the lock-free queue of the calling thread. Returns the number of queued task invocations.
+  ///
+  /// High priority groups are worked on newest first, all others in the order in which they were scheduled.
+  static ezInt32 ScheduleGroupTasksLocal(ezTaskGroup* pGroup, bool bHighPriority);
+
   /// \brief Is called whenever a dependency of pGroup has finished. Once all dependencies are finished, the group's tasks will get scheduled.
   static void DependencyHasFinished(ezTaskGroup* pGroup);
 
@@ -285,6 +302,16 @@ public:
   /// \see FinishFrameTasks() for more details.
   static void SetTargetFrameTime(ezTime targetFrameTime = ezTime::Seconds(1.0 / 40.0) /* 40 FPS -> 25 ms */);
 
+  /// \brief Enables or disables the lock-free per-thread task queues. They are enabled by default.
+  ///
+  /// Tasks with a 'this frame' priority that never wait on other tasks (ezTaskNesting::Never), such as the ones started by ParallelFor(),
+  /// are put into a lock-free work-stealing queue of the thread that starts them, if that thread is a short task worker or the main thread.
+  /// Other worker threads steal from those queues when they run out of work. All other tasks always go through the shared task lists,
+  /// which are protected by a mutex.
+  ///
+  /// Disabling this routes all tasks through the shared task lists. This is mostly useful to compare the performance of both approaches.
+  static void SetUseLocalTaskQueues(bool bEnable);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, TaskSystem);
 
@@ -81,12 +81,33 @@ private:
 
   const ezRenderData* GetFrameData(const ezRTTI* pRtti) const;
 
+  struct RadixSortEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiSortingKey;
+    ezUInt32 m_uiBatchId;
+    ezUInt32 m_uiIndex;
+  };
+
   struct DataPerCategory
   {
     ezDynamicArray< ezRenderDataBatch > m_Batches;
     ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortableRenderData;
+
+    // Scratch memory for sorting. It is kept from frame to frame, so sorting does not need to allocate anything.
+    ezDynamicArray< RadixSortEntry > m_SortEntries;
+    ezDynamicArray< RadixSortEntry > m_SortScratch;
+    ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortedRenderData;
   };
 
+  /// \brief Stable LSD radix sort with 8 bit digits. Digits that are the same for all entries are skipped,
+  /// which is usually the case for large parts of the sorting key.
+  ///
+  /// Returns a pointer to the sorted entries, which is either the data of \a entries or \a scratch.
+  static const RadixSortEntry* RadixSort(ezDynamicArray<RadixSortEntry>& entries, ezDynamicArray<RadixSortEntry>& scratch);
+  static void SortAndBatch(DataPerCategory& dataPerCategory);
+
   ezCamera m_Camera;
   ezViewData m_ViewData;
   ezTime m_WorldTime;
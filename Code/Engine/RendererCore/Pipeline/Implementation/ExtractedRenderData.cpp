@@ -1,10 +1,81 @@
 #include <RendererCorePCH.h>
 
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
+namespace
+{
+  enum
+  {
+    // below this number of render data a comparison sort is faster than radix sorting
+    MIN_RADIX_SORT_COUNT = 256,
+
+    // below this overall number of render data it is not worth to sort the categories in parallel
+    MIN_PARALLEL_SORT_COUNT = 4096,
+
+    NUM_RADIX_DIGITS = 12
+  };
+
+  EZ_ALWAYS_INLINE ezUInt32 GetRadixDigit(ezUInt64 uiSortingKey, ezUInt32 uiBatchId, ezUInt32 uiDigit)
+  {
+    // The first four digits are the batch id and the last eight digits are the sorting key.
+    // Since LSD radix sort is stable, this gives the same order as comparing the sorting key first and the batch id second.
+    return uiDigit < 4 ? (uiBatchId >> (uiDigit * 8)) & 0xFF : static_cast<ezUInt32>(uiSortingKey >> ((uiDigit - 4) * 8)) & 0xFF;
+  }
+} // namespace
+
 ezExtractedRenderData::ezExtractedRenderData() {}
 
+// static
+const ezExtractedRenderData::RadixSortEntry* ezExtractedRenderData::RadixSort(ezDynamicArray<RadixSortEntry>& entries, ezDynamicArray<RadixSortEntry>& scratch)
+{
+  const ezUInt32 uiCount = entries.GetCount();
+  scratch.SetCountUninitialized(uiCount);
+
+  ezUInt32 histograms[NUM_RADIX_DIGITS][256] = {};
+
+  for (const RadixSortEntry& entry : entries)
+  {
+    for (ezUInt32 uiDigit = 0; uiDigit < 4; ++uiDigit)
+    {
+      ++histograms[uiDigit][(entry.m_uiBatchId >> (uiDigit * 8)) & 0xFF];
+    }
+
+    for (ezUInt32 uiDigit = 0; uiDigit < 8; ++uiDigit)
+    {
+      ++histograms[uiDigit + 4][static_cast<ezUInt32>(entry.m_uiSortingKey >> (uiDigit * 8)) & 0xFF];
+    }
+  }
+
+  RadixSortEntry* pSource = entries.GetData();
+  RadixSortEntry* pTarget = scratch.GetData();
+
+  for (ezUInt32 uiDigit = 0; uiDigit < NUM_RADIX_DIGITS; ++uiDigit)
+  {
+    ezUInt32* pHistogram = histograms[uiDigit];
+    if (pHistogram[GetRadixDigit(pSource[0].m_uiSortingKey, pSource[0].m_uiBatchId, uiDigit)] == uiCount)
+      continue;
+
+    ezUInt32 uiOffset = 0;
+    for (ezUInt32 i = 0; i < 256; ++i)
+    {
+      const ezUInt32 uiBucketCount = pHistogram[i];
+      pHistogram[i] = uiOffset;
+      uiOffset += uiBucketCount;
+    }
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      pTarget[pHistogram[GetRadixDigit(pSource[i].m_uiSortingKey, pSource[i].m_uiBatchId, uiDigit)]++] = pSource[i];
+    }
+
+    ezMath::Swap(pSource, pTarget);
+  }
+
+  return pSource;
+}
+
 void ezExtractedRenderData::AddRenderData(const ezRenderData* pRenderData, ezRenderData::Category category)
 {
   m_DataPerCategory.EnsureCount(category.m_uiValue + 1);
@@ -23,6 +94,39 @@ void ezExtractedRenderData::SortAndBatch()
 {
   EZ_PROFILE_SCOPE("SortAndBatch");
 
+  ezUInt32 uiTotalCount = 0;
+  for (auto& dataPerCategory : m_DataPerCategory)
+  {
+    uiTotalCount += dataPerCategory.m_SortableRenderData.GetCount();
+  }
+
+  if (uiTotalCount < MIN_PARALLEL_SORT_COUNT)
+  {
+    for (auto& dataPerCategory : m_DataPerCategory)
+    {
+      SortAndBatch(dataPerCategory);
+    }
+  }
+  else
+  {
+    // every category is sorted and batched independently, so each one can be handled by its own task
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.uiMaxTasksPerThread = 4;
+
+    ezTaskSystem::ParallelForIndexed(0, m_DataPerCategory.GetCount(), [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        SortAndBatch(m_DataPerCategory[i]);
+      }
+    },
+      "SortAndBatch", params);
+  }
+}
+
+// static
+void ezExtractedRenderData::SortAndBatch(DataPerCategory& dataPerCategory)
+{
   struct RenderDataComparer
   {
     EZ_FORCE_INLINE bool Less(const ezRenderDataBatch::SortableRenderData& a, const ezRenderDataBatch::SortableRenderData& b) const
@@ -36,38 +140,64 @@ void ezExtractedRenderData::SortAndBatch()
     }
   };
 
-  for (auto& dataPerCategory : m_DataPerCategory)
-  {
-    if (dataPerCategory.m_SortableRenderData.IsEmpty())
-      continue;
+  if (dataPerCategory.m_SortableRenderData.IsEmpty())
+    return;
 
-    auto& data = dataPerCategory.m_SortableRenderData;
+  auto& data = dataPerCategory.m_SortableRenderData;
 
-    // Sort
+  // Sort
+  if (data.GetCount() < MIN_RADIX_SORT_COUNT)
+  {
     data.Sort(RenderDataComparer());
+  }
+  else
+  {
+    const ezUInt32 uiCount = data.GetCount();
 
-    // Find batches
-    ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
-    ezUInt32 uiCurrentBatchStartIndex = 0;
-    const ezRTTI* pCurrentBatchType = data[0].m_pRenderData->GetDynamicRTTI();
-
-    for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+    // the batch id is fetched only once per render data instead of in every comparison
+    auto& entries = dataPerCategory.m_SortEntries;
+    entries.SetCountUninitialized(uiCount);
+    for (ezUInt32 i = 0; i < uiCount; ++i)
     {
-      auto pRenderData = data[i].m_pRenderData;
+      entries[i].m_uiSortingKey = data[i].m_uiSortingKey;
+      entries[i].m_uiBatchId = data[i].m_pRenderData->m_uiBatchId;
+      entries[i].m_uiIndex = i;
+    }
 
-      if (pRenderData->m_uiBatchId != uiCurrentBatchId || pRenderData->GetDynamicRTTI() != pCurrentBatchType)
-      {
-        dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
+    const RadixSortEntry* pSortedEntries = RadixSort(entries, dataPerCategory.m_SortScratch);
 
-        uiCurrentBatchId = pRenderData->m_uiBatchId;
-        uiCurrentBatchStartIndex = i;
-        pCurrentBatchType = pRenderData->GetDynamicRTTI();
-      }
+    auto& sortedData = dataPerCategory.m_SortedRenderData;
+    sortedData.SetCountUninitialized(uiCount);
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      sortedData[i] = data[pSortedEntries[i].m_uiIndex];
     }
 
-    dataPerCategory.m_Batches.ExpandAndGetRef().m_Data =
-        ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], data.GetCount() - uiCurrentBatchStartIndex);
+    // copy back instead of swapping, so both arrays keep their capacity for the next frame
+    ezMemoryUtils::Copy(data.GetData(), sortedData.GetData(), uiCount);
   }
+
+  // Find batches
+  ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
+  ezUInt32 uiCurrentBatchStartIndex = 0;
+  const ezRTTI* pCurrentBatchType = data[0].m_pRenderData->GetDynamicRTTI();
+
+  for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+  {
+    auto pRenderData = data[i].m_pRenderData;
+
+    if (pRenderData->m_uiBatchId != uiCurrentBatchId || pRenderData->GetDynamicRTTI() != pCurrentBatchType)
+    {
+      dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
+
+      uiCurrentBatchId = pRenderData->m_uiBatchId;
+      uiCurrentBatchStartIndex = i;
+      pCurrentBatchType = pRenderData->GetDynamicRTTI();
+    }
+  }
+
+  dataPerCategory.m_Batches.ExpandAndGetRef().m_Data =
+      ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], data.GetCount() - uiCurrentBatchStartIndex);
 }
 
 void ezExtractedRenderData::Clear()
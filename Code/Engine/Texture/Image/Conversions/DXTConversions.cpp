@@ -3,8 +3,11 @@
 #include <Texture/Image/Conversions/DXTConversions.h>
 #include <Texture/Image/Conversions/PixelConversions.h>
 #include <Texture/Image/ImageConversion.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Math/Color16f.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
 #include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 #if EZ_SSE_LEVEL >= EZ_SSE_41 && EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
 #  define EZ_SUPPORTS_BC4_COMPRESSOR
@@ -1689,6 +1692,1066 @@ EZ_TEXTURE_DLL void ezDecompressBlockBC7(const ezUInt8* pSource, ezColorBaseUB*
   }
 } // namespace
 
+namespace
+{
+  // The block encoders keep every 4x4 block twice: once per pixel for the endpoint fitting and once per channel with one vector per row,
+  // so that the palette searches can compare four pixels at once.
+  struct BlockData
+  {
+    ezSimdVec4f m_Pixels[16];
+    ezSimdVec4f m_Channels[4][4]; // channel, row
+  };
+
+  void loadBlock(const ezColorBaseUB* pSource, BlockData& out_block)
+  {
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      out_block.m_Pixels[i].Set(pSource[i].r, pSource[i].g, pSource[i].b, pSource[i].a);
+    }
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      const ezColorBaseUB* p = pSource + 4 * row;
+      out_block.m_Channels[0][row].Set(p[0].r, p[1].r, p[2].r, p[3].r);
+      out_block.m_Channels[1][row].Set(p[0].g, p[1].g, p[2].g, p[3].g);
+      out_block.m_Channels[2][row].Set(p[0].b, p[1].b, p[2].b, p[3].b);
+      out_block.m_Channels[3][row].Set(p[0].a, p[1].a, p[2].a, p[3].a);
+    }
+  }
+
+  ezSimdVec4f clampColor(const ezSimdVec4f& color)
+  {
+    return color.CompMax(ezSimdVec4f::ZeroVector()).CompMin(ezSimdVec4f(255.0f));
+  }
+
+  // Picks the palette entry with the smallest squared error for every pixel.
+  // Returns the summed error of all pixels, weighted with pWeights (one weight per pixel, 0 excludes a pixel).
+  float findBestIndices(const BlockData& block, const float* pWeights, const ezSimdVec4f* pPalette, ezUInt32 uiNumEntries,
+                        ezUInt32 uiNumChannels, ezUInt8* out_pIndices)
+  {
+    ezSimdVec4f totalError = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      ezSimdVec4f bestError(ezMath::MaxValue<float>());
+      ezSimdVec4f bestIndex = ezSimdVec4f::ZeroVector();
+
+      for (ezUInt32 e = 0; e < uiNumEntries; ++e)
+      {
+        const ezSimdVec4f& entry = pPalette[e];
+
+        ezSimdVec4f diff = block.m_Channels[0][row] - entry.Get<ezSwizzle::XXXX>();
+        ezSimdVec4f error = diff.CompMul(diff);
+        diff = block.m_Channels[1][row] - entry.Get<ezSwizzle::YYYY>();
+        error = ezSimdVec4f::MulAdd(diff, diff, error);
+        diff = block.m_Channels[2][row] - entry.Get<ezSwizzle::ZZZZ>();
+        error = ezSimdVec4f::MulAdd(diff, diff, error);
+
+        if (uiNumChannels == 4)
+        {
+          diff = block.m_Channels[3][row] - entry.Get<ezSwizzle::WWWW>();
+          error = ezSimdVec4f::MulAdd(diff, diff, error);
+        }
+
+        const ezSimdVec4b isBetter = error < bestError;
+        bestError = ezSimdVec4f::Select(isBetter, error, bestError);
+        bestIndex = ezSimdVec4f::Select(isBetter, ezSimdVec4f(static_cast<float>(e)), bestIndex);
+      }
+
+      ezSimdVec4f weights;
+      weights.Load<4>(pWeights + 4 * row);
+      totalError = ezSimdVec4f::MulAdd(bestError, weights, totalError);
+
+      float indices[4];
+      bestIndex.Store<4>(indices);
+
+      for (ezUInt32 i = 0; i < 4; ++i)
+      {
+        out_pIndices[4 * row + i] = static_cast<ezUInt8>(indices[i]);
+      }
+    }
+
+    return totalError.HorizontalSum<4>();
+  }
+
+  // index of each channel pair in the upper triangle of a 4x4 matrix
+  static const ezUInt32 s_ChannelPairs[4][4] = {{0, 1, 2, 3}, {1, 4, 5, 6}, {2, 5, 7, 8}, {3, 6, 8, 9}};
+
+  // Finds the principal axis of the (unnormalized) covariance matrix by power iteration.
+  // Returns the squared error that remains when all pixels are projected onto that axis.
+  float findPrincipalAxis(const float (&covariance)[4][4], ezUInt32 uiNumChannels, ezUInt32 uiNumIterations, ezSimdVec4f& out_axis)
+  {
+    // start with the column of the channel with the largest variance
+    ezUInt32 uiStartChannel = 0;
+    float fTrace = 0.0f;
+    for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+    {
+      fTrace += covariance[c][c];
+
+      if (covariance[c][c] > covariance[uiStartChannel][uiStartChannel])
+      {
+        uiStartChannel = c;
+      }
+    }
+
+    if (fTrace <= 0.0f)
+    {
+      out_axis.SetZero();
+      return 0.0f;
+    }
+
+    ezSimdVec4f columns[4];
+    for (ezUInt32 c = 0; c < 4; ++c)
+    {
+      columns[c].Load<4>(covariance[c]);
+    }
+
+    ezSimdVec4f axis = columns[uiStartChannel];
+    for (ezUInt32 iteration = 0; iteration < uiNumIterations; ++iteration)
+    {
+      ezSimdVec4f next = columns[0] * axis.x();
+      next = ezSimdVec4f::MulAdd(columns[1], axis.y(), next);
+      next = ezSimdVec4f::MulAdd(columns[2], axis.z(), next);
+      next = ezSimdVec4f::MulAdd(columns[3], axis.w(), next);
+
+      const ezSimdFloat fMax = next.Abs().HorizontalMax<4>();
+      if (fMax <= ezSimdFloat(ezMath::SmallEpsilon<float>()))
+        break;
+
+      axis = next / fMax;
+    }
+
+    axis.NormalizeIfNotZero<4>();
+    out_axis = axis;
+
+    // the largest eigenvalue is the squared error along the axis, everything else is the error across it
+    ezSimdVec4f projected = columns[0] * axis.x();
+    projected = ezSimdVec4f::MulAdd(columns[1], axis.y(), projected);
+    projected = ezSimdVec4f::MulAdd(columns[2], axis.z(), projected);
+    projected = ezSimdVec4f::MulAdd(columns[3], axis.w(), projected);
+
+    return ezMath::Max(0.0f, fTrace - static_cast<float>(projected.Dot<4>(axis)));
+  }
+
+  // Computes the weighted mean of the pixels and the principal axis of their distribution.
+  // Returns the squared error across the axis, see findPrincipalAxis().
+  float computePrincipalAxis(const BlockData& block, const float* pWeights, ezUInt32 uiNumChannels, ezSimdVec4f& out_mean, ezSimdVec4f& out_axis)
+  {
+    ezSimdVec4f sums[4] = {ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector()};
+    ezSimdVec4f weightSum = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f weights[4];
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      weights[row].Load<4>(pWeights + 4 * row);
+      weightSum += weights[row];
+
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        sums[c] = ezSimdVec4f::MulAdd(block.m_Channels[c][row], weights[row], sums[c]);
+      }
+    }
+
+    const float fTotalWeight = weightSum.HorizontalSum<4>();
+    if (fTotalWeight <= 0.0f)
+    {
+      out_mean.SetZero();
+      out_axis.SetZero();
+      return 0.0f;
+    }
+
+    float mean[4];
+    for (ezUInt32 c = 0; c < 4; ++c)
+    {
+      mean[c] = static_cast<float>(sums[c].HorizontalSum<4>()) / fTotalWeight;
+    }
+
+    out_mean.Load<4>(mean);
+
+    ezSimdVec4f covarianceSums[10];
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      covarianceSums[i].SetZero();
+    }
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      ezSimdVec4f centered[4];
+      for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+      {
+        centered[c] = block.m_Channels[c][row] - ezSimdVec4f(mean[c]);
+      }
+
+      for (ezUInt32 c0 = 0; c0 < uiNumChannels; ++c0)
+      {
+        const ezSimdVec4f weighted = centered[c0].CompMul(weights[row]);
+
+        for (ezUInt32 c1 = c0; c1 < uiNumChannels; ++c1)
+        {
+          ezSimdVec4f& sum = covarianceSums[s_ChannelPairs[c0][c1]];
+          sum = ezSimdVec4f::MulAdd(weighted, centered[c1], sum);
+        }
+      }
+    }
+
+    float covariance[4][4] = {};
+    for (ezUInt32 c0 = 0; c0 < uiNumChannels; ++c0)
+    {
+      for (ezUInt32 c1 = c0; c1 < uiNumChannels; ++c1)
+      {
+        covariance[c0][c1] = covariance[c1][c0] = covarianceSums[s_ChannelPairs[c0][c1]].HorizontalSum<4>();
+      }
+    }
+
+    return findPrincipalAxis(covariance, uiNumChannels, 8, out_axis);
+  }
+
+  // Products of all channel pairs of every pixel. With these the covariance of any subset of pixels only needs a few masked sums.
+  struct BlockMoments
+  {
+    ezSimdVec4f m_Products[10][4]; // channel pair, row
+  };
+
+  void computeMoments(const BlockData& block, ezUInt32 uiNumChannels, BlockMoments& out_moments)
+  {
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      for (ezUInt32 c0 = 0; c0 < uiNumChannels; ++c0)
+      {
+        for (ezUInt32 c1 = c0; c1 < uiNumChannels; ++c1)
+        {
+          out_moments.m_Products[s_ChannelPairs[c0][c1]][row] = block.m_Channels[c0][row].CompMul(block.m_Channels[c1][row]);
+        }
+      }
+    }
+  }
+
+  // Quickly estimates the squared error across the principal axis of the pixels in the mask, see findPrincipalAxis().
+  float estimateLineError(const BlockData& block, const BlockMoments& moments, const ezSimdVec4f* pMask, ezUInt32 uiNumChannels)
+  {
+    ezSimdVec4f count = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f sums[4];
+    ezSimdVec4f productSums[10];
+
+    for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+    {
+      sums[c].SetZero();
+    }
+
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      productSums[i].SetZero();
+    }
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      count += pMask[row];
+
+      for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+      {
+        sums[c] = ezSimdVec4f::MulAdd(block.m_Channels[c][row], pMask[row], sums[c]);
+      }
+
+      for (ezUInt32 c0 = 0; c0 < uiNumChannels; ++c0)
+      {
+        for (ezUInt32 c1 = c0; c1 < uiNumChannels; ++c1)
+        {
+          const ezUInt32 uiPair = s_ChannelPairs[c0][c1];
+          productSums[uiPair] = ezSimdVec4f::MulAdd(moments.m_Products[uiPair][row], pMask[row], productSums[uiPair]);
+        }
+      }
+    }
+
+    const float fCount = count.HorizontalSum<4>();
+    if (fCount <= 1.0f)
+      return 0.0f;
+
+    float sum[4];
+    for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+    {
+      sum[c] = sums[c].HorizontalSum<4>();
+    }
+
+    float covariance[4][4] = {};
+    for (ezUInt32 c0 = 0; c0 < uiNumChannels; ++c0)
+    {
+      for (ezUInt32 c1 = c0; c1 < uiNumChannels; ++c1)
+      {
+        covariance[c0][c1] = covariance[c1][c0] = static_cast<float>(productSums[s_ChannelPairs[c0][c1]].HorizontalSum<4>()) - sum[c0] * sum[c1] / fCount;
+      }
+    }
+
+    ezSimdVec4f axis;
+    return findPrincipalAxis(covariance, uiNumChannels, 4, axis);
+  }
+
+  // Places the two endpoints at the outermost projections of the weighted pixels onto the axis.
+  void computeEndpoints(const BlockData& block, const float* pWeights, const ezSimdVec4f& mean, const ezSimdVec4f& axis, ezSimdVec4f& out_endpoint0,
+                        ezSimdVec4f& out_endpoint1)
+  {
+    ezSimdVec4f minT(ezMath::MaxValue<float>());
+    ezSimdVec4f maxT(-ezMath::MaxValue<float>());
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      ezSimdVec4f t = (block.m_Channels[0][row] - mean.Get<ezSwizzle::XXXX>()).CompMul(axis.Get<ezSwizzle::XXXX>());
+      t = ezSimdVec4f::MulAdd(block.m_Channels[1][row] - mean.Get<ezSwizzle::YYYY>(), axis.Get<ezSwizzle::YYYY>(), t);
+      t = ezSimdVec4f::MulAdd(block.m_Channels[2][row] - mean.Get<ezSwizzle::ZZZZ>(), axis.Get<ezSwizzle::ZZZZ>(), t);
+      t = ezSimdVec4f::MulAdd(block.m_Channels[3][row] - mean.Get<ezSwizzle::WWWW>(), axis.Get<ezSwizzle::WWWW>(), t);
+
+      ezSimdVec4f weights;
+      weights.Load<4>(pWeights + 4 * row);
+      const ezSimdVec4b isUsed = weights > ezSimdVec4f::ZeroVector();
+
+      minT = ezSimdVec4f::Select(isUsed, minT.CompMin(t), minT);
+      maxT = ezSimdVec4f::Select(isUsed, maxT.CompMax(t), maxT);
+    }
+
+    ezSimdFloat fMinT = minT.HorizontalMin<4>();
+    ezSimdFloat fMaxT = maxT.HorizontalMax<4>();
+
+    if (fMinT > fMaxT)
+    {
+      fMinT = 0.0f;
+      fMaxT = 0.0f;
+    }
+
+    out_endpoint0 = clampColor(ezSimdVec4f::MulAdd(axis, fMinT, mean));
+    out_endpoint1 = clampColor(ezSimdVec4f::MulAdd(axis, fMaxT, mean));
+  }
+
+  // Computes the endpoints that minimize the squared error for the given indices (least squares fit).
+  // pIndexToWeight holds the weight of the second endpoint for each index.
+  bool refineEndpoints(const BlockData& block, const float* pWeights, const ezUInt8* pIndices, const float* pIndexToWeight,
+                       ezSimdVec4f& out_endpoint0, ezSimdVec4f& out_endpoint1)
+  {
+    float aa = 0.0f;
+    float bb = 0.0f;
+    float ab = 0.0f;
+    ezSimdVec4f ap = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f bp = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      const float w = pWeights[i];
+      if (w <= 0.0f)
+        continue;
+
+      const float b = pIndexToWeight[pIndices[i]];
+      const float a = 1.0f - b;
+
+      aa += w * a * a;
+      bb += w * b * b;
+      ab += w * a * b;
+      ap = ezSimdVec4f::MulAdd(block.m_Pixels[i], ezSimdFloat(w * a), ap);
+      bp = ezSimdVec4f::MulAdd(block.m_Pixels[i], ezSimdFloat(w * b), bp);
+    }
+
+    const float fDeterminant = aa * bb - ab * ab;
+    if (ezMath::Abs(fDeterminant) < 0.0001f)
+      return false;
+
+    const ezSimdFloat fInvDeterminant = 1.0f / fDeterminant;
+
+    out_endpoint0 = clampColor((ap * bb - bp * ab) * fInvDeterminant);
+    out_endpoint1 = clampColor((bp * aa - ap * ab) * fInvDeterminant);
+    return true;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC1
+
+  // weight of the second color for each index, in four and three color mode
+  static const float s_bc1IndexWeights4[] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+  static const float s_bc1IndexWeights3[] = {0.0f, 1.0f, 0.5f, 0.0f};
+
+  struct EncodingBC1
+  {
+    ezUInt16 m_uiColor0 = 0;
+    ezUInt16 m_uiColor1 = 0;
+    bool m_bThreeColorMode = false;
+    float m_fError = ezMath::MaxValue<float>();
+    ezUInt8 m_Indices[16];
+  };
+
+  ezUInt16 quantizeB5G6R5(const ezSimdVec4f& color)
+  {
+    float c[4];
+    (color + ezSimdVec4f(0.5f)).Store<4>(c);
+    return ezCompressB5G6R5(ezColorBaseUB(static_cast<ezUInt8>(c[0]), static_cast<ezUInt8>(c[1]), static_cast<ezUInt8>(c[2]), 0xFF));
+  }
+
+  // Evaluates the palette exactly like ezDecompressBlockBC1 does. Three color mode only uses the first three entries.
+  void evaluateBC1(const BlockData& block, const float* pWeights, ezUInt16 uiColor0, ezUInt16 uiColor1, bool bThreeColorMode, EncodingBC1& out_encoding)
+  {
+    const ezColorBaseUB c0 = ezDecompressB5G6R5(uiColor0);
+    const ezColorBaseUB c1 = ezDecompressB5G6R5(uiColor1);
+
+    ezSimdVec4f palette[4];
+    palette[0].Set(c0.r, c0.g, c0.b, 255.0f);
+    palette[1].Set(c1.r, c1.g, c1.b, 255.0f);
+
+    if (bThreeColorMode)
+    {
+      palette[2].Set((c0.r + c1.r) / 2, (c0.g + c1.g) / 2, (c0.b + c1.b) / 2, 255.0f);
+    }
+    else
+    {
+      palette[2].Set((2 * c0.r + c1.r + 1) / 3, (2 * c0.g + c1.g + 1) / 3, (2 * c0.b + c1.b + 1) / 3, 255.0f);
+      palette[3].Set((c0.r + 2 * c1.r + 1) / 3, (c0.g + 2 * c1.g + 1) / 3, (c0.b + 2 * c1.b + 1) / 3, 255.0f);
+    }
+
+    out_encoding.m_uiColor0 = uiColor0;
+    out_encoding.m_uiColor1 = uiColor1;
+    out_encoding.m_bThreeColorMode = bThreeColorMode;
+    out_encoding.m_fError = findBestIndices(block, pWeights, palette, bThreeColorMode ? 3 : 4, 3, out_encoding.m_Indices);
+  }
+
+  // Moves each channel of both colors by one step and keeps every change that lowers the error.
+  void searchNeighborsBC1(const BlockData& block, const float* pWeights, EncodingBC1& inout_best)
+  {
+    // field shift and maximum of the R, G and B channel in a B5G6R5 color
+    static const ezUInt32 s_Shifts[] = {11, 5, 0};
+    static const ezInt32 s_Max[] = {31, 63, 31};
+
+    for (ezUInt32 uiColor = 0; uiColor < 2; ++uiColor)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        for (ezInt32 iStep = -1; iStep <= 1; iStep += 2)
+        {
+          const ezUInt16 uiOldColor = uiColor == 0 ? inout_best.m_uiColor0 : inout_best.m_uiColor1;
+          const ezInt32 iValue = ((uiOldColor >> s_Shifts[c]) & s_Max[c]) + iStep;
+
+          if (iValue < 0 || iValue > s_Max[c])
+            continue;
+
+          const ezUInt16 uiNewColor = static_cast<ezUInt16>((uiOldColor & ~(s_Max[c] << s_Shifts[c])) | (iValue << s_Shifts[c]));
+
+          EncodingBC1 candidate;
+          evaluateBC1(block, pWeights, uiColor == 0 ? uiNewColor : inout_best.m_uiColor0, uiColor == 1 ? uiNewColor : inout_best.m_uiColor1,
+                      inout_best.m_bThreeColorMode, candidate);
+
+          if (candidate.m_fError < inout_best.m_fError)
+          {
+            inout_best = candidate;
+          }
+        }
+      }
+    }
+  }
+
+  void encodeBlockBC1(const BlockData& block, const ezColorBaseUB* pSource, bool bForceFourColorMode, ezBlockCompressionQuality::Enum quality,
+                      ezUInt8* pTarget)
+  {
+    // BC1 has 1-bit alpha through the three color mode, BC3 always decodes the colors in four color mode.
+    // Like the DirectXTex conversions, every pixel that isn't fully opaque becomes transparent.
+    float weights[16];
+    bool bHasTransparentPixels = false;
+    bool bHasOpaquePixels = false;
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      const bool bOpaque = bForceFourColorMode || pSource[i].a == 255;
+      weights[i] = bOpaque ? 1.0f : 0.0f;
+      bHasTransparentPixels |= !bOpaque;
+      bHasOpaquePixels |= bOpaque;
+    }
+
+    if (!bHasOpaquePixels)
+    {
+      memset(pTarget, 0x00, 4);
+      memset(pTarget + 4, 0xFF, 4);
+      return;
+    }
+
+    ezSimdVec4f mean, axis, endpoint0, endpoint1;
+    computePrincipalAxis(block, weights, 3, mean, axis);
+    computeEndpoints(block, weights, mean, axis, endpoint0, endpoint1);
+
+    EncodingBC1 best;
+    evaluateBC1(block, weights, quantizeB5G6R5(endpoint1), quantizeB5G6R5(endpoint0), bHasTransparentPixels, best);
+
+    const ezUInt32 uiNumRefinements = quality == ezBlockCompressionQuality::Fast ? 0 : (quality == ezBlockCompressionQuality::Balanced ? 2 : 4);
+    for (ezUInt32 iteration = 0; iteration < uiNumRefinements; ++iteration)
+    {
+      if (!refineEndpoints(block, weights, best.m_Indices, best.m_bThreeColorMode ? s_bc1IndexWeights3 : s_bc1IndexWeights4, endpoint0, endpoint1))
+        break;
+
+      EncodingBC1 candidate;
+      evaluateBC1(block, weights, quantizeB5G6R5(endpoint0), quantizeB5G6R5(endpoint1), best.m_bThreeColorMode, candidate);
+
+      if (candidate.m_fError >= best.m_fError)
+        break;
+
+      best = candidate;
+    }
+
+    if (quality == ezBlockCompressionQuality::High)
+    {
+      searchNeighborsBC1(block, weights, best);
+
+      // opaque blocks may also use the three color mode, as long as they don't use the transparent index
+      if (!bForceFourColorMode && !bHasTransparentPixels)
+      {
+        EncodingBC1 candidate;
+        evaluateBC1(block, weights, best.m_uiColor0, best.m_uiColor1, true, candidate);
+
+        if (refineEndpoints(block, weights, candidate.m_Indices, s_bc1IndexWeights3, endpoint0, endpoint1))
+        {
+          EncodingBC1 refined;
+          evaluateBC1(block, weights, quantizeB5G6R5(endpoint0), quantizeB5G6R5(endpoint1), true, refined);
+
+          if (refined.m_fError < candidate.m_fError)
+          {
+            candidate = refined;
+          }
+        }
+
+        if (candidate.m_fError < best.m_fError)
+        {
+          best = candidate;
+        }
+      }
+    }
+
+    // the order of the colors selects the mode, swapping them only requires to swap the indices of the two colors
+    if (best.m_bThreeColorMode)
+    {
+      if (best.m_uiColor0 > best.m_uiColor1)
+      {
+        ezMath::Swap(best.m_uiColor0, best.m_uiColor1);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          if (best.m_Indices[i] < 2)
+            best.m_Indices[i] ^= 1;
+        }
+      }
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        if (weights[i] <= 0.0f)
+          best.m_Indices[i] = 3;
+      }
+    }
+    else if (!bForceFourColorMode)
+    {
+      if (best.m_uiColor0 < best.m_uiColor1)
+      {
+        ezMath::Swap(best.m_uiColor0, best.m_uiColor1);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          best.m_Indices[i] ^= 1;
+        }
+      }
+      else if (best.m_uiColor0 == best.m_uiColor1)
+      {
+        // decodes in three color mode, where the first three entries are all the same color
+        memset(best.m_Indices, 0, sizeof(best.m_Indices));
+      }
+    }
+
+    pTarget[0] = static_cast<ezUInt8>(best.m_uiColor0 & 0xFF);
+    pTarget[1] = static_cast<ezUInt8>(best.m_uiColor0 >> 8);
+    pTarget[2] = static_cast<ezUInt8>(best.m_uiColor1 & 0xFF);
+    pTarget[3] = static_cast<ezUInt8>(best.m_uiColor1 >> 8);
+
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      const ezUInt8* pIndices = best.m_Indices + 4 * row;
+      pTarget[4 + row] = static_cast<ezUInt8>(pIndices[0] | (pIndices[1] << 2) | (pIndices[2] << 4) | (pIndices[3] << 6));
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC3
+
+  void encodeAlphaBC3(const ezUInt8* pAlpha, ezUInt8* pTarget)
+  {
+#if defined(EZ_SUPPORTS_BC4_COMPRESSOR)
+    ezUInt32 a0, a1;
+    findBestPaletteBC4(pAlpha, a0, a1);
+    packBlockBC4(pAlpha, a0, a1, pTarget);
+#else
+    ezUInt32 a0 = 0;
+    ezUInt32 a1 = 255;
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      a0 = ezMath::Max<ezUInt32>(a0, pAlpha[i]);
+      a1 = ezMath::Min<ezUInt32>(a1, pAlpha[i]);
+    }
+
+    ezUInt32 palette[8];
+    ezUnpackPaletteBC4(a0, a1, palette);
+
+    ezUInt64 indices = 0;
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      ezUInt32 uiBestIndex = 0;
+      ezInt32 iBestError = 256;
+
+      for (ezUInt32 e = 0; e < 8; ++e)
+      {
+        const ezInt32 iError = ezMath::Abs(static_cast<ezInt32>(palette[e]) - static_cast<ezInt32>(pAlpha[i]));
+        if (iError < iBestError)
+        {
+          iBestError = iError;
+          uiBestIndex = e;
+        }
+      }
+
+      indices |= ezUInt64(uiBestIndex) << (3 * i);
+    }
+
+    pTarget[0] = ezUInt8(a0);
+    pTarget[1] = ezUInt8(a1);
+    memcpy(pTarget + 2, &indices, 6);
+#endif
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC7
+
+  struct EndpointsBC7
+  {
+    ezColorBaseUB m_Endpoints[2]; // quantized, without the p-bit
+    ezUInt8 m_PBits[2] = {0, 0};
+    float m_fError = ezMath::MaxValue<float>();
+  };
+
+  class BitWriterBC7
+  {
+  public:
+    BitWriterBC7(ezUInt8* pTarget)
+      : m_pTarget(pTarget)
+    {
+      memset(m_pTarget, 0, 16);
+    }
+
+    void WriteBits(ezUInt32 uiValue, ezUInt32 uiNumBits)
+    {
+      for (ezUInt32 i = 0; i < uiNumBits; ++i, ++m_uiBit)
+      {
+        if ((uiValue >> i) & 1)
+        {
+          m_pTarget[m_uiBit >> 3] |= 1 << (m_uiBit & 7);
+        }
+      }
+    }
+
+  private:
+    ezUInt8* m_pTarget;
+    ezUInt32 m_uiBit = 0;
+  };
+
+  const int* getInterpolationWeightsBC7(ezUInt32 uiIndexPrec)
+  {
+    return uiIndexPrec == 2 ? s_bc67InterpolationWeights2 : (uiIndexPrec == 3 ? s_bc67InterpolationWeights3 : s_bc67InterpolationWeights4);
+  }
+
+  ezUInt8 unquantizeBC7(ezUInt8 uiValue, ezUInt32 uiPrec, ezUInt32 uiPBitsPerSubset, ezUInt32 uiPBit)
+  {
+    return uiPBitsPerSubset > 0 ? bc7Unquantize(static_cast<ezUInt8>((uiValue << 1) | uiPBit), uiPrec + 1) : bc7Unquantize(uiValue, uiPrec);
+  }
+
+  // Returns the value with uiPrec bits that reconstructs fValue best (together with the p-bit, if the mode has p-bits).
+  ezUInt8 quantizeBC7(float fValue, ezUInt32 uiPrec, ezUInt32 uiPBitsPerSubset, ezUInt32 uiPBit, ezInt32& out_iError)
+  {
+    const ezInt32 iMax = (1 << uiPrec) - 1;
+    const ezInt32 iGuess = static_cast<ezInt32>(fValue * iMax / 255.0f + 0.5f);
+    const ezInt32 iTarget = static_cast<ezInt32>(fValue + 0.5f);
+
+    ezUInt8 uiBest = 0;
+    out_iError = ezMath::MaxValue<ezInt32>();
+
+    for (ezInt32 q = ezMath::Max(0, iGuess - 1); q <= ezMath::Min(iMax, iGuess + 1); ++q)
+    {
+      const ezInt32 iError = ezMath::Abs(static_cast<ezInt32>(unquantizeBC7(static_cast<ezUInt8>(q), uiPrec, uiPBitsPerSubset, uiPBit)) - iTarget);
+
+      if (iError < out_iError)
+      {
+        out_iError = iError;
+        uiBest = static_cast<ezUInt8>(q);
+      }
+    }
+
+    return uiBest;
+  }
+
+  ezInt32 quantizeEndpointBC7(const ezSimdVec4f& endpoint, ezUInt32 uiColorPrec, ezUInt32 uiNumChannels, ezUInt32 uiPBitsPerSubset, ezUInt32 uiPBit,
+                              ezColorBaseUB& out_color)
+  {
+    float values[4];
+    endpoint.Store<4>(values);
+
+    ezInt32 iTotalError = 0;
+    for (ezUInt32 c = 0; c < 4; ++c)
+    {
+      ezInt32 iError = 0;
+      out_color.GetData()[c] = c < uiNumChannels ? quantizeBC7(values[c], uiColorPrec, uiPBitsPerSubset, uiPBit, iError) : 0;
+      iTotalError += iError * iError;
+    }
+
+    return iTotalError;
+  }
+
+  float evaluateEndpointsBC7(const BlockData& block, const float* pWeights, const ezColorBaseUB* pEndpoints, const ezUInt8* pPBits,
+                             ezUInt32 uiColorPrec, ezUInt32 uiNumChannels, ezUInt32 uiPBitsPerSubset, ezUInt32 uiIndexPrec, ezUInt8* out_pIndices)
+  {
+    ezColorBaseUB colors[2];
+    for (ezUInt32 e = 0; e < 2; ++e)
+    {
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        colors[e].GetData()[c] = c < uiNumChannels ? unquantizeBC7(pEndpoints[e].GetData()[c], uiColorPrec, uiPBitsPerSubset, pPBits[e]) : 255;
+      }
+    }
+
+    const int* pInterpolationWeights = getInterpolationWeightsBC7(uiIndexPrec);
+    const ezUInt32 uiNumEntries = 1u << uiIndexPrec;
+
+    ezSimdVec4f palette[16];
+    for (ezUInt32 i = 0; i < uiNumEntries; ++i)
+    {
+      const ezUInt32 w = pInterpolationWeights[i];
+
+      float entry[4];
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        entry[c] = static_cast<float>((colors[0].GetData()[c] * (s_bc67WeightMax - w) + colors[1].GetData()[c] * w + s_bc67WeightRound) >> s_bc67WeightShift);
+      }
+
+      palette[i].Load<4>(entry);
+    }
+
+    return findBestIndices(block, pWeights, palette, uiNumEntries, uiNumChannels, out_pIndices);
+  }
+
+  // Quantizes the endpoints and picks the p-bits, either by their quantization error or (at high quality) by trying all combinations.
+  void tryEndpointsBC7(const BlockData& block, const float* pWeights, const ezSimdVec4f* pEndpoints, ezUInt32 uiColorPrec, ezUInt32 uiNumChannels,
+                       ezUInt32 uiPBitsPerSubset, ezUInt32 uiIndexPrec, ezBlockCompressionQuality::Enum quality, EndpointsBC7& inout_best,
+                       ezUInt8* inout_pBestIndices)
+  {
+    ezColorBaseUB quantized[2][2]; // endpoint, p-bit
+    ezInt32 quantizationErrors[2][2];
+
+    const ezUInt32 uiNumPBitValues = uiPBitsPerSubset > 0 ? 2 : 1;
+    for (ezUInt32 e = 0; e < 2; ++e)
+    {
+      for (ezUInt32 p = 0; p < uiNumPBitValues; ++p)
+      {
+        quantizationErrors[e][p] = quantizeEndpointBC7(pEndpoints[e], uiColorPrec, uiNumChannels, uiPBitsPerSubset, p, quantized[e][p]);
+      }
+    }
+
+    // bit 0 is the p-bit of the first endpoint, bit 1 the one of the second endpoint
+    ezUInt32 uiFirstCombination = 0;
+    ezUInt32 uiLastCombination = uiPBitsPerSubset > 0 ? 3 : 0;
+
+    if (uiPBitsPerSubset > 0 && quality != ezBlockCompressionQuality::High)
+    {
+      if (uiPBitsPerSubset == 1)
+      {
+        uiFirstCombination = quantizationErrors[0][0] + quantizationErrors[1][0] <= quantizationErrors[0][1] + quantizationErrors[1][1] ? 0 : 3;
+      }
+      else
+      {
+        uiFirstCombination = (quantizationErrors[0][0] <= quantizationErrors[0][1] ? 0 : 1) | (quantizationErrors[1][0] <= quantizationErrors[1][1] ? 0 : 2);
+      }
+
+      uiLastCombination = uiFirstCombination;
+    }
+
+    for (ezUInt32 uiCombination = uiFirstCombination; uiCombination <= uiLastCombination; ++uiCombination)
+    {
+      const ezUInt8 pBits[2] = {static_cast<ezUInt8>(uiCombination & 1), static_cast<ezUInt8>(uiCombination >> 1)};
+
+      if (uiPBitsPerSubset == 1 && pBits[0] != pBits[1])
+        continue;
+
+      const ezColorBaseUB endpoints[2] = {quantized[0][pBits[0]], quantized[1][pBits[1]]};
+
+      ezUInt8 indices[16];
+      const float fError = evaluateEndpointsBC7(block, pWeights, endpoints, pBits, uiColorPrec, uiNumChannels, uiPBitsPerSubset, uiIndexPrec, indices);
+
+      if (fError < inout_best.m_fError)
+      {
+        inout_best.m_Endpoints[0] = endpoints[0];
+        inout_best.m_Endpoints[1] = endpoints[1];
+        inout_best.m_PBits[0] = pBits[0];
+        inout_best.m_PBits[1] = pBits[1];
+        inout_best.m_fError = fError;
+        memcpy(inout_pBestIndices, indices, 16);
+      }
+    }
+  }
+
+  // Encodes the pixels with a weight greater than zero as one subset. The indices of all other pixels are undefined.
+  void encodeSubsetBC7(const BlockData& block, const float* pWeights, ezUInt32 uiColorPrec, ezUInt32 uiNumChannels, ezUInt32 uiPBitsPerSubset,
+                       ezUInt32 uiIndexPrec, ezBlockCompressionQuality::Enum quality, EndpointsBC7& out_endpoints, ezUInt8* out_pIndices)
+  {
+    ezSimdVec4f mean, axis;
+    ezSimdVec4f endpoints[2];
+    computePrincipalAxis(block, pWeights, uiNumChannels, mean, axis);
+    computeEndpoints(block, pWeights, mean, axis, endpoints[0], endpoints[1]);
+
+    out_endpoints = EndpointsBC7();
+    tryEndpointsBC7(block, pWeights, endpoints, uiColorPrec, uiNumChannels, uiPBitsPerSubset, uiIndexPrec, quality, out_endpoints, out_pIndices);
+
+    const int* pInterpolationWeights = getInterpolationWeightsBC7(uiIndexPrec);
+    float indexWeights[16];
+    for (ezUInt32 i = 0; i < (1u << uiIndexPrec); ++i)
+    {
+      indexWeights[i] = pInterpolationWeights[i] / static_cast<float>(s_bc67WeightMax);
+    }
+
+    const ezUInt32 uiNumRefinements = quality == ezBlockCompressionQuality::Fast ? 0 : (quality == ezBlockCompressionQuality::Balanced ? 1 : 3);
+    for (ezUInt32 iteration = 0; iteration < uiNumRefinements; ++iteration)
+    {
+      if (!refineEndpoints(block, pWeights, out_pIndices, indexWeights, endpoints[0], endpoints[1]))
+        break;
+
+      const float fPreviousError = out_endpoints.m_fError;
+      tryEndpointsBC7(block, pWeights, endpoints, uiColorPrec, uiNumChannels, uiPBitsPerSubset, uiIndexPrec, quality, out_endpoints, out_pIndices);
+
+      if (out_endpoints.m_fError >= fPreviousError)
+        break;
+    }
+  }
+
+  // Encodes the block with one of the modes that use neither rotation nor separate alpha indices (0, 1, 2, 3, 6 and 7).
+  // Returns the squared error of the encoding.
+  float encodeBlockBC7Mode(const BlockData& block, ezUInt32 uiMode, ezUInt32 uiShape, ezBlockCompressionQuality::Enum quality, ezUInt8* pTarget)
+  {
+    const BC7ModeInfo& info = s_bc7ModeInfos[uiMode];
+    const ezUInt32 uiNumSubsets = info.partitions + 1u;
+    const ezUInt32 uiNumChannels = info.rgbaPrec.a > 0 ? 4 : 3;
+    const ezUInt32 uiColorPrec = info.rgbaPrec.r;
+    const ezUInt32 uiPBitsPerSubset = info.pBits / uiNumSubsets;
+    const ezUInt8* pPartition = s_bc67PartitionTable[info.partitions][uiShape];
+
+    EndpointsBC7 endpoints[3];
+    ezUInt8 subsetIndices[3][16];
+    float fError = 0.0f;
+
+    for (ezUInt32 s = 0; s < uiNumSubsets; ++s)
+    {
+      float weights[16];
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        weights[i] = pPartition[i] == s ? 1.0f : 0.0f;
+      }
+
+      encodeSubsetBC7(block, weights, uiColorPrec, uiNumChannels, uiPBitsPerSubset, info.indexPrec, quality, endpoints[s], subsetIndices[s]);
+      fError += endpoints[s].m_fError;
+    }
+
+    ezUInt8 indices[16];
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      indices[i] = subsetIndices[pPartition[i]][i];
+    }
+
+    // the most significant index bit of the anchor pixel of each subset is implicitly zero
+    const ezUInt32 uiMaxIndex = (1u << info.indexPrec) - 1;
+    for (ezUInt32 s = 0; s < uiNumSubsets; ++s)
+    {
+      if (indices[s_bc67FixUp[info.partitions][uiShape][s]] > (uiMaxIndex >> 1))
+      {
+        ezMath::Swap(endpoints[s].m_Endpoints[0], endpoints[s].m_Endpoints[1]);
+        ezMath::Swap(endpoints[s].m_PBits[0], endpoints[s].m_PBits[1]);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          if (pPartition[i] == s)
+            indices[i] = static_cast<ezUInt8>(uiMaxIndex - indices[i]);
+        }
+      }
+    }
+
+    BitWriterBC7 writer(pTarget);
+    writer.WriteBits(1u << uiMode, uiMode + 1);
+    writer.WriteBits(uiShape, info.partitionBits);
+
+    for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+    {
+      for (ezUInt32 s = 0; s < uiNumSubsets; ++s)
+      {
+        writer.WriteBits(endpoints[s].m_Endpoints[0].GetData()[c], uiColorPrec);
+        writer.WriteBits(endpoints[s].m_Endpoints[1].GetData()[c], uiColorPrec);
+      }
+    }
+
+    for (ezUInt32 s = 0; s < uiNumSubsets; ++s)
+    {
+      for (ezUInt32 p = 0; p < uiPBitsPerSubset; ++p)
+      {
+        writer.WriteBits(endpoints[s].m_PBits[p], 1);
+      }
+    }
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      writer.WriteBits(indices[i], isFixUpOffset(info.partitions, uiShape, i) ? info.indexPrec - 1 : info.indexPrec);
+    }
+
+    return fError;
+  }
+
+  // Rates the first uiNumShapes partitions by how well each subset fits onto a line and returns the most promising ones.
+  // The remaining error across the lines is also a rough lower bound for the error of the encoding.
+  void findBestPartitionsBC7(const BlockData& block, const BlockMoments& moments, ezUInt32 uiPartitions, ezUInt32 uiNumShapes, ezUInt32 uiNumChannels,
+                             ezUInt32 uiNumCandidates, ezUInt32* out_pShapes, float* out_pEstimates)
+  {
+    for (ezUInt32 c = 0; c < uiNumCandidates; ++c)
+    {
+      out_pShapes[c] = 0;
+      out_pEstimates[c] = ezMath::MaxValue<float>();
+    }
+
+    for (ezUInt32 uiShape = 0; uiShape < uiNumShapes; ++uiShape)
+    {
+      const ezUInt8* pPartition = s_bc67PartitionTable[uiPartitions][uiShape];
+      float fEstimate = 0.0f;
+
+      for (ezUInt32 s = 0; s <= uiPartitions; ++s)
+      {
+        ezSimdVec4f mask[4];
+        for (ezUInt32 row = 0; row < 4; ++row)
+        {
+          const ezUInt8* p = pPartition + 4 * row;
+          mask[row].Set(p[0] == s ? 1.0f : 0.0f, p[1] == s ? 1.0f : 0.0f, p[2] == s ? 1.0f : 0.0f, p[3] == s ? 1.0f : 0.0f);
+        }
+
+        fEstimate += estimateLineError(block, moments, mask, uiNumChannels);
+      }
+
+      for (ezUInt32 c = 0; c < uiNumCandidates; ++c)
+      {
+        if (fEstimate < out_pEstimates[c])
+        {
+          for (ezUInt32 move = uiNumCandidates - 1; move > c; --move)
+          {
+            out_pShapes[move] = out_pShapes[move - 1];
+            out_pEstimates[move] = out_pEstimates[move - 1];
+          }
+
+          out_pShapes[c] = uiShape;
+          out_pEstimates[c] = fEstimate;
+          break;
+        }
+      }
+    }
+  }
+
+  void encodeBlockBC7(const BlockData& block, const ezColorBaseUB* pSource, ezBlockCompressionQuality::Enum quality, ezUInt8* pTarget)
+  {
+    // mode 6 handles smooth blocks with and without alpha well
+    float fBestError = encodeBlockBC7Mode(block, 6, 0, quality, pTarget);
+
+    // at fast quality only blocks that don't fit onto a single line at all try the modes with multiple subsets
+    const float fMinError = quality == ezBlockCompressionQuality::Fast ? 16.0f * 64.0f : 0.0f;
+    if (fBestError <= fMinError)
+      return;
+
+    bool bOpaque = true;
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      bOpaque &= pSource[i].a == 255;
+    }
+
+    BlockMoments moments;
+    computeMoments(block, bOpaque ? 3 : 4, moments);
+
+    auto tryMode = [&](ezUInt32 uiMode, ezUInt32 uiShape) {
+      ezUInt8 candidate[16];
+      const float fError = encodeBlockBC7Mode(block, uiMode, uiShape, quality, candidate);
+
+      if (fError < fBestError)
+      {
+        fBestError = fError;
+        memcpy(pTarget, candidate, 16);
+      }
+    };
+
+    // two subsets: mode 1 and 3 for opaque blocks, mode 7 for blocks with alpha
+    {
+      const ezUInt32 uiNumCandidates = quality == ezBlockCompressionQuality::High ? 4 : 1;
+      ezUInt32 shapes[4];
+      float estimates[4];
+      findBestPartitionsBC7(block, moments, 1, 64, bOpaque ? 3 : 4, uiNumCandidates, shapes, estimates);
+
+      for (ezUInt32 c = 0; c < uiNumCandidates && estimates[c] < fBestError; ++c)
+      {
+        if (bOpaque)
+        {
+          tryMode(1, shapes[c]);
+
+          if (quality != ezBlockCompressionQuality::Fast)
+          {
+            tryMode(3, shapes[c]);
+          }
+        }
+        else
+        {
+          tryMode(7, shapes[c]);
+        }
+      }
+    }
+
+    // three subsets: mode 0 (only uses the first 16 partitions) and mode 2, both opaque only
+    if (quality == ezBlockCompressionQuality::High && bOpaque)
+    {
+      ezUInt32 shapes[2];
+      float estimates[2];
+      findBestPartitionsBC7(block, moments, 2, 64, 3, 2, shapes, estimates);
+
+      for (ezUInt32 c = 0; c < 2 && estimates[c] < fBestError; ++c)
+      {
+        tryMode(2, shapes[c]);
+      }
+
+      findBestPartitionsBC7(block, moments, 2, 16, 3, 2, shapes, estimates);
+
+      for (ezUInt32 c = 0; c < 2 && estimates[c] < fBestError; ++c)
+      {
+        tryMode(0, shapes[c]);
+      }
+    }
+  }
+} // namespace
+
+void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  BlockData block;
+  loadBlock(pSource, block);
+  encodeBlockBC1(block, pSource, false, quality, pTarget);
+}
+
+void ezCompressBlockBC3(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  ezUInt8 alpha[16];
+  for (ezUInt32 i = 0; i < 16; ++i)
+  {
+    alpha[i] = pSource[i].a;
+  }
+
+  encodeAlphaBC3(alpha, pTarget);
+
+  BlockData block;
+  loadBlock(pSource, block);
+  encodeBlockBC1(block, pSource, true, quality, pTarget + 8);
+}
+
+void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  BlockData block;
+  loadBlock(pSource, block);
+  encodeBlockBC7(block, pSource, quality, pTarget);
+}
+
 class ezImageConversion_BC1_RGBA : public ezImageConversionStepDecompressBlocks
 {
 public:
@@ -2117,6 +3180,94 @@ static ezImageConversion_CompressBC5 s_conversion_compressBC5;
 
 #endif
 
+ezCVarInt cvar_BlockCompressionQuality("texture.BlockCompressionQuality", ezBlockCompressionQuality::Default, ezCVarFlags::Default,
+                                       "Quality of the BC1, BC3 and BC7 compressors: 0 = fast, 1 = balanced, 2 = high");
+
+class ezImageConversion_CompressBC1BC3BC7 : public ezImageConversionStepCompressBlocks
+{
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    static ezImageConversionEntry supportedConversions[] = {
+        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC1_UNORM, ezImageConversionFlags::Default),
+        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC3_UNORM, ezImageConversionFlags::Default),
+        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC7_UNORM, ezImageConversionFlags::Default),
+        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC1_UNORM_SRGB, ezImageConversionFlags::Default),
+        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC3_UNORM_SRGB, ezImageConversionFlags::Default),
+        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC7_UNORM_SRGB, ezImageConversionFlags::Default),
+    };
+
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+    // Slightly penalize these conversions, so that the DirectXTex conversions are preferred when a hardware device is available
+    for (auto& entry : supportedConversions)
+    {
+      entry.m_additionalPenalty = 1.0f;
+    }
+#endif
+
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    const ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezUInt32 targetBlockSize = ezImageFormat::GetBitsPerBlock(targetFormat) / 8;
+    const ezBlockCompressionQuality::Enum quality =
+        static_cast<ezBlockCompressionQuality::Enum>(ezMath::Clamp<int>(cvar_BlockCompressionQuality, ezBlockCompressionQuality::Fast, ezBlockCompressionQuality::High));
+
+    void (*compressBlock)(const ezColorBaseUB*, ezUInt8*, ezBlockCompressionQuality::Enum) = nullptr;
+    switch (targetFormat)
+    {
+      case ezImageFormat::BC1_UNORM:
+      case ezImageFormat::BC1_UNORM_SRGB:
+        compressBlock = &ezCompressBlockBC1;
+        break;
+      case ezImageFormat::BC3_UNORM:
+      case ezImageFormat::BC3_UNORM_SRGB:
+        compressBlock = &ezCompressBlockBC3;
+        break;
+      case ezImageFormat::BC7_UNORM:
+      case ezImageFormat::BC7_UNORM_SRGB:
+        compressBlock = &ezCompressBlockBC7;
+        break;
+      default:
+        return EZ_FAILURE;
+    }
+
+    // Every row of blocks is compressed independently
+    ezTaskSystem::ParallelForIndexed(
+        0, numBlocksY,
+        [&](ezUInt32 startRow, ezUInt32 endRow) {
+          for (ezUInt32 blockY = startRow; blockY < endRow; ++blockY)
+          {
+            for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
+            {
+              ezColorBaseUB sourceBlock[16];
+
+              for (ezUInt32 y = 0; y < 4; ++y)
+              {
+                const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch + 16 * blockX;
+                memcpy(sourceBlock + 4 * y, sourcePointer, 16);
+              }
+
+              ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * targetBlockSize;
+              compressBlock(sourceBlock, targetPointer, quality);
+            }
+          }
+        },
+        "ezImageConversion_CompressBC1BC3BC7");
+
+    return EZ_SUCCESS;
+  }
+};
+
+static ezImageConversion_CompressBC1BC3BC7 s_conversion_compressBC1BC3BC7;
+
+const ezImageConversionStep* ezGetPortableBlockCompressionStep()
+{
+  return &s_conversion_compressBC1BC3BC7;
+}
+
 static ezImageConversion_BC1_RGBA s_conversion_BC1_RGBA;
 static ezImageConversion_BC2_RGBA s_conversion_BC2_RGBA;
 static ezImageConversion_BC3_RGBA s_conversion_BC3_RGBA;
@@ -3,6 +3,7 @@
 #include <Texture/Image/Image.h>
 
 class ezColorLinear16f;
+class ezImageConversionStep;
 
 EZ_TEXTURE_DLL void ezDecompressBlockBC1(const ezUInt8* pSource, ezColorBaseUB* pTarget, bool bForceFourColorMode);
 EZ_TEXTURE_DLL void ezDecompressBlockBC4(const ezUInt8* pSource, ezUInt8* pTarget, ezUInt32 uiStride, ezUInt8 bias);
@@ -11,3 +12,30 @@ EZ_TEXTURE_DLL void ezDecompressBlockBC7(const ezUInt8* pSource, ezColorBaseUB*
 
 EZ_TEXTURE_DLL void ezUnpackPaletteBC4(ezUInt32 a0, ezUInt32 a1, ezUInt32* alphas);
 
+/// \brief Quality levels of the BC1, BC3 and BC7 block compressors. Higher levels try more encodings per block and are slower.
+struct ezBlockCompressionQuality
+{
+  typedef ezUInt8 StorageType;
+
+  enum Enum
+  {
+    Fast,     ///< Fits the endpoints once along the principal axis of the block.
+    Balanced, ///< Additionally refines the endpoints and tries the best two-subset partition for opaque BC7 blocks.
+    High,     ///< Searches more endpoints, p-bits and BC7 partitions.
+
+    Default = Balanced
+  };
+};
+
+/// \brief Compresses a block of 4x4 pixels (row by row) into 8 bytes of BC1 data. Pixels that are not fully opaque become transparent.
+EZ_TEXTURE_DLL void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses a block of 4x4 pixels (row by row) into 16 bytes of BC3 data.
+EZ_TEXTURE_DLL void ezCompressBlockBC3(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses a block of 4x4 pixels (row by row) into 16 bytes of BC7 data.
+EZ_TEXTURE_DLL void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Returns the image conversion step that uses the functions above. ezImageConversion may prefer other steps for the same
+/// formats, e.g. the DirectXTex compressors on Windows.
+EZ_TEXTURE_DLL const ezImageConversionStep* ezGetPortableBlockCompressionStep();
@@ -2,6 +2,7 @@
 
 #include <Foundation/Math/Rect.h>
 #include <Foundation/Math/Size.h>
+#include <Foundation/Types/Delegate.h>
 #include <Texture/Image/Image.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -83,6 +84,15 @@ public:
   /// Genererates the mip maps for the image. The input texture must be in ezImageFormat::R32_G32_B32_A32_FLOAT
   static void GenerateMipMaps(const ezImageView& source, ezImage& target, const MipMapOptions& options);
 
+  /// Receives one mip level of one face and array element. The view is only valid for the duration of the call.
+  using MipMapCallback = ezDelegate<void(const ezImageView& mipMap, ezUInt32 uiMipLevel, ezUInt32 uiFace, ezUInt32 uiArrayIndex)>;
+
+  /// \brief Generates the same mip maps as GenerateMipMaps(), but passes each level to \a callback instead of storing the whole chain.
+  ///
+  /// Only two consecutive mip levels are kept in memory at a time, so large images can be converted or written out level by level.
+  /// The callback is invoked with increasing mip levels, starting with the source itself as level 0.
+  static void GenerateMipMapsStreamed(const ezImageView& source, const MipMapOptions& options, const MipMapCallback& callback);
+
   /// Assumes that the Red and Green components of an image contain XY of an unit length normal and reconstructs the Z component into B
   static void ReconstructNormalZ(ezImage& source);
 
@@ -3,6 +3,7 @@
 #include <Texture/Image/ImageUtils.h>
 
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -648,6 +649,53 @@ inline static void FilterLine(ezUInt32 numSourceElements, const ezSimdVec4f* __r
   }
 }
 
+// Computes one target row as the weighted sum of whole source rows. Compared to filtering each column with FilterLine,
+// all memory accesses are linear and the address mode only has to be resolved once per source row.
+static void FilterRows(ezUInt32 numSourceRows, const ezSimdVec4f* __restrict sourceBegin, ezUInt64 sourceRowStride, ezSimdVec4f* __restrict targetRow,
+  ezUInt32 rowLength, ezUInt32 targetRowIndex, const ezImageFilterWeights& weights, ezImageAddressMode::Enum addressMode,
+  const ezSimdVec4f& borderColor)
+{
+  for (ezUInt32 x = 0; x < rowLength; ++x)
+  {
+    targetRow[x].SetZero();
+  }
+
+  const ezInt32 firstSourceIdx = weights.GetFirstSourceSampleIndex(targetRowIndex);
+
+  for (ezUInt32 weightIdx = 0; weightIdx < weights.GetNumWeights(); ++weightIdx)
+  {
+    const ezSimdVec4f weight(weights.GetWeight(targetRowIndex, weightIdx));
+
+    bool useBorderColor = false;
+    const ezUInt32 sourceIdx =
+      ezImageUtils::GetSampleIndex(numSourceRows, firstSourceIdx + static_cast<ezInt32>(weightIdx), addressMode, useBorderColor);
+
+    if (useBorderColor)
+    {
+      for (ezUInt32 x = 0; x < rowLength; ++x)
+      {
+        targetRow[x] = ezSimdVec4f::MulAdd(borderColor, weight, targetRow[x]);
+      }
+    }
+    else
+    {
+      const ezSimdVec4f* __restrict sourceRow = sourceBegin + sourceIdx * sourceRowStride;
+      for (ezUInt32 x = 0; x < rowLength; ++x)
+      {
+        targetRow[x] = ezSimdVec4f::MulAdd(sourceRow[x], weight, targetRow[x]);
+      }
+    }
+  }
+}
+
+// Lets every task of the filter passes work on at least this many pixels, so that small images don't pay for the task overhead.
+static ezParallelForParams GetFilterParallelForParams(ezUInt32 pixelsPerItem)
+{
+  ezParallelForParams params;
+  params.uiBinSize = ezMath::Max(1u, 16384u / ezMath::Max(1u, pixelsPerItem));
+  return params;
+}
+
 static void DownScaleFastLine(
   ezUInt32 pixelStride, const ezUInt8* src, ezUInt8* dest, ezUInt32 lengthIn, ezUInt32 strideIn, ezUInt32 lengthOut, ezUInt32 strideOut)
 {
@@ -912,12 +960,12 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepSource = &conversionScratch;
   };
 
-  ezHybridArray<ezInt32, 256> firstSampleIndices;
-  firstSampleIndices.Reserve(ezMath::Max(width, height, depth));
+  const ezSimdVec4f borderColorSimd(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
 
   if (width != originalWidth)
   {
     ezImageFilterWeights weights(*filter, originalWidth, width);
+    ezHybridArray<ezInt32, 256> firstSampleIndices;
     firstSampleIndices.SetCountUninitialized(width);
     for (ezUInt32 x = 0; x < width; ++x)
     {
@@ -938,22 +986,23 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetWidth(width);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+    // Every row of every slice, face and array element is filtered independently
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * originalDepth * originalHeight,
+      [&](ezUInt32 startLine, ezUInt32 endLine) {
+        for (ezUInt32 line = startLine; line < endLine; ++line)
         {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = line % originalHeight;
+          const ezUInt32 z = (line / originalHeight) % originalDepth;
+          const ezUInt32 face = (line / (originalHeight * originalDepth)) % numFaces;
+          const ezUInt32 arrayIndex = line / (originalHeight * originalDepth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, borderColorSimd);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D", GetFilterParallelForParams(width));
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -962,11 +1011,6 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
   if (height != originalHeight)
   {
     ezImageFilterWeights weights(*filter, originalHeight, height);
-    firstSampleIndices.SetCount(height);
-    for (ezUInt32 y = 0; y < height; ++y)
-    {
-      firstSampleIndices[y] = weights.GetFirstSourceSampleIndex(y);
-    }
 
     ezImage* stepTarget;
     if (depth == originalDepth && format == ezImageFormat::R32G32B32A32_FLOAT)
@@ -982,22 +1026,22 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetHeight(height);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * originalDepth * height,
+      [&](ezUInt32 startRow, ezUInt32 endRow) {
+        for (ezUInt32 row = startRow; row < endRow; ++row)
         {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = row % height;
+          const ezUInt32 z = (row / height) % originalDepth;
+          const ezUInt32 face = (row / (height * originalDepth)) % numFaces;
+          const ezUInt32 arrayIndex = row / (height * originalDepth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, 0, z);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterRows(originalHeight, filterSource, width, filterTarget, width, y, weights, addressModeV, borderColorSimd);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D", GetFilterParallelForParams(width * originalHeight));
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1006,11 +1050,6 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
   if (depth != originalDepth)
   {
     ezImageFilterWeights weights(*filter, originalDepth, depth);
-    firstSampleIndices.SetCount(depth);
-    for (ezUInt32 z = 0; z < depth; ++z)
-    {
-      firstSampleIndices[z] = weights.GetFirstSourceSampleIndex(z);
-    }
 
     ezImage* stepTarget;
     if (format == ezImageFormat::R32G32B32A32_FLOAT)
@@ -1026,22 +1065,22 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetDepth(depth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < height; ++y)
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * depth * height,
+      [&](ezUInt32 startRow, ezUInt32 endRow) {
+        for (ezUInt32 row = startRow; row < endRow; ++row)
         {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = row % height;
+          const ezUInt32 z = (row / height) % depth;
+          const ezUInt32 face = (row / (height * depth)) % numFaces;
+          const ezUInt32 arrayIndex = row / (height * depth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, 0);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterRows(originalDepth, filterSource, width * height, filterTarget, width, z, weights, addressModeW, borderColorSimd);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D", GetFilterParallelForParams(width * originalDepth));
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1051,30 +1090,65 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
   return ezImageConversion::Convert(*stepSource, target, format);
 }
 
-void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, const MipMapOptions& options)
+static ezUInt32 PrepareMipMapOptions(const ezImageView& source, const ezImageUtils::MipMapOptions& options, ezImageUtils::MipMapOptions& out_Options)
 {
-  ezImageHeader header = source.GetHeader();
-  EZ_ASSERT_DEV(header.GetImageFormat() == ezImageFormat::R32G32B32A32_FLOAT, "The source image must be a RGBA 32-bit float format.");
-  EZ_ASSERT_DEV(&source != &target, "Source and target must not be the same image.");
+  EZ_ASSERT_DEV(source.GetImageFormat() == ezImageFormat::R32G32B32A32_FLOAT, "The source image must be a RGBA 32-bit float format.");
 
   // Make a local copy to be able to tweak some of the options
-  ezImageUtils::MipMapOptions mipMapOptions = options;
+  out_Options = options;
 
   // alpha thresholds with extreme values are not supported at the moment
-  mipMapOptions.m_alphaThreshold = ezMath::Clamp(mipMapOptions.m_alphaThreshold, 0.05f, 0.95f);
+  out_Options.m_alphaThreshold = ezMath::Clamp(out_Options.m_alphaThreshold, 0.05f, 0.95f);
 
   // Enforce CLAMP addressing mode for cubemaps
   if (source.GetNumFaces() == 6)
   {
-    mipMapOptions.m_addressModeU = ezImageAddressMode::Clamp;
-    mipMapOptions.m_addressModeV = ezImageAddressMode::Clamp;
+    out_Options.m_addressModeU = ezImageAddressMode::Clamp;
+    out_Options.m_addressModeV = ezImageAddressMode::Clamp;
+  }
+
+  ezUInt32 numMipMaps = source.GetHeader().ComputeNumberOfMipMaps();
+  if (out_Options.m_numMipMaps > 0 && out_Options.m_numMipMaps < numMipMaps)
+  {
+    numMipMaps = out_Options.m_numMipMaps;
   }
 
-  ezUInt32 numMipMaps = header.ComputeNumberOfMipMaps();
-  if (mipMapOptions.m_numMipMaps > 0 && mipMapOptions.m_numMipMaps < numMipMaps)
+  return numMipMaps;
+}
+
+static ezImageHeader GetNextMipMapHeader(const ezImageHeader& currentMipMapHeader)
+{
+  ezImageHeader nextMipMapHeader = currentMipMapHeader;
+  nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
+  nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
+  nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
+  return nextMipMapHeader;
+}
+
+static void GenerateNextMipMap(const ezImageView& currentMipMap, ezImage& nextMipMap, const ezImageUtils::MipMapOptions& options, float targetCoverage)
+{
+  ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMap.GetWidth(), nextMipMap.GetHeight(), nextMipMap.GetDepth(), options.m_filter,
+    options.m_addressModeU, options.m_addressModeV, options.m_addressModeW, options.m_borderColor);
+
+  if (options.m_preserveCoverage)
+  {
+    NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), options.m_alphaThreshold, targetCoverage);
+  }
+
+  if (options.m_renormalizeNormals)
   {
-    numMipMaps = mipMapOptions.m_numMipMaps;
+    ezImageUtils::RenormalizeNormalMap(nextMipMap);
   }
+}
+
+void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, const MipMapOptions& options)
+{
+  EZ_ASSERT_DEV(&source != &target, "Source and target must not be the same image.");
+
+  ezImageUtils::MipMapOptions mipMapOptions;
+  const ezUInt32 numMipMaps = PrepareMipMapOptions(source, options, mipMapOptions);
+
+  ezImageHeader header = source.GetHeader();
   header.SetNumMipLevels(numMipMaps);
 
   target.ResetAndAlloc(header);
@@ -1102,10 +1176,7 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, c
 
       for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
       {
-        ezImageHeader nextMipMapHeader = currentMipMapHeader;
-        nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
-        nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
-        nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
+        ezImageHeader nextMipMapHeader = GetNextMipMapHeader(currentMipMapHeader);
 
         auto sourceData = target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
         ezImage currentMipMap;
@@ -1115,21 +1186,54 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, c
         ezImage nextMipMap;
         nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
 
-        ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMapHeader.GetWidth(), nextMipMapHeader.GetHeight(),
-          nextMipMapHeader.GetDepth(), mipMapOptions.m_filter, mipMapOptions.m_addressModeU, mipMapOptions.m_addressModeV,
-          mipMapOptions.m_addressModeW, mipMapOptions.m_borderColor);
+        GenerateNextMipMap(currentMipMap, nextMipMap, mipMapOptions, targetCoverage);
 
-        if (mipMapOptions.m_preserveCoverage)
-        {
-          NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold, targetCoverage);
-        }
+        currentMipMapHeader = nextMipMapHeader;
+      }
+    }
+  }
+}
 
-        if (mipMapOptions.m_renormalizeNormals)
-        {
-          RenormalizeNormalMap(nextMipMap);
-        }
+void ezImageUtils::GenerateMipMapsStreamed(const ezImageView& source, const MipMapOptions& options, const MipMapCallback& callback)
+{
+  ezImageUtils::MipMapOptions mipMapOptions;
+  const ezUInt32 numMipMaps = PrepareMipMapOptions(source, options, mipMapOptions);
 
-        currentMipMapHeader = nextMipMapHeader;
+  // The two most recent mip levels, used alternately as the source and the target of the next level
+  ezImage mipMaps[2];
+
+  for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
+  {
+    for (ezUInt32 face = 0; face < source.GetNumFaces(); face++)
+    {
+      ezImageHeader currentMipMapHeader = source.GetHeader();
+      currentMipMapHeader.SetNumMipLevels(1);
+      currentMipMapHeader.SetNumFaces(1);
+      currentMipMapHeader.SetNumArrayIndices(1);
+
+      ezImageView currentMipMap;
+      currentMipMap.ResetAndViewExternalStorage(currentMipMapHeader, source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr());
+
+      callback(currentMipMap, 0, face, arrayIndex);
+
+      float targetCoverage = 0.0f;
+      if (mipMapOptions.m_preserveCoverage)
+      {
+        targetCoverage = EvaluateAverageCoverage(currentMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
+      }
+
+      for (ezUInt32 mipMapLevel = 1; mipMapLevel < numMipMaps; mipMapLevel++)
+      {
+        currentMipMapHeader = GetNextMipMapHeader(currentMipMapHeader);
+
+        ezImage& nextMipMap = mipMaps[mipMapLevel % 2];
+        nextMipMap.ResetAndAlloc(currentMipMapHeader);
+
+        GenerateNextMipMap(currentMipMap, nextMipMap, mipMapOptions, targetCoverage);
+
+        callback(nextMipMap, mipMapLevel, face, arrayIndex);
+
+        currentMipMap.ResetAndViewExternalStorage(currentMipMapHeader, nextMipMap.GetByteBlobPtr());
       }
     }
   }
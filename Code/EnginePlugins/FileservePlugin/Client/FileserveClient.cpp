@@ -4,8 +4,10 @@
 #include <FileservePlugin/Fileserver/ClientContext.h>
 #include <Foundation/Communication/GlobalEvent.h>
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
@@ -14,6 +16,25 @@ EZ_IMPLEMENT_SINGLETON(ezFileserveClient);
 
 bool ezFileserveClient::s_bEnableFileserve = true;
 
+/// \brief Writes a prefetched file to the cache, so that the network can be serviced in the meantime.
+struct ezFileserveClient::CacheWriteTask : public ezTask
+{
+  CacheWriteTask() { ConfigureTask("Fileserve Cache Write", ezTaskNesting::Never); }
+
+  virtual void Execute() override
+  {
+    WriteDownloadToDisk(m_sCachedFile, m_Download, m_bCompressed);
+    WriteMetaFile(m_sCachedMetaFile, m_iFileTimeStamp, m_uiFileHash);
+  }
+
+  ezStringBuilder m_sCachedFile;
+  ezStringBuilder m_sCachedMetaFile;
+  ezInt64 m_iFileTimeStamp = 0;
+  ezUInt64 m_uiFileHash = 0;
+  bool m_bCompressed = false;
+  ezDynamicArray<ezUInt8> m_Download;
+};
+
 ezFileserveClient::ezFileserveClient()
     : m_SingletonRegistrar(this)
 {
@@ -74,6 +95,8 @@ void ezFileserveClient::ClearState()
   m_CurFileRequestGuid = ezUuid();
   m_sCurFileRequest.Clear();
   m_Download.Clear();
+  m_PrefetchDownloads.Clear();
+  m_uiServerProtocolVersion = 0;
 }
 
 ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
@@ -125,8 +148,12 @@ ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
     {
       ezLog::Success("Connected to ezFileserver '{0}", m_sServerConnectionAddress);
       m_Network->SetMessageHandler('FSRV', ezMakeDelegate(&ezFileserveClient::NetworkMsgHandler, this));
+      m_Network->SetMessageHandler('FSVS', ezMakeDelegate(&ezFileserveClient::NetworkVersionMsgHandler, this));
 
-      m_Network->Send('FSRV', 'HELO'); // be friendly
+      // be friendly, the server answers with its protocol version
+      ezRemoteMessage msg('FSRV', 'HELO');
+      msg.GetWriter() << ezFileserveProtocolVersion;
+      m_Network->Send(ezRemoteTransmitMode::Reliable, msg);
     }
 
     m_bFailedToConnect = false;
@@ -135,6 +162,17 @@ ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
   return EZ_SUCCESS;
 }
 
+void ezFileserveClient::NetworkVersionMsgHandler(ezRemoteMessage& msg)
+{
+  if (msg.GetMessageID() == 'HELO')
+  {
+    msg.GetReader() >> m_uiServerProtocolVersion;
+    return;
+  }
+
+  ezLog::Error("Unknown FSVS message: '{0}' - {1} bytes", msg.GetMessageID(), msg.GetMessageSize());
+}
+
 void ezFileserveClient::UpdateClient()
 {
   EZ_LOCK(m_Mutex);
@@ -154,6 +192,24 @@ void ezFileserveClient::UpdateClient()
   m_CurrentTime = ezTime::Now();
 
   m_Network->ExecuteAllMessageHandlers();
+
+  if (m_bReloadResources && !m_bDownloading)
+  {
+    m_bReloadResources = false;
+
+    // all loaded resources are about to be read again, bring the files that were accessed so far up to date in one go instead of one
+    // round-trip per file, if the server does not support that, they are downloaded one by one as before
+    ezDynamicArray<ezString> files;
+    files.Reserve(m_FileDataDir.GetCount());
+    for (auto it = m_FileDataDir.GetIterator(); it.IsValid(); ++it)
+    {
+      files.PushBack(it.Key());
+    }
+
+    PrefetchFiles(files).IgnoreResult();
+
+    EZ_BROADCAST_EVENT(ezResourceManager_ReloadAllResources);
+  }
 }
 
 void ezFileserveClient::AddServerAddressToTry(const char* szAddress)
@@ -350,23 +406,13 @@ void ezFileserveClient::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
-  static bool s_bReloadResources = false;
-
   if (msg.GetMessageID() == 'RLDR')
   {
-    s_bReloadResources = true;
-  }
-
-  if (!m_bDownloading && s_bReloadResources)
-  {
-    EZ_BROADCAST_EVENT(ezResourceManager_ReloadAllResources);
-    s_bReloadResources = false;
+    // handled in UpdateClient(), files cannot be downloaded while the message handlers are executed
+    m_bReloadResources = true;
     return;
   }
 
-  if (msg.GetMessageID() == 'RLDR')
-    return;
-
   if (msg.GetMessageID() == 'UACK')
   {
     m_bWaitingForUploadFinished = false;
@@ -441,11 +487,21 @@ void ezFileserveClient::DeleteFile(ezUInt16 uiDataDir, const char* szFile)
 void ezFileserveClient::HandleFileTransferMsg(ezRemoteMessage& msg)
 {
   EZ_LOCK(m_Mutex);
+  ezDynamicArray<ezUInt8>* pDownload = nullptr;
+
   {
     ezUuid fileRequestGuid;
     msg.GetReader() >> fileRequestGuid;
 
-    if (fileRequestGuid != m_CurFileRequestGuid)
+    if (fileRequestGuid == m_CurFileRequestGuid)
+    {
+      pDownload = &m_Download;
+    }
+    else if (PrefetchDownload* pPrefetch = m_PrefetchDownloads.GetValue(fileRequestGuid))
+    {
+      pDownload = &pPrefetch->m_Download;
+    }
+    else
     {
       // ezLog::Debug("Fileserver is answering someone else");
       return;
@@ -459,13 +515,13 @@ void ezFileserveClient::HandleFileTransferMsg(ezRemoteMessage& msg)
   msg.GetReader() >> uiFileSize;
 
   // make sure we don't need to reallocate
-  m_Download.Reserve(uiFileSize);
+  pDownload->Reserve(uiFileSize);
 
   if (uiChunkSize > 0)
   {
-    const ezUInt32 uiStartPos = m_Download.GetCount();
-    m_Download.SetCountUninitialized(uiStartPos + uiChunkSize);
-    msg.GetReader().ReadBytes(&m_Download[uiStartPos], uiChunkSize);
+    const ezUInt32 uiStartPos = pDownload->GetCount();
+    pDownload->SetCountUninitialized(uiStartPos + uiChunkSize);
+    msg.GetReader().ReadBytes(&(*pDownload)[uiStartPos], uiChunkSize);
   }
 }
 
@@ -473,19 +529,30 @@ void ezFileserveClient::HandleFileTransferMsg(ezRemoteMessage& msg)
 void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 {
   EZ_LOCK(m_Mutex);
-  EZ_SCOPE_EXIT(m_bDownloading = false);
 
+  ezUuid fileRequestGuid;
+  msg.GetReader() >> fileRequestGuid;
+
+  if (fileRequestGuid == m_CurFileRequestGuid)
   {
-    ezUuid fileRequestGuid;
-    msg.GetReader() >> fileRequestGuid;
+    EZ_SCOPE_EXIT(m_bDownloading = false);
 
-    if (fileRequestGuid != m_CurFileRequestGuid)
-    {
-      // ezLog::Debug("Fileserver is answering someone else");
-      return;
-    }
+    HandleFinishedDownload(msg, m_sCurFileRequest, m_Download, false);
+    return;
+  }
+
+  if (PrefetchDownload* pPrefetch = m_PrefetchDownloads.GetValue(fileRequestGuid))
+  {
+    HandleFinishedDownload(msg, pPrefetch->m_sFile, pPrefetch->m_Download, true);
+    m_PrefetchDownloads.Remove(fileRequestGuid);
+    return;
   }
 
+  // ezLog::Debug("Fileserver is answering someone else");
+}
+
+void ezFileserveClient::HandleFinishedDownload(ezRemoteMessage& msg, const ezString& sFile, ezDynamicArray<ezUInt8>& download, bool bIsPrefetch)
+{
   ezFileserveFileState fileState;
   {
     ezInt8 iFileStatus = 0;
@@ -502,13 +569,20 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   ezUInt16 uiFoundInDataDir = 0;
   msg.GetReader() >> uiFoundInDataDir;
 
+  // only answers to a prefetch request say whether the data is compressed
+  bool bCompressed = false;
+  if (bIsPrefetch)
+  {
+    msg.GetReader() >> bCompressed;
+  }
+
   if (uiFoundInDataDir == 0xffff) // file does not exist on server in any data dir
   {
-    m_FileDataDir[m_sCurFileRequest] = 0; // placeholder
+    m_FileDataDir[sFile] = 0; // placeholder
 
     for (ezUInt32 i = 0; i < m_MountedDataDirs.GetCount(); ++i)
     {
-      auto& ref = m_MountedDataDirs[i].m_CacheStatus[m_sCurFileRequest];
+      auto& ref = m_MountedDataDirs[i].m_CacheStatus[sFile];
       ref.m_FileHash = 0;
       ref.m_TimeStamp = 0;
       ref.m_LastCheck = m_CurrentTime;
@@ -518,9 +592,9 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   }
   else
   {
-    m_FileDataDir[m_sCurFileRequest] = uiFoundInDataDir;
+    m_FileDataDir[sFile] = uiFoundInDataDir;
 
-    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[m_sCurFileRequest];
+    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[sFile];
     ref.m_FileHash = uiFileHash;
     ref.m_TimeStamp = iFileTimeStamp;
     ref.m_LastCheck = m_CurrentTime;
@@ -532,7 +606,7 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   const ezString& sMountPoint = m_MountedDataDirs[uiFoundInDataDir].m_sMountPoint;
   ezStringBuilder sCachedFile, sCachedMetaFile;
-  BuildPathInCache(m_sCurFileRequest, sMountPoint, &sCachedFile, &sCachedMetaFile);
+  BuildPathInCache(sFile, sMountPoint, &sCachedFile, &sCachedMetaFile);
 
   if (fileState == ezFileserveFileState::NonExistant)
   {
@@ -550,8 +624,24 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   if (fileState == ezFileserveFileState::Different)
   {
-    WriteDownloadToDisk(sCachedFile);
-    WriteMetaFile(sCachedMetaFile, iFileTimeStamp, uiFileHash);
+    // prefetched files are written in the background, so that the network can be serviced in the meantime
+    if (bIsPrefetch)
+    {
+      ezSharedPtr<CacheWriteTask> pTask = EZ_DEFAULT_NEW(CacheWriteTask);
+      pTask->m_sCachedFile = sCachedFile;
+      pTask->m_sCachedMetaFile = sCachedMetaFile;
+      pTask->m_iFileTimeStamp = iFileTimeStamp;
+      pTask->m_uiFileHash = uiFileHash;
+      pTask->m_bCompressed = bCompressed;
+      pTask->m_Download.Swap(download);
+
+      m_CacheWriteTasks.PushBack(ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::LongRunningHighPriority));
+    }
+    else
+    {
+      WriteDownloadToDisk(sCachedFile, download, bCompressed);
+      WriteMetaFile(sCachedMetaFile, iFileTimeStamp, uiFileHash);
+    }
   }
 }
 
@@ -572,14 +662,35 @@ void ezFileserveClient::WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 i
   }
 }
 
-void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile)
+void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile, const ezDynamicArray<ezUInt8>& download, bool bCompressed)
 {
-  EZ_LOCK(m_Mutex);
   ezOSFile file;
   if (file.Open(sCachedFile, ezFileOpenMode::Write).Succeeded())
   {
-    if (!m_Download.IsEmpty())
-      file.Write(m_Download.GetData(), m_Download.GetCount());
+    if (bCompressed)
+    {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+      ezRawMemoryStreamReader reader(download);
+      ezCompressedStreamReaderZstd decompressor(&reader);
+
+      ezUInt8 uiTemp[1024 * 8];
+      while (true)
+      {
+        const ezUInt64 uiRead = decompressor.ReadBytes(uiTemp, EZ_ARRAY_SIZE(uiTemp));
+
+        if (uiRead == 0)
+          break;
+
+        file.Write(uiTemp, uiRead);
+      }
+#else
+      EZ_REPORT_FAILURE("Received compressed data without zstd support");
+#endif
+    }
+    else if (!download.IsEmpty())
+    {
+      file.Write(download.GetData(), download.GetCount());
+    }
 
     file.Close();
   }
@@ -677,6 +788,126 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
   }
 }
 
+ezResult ezFileserveClient::PrefetchFiles(ezArrayPtr<const ezString> files)
+{
+  EZ_LOCK(m_Mutex);
+  if (m_bDownloading)
+  {
+    ezLog::Warning("Trying to prefetch files over fileserve while another file is already downloading. Prefetch is ignored.");
+    return EZ_FAILURE;
+  }
+
+  if (m_Network == nullptr || !m_Network->IsConnectedToServer())
+    return EZ_FAILURE;
+
+  if (m_uiServerProtocolVersion == 0)
+  {
+    // the answer to 'HELO' usually arrived long ago, servers that never answer only know protocol version 1
+    const ezTime tStart = ezTime::Now();
+    while (m_uiServerProtocolVersion == 0 && ezTime::Now() - tStart < ezTime::Seconds(1) && m_Network->IsConnectedToServer())
+    {
+      m_Network->UpdateRemoteInterface();
+      m_Network->ExecuteAllMessageHandlers();
+    }
+
+    if (m_uiServerProtocolVersion == 0)
+    {
+      m_uiServerProtocolVersion = 1;
+    }
+  }
+
+  if (m_uiServerProtocolVersion < 2)
+  {
+    ezLog::Dev("The fileserver does not support prefetching files.");
+    return EZ_FAILURE;
+  }
+
+  m_CurrentTime = ezTime::Now();
+
+  ezRemoteMessage msg('FSRV', 'PREF');
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  msg.GetWriter() << true; // compressed data is welcome
+#else
+  msg.GetWriter() << false;
+#endif
+
+  ezHybridArray<ezUInt32, 256> requestedFiles;
+
+  for (ezUInt32 i = 0; i < files.GetCount(); ++i)
+  {
+    const ezString& sFile = files[i];
+
+    bool bCachedYet = false;
+    auto itFileDataDir = m_FileDataDir.FindOrAdd(sFile, &bCachedYet);
+    if (!bCachedYet)
+    {
+      FillFileStatusCache(sFile);
+    }
+
+    // same check as in DownloadFile(), files that were checked recently are not requested again
+    const FileCacheStatus& CacheStatus = m_MountedDataDirs[itFileDataDir.Value()].m_CacheStatus[sFile];
+    if (m_CurrentTime - CacheStatus.m_LastCheck < ezTime::Seconds(5.0f))
+      continue;
+
+    requestedFiles.PushBack(i);
+  }
+
+  if (requestedFiles.IsEmpty())
+    return EZ_SUCCESS;
+
+  msg.GetWriter() << requestedFiles.GetCount();
+
+  for (ezUInt32 i : requestedFiles)
+  {
+    const ezString& sFile = files[i];
+    const ezUInt16 uiUseDataDirCache = m_FileDataDir[sFile];
+    const FileCacheStatus& CacheStatus = m_MountedDataDirs[uiUseDataDirCache].m_CacheStatus[sFile];
+
+    ezUuid downloadGuid;
+    downloadGuid.CreateNewUuid();
+
+    m_PrefetchDownloads[downloadGuid].m_sFile = sFile;
+
+    msg.GetWriter() << uiUseDataDirCache;
+    msg.GetWriter() << sFile;
+    msg.GetWriter() << downloadGuid;
+    msg.GetWriter() << CacheStatus.m_TimeStamp;
+    msg.GetWriter() << CacheStatus.m_FileHash;
+  }
+
+  m_bDownloading = true;
+  EZ_SCOPE_EXIT(m_bDownloading = false);
+
+  // a single request for all files, the server streams back the answers without waiting for us
+  m_Network->Send(ezRemoteTransmitMode::Reliable, msg);
+
+  while (!m_PrefetchDownloads.IsEmpty() && m_Network->IsConnectedToServer())
+  {
+    m_Network->UpdateRemoteInterface();
+    m_Network->ExecuteAllMessageHandlers();
+
+    // the cache status of each file is valid from the moment its answer arrived
+    m_CurrentTime = ezTime::Now();
+  }
+
+  // the cache must be complete before any of the files gets opened
+  for (const ezTaskGroupID& taskGroup : m_CacheWriteTasks)
+  {
+    ezTaskSystem::WaitForGroup(taskGroup);
+  }
+
+  m_CacheWriteTasks.Clear();
+
+  if (!m_PrefetchDownloads.IsEmpty())
+  {
+    m_PrefetchDownloads.Clear();
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
 void ezFileserveClient::DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const
 {
   EZ_LOCK(m_Mutex);
@@ -4,6 +4,8 @@
 
 #include <Foundation/Communication/RemoteInterface.h>
 #include <Foundation/Configuration/Singleton.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <Foundation/Types/Uuid.h>
 
@@ -79,6 +81,21 @@ public:
   /// \brief Adds an address that should be tried for connecting with the server.
   void AddServerAddressToTry(const char* szAddress);
 
+  /// \brief Brings the cached versions of all the given files up to date with a single request to the server.
+  ///
+  /// The paths are relative to the mounted data directories, just like when opening the files through ezFileSystem. For each file the best
+  /// matching data directory is determined, same as for a regular file access.
+  /// Downloading files one by one takes at least one round-trip to the server per file. Here all files are stat-checked and transferred
+  /// in one stream instead, with larger files compressed, and the downloaded files are written to the cache on a background thread while
+  /// the next ones arrive. Call this with the list of files that are about to be loaded, e.g. when a level gets loaded, so that the following
+  /// file accesses are served from the cache.
+  ///
+  /// This is also done automatically for all files that were accessed so far, when the server requests to reload all resources.
+  ///
+  /// Returns EZ_FAILURE if there is no connection to the server, the server is too old to support prefetching, or a download is already
+  /// in progress.
+  ezResult PrefetchFiles(ezArrayPtr<const ezString> files);
+
 private:
   friend class ezDataDirectory::FileserveType;
 
@@ -92,6 +109,14 @@ private:
     ezTime m_LastCheck;
   };
 
+  struct PrefetchDownload
+  {
+    ezString m_sFile;
+    ezDynamicArray<ezUInt8> m_Download;
+  };
+
+  struct CacheWriteTask;
+
   struct DataDir
   {
     // ezString m_sRootName;
@@ -110,10 +135,12 @@ private:
     ezStringBuilder* out_pFullPathMeta) const;
   void GetFullDataDirCachePath(const char* szDataDir, ezStringBuilder& out_sFullPath, ezStringBuilder& out_sFullPathMeta) const;
   void NetworkMsgHandler(ezRemoteMessage& msg);
+  void NetworkVersionMsgHandler(ezRemoteMessage& msg);
   void HandleFileTransferMsg(ezRemoteMessage& msg);
   void HandleFileTransferFinishedMsg(ezRemoteMessage& msg);
+  void HandleFinishedDownload(ezRemoteMessage& msg, const ezString& sFile, ezDynamicArray<ezUInt8>& download, bool bIsPrefetch);
   static void WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash);
-  void WriteDownloadToDisk(ezStringBuilder sCachedFile);
+  static void WriteDownloadToDisk(ezStringBuilder sCachedFile, const ezDynamicArray<ezUInt8>& download, bool bCompressed);
   ezResult DownloadFile(ezUInt16 uiDataDirID, const char* szFile, bool bForceThisDataDir, ezStringBuilder* out_pFullPath);
   void DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const;
   void UploadFile(ezUInt16 uiDataDirID, const char* szFile, const ezDynamicArray<ezUInt8>& fileContent);
@@ -131,10 +158,14 @@ private:
   bool m_bDownloading = false;
   bool m_bFailedToConnect = false;
   bool m_bWaitingForUploadFinished = false;
+  bool m_bReloadResources = false;
+  ezUInt16 m_uiServerProtocolVersion = 0; ///< 0 until the server answered the 'HELO' message.
   ezUuid m_CurFileRequestGuid;
   ezStringBuilder m_sCurFileRequest;
   ezUniquePtr<ezRemoteInterface> m_Network;
   ezDynamicArray<ezUInt8> m_Download;
+  ezHashTable<ezUuid, PrefetchDownload> m_PrefetchDownloads;
+  ezDynamicArray<ezTaskGroupID> m_CacheWriteTasks;
   ezTime m_CurrentTime;
   ezHybridArray<ezString, 4> m_TryServerAddresses;
 
@@ -18,7 +18,7 @@ void ezDataDirectory::FileserveType::ReloadExternalConfigs()
   FolderType::ReloadExternalConfigs();
 }
 
-ezDataDirectoryReader* ezDataDirectory::FileserveType::OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir)
+ezDataDirectoryReader* ezDataDirectory::FileserveType::OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir, ezUInt64 uiFileKey)
 {
   // fileserve cannot handle absolute paths, which is actually already ruled out at creation time, so this is just an optimization
   if (ezPathUtils::IsAbsolutePath(szFile))
@@ -37,7 +37,8 @@ ezDataDirectoryReader* ezDataDirectory::FileserveType::OpenFileToRead(const char
     return nullptr;
 
   // It's fine to use the base class here as it will resurface in CreateFolderReader which gives us control of the important part.
-  return FolderType::OpenFileToRead(sFullPath, FileShareMode, bSpecificallyThisDataDir);
+  // the file is opened from the local cache, the key of the requested path doesn't apply to it
+  return FolderType::OpenFileToRead(sFullPath, FileShareMode, bSpecificallyThisDataDir, 0);
 }
 
 ezDataDirectoryWriter* ezDataDirectory::FileserveType::OpenFileToWrite(const char* szFile, ezFileShareMode::Enum FileShareMode)
@@ -108,7 +109,7 @@ ezResult ezDataDirectory::FileserveType::GetFileStats(const char* szFileOrFolder
   return ezOSFile::GetFileStats(sFullPath, out_Stats);
 }
 
-bool ezDataDirectory::FileserveType::ExistsFile(const char* szFile, bool bOneSpecificDataDir)
+bool ezDataDirectory::FileserveType::ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey)
 {
   ezStringBuilder sRedirected;
   if (ResolveAssetRedirection(szFile, sRedirected))
@@ -40,12 +40,12 @@ namespace ezDataDirectory
     void FinishedWriting(FolderWriter* pWriter);
 
   protected:
-    virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir) override;
+    virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir, ezUInt64 uiFileKey) override;
     virtual ezDataDirectoryWriter* OpenFileToWrite(const char* szFile, ezFileShareMode::Enum FileShareMode) override;
     virtual ezResult InternalInitializeDataDirectory(const char* szDirectory) override;
     virtual void RemoveDataDirectory() override;
     virtual void DeleteFile(const char* szFile) override;
-    virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir) override;
+    virtual bool ExistsFile(const char* szFile, bool bOneSpecificDataDir, ezUInt64 uiFileKey) override;
     /// \brief Limitation: Fileserve does not handle folders, only files. If someone stats a folder, this will fail.
     virtual ezResult GetFileStats(const char* szFileOrFolder, bool bOneSpecificDataDir, ezFileStats& out_Stats) override;
     virtual FolderReader* CreateFolderReader() const override;
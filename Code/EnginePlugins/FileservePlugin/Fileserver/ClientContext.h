@@ -14,6 +14,12 @@ enum class ezFileserveFileState
   Different = 5,
 };
 
+/// \brief Version of the messages that ezFileserveClient and ezFileserver exchange.
+///
+/// The client sends its version with the 'HELO' message and the server answers with its own version under the 'FSVS' system ID,
+/// which version 1 clients ignore. Servers that don't answer only know version 1. Version 2 added the 'PREF' prefetch request.
+constexpr ezUInt16 ezFileserveProtocolVersion = 2;
+
 class EZ_FILESERVEPLUGIN_DLL ezFileserveClientContext
 {
 public:
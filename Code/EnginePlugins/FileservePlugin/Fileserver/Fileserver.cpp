@@ -4,7 +4,9 @@
 #include <FileservePlugin/Fileserver/Fileserver.h>
 #include <Foundation/Algorithm/HashingUtils.h>
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
 
 EZ_IMPLEMENT_SINGLETON(ezFileserver);
@@ -83,7 +85,18 @@ void ezFileserver::NetworkMsgHandler(ezRemoteMessage& msg)
   auto& client = DetermineClient(msg);
 
   if (msg.GetMessageID() == 'HELO')
+  {
+    // older clients don't send their protocol version and would not understand the answer
+    // messages are broadcast to all clients, so the answer uses its own system ID, for which older clients have no message handler
+    if (msg.GetMessageSize() > 0)
+    {
+      ezRemoteMessage ret('FSVS', 'HELO');
+      ret.GetWriter() << ezFileserveProtocolVersion;
+      m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+    }
+
     return;
+  }
 
   if (msg.GetMessageID() == 'RUTR')
   {
@@ -102,6 +115,12 @@ void ezFileserver::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
+  if (msg.GetMessageID() == 'PREF')
+  {
+    HandlePrefetchRequest(client, msg);
+    return;
+  }
+
   if (msg.GetMessageID() == 'UPLH')
   {
     HandleUploadFileHeader(client, msg);
@@ -268,12 +287,71 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
   msg.GetReader() >> status.m_iTimestamp;
   msg.GetReader() >> status.m_uiHash;
 
+  SendFileToClient(client, uiDataDirID, bForceThisDataDir, sRequestedFile, downloadGuid, status, false, false);
+}
+
+void ezFileserver::HandlePrefetchRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
+{
+  // the client only asks for compressed data, if it is able to decompress it
+  bool bCompress = false;
+  msg.GetReader() >> bCompress;
+
+#ifndef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  bCompress = false;
+#endif
+
+  ezUInt32 uiNumFiles = 0;
+  msg.GetReader() >> uiNumFiles;
+
+  ezStringBuilder sRequestedFile;
+
+  // answer all requests in one go, the client does not wait for one file to arrive before it requests the next
+  for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+  {
+    ezUInt16 uiDataDirID = 0;
+    msg.GetReader() >> uiDataDirID;
+    msg.GetReader() >> sRequestedFile;
+
+    ezUuid downloadGuid;
+    msg.GetReader() >> downloadGuid;
+
+    ezFileserveClientContext::FileStatus status;
+    msg.GetReader() >> status.m_iTimestamp;
+    msg.GetReader() >> status.m_uiHash;
+
+    SendFileToClient(client, uiDataDirID, false, sRequestedFile, downloadGuid, status, true, bCompress);
+  }
+}
+
+void ezFileserver::SendFileToClient(ezFileserveClientContext& client, ezUInt16 uiDataDirID, bool bForceThisDataDir, const char* szRequestedFile,
+  const ezUuid& downloadGuid, ezFileserveClientContext::FileStatus status, bool bIsPrefetch, bool bCompress)
+{
   ezFileserverEvent e;
   e.m_uiClientID = client.m_uiApplicationID;
-  e.m_szPath = sRequestedFile;
+  e.m_szPath = szRequestedFile;
   e.m_uiSentTotal = 0;
 
-  const ezFileserveFileState filestate = client.GetFileStatus(uiDataDirID, sRequestedFile, status, m_SendToClient, bForceThisDataDir);
+  const ezFileserveFileState filestate = client.GetFileStatus(uiDataDirID, szRequestedFile, status, m_SendToClient, bForceThisDataDir);
+
+  // small files are not worth the effort
+  bCompress = bCompress && filestate == ezFileserveFileState::Different && m_SendToClient.GetCount() > 1024;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (bCompress)
+  {
+    ezMemoryStreamContainerStorage<ezDynamicArray<ezUInt8>> storage(m_SendToClient.GetCount());
+
+    {
+      ezMemoryStreamWriter writer(&storage);
+      ezCompressedStreamWriterZstd compressor(&writer, ezCompressedStreamWriterZstd::Compression::Fastest);
+      compressor.WriteBytes(m_SendToClient.GetData(), m_SendToClient.GetCount());
+      compressor.FinishCompressedStream();
+    }
+
+    m_SendToClient.SetCountUninitialized(storage.GetStorageSize());
+    ezMemoryUtils::Copy(m_SendToClient.GetData(), storage.GetData(), storage.GetStorageSize());
+  }
+#endif
 
   {
     e.m_Type = ezFileserverEvent::Type::FileDownloadRequest;
@@ -324,6 +402,12 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
     ret.GetWriter() << status.m_uiHash;
     ret.GetWriter() << uiDataDirID;
 
+    // only answers to 'PREF' carry the compression flag, so 'READ' answers stay the same for clients of protocol version 1
+    if (bIsPrefetch)
+    {
+      ret.GetWriter() << bCompress;
+    }
+
     m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
   }
 
@@ -94,6 +94,9 @@ private:
   void HandleMountRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUnmountRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleFileRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
+  void HandlePrefetchRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
+  void SendFileToClient(ezFileserveClientContext& client, ezUInt16 uiDataDirID, bool bForceThisDataDir, const char* szRequestedFile,
+    const ezUuid& downloadGuid, ezFileserveClientContext::FileStatus status, bool bIsPrefetch, bool bCompress);
   void HandleDeleteFileRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUploadFileHeader(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUploadFileTransfer(ezFileserveClientContext& client, ezRemoteMessage &msg);
@@ -4,6 +4,7 @@
 #include <Core/World/WorldModule.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
 #include <Foundation/Time/Clock.h>
 #include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Gravity.h>
@@ -68,27 +69,60 @@ void ezParticleBehaviorFactory_Gravity::QueryFinalizerDependencies(ezSet<const e
 
 //////////////////////////////////////////////////////////////////////////
 
+ezParticleBehavior_Gravity::ezParticleBehavior_Gravity()
+{
+  m_bSupportsParallelProcessing = true;
+}
+
 void ezParticleBehavior_Gravity::CreateRequiredStreams()
 {
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
+void ezParticleBehavior_Gravity::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
+{
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
+
+  const ezVec3 vGravity = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity() : ezVec3(0.0f, 0.0f, -10.0f);
+  const ezVec3 g = vGravity * m_fGravityFactor * (float)tDiff.GetSeconds();
+
+  m_vAddGravity[0].Set(g.x, g.y, g.z, g.x);
+  m_vAddGravity[1].Set(g.y, g.z, g.x, g.y);
+  m_vAddGravity[2].Set(g.z, g.x, g.y, g.z);
+}
+
 void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Gravity");
 
-  const ezVec3 vGravity = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity() : ezVec3(0.0f, 0.0f, -10.0f);
+  ProcessRange(0, uiNumElements);
+}
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
-  const ezVec3 addGravity = vGravity * m_fGravityFactor * tDiff;
+void ezParticleBehavior_Gravity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  ezSimdVec4f vAddGravity0, vAddGravity1, vAddGravity2;
+  vAddGravity0.Load<4>(&m_vAddGravity[0].x);
+  vAddGravity1.Load<4>(&m_vAddGravity[1].x);
+  vAddGravity2.Load<4>(&m_vAddGravity[2].x);
 
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  // four packed velocities are exactly three SIMD vectors, the stream padding allows to always process full blocks
+  float* pVelocity = m_pStreamVelocity->GetWritableData<float>() + uiStartIndex * 3;
+  float* pVelocityEnd = pVelocity + uiNumElements * 3;
 
-  while (!itVelocity.HasReachedEnd())
+  for (; pVelocity < pVelocityEnd; pVelocity += 12)
   {
-    itVelocity.Current() += addGravity;
-
-    itVelocity.Advance();
+    ezSimdVec4f v0, v1, v2;
+    v0.Load<4>(pVelocity + 0);
+    v1.Load<4>(pVelocity + 4);
+    v2.Load<4>(pVelocity + 8);
+
+    v0 += vAddGravity0;
+    v1 += vAddGravity1;
+    v2 += vAddGravity2;
+
+    v0.Store<4>(pVelocity + 0);
+    v1.Store<4>(pVelocity + 4);
+    v2.Store<4>(pVelocity + 8);
   }
 }
 
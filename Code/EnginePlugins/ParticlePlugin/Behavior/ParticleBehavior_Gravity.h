@@ -29,6 +29,8 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleBehavior_Gravity final : public ezParticle
   EZ_ADD_DYNAMIC_REFLECTION(ezParticleBehavior_Gravity, ezParticleBehavior);
 
 public:
+  ezParticleBehavior_Gravity();
+
   float m_fGravityFactor;
 
   virtual void CreateRequiredStreams() override;
@@ -36,11 +38,16 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Gravity;
 
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
   ezPhysicsWorldModuleInterface* m_pPhysicsModule;
 
   ezProcessingStream* m_pStreamVelocity;
+
+  // the velocity change of this step, rotated such that it can be added to four packed ezVec3 at once
+  ezVec4 m_vAddGravity[3];
 };
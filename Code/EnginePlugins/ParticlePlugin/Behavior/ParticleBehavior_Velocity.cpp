@@ -99,44 +99,78 @@ void ezParticleBehaviorFactory_Velocity::QueryFinalizerDependencies(ezSet<const
   inout_FinalizerDeps.Insert(ezGetStaticRTTI<ezParticleFinalizerFactory_ApplyVelocity>());
 }
 
+ezParticleBehavior_Velocity::ezParticleBehavior_Velocity()
+{
+  m_bSupportsParallelProcessing = true;
+}
+
 void ezParticleBehavior_Velocity::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Velocity::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Velocity");
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  const float fDiff = (float)tDiff.GetSeconds();
   const ezVec3 vDown = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity().GetNormalized() : ezVec3(0.0f, 0.0f, -1.0f);
-  const ezVec3 vRise = vDown * tDiff * -m_fRiseSpeed;
+  const ezVec3 vRise = vDown * fDiff * -m_fRiseSpeed;
 
   ezVec3 vWind(0);
   if (m_pWindModule != nullptr)
   {
-    vWind = m_pWindModule->GetWindAt(GetOwnerSystem()->GetTransform().m_vPosition) * m_fWindInfluence * tDiff;
+    vWind = m_pWindModule->GetWindAt(GetOwnerSystem()->GetTransform().m_vPosition) * m_fWindInfluence * fDiff;
   }
 
-  const ezVec3 vAddPos0 = vRise + vWind;
-
-  ezSimdVec4f vAddPos;
-  vAddPos.Load<3>(&vAddPos0.x);
+  m_vAddPosition = (vRise + vWind).GetAsVec4(0.0f);
 
   const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
-  const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+  m_fFrictionFactor = ezMath::Pow(0.5f, fDiff * fFriction);
+}
+
+void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Velocity");
+
+  ProcessRange(0, uiNumElements);
+}
+
+void ezParticleBehavior_Velocity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  ezSimdVec4f vAddPos;
+  vAddPos.Load<4>(&m_vAddPosition.x);
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
     itPosition.Current() += vAddPos;
-    itVelocity.Current() *= fFrictionFactor;
 
     itPosition.Advance();
-    itVelocity.Advance();
+  }
+
+  // the velocities are scaled uniformly, so four packed ezVec3 can be treated as three SIMD vectors
+  const ezSimdFloat fFrictionFactor(m_fFrictionFactor);
+
+  float* pVelocity = m_pStreamVelocity->GetWritableData<float>() + uiStartIndex * 3;
+  float* pVelocityEnd = pVelocity + uiNumElements * 3;
+
+  for (; pVelocity < pVelocityEnd; pVelocity += 12)
+  {
+    ezSimdVec4f v0, v1, v2;
+    v0.Load<4>(pVelocity + 0);
+    v1.Load<4>(pVelocity + 4);
+    v2.Load<4>(pVelocity + 8);
+
+    v0 *= fFrictionFactor;
+    v1 *= fFrictionFactor;
+    v2 *= fFrictionFactor;
+
+    v0.Store<4>(pVelocity + 0);
+    v1.Store<4>(pVelocity + 4);
+    v2.Store<4>(pVelocity + 8);
   }
 }
 
@@ -32,6 +32,8 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleBehavior_Velocity final : public ezParticl
   EZ_ADD_DYNAMIC_REFLECTION(ezParticleBehavior_Velocity, ezParticleBehavior);
 
 public:
+  ezParticleBehavior_Velocity();
+
   virtual void CreateRequiredStreams() override;
 
   float m_fRiseSpeed = 0;
@@ -41,7 +43,9 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Velocity;
 
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
   virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
@@ -51,4 +55,8 @@ protected:
 
   ezProcessingStream* m_pStreamPosition;
   ezProcessingStream* m_pStreamVelocity;
+
+  // computed once per step, so that the ranges that are processed in parallel don't need to query the world modules
+  ezVec4 m_vAddPosition = ezVec4::ZeroVector();
+  float m_fFrictionFactor = 1.0f;
 };
@@ -4,6 +4,7 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Math/Declarations.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
 
 // clang-format off
@@ -30,6 +31,7 @@ ezParticleFinalizer_ApplyVelocity::ezParticleFinalizer_ApplyVelocity()
 {
   // a bit later than the other finalizers
   m_fPriority = 525.0f;
+  m_bSupportsParallelProcessing = true;
 }
 
 ezParticleFinalizer_ApplyVelocity::~ezParticleFinalizer_ApplyVelocity() {}
@@ -44,18 +46,22 @@ void ezParticleFinalizer_ApplyVelocity::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: ApplyVelocity");
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  ProcessRange(0, uiNumElements);
+}
+
+void ezParticleFinalizer_ApplyVelocity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  const ezSimdVec4f vDiff((float)m_TimeDiff.GetSeconds());
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezSimdVec4f* pPosition = m_pStreamPosition->GetWritableData<ezSimdVec4f>() + uiStartIndex;
+  const float* pVelocity = m_pStreamVelocity->GetData<float>() + uiStartIndex * 3;
 
-  while (!itPosition.HasReachedEnd())
+  for (ezUInt64 i = 0; i < uiNumElements; ++i)
   {
-    ezVec3& pos = reinterpret_cast<ezVec3&>(itPosition.Current());
-
-    pos += itVelocity.Current() * tDiff;
+    // Load<3> sets w to zero, so the w component of the position is kept
+    ezSimdVec4f vVelocity;
+    vVelocity.Load<3>(pVelocity + i * 3);
 
-    itPosition.Advance();
-    itVelocity.Advance();
+    pPosition[i] = ezSimdVec4f::MulAdd(vVelocity, vDiff, pPosition[i]);
   }
 }
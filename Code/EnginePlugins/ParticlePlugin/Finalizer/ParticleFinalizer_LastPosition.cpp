@@ -4,6 +4,7 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Math/Declarations.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_LastPosition.h>
 
 // clang-format off
@@ -32,6 +33,7 @@ ezParticleFinalizer_LastPosition::ezParticleFinalizer_LastPosition()
 {
   // do this at the start of the frame, but after the initializers
   m_fPriority = -499.0f;
+  m_bSupportsParallelProcessing = true;
 }
 
 ezParticleFinalizer_LastPosition::~ezParticleFinalizer_LastPosition() = default;
@@ -46,17 +48,16 @@ void ezParticleFinalizer_LastPosition::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: LastPosition");
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
-
-  while (!itPosition.HasReachedEnd())
-  {
-    ezVec3 curPos = itPosition.Current().GetAsVec3();
-    ezVec3& lastPos = itLastPosition.Current();
+  ProcessRange(0, uiNumElements);
+}
 
-    lastPos = curPos;
+void ezParticleFinalizer_LastPosition::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  const ezSimdVec4f* pPosition = m_pStreamPosition->GetData<ezSimdVec4f>() + uiStartIndex;
+  float* pLastPosition = m_pStreamLastPosition->GetWritableData<float>() + uiStartIndex * 3;
 
-    itPosition.Advance();
-    itLastPosition.Advance();
+  for (ezUInt64 i = 0; i < uiNumElements; ++i)
+  {
+    pPosition[i].Store<3>(pLastPosition + i * 3);
   }
 }
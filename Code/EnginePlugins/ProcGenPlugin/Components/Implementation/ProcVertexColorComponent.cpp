@@ -180,7 +180,8 @@ void ezProcVertexColorComponentManager::UpdateComponentVertexColors(ezProcVertex
 
   ezStringBuilder taskName = "VertexColor ";
   taskName.Append(pCpuMesh->GetResourceDescription().GetView());
-  pUpdateTask->ConfigureTask(taskName, ezTaskNesting::Never);
+  // the expression VM waits for its parallel chunks on large meshes
+  pUpdateTask->ConfigureTask(taskName, ezTaskNesting::Maybe);
 
   pUpdateTask->Prepare(*GetWorld(), mbDesc, pComponent->GetOwner()->GetGlobalTransform(), pComponent->m_Outputs,
     outputMappings, m_VertexColorData.GetArrayPtr().GetSubArray(uiBufferOffset, uiVertexColorCount));
@@ -56,9 +56,11 @@ namespace ezProcGenInternal
 {
   Output::~Output() = default;
 
+  ezHashedString ExpressionInputs::s_sPosition = ezMakeHashedString("Position");
   ezHashedString ExpressionInputs::s_sPositionX = ezMakeHashedString("PositionX");
   ezHashedString ExpressionInputs::s_sPositionY = ezMakeHashedString("PositionY");
   ezHashedString ExpressionInputs::s_sPositionZ = ezMakeHashedString("PositionZ");
+  ezHashedString ExpressionInputs::s_sNormal = ezMakeHashedString("Normal");
   ezHashedString ExpressionInputs::s_sNormalX = ezMakeHashedString("NormalX");
   ezHashedString ExpressionInputs::s_sNormalY = ezMakeHashedString("NormalY");
   ezHashedString ExpressionInputs::s_sNormalZ = ezMakeHashedString("NormalZ");
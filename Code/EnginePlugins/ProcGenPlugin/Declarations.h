@@ -147,9 +147,11 @@ namespace ezProcGenInternal
 
   struct EZ_PROCGENPLUGIN_DLL ExpressionInputs
   {
+    static ezHashedString s_sPosition;
     static ezHashedString s_sPositionX;
     static ezHashedString s_sPositionY;
     static ezHashedString s_sPositionZ;
+    static ezHashedString s_sNormal;
     static ezHashedString s_sNormalX;
     static ezHashedString s_sNormalY;
     static ezHashedString s_sNormalZ;
@@ -130,13 +130,8 @@ void PlacementTask::ExecuteVM()
 
     ezHybridArray<ezExpression::Stream, 8> inputs;
     {
-      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vPosition.x), ExpressionInputs::s_sPositionX));
-      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vPosition.y), ExpressionInputs::s_sPositionY));
-      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vPosition.z), ExpressionInputs::s_sPositionZ));
-
-      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vNormal.x), ExpressionInputs::s_sNormalX));
-      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vNormal.y), ExpressionInputs::s_sNormalY));
-      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vNormal.z), ExpressionInputs::s_sNormalZ));
+      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vPosition), ExpressionInputs::s_sPosition, ezExpression::Stream::Type::Float3));
+      inputs.PushBack(ezExpression::MakeStream(m_InputPoints.GetArrayPtr(), offsetof(PlacementPoint, m_vNormal), ExpressionInputs::s_sNormal, ezExpression::Stream::Type::Float3));
 
       // Point index
       ezArrayPtr<float> pointIndex = m_TempData.GetArrayPtr().GetSubArray(0, uiNumInstances);
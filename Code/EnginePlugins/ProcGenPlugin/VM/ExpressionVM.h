@@ -16,15 +16,14 @@ namespace ezExpression
       enum Enum
       {
         Float,
-        /*Float2, // not supported yet
-        Float3, // not supported yet
-        Float4, // not supported yet
+        Float2,
+        Float3,
+        Float4,
 
-        Int, // not supported yet
-        Int2, // not supported yet
-        Int3, // not supported yet
-        Int4, // not supported yet
-        */
+        Int,
+        Int2,
+        Int3,
+        Int4,
 
         Count
       };
@@ -36,6 +35,8 @@ namespace ezExpression
     ~Stream();
 
     ezUInt32 GetElementSize() const;
+    ezUInt32 GetNumComponents() const;
+    bool IsIntType() const;
     void ValidateDataSize(ezUInt32 uiNumInstances, const char* szDataName) const;
 
     ezHashedString m_sName;
@@ -44,12 +45,17 @@ namespace ezExpression
     ezUInt16 m_uiByteStride;
   };
 
+  /// \brief Creates a stream that reads or writes one element of the given type per entry of data.
+  ///
+  /// A vector stream (e.g. Float3) provides one input or output per component. The components are named after the stream with
+  /// the suffixes X, Y, Z and W, e.g. a Float3 stream called 'Position' provides 'PositionX', 'PositionY' and 'PositionZ'.
+  /// Int streams are converted to float when they are loaded and truncated when they are stored.
   template <typename T>
-  Stream MakeStream(ezArrayPtr<T> data, ezUInt32 uiOffset, const ezHashedString& sName)
+  Stream MakeStream(ezArrayPtr<T> data, ezUInt32 uiOffset, const ezHashedString& sName, Stream::Type::Enum type = Stream::Type::Float)
   {
     auto byteData = data.ToByteArray().GetSubArray(uiOffset);
 
-    return Stream(sName, Stream::Type::Float, byteData, sizeof(T));
+    return Stream(sName, type, byteData, sizeof(T));
   }
 } // namespace ezExpression
 
@@ -64,14 +70,33 @@ public:
 
   void RegisterDefaultFunctions();
 
+  /// \brief Executes the byte code for the given number of instances.
+  ///
+  /// Large instance counts are split into chunks that are executed in parallel through ezTaskSystem::ParallelFor,
+  /// therefore all registered functions need to be thread-safe and this must not be called from a task that is configured with ezTaskNesting::Never.
   ezResult Execute(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezExpression::Stream> outputs,
     ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData = ezExpression::GlobalData());
 
 private:
+  struct StreamMapping
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiStreamIndex;
+    ezUInt32 m_uiComponentIndex;
+  };
+
+  template <typename StreamType>
+  static ezResult MapStreams(ezArrayPtr<const ezHashedString> streamNames, ezArrayPtr<StreamType> streams, const char* szStreamType,
+    ezUInt32 uiNumInstances, ezDynamicArray<StreamMapping>& out_Mapping);
+
+  ezResult ExecuteChunk(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezExpression::Stream> outputs,
+    ezUInt32 uiFirstInstance, ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData, ezSimdVec4f* pRegisters) const;
+
   ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Registers;
 
-  ezDynamicArray<ezUInt32> m_InputMapping;
-  ezDynamicArray<ezUInt32> m_OutputMapping;
+  ezDynamicArray<StreamMapping> m_InputMapping;
+  ezDynamicArray<StreamMapping> m_OutputMapping;
   ezDynamicArray<ezUInt32> m_FunctionMapping;
 
   struct FunctionInfo
@@ -27,7 +27,8 @@ void ezDefaultExpressionFunctions::Random(ezExpression::Inputs inputs, ezExpress
 
 namespace
 {
-  static ezSimdPerlinNoise s_PerlinNoise(12345);
+  // shared by all threads that execute expressions, which is fine as long as it is never modified after construction
+  static const ezSimdPerlinNoise s_PerlinNoise(12345);
 }
 
 //static
@@ -1,6 +1,8 @@
 #include <ProcGenPluginPCH.h>
 
 #include <Foundation/SimdMath/SimdMath.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <ProcGenPlugin/VM/ExpressionByteCode.h>
 #include <ProcGenPlugin/VM/ExpressionVM.h>
 
@@ -14,6 +16,13 @@ namespace
 #  define VM_INLINE EZ_ALWAYS_INLINE
 #endif
 
+  enum
+  {
+    // Large instance counts are executed in chunks of this size in parallel.
+    // Must be a multiple of 4 so that every chunk starts at a register boundary.
+    InstancesPerChunk = 4096,
+  };
+
   template <typename Func>
   VM_INLINE void VMOperation1(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
     Func func)
@@ -84,72 +93,178 @@ namespace
     }
   }
 
-  VM_INLINE float ReadInputData(const ezUInt8* pData) { return *reinterpret_cast<const float*>(pData); }
+  struct FloatData
+  {
+    typedef float Type;
+
+    static VM_INLINE ezSimdVec4f ToRegister(const float* pValues)
+    {
+      ezSimdVec4f r;
+      r.Load<4>(pValues);
+      return r;
+    }
 
-  void VMLoadInput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezUInt32> inputMapping)
+    static VM_INLINE void FromRegister(const ezSimdVec4f& r, float* pValues) { r.Store<4>(pValues); }
+  };
+
+  struct IntData
   {
-    ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
-    ezSimdVec4f* re = r + uiNumRegisters;
+    typedef ezInt32 Type;
 
-    ezUInt32 uiInputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
-    uiInputIndex = inputMapping[uiInputIndex];
-    auto& input = inputs[uiInputIndex];
-    ezUInt32 uiByteStride = input.m_uiByteStride;
-    const ezUInt8* pInputData = input.m_Data.GetPtr();
-    const ezUInt8* pInputDataEnd = pInputData + input.m_Data.GetCount() - uiByteStride;
+    static VM_INLINE ezSimdVec4f ToRegister(const ezInt32* pValues) { return ezSimdVec4i(pValues[0], pValues[1], pValues[2], pValues[3]).ToFloat(); }
 
-    while (r != re)
+    static VM_INLINE void FromRegister(const ezSimdVec4f& r, ezInt32* pValues)
     {
-      float x = ReadInputData(pInputData);
-      pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
-      float y = ReadInputData(pInputData);
-      pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
-      float z = ReadInputData(pInputData);
-      pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
-      float w = ReadInputData(pInputData);
-      pInputData += pInputData < pInputDataEnd ? uiByteStride : 0;
-
-      r->Set(x, y, z, w);
-      ++r;
+      ezSimdVec4i i = ezSimdVec4i::Truncate(r);
+      pValues[0] = i.x();
+      pValues[1] = i.y();
+      pValues[2] = i.z();
+      pValues[3] = i.w();
+    }
+  };
+
+  template <typename T>
+  VM_INLINE T ReadInputData(const ezUInt8* pData)
+  {
+    return *reinterpret_cast<const T*>(pData);
+  }
+
+  template <typename DataType>
+  void VMLoadInputData(ezSimdVec4f* r, const ezExpression::Stream& input, ezUInt32 uiComponentIndex, ezUInt32 uiFirstInstance, ezUInt32 uiNumInstances)
+  {
+    typedef typename DataType::Type T;
+
+    const ezUInt32 uiByteStride = input.m_uiByteStride;
+    const ezUInt8* pInputData = input.m_Data.GetPtr() + uiFirstInstance * uiByteStride + uiComponentIndex * sizeof(T);
+
+    const ezUInt32 uiNumFullRegisters = uiNumInstances / 4;
+    ezSimdVec4f* re = r + uiNumFullRegisters;
+
+    if (uiByteStride == sizeof(T))
+    {
+      // tightly packed data can be loaded directly
+      while (r != re)
+      {
+        *r = DataType::ToRegister(reinterpret_cast<const T*>(pInputData));
+        pInputData += 4 * sizeof(T);
+        ++r;
+      }
+    }
+    else
+    {
+      while (r != re)
+      {
+        T values[4];
+        values[0] = ReadInputData<T>(pInputData);
+        values[1] = ReadInputData<T>(pInputData + uiByteStride);
+        values[2] = ReadInputData<T>(pInputData + uiByteStride * 2);
+        values[3] = ReadInputData<T>(pInputData + uiByteStride * 3);
+        pInputData += uiByteStride * 4;
+
+        *r = DataType::ToRegister(values);
+        ++r;
+      }
+    }
+
+    // the remaining lanes of a partially used register are filled with the last instance
+    const ezUInt32 uiNumRemainingInstances = uiNumInstances - uiNumFullRegisters * 4;
+    if (uiNumRemainingInstances > 0)
+    {
+      T values[4];
+      for (ezUInt32 i = 0; i < 4; ++i)
+      {
+        values[i] = ReadInputData<T>(pInputData);
+        pInputData += (i + 1) < uiNumRemainingInstances ? uiByteStride : 0;
+      }
+
+      *r = DataType::ToRegister(values);
+    }
+  }
+
+  void VMLoadInput(ezSimdVec4f* r, const ezExpression::Stream& input, ezUInt32 uiComponentIndex, ezUInt32 uiFirstInstance, ezUInt32 uiNumInstances)
+  {
+    if (input.IsIntType())
+    {
+      VMLoadInputData<IntData>(r, input, uiComponentIndex, uiFirstInstance, uiNumInstances);
+    }
+    else
+    {
+      VMLoadInputData<FloatData>(r, input, uiComponentIndex, uiFirstInstance, uiNumInstances);
     }
   }
 
-  VM_INLINE void StoreOutputData(ezUInt8* pData, float fData) { *reinterpret_cast<float*>(pData) = fData; }
+  template <typename T>
+  VM_INLINE void StoreOutputData(ezUInt8* pData, T data)
+  {
+    *reinterpret_cast<T*>(pData) = data;
+  }
 
-  void VMStoreOutput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<ezExpression::Stream> outputs, ezArrayPtr<ezUInt32> outputMapping)
+  template <typename DataType>
+  void VMStoreOutputData(const ezSimdVec4f* r, ezExpression::Stream& output, ezUInt32 uiComponentIndex, ezUInt32 uiFirstInstance, ezUInt32 uiNumInstances)
   {
-    ezUInt32 uiOutputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
-    uiOutputIndex = outputMapping[uiOutputIndex];
-    auto& output = outputs[uiOutputIndex];
-    ezUInt32 uiByteStride = output.m_uiByteStride;
-    ezUInt8* pOutputData = output.m_Data.GetPtr();
-    ezUInt8* pOutputDataEnd = pOutputData + output.m_Data.GetCount() - uiByteStride;
+    typedef typename DataType::Type T;
 
-    ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
-    ezSimdVec4f* re = r + uiNumRegisters;
+    const ezUInt32 uiByteStride = output.m_uiByteStride;
+    ezUInt8* pOutputData = output.m_Data.GetPtr() + uiFirstInstance * uiByteStride + uiComponentIndex * sizeof(T);
 
-    while (r != re)
+    const ezUInt32 uiNumFullRegisters = uiNumInstances / 4;
+    const ezSimdVec4f* re = r + uiNumFullRegisters;
+
+    if (uiByteStride == sizeof(T))
+    {
+      // tightly packed data can be stored directly
+      while (r != re)
+      {
+        DataType::FromRegister(*r, reinterpret_cast<T*>(pOutputData));
+        pOutputData += 4 * sizeof(T);
+        ++r;
+      }
+    }
+    else
     {
-      float data[4];
-      r->Store<4>(data);
-
-      StoreOutputData(pOutputData, data[0]);
-      pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
-      StoreOutputData(pOutputData, data[1]);
-      pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
-      StoreOutputData(pOutputData, data[2]);
-      pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
-      StoreOutputData(pOutputData, data[3]);
-      pOutputData += pOutputData < pOutputDataEnd ? uiByteStride : 0;
+      while (r != re)
+      {
+        T values[4];
+        DataType::FromRegister(*r, values);
 
-      ++r;
+        StoreOutputData(pOutputData, values[0]);
+        StoreOutputData(pOutputData + uiByteStride, values[1]);
+        StoreOutputData(pOutputData + uiByteStride * 2, values[2]);
+        StoreOutputData(pOutputData + uiByteStride * 3, values[3]);
+        pOutputData += uiByteStride * 4;
+
+        ++r;
+      }
+    }
+
+    const ezUInt32 uiNumRemainingInstances = uiNumInstances - uiNumFullRegisters * 4;
+    if (uiNumRemainingInstances > 0)
+    {
+      T values[4];
+      DataType::FromRegister(*r, values);
+
+      for (ezUInt32 i = 0; i < uiNumRemainingInstances; ++i)
+      {
+        StoreOutputData(pOutputData, values[i]);
+        pOutputData += uiByteStride;
+      }
+    }
+  }
+
+  void VMStoreOutput(const ezSimdVec4f* r, ezExpression::Stream& output, ezUInt32 uiComponentIndex, ezUInt32 uiFirstInstance, ezUInt32 uiNumInstances)
+  {
+    if (output.IsIntType())
+    {
+      VMStoreOutputData<IntData>(r, output, uiComponentIndex, uiFirstInstance, uiNumInstances);
+    }
+    else
+    {
+      VMStoreOutputData<FloatData>(r, output, uiComponentIndex, uiFirstInstance, uiNumInstances);
     }
   }
 
   void VMCall(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    const ezExpression::GlobalData& globalData, ezExpressionFunction& func)
+    const ezExpression::GlobalData& globalData, const ezExpressionFunction& func)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezUInt32 uiNumArgs = ezExpressionByteCode::GetFunctionArgCount(pByteCode);
@@ -194,21 +309,26 @@ ezExpression::Stream::Stream(const ezHashedString& sName, Type::Enum type, ezArr
 ezExpression::Stream::~Stream() = default;
 
 ezUInt32 ezExpression::Stream::GetElementSize() const
+{
+  return GetNumComponents() * 4;
+}
+
+ezUInt32 ezExpression::Stream::GetNumComponents() const
 {
   switch (m_Type)
   {
     case Type::Float:
-      // case Type::Int:
+    case Type::Int:
+      return 1;
+    case Type::Float2:
+    case Type::Int2:
+      return 2;
+    case Type::Float3:
+    case Type::Int3:
+      return 3;
+    case Type::Float4:
+    case Type::Int4:
       return 4;
-      /*case Type::Float2:
-      case Type::Int2:
-        return 8;
-      case Type::Float3:
-      case Type::Int3:
-        return 12;
-      case Type::Float4:
-      case Type::Int4:
-        return 16;*/
 
       EZ_DEFAULT_CASE_NOT_IMPLEMENTED
   }
@@ -216,6 +336,11 @@ ezUInt32 ezExpression::Stream::GetElementSize() const
   return 0;
 }
 
+bool ezExpression::Stream::IsIntType() const
+{
+  return m_Type >= Type::Int;
+}
+
 void ezExpression::Stream::ValidateDataSize(ezUInt32 uiNumInstances, const char* szDataName) const
 {
   ezUInt32 uiElementSize = GetElementSize();
@@ -249,69 +374,72 @@ void ezExpressionVM::RegisterDefaultFunctions()
   RegisterFunction("PerlinNoise", &ezDefaultExpressionFunctions::PerlinNoise);
 }
 
-ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs,
-  ezArrayPtr<ezExpression::Stream> outputs, ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData)
+// static
+template <typename StreamType>
+ezResult ezExpressionVM::MapStreams(ezArrayPtr<const ezHashedString> streamNames, ezArrayPtr<StreamType> streams, const char* szStreamType,
+  ezUInt32 uiNumInstances, ezDynamicArray<StreamMapping>& out_Mapping)
 {
-  // Input mapping
-  {
-    auto inputNames = byteCode.GetInputs();
+  out_Mapping.Clear();
+  out_Mapping.Reserve(streamNames.GetCount());
 
-    m_InputMapping.Clear();
-    m_InputMapping.Reserve(inputNames.GetCount());
+  for (auto& streamName : streamNames)
+  {
+    bool bStreamFound = false;
 
-    for (auto& inputName : inputNames)
+    for (ezUInt32 i = 0; i < streams.GetCount() && !bStreamFound; ++i)
     {
-      bool bInputFound = false;
+      const ezExpression::Stream& stream = streams[i];
+      const ezUInt32 uiNumComponents = stream.GetNumComponents();
 
-      for (ezUInt32 i = 0; i < inputs.GetCount(); ++i)
+      ezUInt32 uiComponentIndex = 0;
+      if (uiNumComponents == 1)
       {
-        if (inputs[i].m_sName == inputName)
-        {
-          inputs[i].ValidateDataSize(uiNumInstances, "Input");
+        bStreamFound = stream.m_sName == streamName;
+      }
+      else if (ezStringUtils::StartsWith(streamName.GetData(), stream.m_sName.GetData()))
+      {
+        // vector streams provide one scalar stream per component, e.g. 'PositionX' for the x component of 'Position'
+        const char* szSuffix = streamName.GetData() + stream.m_sName.GetString().GetElementCount();
+        const char szComponentNames[] = "XYZW";
 
-          m_InputMapping.PushBack(i);
-          bInputFound = true;
-          break;
+        for (ezUInt32 c = 0; c < uiNumComponents; ++c)
+        {
+          if (szSuffix[0] == szComponentNames[c] && szSuffix[1] == '\0')
+          {
+            uiComponentIndex = c;
+            bStreamFound = true;
+            break;
+          }
         }
       }
 
-      if (!bInputFound)
+      if (bStreamFound)
       {
-        ezLog::Error("Bytecode expects an input '{0}'", inputName);
-        return EZ_FAILURE;
+        stream.ValidateDataSize(uiNumInstances, szStreamType);
+
+        auto& mapping = out_Mapping.ExpandAndGetRef();
+        mapping.m_uiStreamIndex = i;
+        mapping.m_uiComponentIndex = uiComponentIndex;
       }
     }
-  }
 
-  // Output mapping
-  {
-    auto outputNames = byteCode.GetOutputs();
-
-    m_OutputMapping.Clear();
-    m_OutputMapping.Reserve(outputNames.GetCount());
-
-    for (auto& outputName : outputNames)
+    if (!bStreamFound)
     {
-      bool bOutputFound = false;
-
-      for (ezUInt32 i = 0; i < outputs.GetCount(); ++i)
-      {
-        if (outputs[i].m_sName == outputName)
-        {
-          outputs[i].ValidateDataSize(uiNumInstances, "Output");
+      ezLog::Error("Bytecode expects an {0} '{1}'", szStreamType, streamName);
+      return EZ_FAILURE;
+    }
+  }
 
-          m_OutputMapping.PushBack(i);
-          bOutputFound = true;
-          break;
-        }
-      }
+  return EZ_SUCCESS;
+}
 
-      if (!bOutputFound)
-      {
-        ezLog::Error("Bytecode expects an output '{0}'", outputName);
-        return EZ_FAILURE;
-      }
-    }
+ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs,
+  ezArrayPtr<ezExpression::Stream> outputs, ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData)
+{
+  if (MapStreams(byteCode.GetInputs(), inputs, "input", uiNumInstances, m_InputMapping).Failed() ||
+      MapStreams(byteCode.GetOutputs(), outputs, "output", uiNumInstances, m_OutputMapping).Failed())
+  {
+    return EZ_FAILURE;
   }
 
   // Function mapping and validation
@@ -344,13 +472,41 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
     }
   }
 
-  const ezUInt32 uiNumRegisters = (uiNumInstances + 3) / 4;
-  const ezUInt32 uiLastInstanceIndex = uiNumInstances - 1;
+  // Every chunk gets its own set of registers, so chunks can be executed in parallel
+  const ezUInt32 uiNumChunks = (uiNumInstances + InstancesPerChunk - 1) / InstancesPerChunk;
+  const ezUInt32 uiRegistersPerChunk = byteCode.GetNumTempRegisters() * ((ezMath::Min<ezUInt32>(uiNumInstances, InstancesPerChunk) + 3) / 4);
+  m_Registers.SetCountUninitialized(uiRegistersPerChunk * uiNumChunks);
+
+  if (uiNumChunks <= 1)
+  {
+    return ExecuteChunk(byteCode, inputs, outputs, 0, uiNumInstances, globalData, m_Registers.GetData());
+  }
+
+  ezAtomicInteger32 iNumFailedChunks;
+
+  ezTaskSystem::ParallelForIndexed(0, uiNumChunks, [&](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+    for (ezUInt32 uiChunk = uiStartChunk; uiChunk < uiEndChunk; ++uiChunk)
+    {
+      const ezUInt32 uiFirstInstance = uiChunk * InstancesPerChunk;
+      const ezUInt32 uiNumChunkInstances = ezMath::Min<ezUInt32>(uiNumInstances - uiFirstInstance, InstancesPerChunk);
+      ezSimdVec4f* pRegisters = m_Registers.GetData() + uiChunk * uiRegistersPerChunk;
+
+      if (ExecuteChunk(byteCode, inputs, outputs, uiFirstInstance, uiNumChunkInstances, globalData, pRegisters).Failed())
+      {
+        iNumFailedChunks.Increment();
+      }
+    }
+  },
+    "ExpressionVM");
 
-  const ezUInt32 uiTotalNumRegisters = byteCode.GetNumTempRegisters() * uiNumRegisters;
-  m_Registers.SetCountUninitialized(uiTotalNumRegisters);
+  return iNumFailedChunks == 0 ? EZ_SUCCESS : EZ_FAILURE;
+}
 
-  ezSimdVec4f* pRegisters = m_Registers.GetData();
+ezResult ezExpressionVM::ExecuteChunk(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs,
+  ezArrayPtr<ezExpression::Stream> outputs, ezUInt32 uiFirstInstance, ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData,
+  ezSimdVec4f* pRegisters) const
+{
+  const ezUInt32 uiNumRegisters = (uiNumInstances + 3) / 4;
 
   // Execute bytecode
   const ezExpressionByteCode::StorageType* pByteCode = byteCode.GetByteCode();
@@ -404,12 +560,22 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
         break;
 
       case ezExpressionByteCode::OpCode::Mov_I:
-        VMLoadInput(pByteCode, pRegisters, uiNumRegisters, inputs, m_InputMapping);
-        break;
+      {
+        ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+        const StreamMapping& mapping = m_InputMapping[ezExpressionByteCode::GetRegisterIndex(pByteCode, 1)];
+
+        VMLoadInput(r, inputs[mapping.m_uiStreamIndex], mapping.m_uiComponentIndex, uiFirstInstance, uiNumInstances);
+      }
+      break;
 
       case ezExpressionByteCode::OpCode::Mov_O:
-        VMStoreOutput(pByteCode, pRegisters, uiNumRegisters, outputs, m_OutputMapping);
-        break;
+      {
+        const StreamMapping& mapping = m_OutputMapping[ezExpressionByteCode::GetRegisterIndex(pByteCode, 1)];
+        const ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+
+        VMStoreOutput(r, outputs[mapping.m_uiStreamIndex], mapping.m_uiComponentIndex, uiFirstInstance, uiNumInstances);
+      }
+      break;
 
         // binary
       case ezExpressionByteCode::OpCode::Add_RR:
@@ -0,0 +1,151 @@
+#include <Foundation/Application/Application.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Logging/ConsoleWriter.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Logging/VisualStudioWriter.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Utilities/CommandLineUtils.h>
+
+/* ezProfilingConverter command line options:
+
+Converts binary profiling recordings, as written by ezProfilingSystem::StartStreaming(), into the JSON trace format
+that can be opened with chrome://tracing.
+
+-out "path/to/file.json"
+
+If no -out is specified, the output file is written next to the input file with the extension changed to 'json'.
+
+Examples:
+
+ezProfilingConverter.exe "C:\Capture.ezProfile"
+  will convert the recording to "C:\Capture.json"
+
+ezProfilingConverter.exe "C:\Capture.ezProfile" -out "C:\Trace.json"
+  will convert the recording to "C:\Trace.json"
+
+*/
+
+class ezProfilingConverter : public ezApplication
+{
+public:
+  typedef ezApplication SUPER;
+
+  ezString m_sInput;
+  ezString m_sOutput;
+
+  ezProfilingConverter()
+    : ezApplication("ProfilingConverter")
+  {
+  }
+
+  ezResult ParseArguments()
+  {
+    if (GetArgumentCount() <= 1)
+    {
+      ezLog::Error("No arguments given");
+      return EZ_FAILURE;
+    }
+
+    ezCommandLineUtils& cmd = *ezCommandLineUtils::GetGlobalInstance();
+
+    m_sInput = ezOSFile::MakePathAbsoluteWithCWD(GetArgument(1));
+
+    if (!ezOSFile::ExistsFile(m_sInput))
+    {
+      ezLog::Error("Input file does not exist: '{}'", m_sInput);
+      return EZ_FAILURE;
+    }
+
+    m_sOutput = cmd.GetStringOption("-out");
+
+    if (m_sOutput.IsEmpty())
+    {
+      ezStringBuilder sOutput = m_sInput;
+      sOutput.ChangeFileExtension("json");
+
+      m_sOutput = sOutput;
+    }
+
+    m_sOutput = ezOSFile::MakePathAbsoluteWithCWD(m_sOutput);
+
+    ezLog::Info("Input: '{}'", m_sInput);
+    ezLog::Info("Output: '{}'", m_sOutput);
+
+    return EZ_SUCCESS;
+  }
+
+  virtual void AfterCoreSystemsStartup() override
+  {
+    // Add the empty data directory to access files via absolute paths
+    ezFileSystem::AddDataDirectory("", "App", ":", ezFileSystem::AllowWrites);
+
+    ezGlobalLog::AddLogWriter(ezLogWriter::Console::LogMessageHandler);
+    ezGlobalLog::AddLogWriter(ezLogWriter::VisualStudio::LogMessageHandler);
+  }
+
+  virtual void BeforeCoreSystemsShutdown() override
+  {
+    // prevent further output during shutdown
+    ezGlobalLog::RemoveLogWriter(ezLogWriter::Console::LogMessageHandler);
+    ezGlobalLog::RemoveLogWriter(ezLogWriter::VisualStudio::LogMessageHandler);
+
+    SUPER::BeforeCoreSystemsShutdown();
+  }
+
+  ezResult Convert()
+  {
+    ezProfilingSystem::ProfilingData profilingData;
+
+    {
+      ezFileReader file;
+      if (file.Open(m_sInput).Failed())
+      {
+        ezLog::Error("Failed to open '{}'", m_sInput);
+        return EZ_FAILURE;
+      }
+
+      EZ_SUCCEED_OR_RETURN(profilingData.Read(file));
+    }
+
+    ezUInt32 uiNumScopes = 0;
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      uiNumScopes += eventBuffer.m_Data.GetCount();
+    }
+
+    ezLog::Info("Read {} scopes of {} threads and {} frames", uiNumScopes, profilingData.m_AllEventBuffers.GetCount(),
+      profilingData.m_FrameStartTimes.GetCount());
+
+    ezFileWriter file;
+    if (file.Open(m_sOutput).Failed())
+    {
+      ezLog::Error("Failed to open '{}' for writing", m_sOutput);
+      return EZ_FAILURE;
+    }
+
+    return profilingData.Write(file);
+  }
+
+  virtual ApplicationExecution Run() override
+  {
+    if (ParseArguments().Failed())
+    {
+      SetReturnCode(1);
+      return ezApplication::Quit;
+    }
+
+    if (Convert().Failed())
+    {
+      ezLog::Error("Converting the profiling data failed");
+      SetReturnCode(2);
+    }
+
+    return ezApplication::Quit;
+  }
+};
+
+EZ_CONSOLEAPP_ENTRY_POINT(ezProfilingConverter);
@@ -240,6 +240,55 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "LoadingQueueStats")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    // start with a fresh frame
+    ezResourceManager::PerFrameUpdate();
+
+    const ezUInt32 uiNumResources = 100;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Stats-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    ezResourceManager::PerFrameUpdate();
+
+    const ezResourceManager::LoadingQueueStats stats = ezResourceManager::GetLoadingQueueStats();
+    EZ_TEST_INT(stats.m_uiQueueDepth, 0);
+    EZ_TEST_BOOL(stats.m_uiMaxQueueDepth > 0);
+    EZ_TEST_BOOL(stats.m_uiMaxQueueDepth <= uiNumResources);
+    EZ_TEST_INT(stats.m_uiNumLoadsStarted, uiNumResources);
+    EZ_TEST_INT(stats.m_uiNumLoadsFinished, uiNumResources);
+    EZ_TEST_BOOL(stats.m_AverageTimeToLoad >= stats.m_AverageTimeInQueue);
+    EZ_TEST_BOOL(stats.m_MaxTimeToLoad >= stats.m_AverageTimeToLoad);
+    EZ_TEST_BOOL(stats.m_MaxTimeInQueue >= stats.m_AverageTimeInQueue);
+
+    hResources.Clear();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+
   // Test disabled as it deadlocks
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Blocking")
   {
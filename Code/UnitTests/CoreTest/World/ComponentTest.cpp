@@ -2,6 +2,8 @@
 
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
+#include <Foundation/Utilities/DGMLWriter.h>
+#include <Foundation/Utilities/Stats.h>
 
 namespace
 {
@@ -152,6 +154,148 @@ namespace
       TestComponent2::CreateComponent(pChild, pChildComponent);
     }
   }
+
+  //////////////////////////////////////////////////////////////////////////
+
+  ezAtomicInteger32 s_iScheduleCounter;
+  ezInt32 s_iWriteGameObjectsStamp = 0;
+  ezInt32 s_iWriteAStamp = 0;
+  ezInt32 s_iReadAStamp = 0;
+  ezInt32 s_iAsyncReadStamp = 0;
+  ezInt32 s_iBarrierStamp = 0;
+
+  typedef ezComponentManager<class ScheduleTestComponentA, ezBlockStorageType::FreeList> ScheduleTestComponentAManager;
+
+  class ScheduleTestComponentA : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ScheduleTestComponentA, ezComponent, ScheduleTestComponentAManager);
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(ScheduleTestComponentA, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  class ScheduleTestComponentB;
+  class ScheduleTestManagerB : public ezComponentManager<ScheduleTestComponentB, ezBlockStorageType::FreeList>
+  {
+  public:
+    ScheduleTestManagerB(ezWorld* pWorld)
+      : ezComponentManager<ScheduleTestComponentB, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto descWriteA = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerB::WriteA, this);
+      descWriteA.m_fPriority = 100.0f;
+      descWriteA.m_WriteAccess.PushBack(ezGetStaticRTTI<ScheduleTestComponentA>());
+
+      // reads all components, so it has to wait for every function that writes to any component type
+      auto descAsyncRead = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerB::AsyncRead, this);
+      descAsyncRead.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
+      descAsyncRead.m_ReadAccess.PushBack(ezGetStaticRTTI<ezComponent>());
+
+      // no declared access, called exclusively
+      auto descBarrier = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerB::Barrier, this);
+      descBarrier.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PostAsync;
+
+      this->RegisterUpdateFunction(descWriteA);
+      this->RegisterUpdateFunction(descAsyncRead);
+      this->RegisterUpdateFunction(descBarrier);
+    }
+
+    void WriteA(const ezWorldModule::UpdateContext& context) { s_iWriteAStamp = s_iScheduleCounter.Increment(); }
+    void AsyncRead(const ezWorldModule::UpdateContext& context) { s_iAsyncReadStamp = s_iScheduleCounter.Increment(); }
+    void Barrier(const ezWorldModule::UpdateContext& context) { s_iBarrierStamp = s_iScheduleCounter.Increment(); }
+  };
+
+  class ScheduleTestComponentB : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ScheduleTestComponentB, ezComponent, ScheduleTestManagerB);
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(ScheduleTestComponentB, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  class ScheduleTestComponentC;
+  class ScheduleTestManagerC : public ezComponentManager<ScheduleTestComponentC, ezBlockStorageType::FreeList>
+  {
+  public:
+    ScheduleTestManagerC(ezWorld* pWorld)
+      : ezComponentManager<ScheduleTestComponentC, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      // independent of ScheduleTestManagerB::WriteA
+      auto descWriteGameObjects = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerC::WriteGameObjects, this);
+      descWriteGameObjects.m_fPriority = 200.0f;
+      descWriteGameObjects.m_WriteAccess.PushBack(ezGetStaticRTTI<ezGameObject>());
+
+      // has to wait for ScheduleTestManagerB::WriteA and for WriteGameObjects since both are functions of the same module
+      auto descReadA = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerC::ReadA, this);
+      descReadA.m_ReadAccess.PushBack(ezGetStaticRTTI<ScheduleTestComponentA>());
+
+      this->RegisterUpdateFunction(descWriteGameObjects);
+      this->RegisterUpdateFunction(descReadA);
+    }
+
+    void WriteGameObjects(const ezWorldModule::UpdateContext& context) { s_iWriteGameObjectsStamp = s_iScheduleCounter.Increment(); }
+    void ReadA(const ezWorldModule::UpdateContext& context) { s_iReadAStamp = s_iScheduleCounter.Increment(); }
+  };
+
+  class ScheduleTestComponentC : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ScheduleTestComponentC, ezComponent, ScheduleTestManagerC);
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(ScheduleTestComponentC, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  //////////////////////////////////////////////////////////////////////////
+
+  ezAtomicInteger32 s_iAutoGranularityUpdateCount;
+  ezAtomicInteger32 s_iAutoGranularityMisalignedBatches;
+
+  class AutoGranularityTestComponent;
+  class AutoGranularityTestManager : public ezComponentManager<AutoGranularityTestComponent, ezBlockStorageType::Compact>
+  {
+  public:
+    AutoGranularityTestManager(ezWorld* pWorld)
+      : ezComponentManager<AutoGranularityTestComponent, ezBlockStorageType::Compact>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(AutoGranularityTestManager::UpdateAsync, this);
+      desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
+      desc.m_bAutoGranularity = true;
+
+      this->RegisterUpdateFunction(desc);
+    }
+
+    void UpdateAsync(const ezWorldModule::UpdateContext& context)
+    {
+      if (context.m_uiFirstComponentIndex % m_uiComponentsPerBlock != 0)
+      {
+        s_iAutoGranularityMisalignedBatches.Increment();
+      }
+
+      for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+      {
+        s_iAutoGranularityUpdateCount.Increment();
+      }
+    }
+  };
+
+  class AutoGranularityTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(AutoGranularityTestComponent, ezComponent, AutoGranularityTestManager);
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(AutoGranularityTestComponent, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
 } // namespace
 
 
@@ -521,4 +665,91 @@ EZ_CREATE_SIMPLE_TEST(World, Components)
     EZ_TEST_INT(TestComponent::s_iActivateCounter, 2);
     EZ_TEST_INT(TestComponent::s_iSimulationStartedCounter, 1);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Update Function Schedule")
+  {
+    ezWorldDesc scheduleWorldDesc("ScheduleTest");
+    ezWorld scheduleWorld(scheduleWorldDesc);
+    EZ_LOCK(scheduleWorld.GetWriteMarker());
+
+    ezGameObjectDesc desc;
+    ezGameObject* pObject = nullptr;
+    scheduleWorld.CreateObject(desc, pObject);
+
+    ScheduleTestComponentB* pComponentB = nullptr;
+    ScheduleTestComponentB::CreateComponent(pObject, pComponentB);
+
+    ScheduleTestComponentC* pComponentC = nullptr;
+    ScheduleTestComponentC::CreateComponent(pObject, pComponentC);
+
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      s_iScheduleCounter = 0;
+
+      scheduleWorld.Update();
+
+      EZ_TEST_INT(s_iScheduleCounter, 5);
+      EZ_TEST_BOOL(s_iWriteGameObjectsStamp <= 2);
+      EZ_TEST_BOOL(s_iWriteAStamp <= 2);
+      EZ_TEST_INT(s_iReadAStamp, 3);
+      EZ_TEST_INT(s_iAsyncReadStamp, 4);
+      EZ_TEST_INT(s_iBarrierStamp, 5);
+    }
+
+    ezDGMLGraph graph;
+    scheduleWorld.WriteUpdateScheduleToDGML(graph);
+
+    ezStringBuilder sGraph;
+    EZ_TEST_BOOL(ezDGMLGraphWriter::WriteGraphToString(sGraph, graph).Succeeded());
+    EZ_TEST_BOOL(sGraph.FindSubString("ScheduleTestManagerC::WriteGameObjects") != nullptr);
+    EZ_TEST_BOOL(sGraph.FindSubString("ScheduleTestManagerB::WriteA") != nullptr);
+    EZ_TEST_BOOL(sGraph.FindSubString("ScheduleTestManagerC::ReadA") != nullptr);
+    EZ_TEST_BOOL(sGraph.FindSubString("ScheduleTestManagerB::AsyncRead") != nullptr);
+    EZ_TEST_BOOL(sGraph.FindSubString("ScheduleTestManagerB::Barrier") != nullptr);
+
+    // ReadA depends on WriteGameObjects and WriteA, AsyncRead on all three pre-async functions, WriteGameObjects and WriteA are independent
+    ezUInt32 uiNumDependencies = 0;
+    for (const char* szLink = sGraph.FindSubString("<Link Source"); szLink != nullptr; szLink = sGraph.FindSubString("<Link Source", szLink + 1))
+    {
+      ++uiNumDependencies;
+    }
+    EZ_TEST_INT(uiNumDependencies, 5);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Automatic Granularity")
+  {
+    ezWorldDesc autoWorldDesc("AutoGranularityTest");
+    ezWorld autoWorld(autoWorldDesc);
+    EZ_LOCK(autoWorld.GetWriteMarker());
+
+    const ezUInt32 uiComponentsPerBlock = ezDataBlock<AutoGranularityTestComponent, ezInternal::DEFAULT_BLOCK_SIZE>::CAPACITY;
+    const ezUInt32 uiNumComponents = uiComponentsPerBlock * 10 + 7;
+
+    for (ezUInt32 i = 0; i < uiNumComponents; ++i)
+    {
+      ezGameObjectDesc desc;
+      ezGameObject* pObject = nullptr;
+      autoWorld.CreateObject(desc, pObject);
+
+      AutoGranularityTestComponent* pComponent = nullptr;
+      AutoGranularityTestComponent::CreateComponent(pObject, pComponent);
+    }
+
+    s_iAutoGranularityMisalignedBatches = 0;
+
+    for (ezUInt32 i = 0; i < 5; ++i)
+    {
+      s_iAutoGranularityUpdateCount = 0;
+
+      autoWorld.Update();
+
+      EZ_TEST_INT(s_iAutoGranularityUpdateCount, uiNumComponents);
+
+      const ezUInt32 uiGranularity = ezStats::GetStat("World Update/AutoGranularityTest/Granularity/AutoGranularityTestManager::UpdateAsync").ConvertTo<ezUInt32>();
+      EZ_TEST_BOOL(uiGranularity > 0);
+      EZ_TEST_INT(uiGranularity % uiComponentsPerBlock, 0);
+    }
+
+    EZ_TEST_INT(s_iAutoGranularityMisalignedBatches, 0);
+  }
 }
@@ -82,6 +82,53 @@ namespace
   EZ_END_COMPONENT_TYPE;
   // clang-format on
 
+  class TestComponentBatchMsg;
+
+  class TestComponentBatchMsgManager : public ezComponentManager<TestComponentBatchMsg, ezBlockStorageType::FreeList>
+  {
+  public:
+    TestComponentBatchMsgManager(ezWorld* pWorld)
+        : ezComponentManager<TestComponentBatchMsg, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void DeliverQueuedMessages(ezArrayPtr<const QueuedMessage> messages) override
+    {
+      m_BatchSizes.PushBack(messages.GetCount());
+
+      ezComponentManagerBase::DeliverQueuedMessages(messages);
+    }
+
+    ezDynamicArray<ezUInt32> m_BatchSizes;
+    ezDynamicArray<ezInt32> m_ReceivedValues;
+  };
+
+  class TestComponentBatchMsg : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(TestComponentBatchMsg, ezComponent, TestComponentBatchMsgManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override {}
+    virtual void DeserializeComponent(ezWorldReader& stream) override {}
+
+    void OnTestMessage(TestMessage1& msg) { static_cast<TestComponentBatchMsgManager*>(GetOwningManager())->m_ReceivedValues.PushBack(msg.m_iValue); }
+
+    void OnTestMessage2(TestMessage2& msg) { static_cast<TestComponentBatchMsgManager*>(GetOwningManager())->m_ReceivedValues.PushBack(1000 + msg.m_iValue); }
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(TestComponentBatchMsg, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(TestMessage1, OnTestMessage),
+      EZ_MESSAGE_HANDLER(TestMessage2, OnTestMessage2),
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
   void ResetComponents(ezGameObject& object)
   {
     TestComponentMsg* pComponent = nullptr;
@@ -200,6 +247,97 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
     ezFrameAllocator::Reset();
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batched Queuing")
+  {
+    TestComponentBatchMsgManager* pBatchManager = world.GetOrCreateComponentManager<TestComponentBatchMsgManager>();
+
+    ezComponentHandle hComponents[4];
+    ezGameObject* pObjects[4];
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(hComponents); ++i)
+    {
+      desc.m_hParent.Invalidate();
+      desc.m_sName.Assign("Batch");
+      world.CreateObject(desc, pObjects[i]);
+
+      TestComponentBatchMsg* pBatchComponent = nullptr;
+      hComponents[i] = pBatchManager->CreateComponent(pObjects[i], pBatchComponent);
+    }
+
+    world.Update();
+
+    ezDynamicArray<ezInt32> firstOrder;
+
+    // post the same messages twice in different order, the delivery order has to be the same
+    for (ezUInt32 uiRun = 0; uiRun < 2; ++uiRun)
+    {
+      pBatchManager->m_BatchSizes.Clear();
+      pBatchManager->m_ReceivedValues.Clear();
+
+      for (ezUInt32 i = 0; i < 24; ++i)
+      {
+        const ezUInt32 uiIndex = uiRun == 0 ? i : 23 - i;
+        const ezUInt32 uiReceiver = uiIndex % EZ_ARRAY_SIZE(hComponents);
+
+        if (uiIndex % 3 == 0)
+        {
+          TestMessage2 msg2;
+          msg2.m_iValue = uiIndex;
+          world.PostMessage(hComponents[uiReceiver], msg2, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+        }
+        else
+        {
+          TestMessage1 msg;
+          msg.m_iValue = uiIndex;
+          world.PostMessage(hComponents[uiReceiver], msg, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+        }
+      }
+
+      // messages to an object are still delivered to its components
+      {
+        TestMessage1 msg;
+        msg.m_iValue = 100;
+        pObjects[0]->PostMessage(msg, ezTime::Zero(), ezObjectMsgQueueType::NextFrame);
+      }
+
+      world.Update();
+
+      // one batch per message type, TestMessage1 is delivered first because of its smaller sorting key
+      EZ_TEST_INT(pBatchManager->m_BatchSizes.GetCount(), 2);
+      if (pBatchManager->m_BatchSizes.GetCount() == 2)
+      {
+        EZ_TEST_INT(pBatchManager->m_BatchSizes[0], 16);
+        EZ_TEST_INT(pBatchManager->m_BatchSizes[1], 8);
+      }
+
+      const auto& values = pBatchManager->m_ReceivedValues;
+      EZ_TEST_INT(values.GetCount(), 25);
+      EZ_TEST_INT(values[0], 100);
+
+      for (ezUInt32 i = 1; i < values.GetCount(); ++i)
+      {
+        const bool bIsMessage2 = values[i] >= 1000;
+        EZ_TEST_BOOL(bIsMessage2 || values[i - 1] < 1000);
+
+        // within a batch the messages are grouped by receiver
+        if ((values[i - 1] >= 1000) == bIsMessage2 && i > 1)
+        {
+          EZ_TEST_BOOL((values[i - 1] % 1000) % 4 <= (values[i] % 1000) % 4);
+        }
+      }
+
+      if (uiRun == 0)
+      {
+        firstOrder = values;
+      }
+      else
+      {
+        EZ_TEST_BOOL(firstOrder == values);
+      }
+    }
+
+    ezFrameAllocator::Reset();
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing with delay")
   {
     ResetComponents(*pRoot);
@@ -1,6 +1,8 @@
 #include <CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
@@ -55,6 +57,78 @@ namespace
   }
   EZ_END_COMPONENT_TYPE;
   // clang-format on
+
+  ezSimdBBoxSphere CreateRandomSpatialBounds(ezRandom& rng)
+  {
+    // mostly small objects, some larger ones and a few that are larger than the whole octree or lie outside of it
+    float fHalfExtent = rng.FloatMinMax(0.1f, 10.0f);
+    float fRange = 10000.0f;
+
+    const ezUInt32 uiKind = rng.UIntInRange(100);
+    if (uiKind < 5)
+    {
+      fHalfExtent = rng.FloatMinMax(500.0f, 20000.0f);
+    }
+    else if (uiKind < 10)
+    {
+      fRange = 30000.0f;
+    }
+
+    const ezVec3 vCenter(rng.FloatMinMax(-fRange, fRange), rng.FloatMinMax(-fRange, fRange), rng.FloatMinMax(-fRange, fRange));
+    const ezVec3 vHalfExtents(fHalfExtent, fHalfExtent * rng.FloatMinMax(0.2f, 1.0f), fHalfExtent * rng.FloatMinMax(0.2f, 1.0f));
+
+    ezBoundingBox box;
+    box.SetCenterAndHalfExtents(vCenter, vHalfExtents);
+
+    return ezSimdConversion::ToBBoxSphere(ezBoundingBoxSphere(box));
+  }
+
+  template <typename T>
+  bool HaveSameObjects(ezDynamicArray<T>& a, ezDynamicArray<T>& b)
+  {
+    a.Sort();
+    b.Sort();
+    return a == b;
+  }
+
+  void CompareSpatialSystems(const ezSpatialSystem& grid, const ezSpatialSystem& octree, ezRandom& rng, ezUInt32 uiCategoryBitmask)
+  {
+    for (ezUInt32 i = 0; i < 20; ++i)
+    {
+      const ezVec3 vCenter(rng.FloatMinMax(-12000.0f, 12000.0f), rng.FloatMinMax(-12000.0f, 12000.0f), rng.FloatMinMax(-12000.0f, 12000.0f));
+      const float fSize = rng.FloatMinMax(10.0f, 1500.0f);
+
+      ezDynamicArray<ezGameObject*> gridObjects;
+      ezDynamicArray<ezGameObject*> octreeObjects;
+
+      const ezBoundingSphere sphere(vCenter, fSize);
+      grid.FindObjectsInSphere(sphere, uiCategoryBitmask, gridObjects);
+      octree.FindObjectsInSphere(sphere, uiCategoryBitmask, octreeObjects);
+      EZ_TEST_BOOL(HaveSameObjects(gridObjects, octreeObjects));
+
+      gridObjects.Clear();
+      octreeObjects.Clear();
+
+      ezBoundingBox box;
+      box.SetCenterAndHalfExtents(vCenter, ezVec3(fSize, fSize * 0.5f, fSize * 0.25f));
+      grid.FindObjectsInBox(box, uiCategoryBitmask, gridObjects);
+      octree.FindObjectsInBox(box, uiCategoryBitmask, octreeObjects);
+      EZ_TEST_BOOL(HaveSameObjects(gridObjects, octreeObjects));
+
+      ezVec3 vDir(rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f));
+      vDir.NormalizeIfNotZero(ezVec3(1, 0, 0));
+      const ezVec3 vUp = ezMath::Abs(vDir.z) < 0.9f ? ezVec3(0, 0, 1) : ezVec3(1, 0, 0);
+
+      ezFrustum frustum;
+      frustum.SetFrustum(vCenter, vDir, vUp, ezAngle::Degree(70.0f), ezAngle::Degree(50.0f), 0.1f, fSize * 2.0f);
+
+      ezDynamicArray<const ezGameObject*> gridVisibleObjects;
+      ezDynamicArray<const ezGameObject*> octreeVisibleObjects;
+      grid.FindVisibleObjects(frustum, uiCategoryBitmask, gridVisibleObjects);
+      octree.FindVisibleObjects(frustum, uiCategoryBitmask, octreeVisibleObjects);
+      EZ_TEST_BOOL(HaveSameObjects(gridVisibleObjects, octreeVisibleObjects));
+    }
+  }
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
@@ -249,3 +323,128 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
 
   world.Update();
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_LooseOctree)
+{
+  // the octree must find exactly the same objects as the regular grid, the objects are never dereferenced by the spatial systems
+  ezSpatialSystem_RegularGrid grid;
+  ezSpatialSystem_LooseOctree octree;
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  const ezUInt32 uiStaticBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+  const ezUInt32 uiDynamicBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+  const ezUInt32 uiBothBitmask = uiStaticBitmask | uiDynamicBitmask;
+
+  ezDynamicArray<ezSpatialDataHandle> gridHandles;
+  ezDynamicArray<ezSpatialDataHandle> octreeHandles;
+  ezDynamicArray<ezGameObject*> objects;
+  ezDynamicArray<ezSimdBBoxSphere, ezAlignedAllocatorWrapper> allBounds;
+
+  for (ezUInt32 i = 0; i < 2000; ++i)
+  {
+    ezGameObject* pObject = reinterpret_cast<ezGameObject*>(static_cast<size_t>(i + 1) * 16);
+    const ezUInt32 uiCategoryBitmask = (i % 3) == 0 ? uiDynamicBitmask : uiStaticBitmask;
+    const ezSimdBBoxSphere bounds = CreateRandomSpatialBounds(rng);
+
+    gridHandles.PushBack(grid.CreateSpatialData(bounds, pObject, uiCategoryBitmask));
+    octreeHandles.PushBack(octree.CreateSpatialData(bounds, pObject, uiCategoryBitmask));
+    objects.PushBack(pObject);
+    allBounds.PushBack(bounds);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queries")
+  {
+    CompareSpatialSystems(grid, octree, rng, uiStaticBitmask);
+    CompareSpatialSystems(grid, octree, rng, uiBothBitmask);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "UpdateSpatialData")
+  {
+    for (ezUInt32 i = 0; i < objects.GetCount(); i += 2)
+    {
+      ezSimdBBoxSphere bounds = CreateRandomSpatialBounds(rng);
+
+      // small movements mostly keep the object in the same node
+      if ((i % 4) == 0)
+      {
+        ezBoundingBox box;
+        EZ_TEST_BOOL(octree.GetNodeBoxForSpatialData(octreeHandles[i], box).Succeeded());
+
+        const ezSimdVec4f vOffset(rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f), 0.0f);
+        bounds = allBounds[i];
+        bounds.m_CenterAndRadius += vOffset;
+      }
+
+      allBounds[i] = bounds;
+
+      const ezUInt32 uiCategoryBitmask = (i % 6) == 0 ? uiStaticBitmask : uiDynamicBitmask;
+
+      grid.UpdateSpatialData(gridHandles[i], bounds, objects[i], uiCategoryBitmask);
+      octree.UpdateSpatialData(octreeHandles[i], bounds, objects[i], uiCategoryBitmask);
+    }
+
+    CompareSpatialSystems(grid, octree, rng, uiStaticBitmask);
+    CompareSpatialSystems(grid, octree, rng, uiBothBitmask);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "UpdateSpatialDataBatch")
+  {
+    ezDynamicArray<ezSpatialSystem::SpatialDataUpdate, ezAlignedAllocatorWrapper> updates;
+
+    for (ezUInt32 i = 1; i < objects.GetCount(); i += 2)
+    {
+      ezSimdBBoxSphere bounds = CreateRandomSpatialBounds(rng);
+
+      // small movements mostly keep the object in the same cell, which is applied in parallel by the grid
+      if ((i % 4) != 3)
+      {
+        const ezSimdVec4f vOffset(rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f), 0.0f);
+        bounds = allBounds[i];
+        bounds.m_CenterAndRadius += vOffset;
+      }
+
+      allBounds[i] = bounds;
+
+      const ezUInt32 uiCategoryBitmask = (i % 10) == 1 ? uiStaticBitmask : uiDynamicBitmask;
+
+      auto& update = updates.ExpandAndGetRef();
+      update.m_Bounds = bounds;
+      update.m_hData = gridHandles[i];
+      update.m_pObject = objects[i];
+      update.m_uiCategoryBitmask = uiCategoryBitmask;
+
+      octree.UpdateSpatialData(octreeHandles[i], bounds, objects[i], uiCategoryBitmask);
+    }
+
+    grid.UpdateSpatialDataBatch(updates);
+
+    CompareSpatialSystems(grid, octree, rng, uiStaticBitmask);
+    CompareSpatialSystems(grid, octree, rng, uiBothBitmask);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "DeleteSpatialData")
+  {
+    for (ezUInt32 i = 0; i < objects.GetCount(); i += 3)
+    {
+      grid.DeleteSpatialData(gridHandles[i]);
+      octree.DeleteSpatialData(octreeHandles[i]);
+    }
+
+    CompareSpatialSystems(grid, octree, rng, uiBothBitmask);
+
+    for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+    {
+      if ((i % 3) != 0)
+      {
+        grid.DeleteSpatialData(gridHandles[i]);
+        octree.DeleteSpatialData(octreeHandles[i]);
+      }
+    }
+
+    ezHybridArray<ezBoundingBox, 16> nodeBoxes;
+    octree.GetAllNodeBoxes(nodeBoxes);
+    EZ_TEST_INT(nodeBoxes.GetCount(), 0);
+  }
+}
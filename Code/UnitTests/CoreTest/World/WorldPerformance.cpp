@@ -1,5 +1,7 @@
 #include <CoreTestPCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
@@ -114,6 +116,103 @@ namespace
     }
   }
 
+
+  void FillSpatialSystemForProfiling(ezSpatialSystem& spatialSystem, ezUInt32 uiNumObjects)
+  {
+    ezRandom rng;
+    rng.Initialize(7);
+
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    // a few dense hotspots of small clutter, some medium sized objects and very few huge ones
+    ezVec3 hotspots[16];
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(hotspots); ++i)
+    {
+      hotspots[i].Set(rng.FloatMinMax(-7000.0f, 7000.0f), rng.FloatMinMax(-7000.0f, 7000.0f), rng.FloatMinMax(-500.0f, 500.0f));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      const ezUInt32 uiKind = rng.UIntInRange(100);
+
+      ezVec3 vCenter;
+      float fHalfExtent;
+      if (uiKind < 90)
+      {
+        vCenter = hotspots[rng.UIntInRange(EZ_ARRAY_SIZE(hotspots))] +
+                  ezVec3(rng.FloatMinMax(-1000.0f, 1000.0f), rng.FloatMinMax(-1000.0f, 1000.0f), rng.FloatMinMax(-100.0f, 100.0f));
+        fHalfExtent = rng.FloatMinMax(0.1f, 2.0f);
+      }
+      else
+      {
+        vCenter.Set(rng.FloatMinMax(-8000.0f, 8000.0f), rng.FloatMinMax(-8000.0f, 8000.0f), rng.FloatMinMax(-1000.0f, 1000.0f));
+        fHalfExtent = uiKind < 99 ? rng.FloatMinMax(5.0f, 50.0f) : rng.FloatMinMax(200.0f, 2000.0f);
+      }
+
+      ezBoundingBox box;
+      box.SetCenterAndHalfExtents(vCenter, ezVec3(fHalfExtent));
+
+      // the spatial systems never dereference the object pointer
+      ezGameObject* pObject = reinterpret_cast<ezGameObject*>(static_cast<size_t>(i + 1) * 16);
+      spatialSystem.CreateSpatialData(ezSimdConversion::ToBBoxSphere(ezBoundingBoxSphere(box)), pObject, uiCategoryBitmask);
+    }
+  }
+
+  void MeasureSpatialQueries(const char* szName, ezSpatialSystem& spatialSystem, ezUInt32 uiNumObjects, ezUInt32& out_uiNumFound)
+  {
+    ezStopwatch sw;
+    FillSpatialSystemForProfiling(spatialSystem, uiNumObjects);
+    const ezTime tCreate = sw.Checkpoint();
+
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    const ezUInt32 uiNumQueries = 32;
+
+    ezRandom rng;
+    rng.Initialize(11);
+
+    out_uiNumFound = 0;
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezTime tVisible;
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      const ezVec3 vPos(rng.FloatMinMax(-8000.0f, 8000.0f), rng.FloatMinMax(-8000.0f, 8000.0f), rng.FloatMinMax(0.0f, 200.0f));
+      const ezAngle dir = ezAngle::Degree(rng.FloatMinMax(0.0f, 360.0f));
+
+      ezFrustum frustum;
+      frustum.SetFrustum(vPos, ezVec3(ezMath::Cos(dir), ezMath::Sin(dir), -0.2f).GetNormalized(), ezVec3(0, 0, 1), ezAngle::Degree(90.0f),
+        ezAngle::Degree(60.0f), 0.1f, 5000.0f);
+
+      visibleObjects.Clear();
+
+      sw.StopAndReset();
+      sw.Resume();
+      spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+      tVisible += sw.GetRunningTotal();
+
+      out_uiNumFound += visibleObjects.GetCount();
+    }
+
+    ezDynamicArray<ezGameObject*> objectsInSphere;
+    ezTime tSphere;
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      const ezBoundingSphere sphere(
+        ezVec3(rng.FloatMinMax(-8000.0f, 8000.0f), rng.FloatMinMax(-8000.0f, 8000.0f), rng.FloatMinMax(-200.0f, 200.0f)), rng.FloatMinMax(10.0f, 500.0f));
+
+      objectsInSphere.Clear();
+
+      sw.StopAndReset();
+      sw.Resume();
+      spatialSystem.FindObjectsInSphere(sphere, uiCategoryBitmask, objectsInSphere);
+      tSphere += sw.GetRunningTotal();
+
+      out_uiNumFound += objectsInSphere.GetCount();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s, %u objects: create %.2fms, FindVisibleObjects %.3fms, FindObjectsInSphere %.3fms", szName,
+      uiNumObjects, tCreate.GetMilliseconds(), tVisible.GetMilliseconds() / uiNumQueries, tSphere.GetMilliseconds() / uiNumQueries);
+  }
 } // namespace
 
 
@@ -288,3 +387,29 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystem)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "RegularGrid vs LooseOctree")
+  {
+    const ezUInt32 numObjects[] = {10000, 100000, 1000000};
+
+    for (ezUInt32 uiNumObjects : numObjects)
+    {
+      ezUInt32 uiNumFoundInGrid = 0;
+      ezUInt32 uiNumFoundInOctree = 0;
+
+      {
+        ezSpatialSystem_RegularGrid grid;
+        MeasureSpatialQueries("RegularGrid", grid, uiNumObjects, uiNumFoundInGrid);
+      }
+
+      {
+        ezSpatialSystem_LooseOctree octree;
+        MeasureSpatialQueries("LooseOctree", octree, uiNumObjects, uiNumFoundInOctree);
+      }
+
+      EZ_TEST_INT(uiNumFoundInGrid, uiNumFoundInOctree);
+    }
+  }
+}
@@ -0,0 +1,151 @@
+#include <CoreTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+
+namespace
+{
+  class TestComponentSerialized;
+  typedef ezComponentManager<TestComponentSerialized, ezBlockStorageType::FreeList> TestComponentSerializedManager;
+
+  class TestComponentSerialized : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(TestComponentSerialized, ezComponent, TestComponentSerializedManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override
+    {
+      stream.GetStream() << m_iValue;
+      stream.WriteGameObjectHandle(m_hTarget);
+    }
+
+    virtual void DeserializeComponent(ezWorldReader& stream) override
+    {
+      stream.GetStream() >> m_iValue;
+      m_hTarget = stream.ReadGameObjectHandle();
+    }
+
+    ezInt32 m_iValue = 0;
+    ezGameObjectHandle m_hTarget;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(TestComponentSerialized, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  void CreateTestWorld(ezWorld& world, ezUInt32 uiNumRootObjects, ezUInt32 uiNumChildrenPerRoot)
+  {
+    ezStringBuilder sName;
+
+    for (ezUInt32 r = 0; r < uiNumRootObjects; ++r)
+    {
+      ezGameObjectDesc rootDesc;
+      sName.Format("Root{}", r);
+      rootDesc.m_sName.Assign(sName.GetData());
+      rootDesc.m_LocalPosition.Set(static_cast<float>(r), 0, 0);
+
+      ezGameObject* pRoot = nullptr;
+      const ezGameObjectHandle hRoot = world.CreateObject(rootDesc, pRoot);
+
+      for (ezUInt32 c = 0; c < uiNumChildrenPerRoot; ++c)
+      {
+        ezGameObjectDesc childDesc;
+        sName.Format("Child{}_{}", r, c);
+        childDesc.m_sName.Assign(sName.GetData());
+        childDesc.m_hParent = hRoot;
+        childDesc.m_LocalPosition.Set(0, static_cast<float>(c), 0);
+
+        ezGameObject* pChild = nullptr;
+        world.CreateObject(childDesc, pChild);
+
+        TestComponentSerialized* pComponent = nullptr;
+        TestComponentSerialized::CreateComponent(pChild, pComponent);
+        pComponent->m_iValue = static_cast<ezInt32>(r * uiNumChildrenPerRoot + c);
+        pComponent->m_hTarget = hRoot;
+        pComponent->SetActiveFlag((c % 3) != 0);
+        pComponent->SetUserFlag(3, (c % 2) != 0);
+      }
+    }
+  }
+
+  void TestRoundTrip(ezUInt32 uiNumRootObjects, ezUInt32 uiNumChildrenPerRoot)
+  {
+    ezMemoryStreamStorage storage;
+
+    {
+      ezWorldDesc worldDesc("Source");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+      CreateTestWorld(world, uiNumRootObjects, uiNumChildrenPerRoot);
+
+      ezMemoryStreamWriter writer(&storage);
+      ezWorldWriter worldWriter;
+      worldWriter.WriteWorld(writer, world);
+    }
+
+    ezMemoryStreamReader reader(&storage);
+    ezWorldReader worldReader;
+    EZ_TEST_BOOL(worldReader.ReadWorldDescription(reader).Succeeded());
+    EZ_TEST_INT(worldReader.GetRootObjectCount(), uiNumRootObjects);
+    EZ_TEST_INT(worldReader.GetChildObjectCount(), uiNumRootObjects * uiNumChildrenPerRoot);
+
+    // instantiate twice to make sure the reader can be reused
+    for (ezUInt32 uiInstance = 0; uiInstance < 2; ++uiInstance)
+    {
+      ezWorldDesc worldDesc("Target");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      worldReader.InstantiateWorld(world);
+
+      EZ_TEST_INT(world.GetObjectCount(), uiNumRootObjects * (uiNumChildrenPerRoot + 1));
+
+      const TestComponentSerializedManager* pManager = world.GetComponentManager<TestComponentSerializedManager>();
+      EZ_TEST_BOOL(pManager != nullptr);
+
+      if (pManager == nullptr)
+        return;
+
+      EZ_TEST_INT(pManager->GetComponentCount(), uiNumRootObjects * uiNumChildrenPerRoot);
+
+      ezInt64 iValueSum = 0;
+      for (auto it = pManager->GetComponents(); it.IsValid(); ++it)
+      {
+        const TestComponentSerialized& component = *it;
+        const ezGameObject* pOwner = component.GetOwner();
+
+        const ezUInt32 c = static_cast<ezUInt32>(component.m_iValue) % uiNumChildrenPerRoot;
+        const ezUInt32 r = static_cast<ezUInt32>(component.m_iValue) / uiNumChildrenPerRoot;
+
+        ezStringBuilder sExpectedName;
+        sExpectedName.Format("Child{}_{}", r, c);
+        EZ_TEST_STRING(pOwner->GetName(), sExpectedName);
+        EZ_TEST_BOOL(component.GetActiveFlag() == ((c % 3) != 0));
+        EZ_TEST_BOOL(component.GetUserFlag(3) == ((c % 2) != 0));
+        EZ_TEST_BOOL(component.m_hTarget == pOwner->GetParent()->GetHandle());
+
+        iValueSum += component.m_iValue;
+      }
+
+      const ezInt64 iNumComponents = uiNumRootObjects * uiNumChildrenPerRoot;
+      EZ_TEST_INT(iValueSum, iNumComponents * (iNumComponents - 1) / 2);
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, WorldSerializer)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Small Round Trip")
+  {
+    TestRoundTrip(3, 4);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Large Round Trip")
+  {
+    // thousands of components, spread over many hierarchies
+    TestRoundTrip(64, 40);
+  }
+}
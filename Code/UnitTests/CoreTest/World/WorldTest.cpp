@@ -1,7 +1,9 @@
 #include <CoreTestPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Clock.h>
+#include <Foundation/Utilities/Stats.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(World);
@@ -167,6 +169,144 @@ EZ_CREATE_SIMPLE_TEST(World, World)
     TestTransforms(o, offset);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms dynamic multi-threaded")
+  {
+    // without a spatial system the transforms are updated by multiple tasks, how many depends on the number of worker threads,
+    // which is zero until the task system starts its threads
+    ezTaskSystem::SetWorkerThreadCount(-1, -1);
+
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_bAutoCreateSpatialSystem = false;
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    // a task updates at least 16 data blocks of about 18 objects each, so every level is split into several tasks
+    const ezUInt32 uiNumRoots = 2048;
+
+    ezGameObjectDesc desc;
+    desc.m_bDynamic = true;
+
+    ezDynamicArray<ezGameObject*> roots;
+    for (ezUInt32 i = 0; i < uiNumRoots; ++i)
+    {
+      desc.m_LocalPosition.Set(static_cast<float>(i), 0.0f, 0.0f);
+      world.CreateObject(desc, roots.ExpandAndGetRef());
+    }
+
+    // create the children round-robin, so that the children of one parent end up in different data blocks
+    ezDynamicArray<ezGameObject*> children;
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      for (ezUInt32 i = 0; i < uiNumRoots; ++i)
+      {
+        desc.m_hParent = roots[(i * 7 + c) % uiNumRoots]->GetHandle();
+        desc.m_LocalPosition.Set(0.0f, static_cast<float>(c + 1), 0.0f);
+        world.CreateObject(desc, children.ExpandAndGetRef());
+      }
+    }
+
+    ezDynamicArray<ezGameObject*> grandChildren;
+    for (ezUInt32 i = 0; i < children.GetCount(); ++i)
+    {
+      desc.m_hParent = children[children.GetCount() - 1 - i]->GetHandle();
+      desc.m_LocalPosition.Set(0.0f, 0.0f, 1.0f);
+      world.CreateObject(desc, grandChildren.ExpandAndGetRef());
+    }
+
+    const ezVec3 offset(0.0f, 0.0f, 1000.0f);
+    for (ezGameObject* pRoot : roots)
+    {
+      pRoot->SetLocalPosition(pRoot->GetLocalPosition() + offset);
+    }
+
+    world.Update();
+
+    for (ezGameObject* pGrandChild : grandChildren)
+    {
+      const ezGameObject* pChild = pGrandChild->GetParent();
+      const ezGameObject* pRoot = pChild->GetParent();
+
+      EZ_TEST_VEC3(pRoot->GetGlobalPosition(), pRoot->GetLocalPosition(), 0);
+      EZ_TEST_VEC3(pChild->GetGlobalPosition(), pRoot->GetLocalPosition() + pChild->GetLocalPosition(), 0);
+      EZ_TEST_VEC3(pGrandChild->GetGlobalPosition(), pChild->GetGlobalPosition() + ezVec3(0.0f, 0.0f, 1.0f), 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms dirty tracking")
+  {
+    for (ezUInt32 uiSpatialSystem = 0; uiSpatialSystem < 2; ++uiSpatialSystem)
+    {
+      ezWorldDesc worldDesc("DirtyTest");
+      worldDesc.m_bAutoCreateSpatialSystem = uiSpatialSystem == 1;
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      auto getUpdatedCount = []() { return ezStats::GetStat("World Update/DirtyTest/Updated Transforms").ConvertTo<ezUInt32>(); };
+      auto getVisitedCount = []() { return ezStats::GetStat("World Update/DirtyTest/Visited Transforms").ConvertTo<ezUInt32>(); };
+
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = true;
+
+      ezGameObject* roots[3];
+      ezGameObject* children[6];
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        desc.m_hParent.Invalidate();
+        desc.m_LocalPosition.Set(static_cast<float>(i), 0.0f, 0.0f);
+        world.CreateObject(desc, roots[i]);
+
+        desc.m_hParent = roots[i]->GetHandle();
+        desc.m_LocalPosition.Set(0.0f, 1.0f, 0.0f);
+        world.CreateObject(desc, children[i * 2 + 0]);
+        world.CreateObject(desc, children[i * 2 + 1]);
+      }
+
+      // newly created objects are updated once
+      world.Update();
+      EZ_TEST_INT(getUpdatedCount(), 9);
+      EZ_TEST_INT(getVisitedCount(), 9);
+
+      // nothing has changed, so nothing is updated
+      world.Update();
+      EZ_TEST_INT(getUpdatedCount(), 0);
+      EZ_TEST_INT(getVisitedCount(), 0);
+
+      // moving a parent also updates its children, but nothing else
+      roots[1]->SetLocalPosition(ezVec3(10.0f, 0.0f, 0.0f));
+      world.Update();
+      EZ_TEST_INT(getUpdatedCount(), 3);
+      EZ_TEST_VEC3(roots[1]->GetGlobalPosition(), ezVec3(10.0f, 0.0f, 0.0f), 0);
+      EZ_TEST_VEC3(children[2]->GetGlobalPosition(), ezVec3(10.0f, 1.0f, 0.0f), 0);
+      EZ_TEST_VEC3(children[3]->GetGlobalPosition(), ezVec3(10.0f, 1.0f, 0.0f), 0);
+      EZ_TEST_VEC3(children[4]->GetGlobalPosition(), ezVec3(2.0f, 1.0f, 0.0f), 0);
+
+      // moved objects might be updated once more to reset their velocity, after that they are skipped again
+      world.Update();
+      world.Update();
+      EZ_TEST_INT(getUpdatedCount(), 0);
+
+      // moving a child does not update its parent or siblings
+      children[5]->SetLocalPosition(ezVec3(0.0f, 2.0f, 0.0f));
+      world.Update();
+      EZ_TEST_INT(getUpdatedCount(), 1);
+      EZ_TEST_VEC3(children[5]->GetGlobalPosition(), ezVec3(2.0f, 2.0f, 0.0f), 0);
+
+      // deleting an object moves another object into its slot, which has to be updated as well
+      world.Update();
+      world.Update();
+      const ezGameObjectHandle hRoot = roots[2]->GetHandle();
+      const ezGameObjectHandle hChild = children[5]->GetHandle();
+      world.DeleteObjectNow(roots[0]->GetHandle());
+      world.Update();
+
+      ezGameObject* pObject = nullptr;
+      EZ_TEST_BOOL(world.TryGetObject(hRoot, pObject));
+      EZ_TEST_VEC3(pObject->GetGlobalPosition(), ezVec3(2.0f, 0.0f, 0.0f), 0);
+      EZ_TEST_BOOL(world.TryGetObject(hChild, pObject));
+      EZ_TEST_VEC3(pObject->GetGlobalPosition(), ezVec3(2.0f, 2.0f, 0.0f), 0);
+    }
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms static")
   {
     ezWorldDesc worldDesc("Test");
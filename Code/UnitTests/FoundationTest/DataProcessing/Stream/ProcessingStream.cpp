@@ -6,6 +6,8 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Time/Stopwatch.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(DataProcessing);
 
@@ -52,6 +54,54 @@ protected:
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddOneStreamProcessor, 1, ezRTTIDefaultAllocator<AddOneStreamProcessor>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+// Parallel add processor, works on four elements at a time
+
+class AddParallelStreamProcessor : public ezProcessingStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(AddParallelStreamProcessor, ezProcessingStreamProcessor);
+
+public:
+  AddParallelStreamProcessor() { m_bSupportsParallelProcessing = true; }
+
+  void SetStreamName(ezHashedString StreamName) { m_StreamName = StreamName; }
+
+  float m_fValue = 1.0f;
+
+protected:
+  virtual ezResult UpdateStreamBindings() override
+  {
+    m_pStream = m_pStreamGroup->GetStreamByName(m_StreamName);
+
+    return m_pStream ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
+
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    EZ_TEST_BOOL(uiStartIndex % ezProcessingStream::ElementPadding == 0);
+
+    float* pData = m_pStream->GetWritableData<float>() + uiStartIndex;
+    const ezSimdVec4f vValue(m_fValue);
+
+    for (ezUInt64 i = 0; i < uiNumElements; i += 4)
+    {
+      ezSimdVec4f v;
+      v.Load<4>(pData + i);
+      v += vValue;
+      v.Store<4>(pData + i);
+    }
+  }
+
+  ezHashedString m_StreamName;
+  ezProcessingStream* m_pStream = nullptr;
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddParallelStreamProcessor, 1, ezRTTIDefaultAllocator<AddParallelStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
 {
   ezProcessingStreamGroup Group;
@@ -157,3 +207,82 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ParallelProcessing)
+{
+  ezProcessingStreamGroup Group;
+  ezProcessingStream* pStream = Group.AddStream("Stream", ezProcessingStream::DataType::Float);
+
+  ezProcessingStreamSpawnerZeroInitialized* pSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+  pSpawner->SetStreamName(pStream->GetName());
+  Group.AddProcessor(pSpawner);
+
+  // two consecutive parallel processors are run together on the same ranges
+  AddParallelStreamProcessor* pAddOne = EZ_DEFAULT_NEW(AddParallelStreamProcessor);
+  pAddOne->SetStreamName(pStream->GetName());
+  pAddOne->m_fPriority = 1.0f;
+  Group.AddProcessor(pAddOne);
+
+  AddParallelStreamProcessor* pAddTwo = EZ_DEFAULT_NEW(AddParallelStreamProcessor);
+  pAddTwo->SetStreamName(pStream->GetName());
+  pAddTwo->m_fValue = 2.0f;
+  pAddTwo->m_fPriority = 2.0f;
+  Group.AddProcessor(pAddTwo);
+
+  // not a multiple of the range size nor of the padding
+  const ezUInt32 uiNumElements = 100003;
+  Group.SetSize(uiNumElements);
+  Group.InitializeElements(uiNumElements);
+  Group.Process();
+
+  EZ_TEST_INT(Group.GetNumActiveElements(), uiNumElements);
+
+  const ezUInt32 uiNumFrames = 10;
+  ezStopwatch sw;
+
+  for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+  {
+    Group.Process();
+  }
+
+  ezTestFramework::Output(ezTestOutput::Duration, "%u elements, 2 parallel processors: %.3fms per frame", uiNumElements, sw.GetRunningTotal().GetMilliseconds() / uiNumFrames);
+
+  {
+    const float* pData = pStream->GetData<float>();
+    ezUInt32 uiNumWrong = 0;
+    for (ezUInt32 i = 0; i < uiNumElements; ++i)
+    {
+      if (pData[i] != 3.0f * uiNumFrames)
+        ++uiNumWrong;
+    }
+
+    EZ_TEST_INT(uiNumWrong, 0);
+  }
+
+  // few elements are processed serially
+  {
+    ezProcessingStreamGroup SmallGroup;
+    ezProcessingStream* pSmallStream = SmallGroup.AddStream("Stream", ezProcessingStream::DataType::Float);
+
+    ezProcessingStreamSpawnerZeroInitialized* pSmallSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+    pSmallSpawner->SetStreamName(pSmallStream->GetName());
+    SmallGroup.AddProcessor(pSmallSpawner);
+
+    AddParallelStreamProcessor* pSmallAdd = EZ_DEFAULT_NEW(AddParallelStreamProcessor);
+    pSmallAdd->SetStreamName(pSmallStream->GetName());
+    pSmallAdd->m_fPriority = 1.0f;
+    SmallGroup.AddProcessor(pSmallAdd);
+
+    SmallGroup.SetSize(10);
+    SmallGroup.InitializeElements(10);
+    SmallGroup.Process();
+    SmallGroup.Process();
+
+    ezProcessingStreamIterator<float> it(pSmallStream, SmallGroup.GetNumActiveElements(), 0);
+    while (!it.HasReachedEnd())
+    {
+      EZ_TEST_FLOAT(it.Current(), 1.0f, 0.0f);
+      it.Advance();
+    }
+  }
+}
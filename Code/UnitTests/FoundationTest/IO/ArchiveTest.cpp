@@ -1,6 +1,9 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/Archive/ArchiveBuilder.h>
+#include <Foundation/IO/Archive/ArchiveReader.h>
+#include <Foundation/IO/Archive/ArchiveUtils.h>
 #include <Foundation/IO/Archive/DataDirTypeArchive.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
@@ -153,3 +156,243 @@ EZ_CREATE_SIMPLE_TEST(IO, Archive)
 }
 
 #endif
+
+#if EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE) && defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT)
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveBuilder)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveBuilderTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::CreateDirectoryStructure(sOutputFolder).IgnoreResult();
+
+  if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "Clear", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS).Failed())
+    return;
+
+  const char* szFileList[] = {
+    "Small.txt",    // a single compressed frame
+    "Large.bin",    // many compressed frames
+    "Random.bin",   // incompressible, should get stored uncompressed
+    "Empty.txt",
+  };
+
+  const ezUInt32 uiFileSizes[] = {1024 * 10, 1024 * 1024 * 3 + 17, 1024 * 512, 0};
+  const ezUInt32 uiFrameSize = 1024 * 64;
+
+  // every fourth 32 bit value is random, which gives a data set that compresses reasonably well, but not perfectly
+  auto GetData = [](ezUInt32 uiFileIdx, ezUInt32 uiIndex) -> ezUInt32 {
+    const ezUInt32 uiRandom = (uiIndex * 1664525u + 1013904223u + uiFileIdx) * 2654435761u;
+    return (uiFileIdx == 2 || (uiIndex & 3) == 0) ? uiRandom : uiIndex / 64;
+  };
+
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Frames.ezArchive");
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Build Archive")
+  {
+    ezArchiveBuilder builder;
+    builder.m_uiCompressionFrameSize = uiFrameSize;
+
+    ezStringBuilder fileName;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < EZ_ARRAY_SIZE(szFileList); ++uiFileIdx)
+    {
+      fileName.Set(":output/Source/", szFileList[uiFileIdx]);
+
+      ezFileWriter file;
+      if (EZ_TEST_BOOL(file.Open(fileName).Succeeded()).Failed())
+        return;
+
+      for (ezUInt32 i = 0; i < uiFileSizes[uiFileIdx] / 4; ++i)
+      {
+        file << GetData(uiFileIdx, i);
+      }
+
+      for (ezUInt32 i = 0; i < uiFileSizes[uiFileIdx] % 4; ++i)
+      {
+        file << static_cast<ezUInt8>(i);
+      }
+
+      auto& entry = builder.m_Entries.ExpandAndGetRef();
+      entry.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Source/", szFileList[uiFileIdx]);
+      entry.m_sRelTargetPath = szFileList[uiFileIdx];
+      entry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+    }
+
+    ezTime tStart = ezTime::Now();
+    EZ_TEST_BOOL(builder.WriteArchive(":output/Frames.ezArchive").Succeeded());
+    ezTestFramework::Output(ezTestOutput::Duration, "Building the archive: %.2fms", (ezTime::Now() - tStart).GetMilliseconds());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compression Modes")
+  {
+    ezArchiveReader reader;
+    if (EZ_TEST_BOOL(reader.OpenArchive(sArchiveFile).Succeeded()).Failed())
+      return;
+
+    const ezArchiveTOC& toc = reader.GetArchiveTOC();
+
+    const ezArchiveCompressionMode expectedModes[] = {
+      ezArchiveCompressionMode::Compressed_zstd,
+      ezArchiveCompressionMode::Compressed_zstd_framed,
+      ezArchiveCompressionMode::Uncompressed,
+      ezArchiveCompressionMode::Uncompressed,
+    };
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < EZ_ARRAY_SIZE(szFileList); ++uiFileIdx)
+    {
+      const ezUInt32 uiEntry = toc.FindEntry(szFileList[uiFileIdx]);
+      if (EZ_TEST_BOOL(uiEntry != ezInvalidIndex).Failed())
+        continue;
+
+      EZ_TEST_BOOL(toc.m_Entries[uiEntry].m_CompressionMode == expectedModes[uiFileIdx]);
+      EZ_TEST_INT(toc.m_Entries[uiEntry].m_uiUncompressedDataSize, uiFileSizes[uiFileIdx]);
+    }
+
+    EZ_TEST_BOOL(toc.m_Entries[toc.FindEntry("Large.bin")].m_uiStoredDataSize < uiFileSizes[1] * 8 / 10);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Archive Version")
+  {
+    ezUInt8 uiVersion = 0;
+
+    // only archives with framed entries need the new version
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":output/Frames.ezArchive").Succeeded()).Failed())
+        return;
+
+      EZ_TEST_BOOL(ezArchiveUtils::ReadHeader(file, uiVersion).Succeeded());
+      EZ_TEST_INT(uiVersion, 3);
+    }
+
+    ezArchiveBuilder builder;
+    builder.m_uiCompressionFrameSize = uiFrameSize;
+
+    for (ezUInt32 uiFileIdx : {0, 2})
+    {
+      auto& entry = builder.m_Entries.ExpandAndGetRef();
+      entry.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Source/", szFileList[uiFileIdx]);
+      entry.m_sRelTargetPath = szFileList[uiFileIdx];
+      entry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+    }
+
+    EZ_TEST_BOOL(builder.WriteArchive(":output/NoFrames.ezArchive").Succeeded());
+
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":output/NoFrames.ezArchive").Succeeded()).Failed())
+        return;
+
+      EZ_TEST_BOOL(ezArchiveUtils::ReadHeader(file, uiVersion).Succeeded());
+      EZ_TEST_INT(uiVersion, 2);
+    }
+
+    ezArchiveReader reader;
+    if (EZ_TEST_BOOL(reader.OpenArchive(ezStringBuilder(sOutputFolder, "/NoFrames.ezArchive")).Succeeded()).Failed())
+      return;
+
+    const ezArchiveTOC& toc = reader.GetArchiveTOC();
+    EZ_TEST_BOOL(toc.m_Entries[toc.FindEntry("Small.txt")].m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd);
+    EZ_TEST_BOOL(toc.m_Entries[toc.FindEntry("Random.bin")].m_CompressionMode == ezArchiveCompressionMode::Uncompressed);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "Clear", "archive", ezFileSystem::ReadOnly) == EZ_SUCCESS).Failed())
+      return;
+
+    ezStringBuilder sFileSrc;
+    ezStringBuilder sFileDst;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < EZ_ARRAY_SIZE(szFileList); ++uiFileIdx)
+    {
+      sFileSrc.Set(":output/Source/", szFileList[uiFileIdx]);
+      sFileDst.Set(":archive/", szFileList[uiFileIdx]);
+
+      EZ_TEST_FILES(sFileSrc, sFileDst, "Archived file should be identical");
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Seek in Frames")
+  {
+    ezFileReader file;
+    if (EZ_TEST_BOOL(file.Open(":archive/Large.bin").Succeeded()).Failed())
+      return;
+
+    // skip into the middle of a frame, then across a couple of frames, then within the same frame
+    const ezUInt32 uiSkips[] = {uiFrameSize * 3 + 400, uiFrameSize * 20 + 4, 1024 * 8};
+
+    ezUInt32 uiPosition = 0;
+    ezUInt32 uiValue = 0;
+
+    for (ezUInt32 uiSkip : uiSkips)
+    {
+      EZ_TEST_INT(file.SkipBytes(uiSkip), uiSkip);
+      uiPosition += uiSkip;
+
+      for (ezUInt32 i = 0; i < 512; ++i)
+      {
+        file >> uiValue;
+        EZ_TEST_INT(uiValue, GetData(1, uiPosition / 4));
+        uiPosition += 4;
+      }
+    }
+
+    // skipping past the end stops at the end of the file
+    EZ_TEST_INT(file.SkipBytes(uiFileSizes[1]), uiFileSizes[1] - uiPosition);
+    EZ_TEST_INT(file.ReadBytes(&uiValue, 4), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mapped Data")
+  {
+    // compressed entries have to be decoded and can't be accessed in place
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":archive/Large.bin").Succeeded()).Failed())
+        return;
+
+      EZ_TEST_BOOL(file.GetMappedData().IsEmpty());
+    }
+
+    ezFileReader file;
+    if (EZ_TEST_BOOL(file.Open(":archive/Random.bin").Succeeded()).Failed())
+      return;
+
+    const ezArrayPtr<const ezUInt8> mappedData = file.GetMappedData();
+    if (EZ_TEST_INT(mappedData.GetCount(), uiFileSizes[2]).Failed())
+      return;
+
+    ezTime tStart = ezTime::Now();
+    for (ezUInt32 i = 0; i < uiFileSizes[2] / 4; ++i)
+    {
+      ezUInt32 uiValue;
+      ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&uiValue), mappedData.GetPtr() + i * 4, 4);
+
+      if (uiValue != GetData(2, i))
+      {
+        EZ_TEST_INT(uiValue, GetData(2, i));
+        break;
+      }
+    }
+    ezTestFramework::Output(ezTestOutput::Duration, "Reading the mapped entry in place: %.3fms", (ezTime::Now() - tStart).GetMilliseconds());
+
+    // reading through the stream interface copies the data, but doesn't add a cache in between
+    ezDynamicArray<ezUInt8> copy;
+    copy.SetCountUninitialized(uiFileSizes[2]);
+
+    tStart = ezTime::Now();
+    EZ_TEST_INT(file.ReadBytes(copy.GetData(), uiFileSizes[2]), uiFileSizes[2]);
+    ezTestFramework::Output(ezTestOutput::Duration, "Copying the mapped entry: %.3fms", (ezTime::Now() - tStart).GetMilliseconds());
+
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(copy.GetData(), mappedData.GetPtr(), uiFileSizes[2]));
+
+    // the view does not depend on the read position
+    EZ_TEST_INT(file.ReadBytes(copy.GetData(), 4), 0);
+    EZ_TEST_INT(file.GetMappedData().GetCount(), uiFileSizes[2]);
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("Clear");
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Threading/Thread.h>
 
 #if EZ_ENABLED(EZ_SUPPORTS_LONG_PATHS)
 #define LongPath "AVeryLongSubFolderPathNameThatShouldExceedThePathLengthLimitOnPlatformsLikeWindowsWhereOnly260CharactersAreAllowedOhNoesIStillNeedMoreThisIsNotLongEnoughAaaaaaaaaaaaaaahhhhStillTooShortAaaaaaaaaaaaaaaaaaaaaahImBoredNow"
@@ -11,6 +12,36 @@
 #define LongPath "AShortPathBecaueThisPlatformDoesntSupportLongOnes"
 #endif
 
+namespace
+{
+  class FileSystemLookupThread : public ezThread
+  {
+  public:
+    FileSystemLookupThread()
+      : ezThread("File System Lookup Thread")
+    {
+    }
+
+    ezAtomicInteger32* m_pKeepRunning = nullptr;
+    ezUInt32 m_uiLookups = 0;
+    ezUInt32 m_uiFailedLookups = 0;
+
+    virtual ezUInt32 Run() override
+    {
+      while (*m_pKeepRunning != 0)
+      {
+        ezFileReader FileIn;
+        if (!ezFileSystem::ExistsFile("FileSystemLookupTest.txt") || FileIn.Open("FileSystemLookupTest.txt").Failed())
+          ++m_uiFailedLookups;
+
+        ++m_uiLookups;
+      }
+
+      return 0;
+    }
+  };
+} // namespace
+
 EZ_CREATE_SIMPLE_TEST(IO, FileSystem)
 {
   ezStringBuilder sFileContent = "Lyrics to Taste The Cake:\n\
@@ -361,4 +392,119 @@ Only concrete and clocks.\n\
 
     ezFileSystem::RemoveDataDirectoryGroup("remove");
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "File Index")
+  {
+    ezDataDirectory::FolderType::s_bUseFileIndex = true;
+
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder1, "index", "index1", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder2, "index", "index2", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+
+    ezDataDirectory::FolderType::s_bUseFileIndex = false;
+
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder2, "index", "plain2", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+
+    // the index needs file iteration and a directory watcher, wherever those are available it must be in use
+    {
+      const bool bIndexSupported = ezDataDirectory::FolderType::IsFileIndexSupported();
+
+      auto pIndex1 = static_cast<ezDataDirectory::FolderType*>(ezFileSystem::FindDataDirectoryWithRoot("index1"));
+      auto pIndex2 = static_cast<ezDataDirectory::FolderType*>(ezFileSystem::FindDataDirectoryWithRoot("index2"));
+      auto pPlain2 = static_cast<ezDataDirectory::FolderType*>(ezFileSystem::FindDataDirectoryWithRoot("plain2"));
+
+      EZ_TEST_BOOL(pIndex1->HasFileIndex() == bIndexSupported);
+      EZ_TEST_BOOL(pIndex2->HasFileIndex() == bIndexSupported);
+      EZ_TEST_BOOL(!pPlain2->HasFileIndex());
+
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+      EZ_TEST_BOOL(bIndexSupported);
+#endif
+    }
+
+    // written through the indexed data directory
+    {
+      ezFileWriter FileOut;
+      EZ_TEST_BOOL(FileOut.Open(":index1/SubSub/FileIndexTest.txt") == EZ_SUCCESS);
+      EZ_TEST_BOOL(FileOut.WriteBytes(sFileContent.GetData(), sFileContent.GetElementCount()) == EZ_SUCCESS);
+    }
+
+    ezFileSystem::ResetProbeStats();
+
+    {
+      EZ_TEST_BOOL(ezFileSystem::ExistsFile("SubSub/FileIndexTest.txt"));
+      EZ_TEST_BOOL(ezFileSystem::ExistsFile(":index1/SubSub/FileIndexTest.txt"));
+      EZ_TEST_BOOL(!ezFileSystem::ExistsFile(":index2/SubSub/FileIndexTest.txt"));
+
+      ezFileReader FileIn;
+      EZ_TEST_BOOL(FileIn.Open("SubSub/FileIndexTest.txt") == EZ_SUCCESS);
+      EZ_TEST_INT(FileIn.GetFileSize(), sFileContent.GetElementCount());
+    }
+
+    // the unrooted lookups first try plain2 and index2, which don't have the file
+    ezFileSystem::ProbeStats stats = ezFileSystem::GetProbeStats();
+    EZ_TEST_INT(stats.m_uiHits, 3);
+    EZ_TEST_INT(stats.m_uiMisses, 5);
+
+    // written and deleted through another data directory that points to the indexed folder
+    {
+      ezFileWriter FileOut;
+      EZ_TEST_BOOL(FileOut.Open(":plain2/FileIndexTest2.txt") == EZ_SUCCESS);
+      FileOut.Close();
+
+      EZ_TEST_BOOL(ezFileSystem::ExistsFile(":index2/FileIndexTest2.txt"));
+
+      ezFileSystem::DeleteFile(":plain2/FileIndexTest2.txt");
+      EZ_TEST_BOOL(!ezFileSystem::ExistsFile(":index2/FileIndexTest2.txt"));
+    }
+
+    ezFileSystem::DeleteFile(":index1/SubSub/FileIndexTest.txt");
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile("SubSub/FileIndexTest.txt"));
+
+    {
+      ezFileReader FileIn;
+      EZ_TEST_BOOL(FileIn.Open("SubSub/FileIndexTest.txt") == EZ_FAILURE);
+    }
+
+    ezFileSystem::RemoveDataDirectoryGroup("index");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Concurrent Lookups")
+  {
+    {
+      ezFileWriter FileOut;
+      EZ_TEST_BOOL(FileOut.Open(":output1/FileSystemLookupTest.txt") == EZ_SUCCESS);
+      EZ_TEST_BOOL(FileOut.WriteBytes(sFileContent.GetData(), sFileContent.GetElementCount()) == EZ_SUCCESS);
+    }
+
+    ezAtomicInteger32 iKeepRunning = 1;
+
+    FileSystemLookupThread threads[2];
+    for (auto& thread : threads)
+    {
+      thread.m_pKeepRunning = &iKeepRunning;
+      thread.Start();
+    }
+
+    // the lookups don't lock the file system, they must neither fail nor use data directories that are being removed
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(szOutputFolder, "lookup", "lookup1") == EZ_SUCCESS);
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder2, "lookup", "lookup2") == EZ_SUCCESS);
+
+      EZ_TEST_BOOL(ezFileSystem::RemoveDataDirectory("lookup1"));
+      EZ_TEST_INT(ezFileSystem::RemoveDataDirectoryGroup("lookup"), 1);
+    }
+
+    iKeepRunning = 0;
+
+    for (auto& thread : threads)
+    {
+      thread.Join();
+
+      EZ_TEST_BOOL(thread.m_uiLookups > 0);
+      EZ_TEST_INT(thread.m_uiFailedLookups, 0);
+    }
+
+    ezFileSystem::DeleteFile(":output1/FileSystemLookupTest.txt");
+  }
 }
@@ -0,0 +1,225 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+
+namespace
+{
+  double ComputeRootMeanSquareError(const ezImageView& imageA, const ezImageView& imageB)
+  {
+    double fSum = 0.0;
+
+    for (ezUInt32 y = 0; y < imageA.GetHeight(); ++y)
+    {
+      const ezUInt8* pA = imageA.GetPixelPointer<ezUInt8>(0, 0, 0, 0, y);
+      const ezUInt8* pB = imageB.GetPixelPointer<ezUInt8>(0, 0, 0, 0, y);
+
+      for (ezUInt32 i = 0; i < imageA.GetWidth() * 4; ++i)
+      {
+        const double fDiff = static_cast<double>(pA[i]) - static_cast<double>(pB[i]);
+        fSum += fDiff * fDiff;
+      }
+    }
+
+    return ezMath::Sqrt(fSum / (imageA.GetWidth() * imageA.GetHeight() * 4));
+  }
+
+  typedef void (*CompressBlockFunc)(const ezColorBaseUB*, ezUInt8*, ezBlockCompressionQuality::Enum);
+
+  // Blocks at the right and bottom border repeat the last column and row of the image
+  void CompressImage(const ezImageView& image, ezImageFormat::Enum format, ezBlockCompressionQuality::Enum quality, ezDynamicArray<ezUInt8>& out_Blocks)
+  {
+    const CompressBlockFunc compressBlock = format == ezImageFormat::BC1_UNORM ? &ezCompressBlockBC1 : format == ezImageFormat::BC3_UNORM ? &ezCompressBlockBC3 : &ezCompressBlockBC7;
+    const ezUInt32 uiBlockSize = ezImageFormat::GetBitsPerBlock(format) / 8;
+    const ezUInt32 uiNumBlocksX = (image.GetWidth() + 3) / 4;
+    const ezUInt32 uiNumBlocksY = (image.GetHeight() + 3) / 4;
+
+    out_Blocks.SetCountUninitialized(uiNumBlocksX * uiNumBlocksY * uiBlockSize);
+
+    ezColorBaseUB sourceBlock[16];
+
+    for (ezUInt32 blockY = 0; blockY < uiNumBlocksY; ++blockY)
+    {
+      for (ezUInt32 blockX = 0; blockX < uiNumBlocksX; ++blockX)
+      {
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          const ezUInt32 x = ezMath::Min(blockX * 4 + i % 4, image.GetWidth() - 1);
+          const ezUInt32 y = ezMath::Min(blockY * 4 + i / 4, image.GetHeight() - 1);
+          sourceBlock[i] = *image.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y);
+        }
+
+        compressBlock(sourceBlock, &out_Blocks[(blockY * uiNumBlocksX + blockX) * uiBlockSize], quality);
+      }
+    }
+  }
+
+  void DecompressImage(const ezDynamicArray<ezUInt8>& blocks, ezImageFormat::Enum format, ezImage& inout_Image)
+  {
+    const ezUInt32 uiBlockSize = ezImageFormat::GetBitsPerBlock(format) / 8;
+    const ezUInt32 uiNumBlocksX = (inout_Image.GetWidth() + 3) / 4;
+    const ezUInt32 uiNumBlocksY = (inout_Image.GetHeight() + 3) / 4;
+
+    ezColorBaseUB decoded[16];
+
+    for (ezUInt32 blockY = 0; blockY < uiNumBlocksY; ++blockY)
+    {
+      for (ezUInt32 blockX = 0; blockX < uiNumBlocksX; ++blockX)
+      {
+        const ezUInt8* pBlock = &blocks[(blockY * uiNumBlocksX + blockX) * uiBlockSize];
+
+        switch (format)
+        {
+          case ezImageFormat::BC1_UNORM:
+            ezDecompressBlockBC1(pBlock, decoded, false);
+            break;
+          case ezImageFormat::BC3_UNORM:
+            ezDecompressBlockBC1(pBlock + 8, decoded, true);
+            ezDecompressBlockBC4(pBlock, &decoded[0].a, 4, 0);
+            break;
+          default:
+            ezDecompressBlockBC7(pBlock, decoded);
+            break;
+        }
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          const ezUInt32 x = blockX * 4 + i % 4;
+          const ezUInt32 y = blockY * 4 + i / 4;
+
+          if (x < inout_Image.GetWidth() && y < inout_Image.GetHeight())
+          {
+            *inout_Image.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y) = decoded[i];
+          }
+        }
+      }
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, BlockCompression)
+{
+  const ezStringBuilder sReadDir(">sdk/", ezTestFramework::GetInstance()->GetRelTestDataPath());
+
+  ezResult addDir = ezFileSystem::AddDataDirectory(sReadDir.GetData(), "BlockCompressionTest");
+  EZ_TEST_BOOL(addDir == EZ_SUCCESS);
+
+  if (addDir.Failed())
+    return;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC1 Transparency")
+  {
+    ezColorBaseUB source[16];
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      source[i] = ezColorBaseUB(static_cast<ezUInt8>(i * 16), 128, static_cast<ezUInt8>(255 - i * 16), (i & 1) ? 255 : 0);
+    }
+
+    for (ezUInt32 quality = ezBlockCompressionQuality::Fast; quality <= ezBlockCompressionQuality::High; ++quality)
+    {
+      ezUInt8 block[8];
+      ezCompressBlockBC1(source, block, static_cast<ezBlockCompressionQuality::Enum>(quality));
+
+      ezColorBaseUB decoded[16];
+      ezDecompressBlockBC1(block, decoded, false);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        EZ_TEST_INT(decoded[i].a, source[i].a);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Alpha Gradient")
+  {
+    ezColorBaseUB source[16];
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      source[i] = ezColorBaseUB(200, static_cast<ezUInt8>(i * 8), 50, static_cast<ezUInt8>(i * 17));
+    }
+
+    ezUInt8 block[16];
+    ezColorBaseUB decoded[16];
+
+    ezCompressBlockBC7(source, block, ezBlockCompressionQuality::Default);
+    ezDecompressBlockBC7(block, decoded);
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      EZ_TEST_BOOL_MSG(ezMath::Abs(decoded[i].a - source[i].a) <= 4, "BC7 alpha of pixel %u", i);
+    }
+
+    ezCompressBlockBC3(source, block, ezBlockCompressionQuality::Default);
+    ezDecompressBlockBC4(block, &decoded[0].a, 4, 0);
+
+    // BC3 only has 8 alpha levels per block, so the 16 levels of the gradient can't all be hit
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      EZ_TEST_BOOL_MSG(ezMath::Abs(decoded[i].a - source[i].a) <= 20, "BC3 alpha of pixel %u", i);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Throughput and Quality")
+  {
+    ezImage source;
+    EZ_TEST_BOOL(source.LoadFrom("ImageConversions/reference.png").Succeeded());
+    EZ_TEST_BOOL(source.Convert(ezImageFormat::R8G8B8A8_UNORM).Succeeded());
+
+    // BC1 only has 1-bit alpha, so it gets an opaque copy of the reference image
+    ezImage opaqueSource;
+    opaqueSource.ResetAndCopy(source);
+    for (ezUInt32 y = 0; y < opaqueSource.GetHeight(); ++y)
+    {
+      ezColorBaseUB* pPixel = opaqueSource.GetPixelPointer<ezColorBaseUB>(0, 0, 0, 0, y);
+
+      for (ezUInt32 x = 0; x < opaqueSource.GetWidth(); ++x)
+      {
+        pPixel[x].a = 255;
+      }
+    }
+
+    const double fMegaPixels = source.GetWidth() * source.GetHeight() / 1000000.0;
+
+    const ezImageFormat::Enum formats[] = {ezImageFormat::BC1_UNORM, ezImageFormat::BC3_UNORM, ezImageFormat::BC7_UNORM};
+    const char* qualityNames[] = {"fast", "balanced", "high"};
+
+    // the largest acceptable RMSE on the reference image at balanced quality
+    const double maxErrors[] = {10.0, 10.0, 3.0};
+
+    // the compressors are called directly, ezImageConversion might pick other implementations (e.g. DirectXTex on Windows)
+    for (ezUInt32 f = 0; f < EZ_ARRAY_SIZE(formats); ++f)
+    {
+      const ezImage& formatSource = formats[f] == ezImageFormat::BC1_UNORM ? opaqueSource : source;
+      double errors[3];
+
+      for (ezUInt32 quality = ezBlockCompressionQuality::Fast; quality <= ezBlockCompressionQuality::High; ++quality)
+      {
+        ezDynamicArray<ezUInt8> blocks;
+
+        // repeat the compression until the measurement covers at least 100ms
+        ezUInt32 uiNumRuns = 0;
+        const ezTime tStart = ezTime::Now();
+        do
+        {
+          CompressImage(formatSource, formats[f], static_cast<ezBlockCompressionQuality::Enum>(quality), blocks);
+          ++uiNumRuns;
+        } while ((ezTime::Now() - tStart).GetMilliseconds() < 100.0);
+        const ezTime tDuration = (ezTime::Now() - tStart) / static_cast<double>(uiNumRuns);
+
+        ezImage decompressed;
+        decompressed.ResetAndCopy(formatSource);
+        DecompressImage(blocks, formats[f], decompressed);
+        errors[quality] = ComputeRootMeanSquareError(formatSource, decompressed);
+
+        ezTestFramework::Output(ezTestOutput::Duration, "%s (%s): %.2f MP/s, RMSE %.2f", ezImageFormat::GetName(formats[f]),
+          qualityNames[quality], fMegaPixels / tDuration.GetSeconds(), errors[quality]);
+      }
+
+      EZ_TEST_BOOL(errors[ezBlockCompressionQuality::Balanced] <= errors[ezBlockCompressionQuality::Fast]);
+      EZ_TEST_BOOL(errors[ezBlockCompressionQuality::High] <= errors[ezBlockCompressionQuality::Balanced]);
+      EZ_TEST_BOOL(errors[ezBlockCompressionQuality::Balanced] <= maxErrors[f]);
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("BlockCompressionTest");
+}
@@ -5,6 +5,7 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
 #include <Texture/Image/Formats/BmpFileFormat.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/Formats/ImageFileFormat.h>
@@ -83,11 +84,17 @@ private:
 
       // the [test] tag tells the test framework to output the log message in the GUI
       ezLog::Info("[test]Default encoding Path:");
+      bool bUsesPortableBlockCompression = false;
       for (ezUInt32 i = 0; i < encodingPath.GetCount(); ++i)
       {
         ezLog::Info("[test]  {} -> {}", ezImageFormat::GetName(encodingPath[i].m_sourceFormat),
           ezImageFormat::GetName(encodingPath[i].m_targetFormat));
+
+        bUsesPortableBlockCompression |= encodingPath[i].m_step == ezGetPortableBlockCompressionStep();
       }
+
+      // The portable compressors produce different (but equally valid) blocks than DirectXTex
+      ezTestFramework::GetInstance()->SetImageReferenceOverrideFolderName(bUsesPortableBlockCompression ? "Images_Reference_Portable" : "");
     }
 
     // Test LDR: Load, encode to target format, then do image comparison (which internally decodes to BGR8_UNORM again).
@@ -214,6 +221,8 @@ private:
     ezFileSystem::RemoveDataDirectoryGroup("ImageConversionTest");
     ezFileSystem::RemoveDataDirectoryGroup("ImageComparisonDataDir");
 
+    ezTestFramework::GetInstance()->SetImageReferenceOverrideFolderName("");
+
     ezStartup::ShutdownCoreSystems();
     ezMemoryTracker::DumpMemoryLeaks();
 
@@ -116,5 +116,97 @@ EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
     EZ_TEST_INT(uiError, 1433);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D")
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(8);
+    header.SetHeight(4);
+    header.SetDepth(16);
+
+    ezImage volume;
+    volume.ResetAndAlloc(header);
+
+    for (ezUInt32 z = 0; z < header.GetDepth(); ++z)
+    {
+      for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+      {
+        for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+        {
+          *volume.GetPixelPointer<ezColor>(0, 0, 0, x, y, z) = ezColor(1.0f, 0.5f, static_cast<float>(z), 1.0f);
+        }
+      }
+    }
+
+    ezImage scaled;
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(volume, scaled, 4, 2, 8).Succeeded());
+    EZ_TEST_INT(scaled.GetDepth(), 8);
+
+    float fPreviousSlice = -1.0f;
+    for (ezUInt32 z = 0; z < scaled.GetDepth(); ++z)
+    {
+      const float fSlice = scaled.GetPixelPointer<ezColor>(0, 0, 0, 0, 0, z)->b;
+      EZ_TEST_BOOL(fSlice > fPreviousSlice);
+      fPreviousSlice = fSlice;
+
+      for (ezUInt32 y = 0; y < scaled.GetHeight(); ++y)
+      {
+        for (ezUInt32 x = 0; x < scaled.GetWidth(); ++x)
+        {
+          const ezColor color = *scaled.GetPixelPointer<ezColor>(0, 0, 0, x, y, z);
+          EZ_TEST_FLOAT(color.r, 1.0f, 0.0001f);
+          EZ_TEST_FLOAT(color.g, 0.5f, 0.0001f);
+          EZ_TEST_FLOAT(color.b, fSlice, 0.0001f);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateMipMapsStreamed")
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(64);
+    header.SetHeight(32);
+    header.SetNumArrayIndices(2);
+
+    ezImage source;
+    source.ResetAndAlloc(header);
+
+    for (ezUInt32 arrayIndex = 0; arrayIndex < header.GetNumArrayIndices(); ++arrayIndex)
+    {
+      for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+      {
+        for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+        {
+          *source.GetPixelPointer<ezColor>(0, 0, arrayIndex, x, y) =
+            ezColor(x / 64.0f, y / 32.0f, static_cast<float>(arrayIndex), ((x ^ y) & 3) == 0 ? 1.0f : 0.0f);
+        }
+      }
+    }
+
+    ezImageFilterSincWithKaiserWindow filter;
+
+    ezImageUtils::MipMapOptions options;
+    options.m_filter = &filter;
+    options.m_preserveCoverage = true;
+    options.m_addressModeU = ezImageAddressMode::Repeat;
+
+    ezImage mipMaps;
+    ezImageUtils::GenerateMipMaps(source, mipMaps, options);
+
+    ezUInt32 uiNumCallbacks = 0;
+    ezImageUtils::GenerateMipMapsStreamed(source, options, [&](const ezImageView& mipMap, ezUInt32 uiMipLevel, ezUInt32 uiFace, ezUInt32 uiArrayIndex) {
+      ++uiNumCallbacks;
+
+      const ezImageView expected = mipMaps.GetSubImageView(uiMipLevel, uiFace, uiArrayIndex);
+      EZ_TEST_INT(mipMap.GetWidth(), expected.GetWidth());
+      EZ_TEST_INT(mipMap.GetHeight(), expected.GetHeight());
+      EZ_TEST_BOOL(memcmp(mipMap.GetByteBlobPtr().GetPtr(), expected.GetByteBlobPtr().GetPtr(), static_cast<size_t>(expected.GetByteBlobPtr().GetCount())) == 0);
+    });
+
+    EZ_TEST_INT(uiNumCallbacks, mipMaps.GetNumMipLevels() * mipMaps.GetNumArrayIndices());
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
@@ -7,6 +7,7 @@
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Logging/VisualStudioWriter.h>
 #include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
 #include <TestFramework/Utilities/TestLogInterface.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Logging);
@@ -254,3 +255,202 @@ EZ_CREATE_SIMPLE_TEST(Logging, GlobalTestLog)
     }
   }
 }
+
+namespace
+{
+  struct AsyncLogTestWriter
+  {
+    void LogMessageHandler(const ezLoggingEventData& le)
+    {
+      if (!ezStringUtils::StartsWith(le.m_szText, "Async "))
+        return;
+
+      if (ezStringUtils::IsEqual(le.m_szText, "Async Block"))
+      {
+        // keeps the log thread busy, so that the buffer of the logging thread runs full
+        m_Unblock.WaitForSignal();
+        return;
+      }
+
+      m_CalledOnTestThread.PushBack(ezThreadUtils::GetCurrentThreadID() == m_TestThread);
+      m_Messages.PushBack(le.m_szText);
+    }
+
+    ezThreadSignal m_Unblock;
+    ezThreadID m_TestThread = ezThreadUtils::GetCurrentThreadID();
+    ezDynamicArray<bool> m_CalledOnTestThread;
+    ezDynamicArray<ezString> m_Messages;
+  };
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Logging, AsyncLog)
+{
+  ezLog::GetThreadLocalLogSystem()->SetLogLevel(ezLogMsgType::All);
+
+  AsyncLogTestWriter writer;
+  ezGlobalLog::AddLogWriter(ezMakeDelegate(&AsyncLogTestWriter::LogMessageHandler, &writer));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Ordering")
+  {
+    ezGlobalLog::EnableAsyncLogging();
+    EZ_TEST_BOOL(ezGlobalLog::IsAsyncLoggingEnabled());
+
+    class LogThread : public ezThread
+    {
+    public:
+      virtual ezUInt32 Run() override
+      {
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          ezLog::Info("Async {0} {1}", m_uiIndex, i);
+        }
+        return 0;
+      }
+
+      ezUInt32 m_uiIndex = 0;
+    };
+
+    LogThread thread[4];
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      thread[i].m_uiIndex = i;
+      thread[i].Start();
+    }
+
+    ezLog::Info("Async Main");
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      thread[i].Join();
+    }
+
+    ezGlobalLog::FlushAsyncLogging();
+
+    EZ_TEST_INT(writer.m_Messages.GetCount(), 4 * 16 + 1);
+
+    ezUInt32 uiNextMessage[4] = {};
+    ezStringBuilder sExpected;
+
+    for (ezUInt32 i = 0; i < writer.m_Messages.GetCount(); ++i)
+    {
+      if (writer.m_Messages[i] == "Async Main")
+        continue;
+
+      const ezUInt32 uiThread = writer.m_Messages[i].GetData()[6] - '0';
+      EZ_TEST_BOOL(uiThread < 4);
+      if (uiThread >= 4)
+        break;
+
+      // the messages of each thread arrive in the order in which they were logged
+      sExpected.Format("Async {0} {1}", uiThread, uiNextMessage[uiThread]++);
+      EZ_TEST_STRING(writer.m_Messages[i], sExpected);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Dropped Messages")
+  {
+    writer.m_Messages.Clear();
+    writer.m_CalledOnTestThread.Clear();
+
+    // the smallest possible buffer only fits a handful of messages
+    ezGlobalLog::EnableAsyncLogging(0);
+
+    const ezUInt32 uiDroppedBefore = ezGlobalLog::GetDroppedAsyncMessageCount();
+
+    class LogThread : public ezThread
+    {
+    public:
+      virtual ezUInt32 Run() override
+      {
+        ezLog::Info("Async Block");
+
+        for (ezUInt32 i = 0; i < 100; ++i)
+        {
+          ezLog::Info("Async message {0} that is long enough to take up a noticeable amount of space in the ring buffer", i);
+        }
+        return 0;
+      }
+    };
+
+    LogThread thread;
+    thread.Start();
+    thread.Join();
+
+    writer.m_Unblock.RaiseSignal();
+    ezGlobalLog::FlushAsyncLogging();
+
+    const ezUInt32 uiDropped = ezGlobalLog::GetDroppedAsyncMessageCount() - uiDroppedBefore;
+    EZ_TEST_BOOL(uiDropped > 0);
+    EZ_TEST_INT(writer.m_Messages.GetCount() + uiDropped, 100);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Disable")
+  {
+    writer.m_Messages.Clear();
+    writer.m_CalledOnTestThread.Clear();
+
+    ezLog::Info("Async Pending");
+    ezGlobalLog::DisableAsyncLogging();
+    EZ_TEST_BOOL(!ezGlobalLog::IsAsyncLoggingEnabled());
+
+    // everything that was pending is passed on when disabling, afterwards messages are passed on right away
+    EZ_TEST_INT(writer.m_Messages.GetCount(), 1);
+
+    ezLog::Info("Async Sync");
+    EZ_TEST_INT(writer.m_Messages.GetCount(), 2);
+    EZ_TEST_BOOL(writer.m_CalledOnTestThread.PeekBack());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Disable While Logging")
+  {
+    writer.m_Messages.Clear();
+    writer.m_CalledOnTestThread.Clear();
+
+    ezGlobalLog::EnableAsyncLogging();
+
+    const ezUInt32 uiDroppedBefore = ezGlobalLog::GetDroppedAsyncMessageCount();
+
+    class LogThread : public ezThread
+    {
+    public:
+      virtual ezUInt32 Run() override
+      {
+        while (!m_bStop && m_uiNumMessages < 10000)
+        {
+          ezLog::Info("Async {0}", m_uiNumMessages);
+          ++m_uiNumMessages;
+        }
+        return 0;
+      }
+
+      ezAtomicBool m_bStop;
+      ezUInt32 m_uiNumMessages = 0;
+    };
+
+    LogThread thread[4];
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      thread[i].Start();
+    }
+
+    ezThreadUtils::Sleep(ezTime::Milliseconds(5));
+
+    // messages that are logged while disabling must neither get lost nor be passed on twice
+    ezGlobalLog::DisableAsyncLogging();
+
+    ezUInt32 uiNumLogged = 0;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      thread[i].m_bStop = true;
+      thread[i].Join();
+      uiNumLogged += thread[i].m_uiNumMessages;
+    }
+
+    const ezUInt32 uiDropped = ezGlobalLog::GetDroppedAsyncMessageCount() - uiDroppedBefore;
+    EZ_TEST_INT(writer.m_Messages.GetCount() + uiDropped, uiNumLogged);
+  }
+
+  ezGlobalLog::RemoveLogWriter(ezMakeDelegate(&AsyncLogTestWriter::LogMessageHandler, &writer));
+}
@@ -1,8 +1,12 @@
 #include <FoundationTestPCH.h>
 
+#include <Foundation/Math/Random.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Time/Stopwatch.h>
 
 struct EZ_ALIGN(NonAlignedVector, EZ_ALIGNMENT_MINIMUM)
 {
@@ -75,6 +79,104 @@ void TestAlignmentHelper(size_t uiExpectedAlignment)
   EZ_TEST_BOOL(stats.m_uiNumAllocations - stats.m_uiNumDeallocations == 0);
 }
 
+template <ezUInt32 TrackingFlags>
+ezTime MeasureAllocations(const char* szName)
+{
+  ezAllocator<ezMemoryPolicies::ezHeapAllocation, TrackingFlags> allocator(szName);
+
+  void* allocations[256];
+  ezStopwatch sw;
+
+  for (ezUInt32 uiRound = 0; uiRound < 200; ++uiRound)
+  {
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(allocations); ++i)
+    {
+      allocations[i] = allocator.Allocate(16 + (i % 32) * 8, 8);
+    }
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(allocations); ++i)
+    {
+      allocator.Deallocate(allocations[i]);
+    }
+  }
+
+  return sw.GetRunningTotal();
+}
+
+// keeps a window of live allocations with random sizes, like temporary strings, delegates and small arrays do
+ezTime MeasureSmallAllocationChurn(ezAllocatorBase* pAllocator, ezUInt32 uiNumAllocations, ezUInt32 uiSeed)
+{
+  ezRandom rng;
+  rng.Initialize(uiSeed);
+
+  void* allocations[1024] = {};
+
+  // generate the sequence up front, so that only the allocator is measured
+  ezDynamicArray<ezUInt32> sequence;
+  sequence.SetCountUninitialized(uiNumAllocations);
+  for (ezUInt32& uiValue : sequence)
+  {
+    uiValue = (rng.UIntInRange(EZ_ARRAY_SIZE(allocations)) << 16) | (8 + rng.UIntInRange(248));
+  }
+
+  ezStopwatch sw;
+
+  for (ezUInt32 uiValue : sequence)
+  {
+    void*& ptr = allocations[uiValue >> 16];
+    pAllocator->Deallocate(ptr);
+    ptr = pAllocator->Allocate(uiValue & 0xFFFF, 8);
+  }
+
+  for (void* ptr : allocations)
+  {
+    pAllocator->Deallocate(ptr);
+  }
+
+  return sw.GetRunningTotal();
+}
+
+ezTime MeasureArrayGrowth(ezAllocatorBase* pAllocator)
+{
+  ezStopwatch sw;
+
+  for (ezUInt32 uiArray = 0; uiArray < 2000; ++uiArray)
+  {
+    ezDynamicArray<ezUInt32> a(pAllocator);
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      a.PushBack(i);
+    }
+  }
+
+  return sw.GetRunningTotal();
+}
+
+class SizeClassDeallocationThread : public ezThread
+{
+public:
+  SizeClassDeallocationThread(ezMemoryPolicies::ezSizeClassAllocation& policy, ezArrayPtr<void*> allocations)
+    : ezThread("SizeClass Deallocation")
+    , m_Policy(policy)
+    , m_Allocations(allocations)
+  {
+  }
+
+  virtual ezUInt32 Run() override
+  {
+    for (void* ptr : m_Allocations)
+    {
+      m_Policy.Deallocate(ptr);
+    }
+
+    // the blocks that are still in the cache of this thread are returned when the thread exits
+    return 0;
+  }
+
+  ezMemoryPolicies::ezSizeClassAllocation& m_Policy;
+  ezArrayPtr<void*> m_Allocations;
+};
+
 EZ_CREATE_SIMPLE_TEST_GROUP(Memory);
 
 EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
@@ -235,4 +337,323 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sampled allocation tracking")
+  {
+    typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation,
+      ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking | ezMemoryTrackingFlags::EnableSampling>
+      SampledAllocator;
+
+    SampledAllocator allocator("SampledTest");
+
+    // every allocation is recorded
+    ezMemoryTracker::SetSamplingInterval(1);
+    {
+      void* ptr = allocator.Allocate(100, 8);
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(ptr, 8));
+      EZ_TEST_INT(allocator.AllocatedSize(ptr), 100);
+      EZ_TEST_INT(ezMemoryTracker::GetAllocationInfo(allocator.GetId(), ptr).m_uiSize, 100);
+
+      ptr = allocator.Reallocate(ptr, 100, 200, 8);
+      EZ_TEST_INT(allocator.AllocatedSize(ptr), 200);
+      EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, 200);
+
+      allocator.Deallocate(ptr);
+      EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, 0);
+    }
+
+    // the stats are exact, even though only some allocations are recorded, also when allocating on multiple threads
+    ezMemoryTracker::SetSamplingInterval(16);
+    {
+      const ezAllocatorBase::Stats statsBefore = allocator.GetStats();
+      void* keptAllocations[64];
+
+      ezTaskSystem::ParallelForIndexed(0, 64, [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          void* allocations[100];
+          for (ezUInt32 j = 0; j < EZ_ARRAY_SIZE(allocations); ++j)
+          {
+            allocations[j] = allocator.Allocate(j + 1, 8);
+          }
+
+          // keep the first allocation of every iteration
+          keptAllocations[i] = allocations[0];
+          for (ezUInt32 j = 1; j < EZ_ARRAY_SIZE(allocations); ++j)
+          {
+            allocator.Deallocate(allocations[j]);
+          }
+        }
+      });
+
+      ezAllocatorBase::Stats stats = allocator.GetStats();
+      EZ_TEST_INT(stats.m_uiNumAllocations - statsBefore.m_uiNumAllocations, 64 * 100);
+      EZ_TEST_INT(stats.m_uiNumDeallocations - statsBefore.m_uiNumDeallocations, 64 * 99);
+      EZ_TEST_INT(stats.m_uiAllocationSize, 64);
+
+      for (void* ptr : keptAllocations)
+      {
+        allocator.Deallocate(ptr);
+      }
+      EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, 0);
+    }
+
+    // one allocation per 4KB is recorded, large allocations are always recorded
+    ezMemoryTracker::SetSamplingInterval(1, 4096);
+    {
+      void* ptr = allocator.Allocate(8192, 8);
+      EZ_TEST_INT(ezMemoryTracker::GetAllocationInfo(allocator.GetId(), ptr).m_uiSize, 8192);
+      allocator.Deallocate(ptr);
+    }
+
+    ezMemoryTracker::SetSamplingInterval(64);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Allocation tracking performance")
+  {
+    const ezTime tUntracked = MeasureAllocations<ezMemoryTrackingFlags::None>("Untracked");
+    const ezTime tTracked = MeasureAllocations<ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking>("Tracked");
+    const ezTime tSampled = MeasureAllocations<ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking |
+                                               ezMemoryTrackingFlags::EnableSampling>("Sampled");
+
+    ezTestFramework::Output(ezTestOutput::Duration, "51200 allocations: untracked %.2fms, tracked %.2fms, sampled %.2fms",
+      tUntracked.GetMilliseconds(), tTracked.GetMilliseconds(), tSampled.GetMilliseconds());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SizeClassAllocator")
+  {
+    ezSizeClassAllocator allocator("SizeClassTest");
+
+    // every size class and a few large allocations
+    ezDynamicArray<ezUInt8*> allocations;
+    for (ezUInt32 uiSize = 1; uiSize <= 3000; uiSize += 7)
+    {
+      ezUInt8* ptr = static_cast<ezUInt8*>(allocator.Allocate(uiSize, uiSize >= 16 ? 16 : 8));
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(ptr, uiSize >= 16 ? 16 : 8));
+      EZ_TEST_INT(allocator.AllocatedSize(ptr), uiSize);
+
+      ezMemoryUtils::PatternFill(ptr, static_cast<ezUInt8>(uiSize), uiSize);
+      allocations.PushBack(ptr);
+    }
+
+    // blocks of the same size class must not overlap
+    for (ezUInt32 i = 0; i < allocations.GetCount(); ++i)
+    {
+      const ezUInt32 uiSize = 1 + i * 7;
+      for (ezUInt32 j = 0; j < uiSize; ++j)
+      {
+        if (allocations[i][j] != static_cast<ezUInt8>(uiSize))
+        {
+          EZ_TEST_FAILURE("Allocation was overwritten", "Size: %u", uiSize);
+          break;
+        }
+      }
+    }
+
+    for (ezUInt8* ptr : allocations)
+    {
+      allocator.Deallocate(ptr);
+    }
+
+    EZ_TEST_INT(ezMemoryPolicies::ezSizeClassAllocation::GetSizeClass(16), 0);
+    EZ_TEST_INT(ezMemoryPolicies::ezSizeClassAllocation::GetSizeClass(17), 1);
+    EZ_TEST_INT(ezMemoryPolicies::ezSizeClassAllocation::GetSizeClass(ezMemoryPolicies::ezSizeClassAllocation::MaxSmallAllocationSize),
+      ezMemoryPolicies::ezSizeClassAllocation::NumSizeClasses - 1);
+    for (ezUInt32 uiSize = 1; uiSize <= ezMemoryPolicies::ezSizeClassAllocation::MaxSmallAllocationSize; ++uiSize)
+    {
+      const ezUInt32 uiSizeClass = ezMemoryPolicies::ezSizeClassAllocation::GetSizeClass(uiSize);
+      EZ_TEST_BOOL(ezMemoryPolicies::ezSizeClassAllocation::GetSizeClassSize(uiSizeClass) >= uiSize);
+      EZ_TEST_BOOL(uiSizeClass == 0 || ezMemoryPolicies::ezSizeClassAllocation::GetSizeClassSize(uiSizeClass - 1) < uiSize);
+    }
+
+    // growing within the same size class keeps the pointer
+    {
+      ezDynamicArray<ezUInt32> a(&allocator);
+      a.Reserve(5);
+      const ezUInt32* pData = a.GetData();
+      a.Reserve(8);
+      EZ_TEST_BOOL(a.GetData() == pData);
+
+      for (ezUInt32 i = 0; i < 1000; ++i)
+      {
+        a.PushBack(i);
+      }
+
+      for (ezUInt32 i = 0; i < 1000; ++i)
+      {
+        EZ_TEST_INT(a[i], i);
+      }
+    }
+
+    // blocks that are allocated on one thread and freed on another end up in the cache of the freeing thread
+    {
+      ezDynamicArray<void*> crossThreadAllocations;
+      crossThreadAllocations.SetCount(64 * 64);
+
+      ezTaskSystem::ParallelForIndexed(0, 64, [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          for (ezUInt32 j = 0; j < 64; ++j)
+          {
+            crossThreadAllocations[i * 64 + j] = allocator.Allocate(16 + j * 4, 8);
+          }
+        }
+      });
+
+      ezTaskSystem::ParallelForIndexed(0, 64, [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          // free the blocks of another task
+          const ezUInt32 uiOther = 63 - i;
+          for (ezUInt32 j = 0; j < 64; ++j)
+          {
+            allocator.Deallocate(crossThreadAllocations[uiOther * 64 + j]);
+          }
+        }
+      });
+    }
+
+    EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SizeClassAllocator releases memory")
+  {
+    ezMemoryPolicies::ezSizeClassAllocation policy(ezFoundation::GetDefaultAllocator());
+    const ezUInt32 uiNumAllocations = 20000;
+    ezDynamicArray<void*> allocations;
+
+    // freeing far more blocks than a thread cache holds returns the spans and the chunks to the heap
+    for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+    {
+      allocations.PushBack(policy.Allocate(64, 8));
+      ezMemoryUtils::PatternFill(static_cast<ezUInt8*>(allocations.PeekBack()), static_cast<ezUInt8>(i), 64);
+    }
+
+    const size_t uiReserved = policy.GetReservedSmallAllocationSize();
+    EZ_TEST_BOOL(uiReserved >= uiNumAllocations * 64);
+
+    for (void* ptr : allocations)
+    {
+      policy.Deallocate(ptr);
+    }
+
+    // the blocks that stay in the cache of this thread come from the first and the last span, which keep at most two chunks alive
+    const size_t uiChunkSize = 256 * 1024;
+    EZ_TEST_BOOL(policy.GetReservedSmallAllocationSize() < uiReserved);
+    EZ_TEST_BOOL(policy.GetReservedSmallAllocationSize() <= 2 * uiChunkSize);
+
+    // blocks that are freed on a thread that exits afterwards go back to the spans they came from
+    allocations.Clear();
+    for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+    {
+      allocations.PushBack(policy.Allocate(128, 8));
+      ezMemoryUtils::PatternFill(static_cast<ezUInt8*>(allocations.PeekBack()), static_cast<ezUInt8>(i), 128);
+    }
+
+    ezUInt32 uiNumOverwritten = 0;
+    for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+    {
+      const ezUInt8* ptr = static_cast<const ezUInt8*>(allocations[i]);
+      if (ptr[0] != static_cast<ezUInt8>(i) || ptr[127] != static_cast<ezUInt8>(i))
+        ++uiNumOverwritten;
+    }
+    EZ_TEST_INT(uiNumOverwritten, 0);
+
+    const size_t uiReservedBeforeThread = policy.GetReservedSmallAllocationSize();
+
+    {
+      SizeClassDeallocationThread thread(policy, allocations);
+      thread.Start();
+      thread.Join();
+    }
+
+    // the cache of this thread still holds the blocks from above and the rest of the last batch of the larger size class
+    EZ_TEST_BOOL(policy.GetReservedSmallAllocationSize() < uiReservedBeforeThread);
+    EZ_TEST_BOOL(policy.GetReservedSmallAllocationSize() <= 3 * uiChunkSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SizeClassAllocator with many allocators")
+  {
+    // more allocators than slots in the thread cache table, so they have to share slots
+    const ezUInt32 uiNumAllocators = 40;
+
+    ezDynamicArray<ezUniquePtr<ezSizeClassAllocator>> allocators;
+    for (ezUInt32 i = 0; i < uiNumAllocators; ++i)
+    {
+      ezStringBuilder sName;
+      sName.Format("SizeClassTest{}", i);
+      allocators.PushBack(EZ_DEFAULT_NEW(ezSizeClassAllocator, sName));
+    }
+
+    ezDynamicArray<ezUInt8*> allocations;
+    for (ezUInt32 uiRound = 0; uiRound < 50; ++uiRound)
+    {
+      for (ezUInt32 i = 0; i < uiNumAllocators; ++i)
+      {
+        ezUInt8* ptr = static_cast<ezUInt8*>(allocators[i]->Allocate(32, 8));
+        ezMemoryUtils::PatternFill(ptr, static_cast<ezUInt8>(i), 32);
+        allocations.PushBack(ptr);
+      }
+    }
+
+    ezUInt32 uiNumOverwritten = 0;
+    for (ezUInt32 i = 0; i < allocations.GetCount(); ++i)
+    {
+      const ezUInt32 uiAllocator = i % uiNumAllocators;
+      if (allocations[i][0] != static_cast<ezUInt8>(uiAllocator) || allocations[i][31] != static_cast<ezUInt8>(uiAllocator))
+        ++uiNumOverwritten;
+
+      allocators[uiAllocator]->Deallocate(allocations[i]);
+    }
+    EZ_TEST_INT(uiNumOverwritten, 0);
+
+    for (ezUInt32 i = 0; i < uiNumAllocators; ++i)
+    {
+      EZ_TEST_INT(allocators[i]->GetStats().m_uiAllocationSize, 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SizeClassAllocator performance")
+  {
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::None> heapAllocator("HeapBenchmark");
+    ezAllocator<ezMemoryPolicies::ezSizeClassAllocation, ezMemoryTrackingFlags::None> sizeClassAllocator("SizeClassBenchmark");
+
+    const ezUInt32 uiNumAllocations = 500000;
+
+    // warm up the caches
+    MeasureSmallAllocationChurn(&heapAllocator, uiNumAllocations, 1);
+    MeasureSmallAllocationChurn(&sizeClassAllocator, uiNumAllocations, 1);
+
+    const ezTime tHeapChurn = MeasureSmallAllocationChurn(&heapAllocator, uiNumAllocations, 2);
+    const ezTime tSizeClassChurn = MeasureSmallAllocationChurn(&sizeClassAllocator, uiNumAllocations, 2);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u small allocations: heap %.2fms, size classes %.2fms", uiNumAllocations,
+      tHeapChurn.GetMilliseconds(), tSizeClassChurn.GetMilliseconds());
+
+    const ezTime tHeapArrays = MeasureArrayGrowth(&heapAllocator);
+    const ezTime tSizeClassArrays = MeasureArrayGrowth(&sizeClassAllocator);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "2000 growing arrays: heap %.2fms, size classes %.2fms", tHeapArrays.GetMilliseconds(),
+      tSizeClassArrays.GetMilliseconds());
+
+    ezAllocatorBase* allocators[] = {&heapAllocator, &sizeClassAllocator};
+    ezTime tParallel[2];
+
+    for (ezUInt32 uiAllocator = 0; uiAllocator < 2; ++uiAllocator)
+    {
+      ezStopwatch sw;
+
+      ezTaskSystem::ParallelForIndexed(0, 16, [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          MeasureSmallAllocationChurn(allocators[uiAllocator], uiNumAllocations / 16, i);
+        }
+      });
+
+      tParallel[uiAllocator] = sw.GetRunningTotal();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u small allocations on multiple threads: heap %.2fms, size classes %.2fms", uiNumAllocations,
+      tParallel[0].GetMilliseconds(), tParallel[1].GetMilliseconds());
+  }
 }
@@ -0,0 +1,123 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace HashedStringPerformance
+{
+  enum Constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_STRINGS = 1024 * 4,
+    NUM_ROUNDS = 2,
+#else
+    NUM_STRINGS = 1024 * 16,
+    NUM_ROUNDS = 4,
+#endif
+    NUM_TASKS = 16
+  };
+
+  /// \brief Assigns all strings to ezHashedString objects from many tasks at the same time.
+  ///
+  /// Every task starts at a different offset into the array, so the tasks do not all fight for the very same string at the same time.
+  ezTime InternConcurrently(const ezDynamicArray<ezString>& strings, ezUInt32 uiNumRounds, ezAtomicInteger32& out_iNumMismatches)
+  {
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.uiMaxTasksPerThread = NUM_TASKS;
+
+    const ezTime t0 = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(0, NUM_TASKS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      const ezUInt32 uiNumStrings = strings.GetCount();
+
+      for (ezUInt32 uiTask = uiStartIndex; uiTask < uiEndIndex; ++uiTask)
+      {
+        const ezUInt32 uiOffset = (uiNumStrings / NUM_TASKS) * uiTask;
+
+        for (ezUInt32 uiRound = 0; uiRound < uiNumRounds; ++uiRound)
+        {
+          for (ezUInt32 i = 0; i < uiNumStrings; ++i)
+          {
+            const ezString& sString = strings[(i + uiOffset) % uiNumStrings];
+
+            ezHashedString hs;
+            hs.Assign(sString.GetData());
+
+            if (hs.GetString() != sString)
+            {
+              out_iNumMismatches.Increment();
+            }
+          }
+        }
+      }
+    },
+      "InternStrings", params);
+
+    return ezTime::Now() - t0;
+  }
+} // namespace HashedStringPerformance
+
+EZ_CREATE_SIMPLE_TEST(Performance, HashedString)
+{
+  ezTaskSystem::SetWorkerThreadCount(-1, -1);
+
+  ezDynamicArray<ezString> strings;
+  strings.Reserve(HashedStringPerformance::NUM_STRINGS);
+
+  {
+    // make sure the strings have never been interned before, even when the test is run multiple times
+    const ezUInt64 uiRun = static_cast<ezUInt64>(ezTime::Now().GetNanoseconds());
+
+    ezStringBuilder sb;
+    for (ezUInt32 i = 0; i < HashedStringPerformance::NUM_STRINGS; ++i)
+    {
+      sb.Format("Performance/HashedString/{0}/Entity{1}/Component", uiRun, i);
+      strings.PushBack(sb);
+    }
+  }
+
+  const double fNumAssignments = static_cast<double>(HashedStringPerformance::NUM_TASKS) * HashedStringPerformance::NUM_STRINGS;
+  const ezUInt32 uiNumWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Intern New Strings")
+  {
+    ezAtomicInteger32 iNumMismatches;
+    const ezTime t = HashedStringPerformance::InternConcurrently(strings, 1, iNumMismatches);
+
+    EZ_TEST_INT((ezInt32)iNumMismatches, 0);
+
+    ezLog::Info("[test]Intern New Strings ({0} tasks, {1} workers): {2}ms, {3}ns per assignment", HashedStringPerformance::NUM_TASKS, uiNumWorkers,
+      ezArgF(t.GetMilliseconds(), 2), ezArgF(t.GetNanoseconds() / fNumAssignments, 2));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Intern Existing Strings")
+  {
+    ezAtomicInteger32 iNumMismatches;
+    const ezTime t = HashedStringPerformance::InternConcurrently(strings, HashedStringPerformance::NUM_ROUNDS, iNumMismatches);
+
+    EZ_TEST_INT((ezInt32)iNumMismatches, 0);
+
+    ezLog::Info("[test]Intern Existing Strings ({0} tasks, {1} workers): {2}ms, {3}ns per assignment", HashedStringPerformance::NUM_TASKS, uiNumWorkers,
+      ezArgF(t.GetMilliseconds(), 2), ezArgF(t.GetNanoseconds() / (fNumAssignments * HashedStringPerformance::NUM_ROUNDS), 2));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Identity")
+  {
+    // strings that were added concurrently must still be unique
+    for (ezUInt32 i = 0; i < strings.GetCount(); i += 97)
+    {
+      const ezStringBuilder sCopy = strings[i];
+
+      ezHashedString hs1, hs2;
+      hs1.Assign(strings[i].GetData());
+      hs2.Assign(sCopy.GetData());
+
+      EZ_TEST_BOOL(hs1 == hs2);
+      EZ_TEST_BOOL(hs1.GetData() == hs2.GetData());
+    }
+  }
+}
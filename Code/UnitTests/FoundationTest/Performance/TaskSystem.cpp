@@ -0,0 +1,125 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace TaskSystemPerformance
+{
+  enum Constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_BURSTS = 200,
+    NUM_NESTED_TASKS = 8,
+    NUM_NESTED_BURSTS = 20,
+#else
+    NUM_BURSTS = 2000,
+    NUM_NESTED_TASKS = 16,
+    NUM_NESTED_BURSTS = 100,
+#endif
+    NUM_ITEMS = 1024
+  };
+
+  /// \brief Starts many small ParallelFor() calls in a row, thus all workers constantly compete for the few tiny tasks.
+  ezUInt64 RunParallelForBursts(ezUInt32 uiNumBursts)
+  {
+    ezAtomicInteger64 iSum;
+
+    ezParallelForParams params;
+    params.uiBinSize = 16;
+    params.uiMaxTasksPerThread = 4;
+
+    for (ezUInt32 burst = 0; burst < uiNumBursts; ++burst)
+    {
+      ezTaskSystem::ParallelForIndexed(0, NUM_ITEMS, [&iSum](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        ezInt64 iLocalSum = 0;
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          iLocalSum += i;
+        }
+        iSum.Add(iLocalSum);
+      },
+        "Burst", params);
+    }
+
+    return static_cast<ezUInt64>((ezInt64)iSum);
+  }
+
+  class ezNestedBurstTask final : public ezTask
+  {
+  public:
+    ezNestedBurstTask() { ConfigureTask("NestedBurst", ezTaskNesting::Maybe); }
+
+    ezUInt64 m_uiResult = 0;
+
+  private:
+    virtual void Execute() override { m_uiResult = RunParallelForBursts(NUM_NESTED_BURSTS); }
+  };
+
+  /// \brief Runs the bursts from the main thread and from within several tasks at the same time.
+  ezTime MeasureContention(ezUInt64& out_uiSum)
+  {
+    out_uiSum = 0;
+
+    const ezTime t0 = ezTime::Now();
+
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+    ezSharedPtr<ezNestedBurstTask> tasks[NUM_NESTED_TASKS];
+    for (ezUInt32 i = 0; i < NUM_NESTED_TASKS; ++i)
+    {
+      tasks[i] = EZ_DEFAULT_NEW(ezNestedBurstTask);
+      ezTaskSystem::AddTaskToGroup(group, tasks[i]);
+    }
+
+    ezTaskSystem::StartTaskGroup(group);
+
+    out_uiSum += RunParallelForBursts(NUM_BURSTS);
+
+    ezTaskSystem::WaitForGroup(group);
+
+    for (ezUInt32 i = 0; i < NUM_NESTED_TASKS; ++i)
+    {
+      out_uiSum += tasks[i]->m_uiResult;
+    }
+
+    return ezTime::Now() - t0;
+  }
+} // namespace TaskSystemPerformance
+
+EZ_CREATE_SIMPLE_TEST(Performance, TaskSystem)
+{
+  const ezUInt64 uiExpectedSumPerBurst = (static_cast<ezUInt64>(TaskSystemPerformance::NUM_ITEMS) * (TaskSystemPerformance::NUM_ITEMS - 1)) / 2;
+  const ezUInt64 uiExpectedSum = uiExpectedSumPerBurst * (TaskSystemPerformance::NUM_BURSTS + TaskSystemPerformance::NUM_NESTED_TASKS * TaskSystemPerformance::NUM_NESTED_BURSTS);
+
+  ezTaskSystem::SetWorkerThreadCount(-1, -1);
+
+  // warm up, allocates the worker threads
+  TaskSystemPerformance::RunParallelForBursts(10);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ParallelFor Contention (Shared Task Lists)")
+  {
+    ezTaskSystem::SetUseLocalTaskQueues(false);
+
+    ezUInt64 uiSum = 0;
+    const ezTime t = TaskSystemPerformance::MeasureContention(uiSum);
+
+    EZ_TEST_BOOL(uiSum == uiExpectedSum);
+
+    ezLog::Info("[test]ParallelFor Contention (Shared Task Lists, {0} workers): {1}ms", ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), ezArgF(t.GetMilliseconds(), 2));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ParallelFor Contention (Local Task Queues)")
+  {
+    ezTaskSystem::SetUseLocalTaskQueues(true);
+
+    ezUInt64 uiSum = 0;
+    const ezTime t = TaskSystemPerformance::MeasureContention(uiSum);
+
+    EZ_TEST_BOOL(uiSum == uiExpectedSum);
+
+    ezLog::Info("[test]ParallelFor Contention (Local Task Queues, {0} workers): {1}ms", ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), ezArgF(t.GetMilliseconds(), 2));
+  }
+
+  ezTaskSystem::SetUseLocalTaskQueues(true);
+}
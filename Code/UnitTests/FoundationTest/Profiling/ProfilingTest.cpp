@@ -2,8 +2,10 @@
 
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/ThreadUtils.h>
+#include <Foundation/Time/Stopwatch.h>
 
 namespace
 {
@@ -21,7 +23,24 @@ namespace
       ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
     }
   }
-}
+
+  ezUInt32 CountScopes(const ezProfilingSystem::ProfilingData& profilingData, const char* szName)
+  {
+    ezUInt32 uiCount = 0;
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        if (profilingData.m_ScopeNames[scope.m_uiNameId] == szName)
+        {
+          ++uiCount;
+        }
+      }
+    }
+
+    return uiCount;
+  }
+} // namespace
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Profiling);
 
@@ -52,4 +71,109 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Interned names")
+  {
+    ezProfilingSystem::Clear();
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Zero());
+
+    // the same temporary buffer is used for different names
+    ezStringBuilder sName;
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      sName.Format("Dynamic scope {}", i);
+      EZ_PROFILE_SCOPE(sName.GetData());
+    }
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezProfilingSystem::Capture(profilingData);
+
+    EZ_TEST_INT(CountScopes(profilingData, "Dynamic scope 0"), 1);
+    EZ_TEST_INT(CountScopes(profilingData, "Dynamic scope 1"), 1);
+    EZ_TEST_INT(CountScopes(profilingData, "Dynamic scope 2"), 1);
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Milliseconds(0.1));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Binary streaming")
+  {
+    ezProfilingSystem::Clear();
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Zero());
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezProfilingSystem::StartStreaming(writer);
+
+    const ezUInt32 uiNumFrames = 4;
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      EZ_PROFILE_SCOPE("Streamed frame");
+
+      for (ezUInt32 i = 0; i < 100; ++i)
+      {
+        EZ_PROFILE_SCOPE("Streamed scope");
+      }
+
+      ezProfilingSystem::StartNewFrame();
+    }
+
+    ezProfilingSystem::StopStreaming();
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezMemoryStreamReader reader(&storage);
+    EZ_TEST_BOOL(profilingData.Read(reader).Succeeded());
+
+    // the last frame scope ends after the last StartNewFrame() call and is written by StopStreaming()
+    EZ_TEST_INT(CountScopes(profilingData, "Streamed frame"), uiNumFrames);
+    EZ_TEST_INT(CountScopes(profilingData, "Streamed scope"), uiNumFrames * 100);
+    EZ_TEST_INT(profilingData.m_FrameStartTimes.GetCount(), uiNumFrames);
+    EZ_TEST_BOOL(!profilingData.m_ThreadInfos.IsEmpty());
+
+    ezProfilingSystem::ProfilingData capturedData;
+    ezProfilingSystem::Capture(capturedData);
+    EZ_TEST_INT(CountScopes(capturedData, "Streamed scope"), uiNumFrames * 100);
+
+    // converting the stream to JSON gives the same result as a capture
+    ezMemoryStreamStorage jsonStorage;
+    ezMemoryStreamWriter jsonWriter(&jsonStorage);
+    EZ_TEST_BOOL(profilingData.Write(jsonWriter).Succeeded());
+    EZ_TEST_BOOL(jsonStorage.GetStorageSize() > 0);
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Milliseconds(0.1));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scope overhead")
+  {
+    ezProfilingSystem::Clear();
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Zero());
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezProfilingSystem::StartStreaming(writer);
+
+    const ezUInt32 uiNumScopes = 10000;
+    ezTime tScopes;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 10; ++uiFrame)
+    {
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+      {
+        EZ_PROFILE_SCOPE("Overhead scope");
+      }
+
+      tScopes += sw.GetRunningTotal();
+
+      ezProfilingSystem::StartNewFrame();
+    }
+
+    ezProfilingSystem::StopStreaming();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Profiling scope overhead: %.1fns, %u bytes streamed per scope",
+      tScopes.GetNanoseconds() / (uiNumScopes * 10), storage.GetStorageSize() / (uiNumScopes * 10));
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Milliseconds(0.1));
+    ezProfilingSystem::Clear();
+  }
 }
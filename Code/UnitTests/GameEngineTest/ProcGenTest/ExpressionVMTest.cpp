@@ -0,0 +1,177 @@
+#include <GameEngineTestPCH.h>
+
+#include <ProcGenPlugin/VM/ExpressionAST.h>
+#include <ProcGenPlugin/VM/ExpressionByteCode.h>
+#include <ProcGenPlugin/VM/ExpressionCompiler.h>
+#include <ProcGenPlugin/VM/ExpressionVM.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ProcGen);
+
+namespace ExpressionVMTestDetail
+{
+  static ezHashedString s_sPosition = ezMakeHashedString("Position");
+  static ezHashedString s_sPositionX = ezMakeHashedString("PositionX");
+  static ezHashedString s_sPositionY = ezMakeHashedString("PositionY");
+  static ezHashedString s_sPositionZ = ezMakeHashedString("PositionZ");
+  static ezHashedString s_sCount = ezMakeHashedString("Count");
+
+  static ezHashedString s_sResult = ezMakeHashedString("Result");
+  static ezHashedString s_sResultX = ezMakeHashedString("ResultX");
+  static ezHashedString s_sResultY = ezMakeHashedString("ResultY");
+  static ezHashedString s_sHalfCount = ezMakeHashedString("HalfCount");
+  static ezHashedString s_sNoise = ezMakeHashedString("Noise");
+
+  static ezHashedString s_sPerlinNoise = ezMakeHashedString("PerlinNoise");
+
+  struct InputData
+  {
+    ezVec3 m_vPosition;
+    ezInt32 m_iCount;
+  };
+
+  struct OutputData
+  {
+    ezVec2 m_vResult;
+    ezInt32 m_iHalfCount;
+    float m_fNoise;
+  };
+
+  // ResultX = PositionX + PositionY * 2 + PositionZ * 3
+  // ResultY = -Count
+  // HalfCount = Count * 0.5
+  // Noise = PerlinNoise(PositionX, PositionY, PositionZ, 2)
+  static void CompileTestExpression(ezExpressionByteCode& out_ByteCode)
+  {
+    ezExpressionAST ast;
+
+    auto pPositionX = ast.CreateInput(s_sPositionX);
+    auto pPositionY = ast.CreateInput(s_sPositionY);
+    auto pPositionZ = ast.CreateInput(s_sPositionZ);
+    auto pCount = ast.CreateInput(s_sCount);
+
+    auto pSum = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pPositionY, ast.CreateConstant(2.0f));
+    pSum = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, pPositionX, pSum);
+    pSum = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, pSum,
+      ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pPositionZ, ast.CreateConstant(3.0f)));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sResultX, pSum));
+
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sResultY, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pCount, ast.CreateConstant(-1.0f))));
+
+    auto pHalfCount = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pCount, ast.CreateConstant(0.5f));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sHalfCount, pHalfCount));
+
+    auto pNoise = ast.CreateFunctionCall(s_sPerlinNoise);
+    pNoise->m_Arguments.PushBack(pPositionX);
+    pNoise->m_Arguments.PushBack(pPositionY);
+    pNoise->m_Arguments.PushBack(pPositionZ);
+    pNoise->m_Arguments.PushBack(ast.CreateConstant(2.0f));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sNoise, pNoise));
+
+    ezExpressionCompiler compiler;
+    EZ_TEST_BOOL(compiler.Compile(ast, out_ByteCode).Succeeded());
+  }
+
+  static void Execute(ezExpressionVM& vm, const ezExpressionByteCode& byteCode, ezArrayPtr<InputData> inputData, ezArrayPtr<OutputData> outputData)
+  {
+    ezHybridArray<ezExpression::Stream, 4> inputs;
+    inputs.PushBack(ezExpression::MakeStream(inputData, offsetof(InputData, m_vPosition), s_sPosition, ezExpression::Stream::Type::Float3));
+    inputs.PushBack(ezExpression::MakeStream(inputData, offsetof(InputData, m_iCount), s_sCount, ezExpression::Stream::Type::Int));
+
+    ezHybridArray<ezExpression::Stream, 4> outputs;
+    outputs.PushBack(ezExpression::MakeStream(outputData, offsetof(OutputData, m_vResult), s_sResult, ezExpression::Stream::Type::Float2));
+    outputs.PushBack(ezExpression::MakeStream(outputData, offsetof(OutputData, m_iHalfCount), s_sHalfCount, ezExpression::Stream::Type::Int));
+    outputs.PushBack(ezExpression::MakeStream(outputData, offsetof(OutputData, m_fNoise), s_sNoise));
+
+    EZ_TEST_BOOL(vm.Execute(byteCode, inputs, outputs, inputData.GetCount()).Succeeded());
+  }
+
+  static void FillInputData(ezArrayPtr<InputData> inputData)
+  {
+    for (ezUInt32 i = 0; i < inputData.GetCount(); ++i)
+    {
+      inputData[i].m_vPosition.Set(i * 0.25f, i * -0.5f, (i % 100) * 0.125f);
+      inputData[i].m_iCount = i * 3 + 1;
+    }
+  }
+} // namespace ExpressionVMTestDetail
+
+EZ_CREATE_SIMPLE_TEST(ProcGen, ExpressionVM)
+{
+  using namespace ExpressionVMTestDetail;
+
+  ezExpressionByteCode byteCode;
+  CompileTestExpression(byteCode);
+
+  ezExpressionVM vm;
+  vm.RegisterDefaultFunctions();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Vector and Int Streams")
+  {
+    // not a multiple of 4, so the last register is only partially stored
+    const ezUInt32 uiNumInstances = 7;
+
+    ezDynamicArray<InputData> inputData;
+    inputData.SetCount(uiNumInstances);
+    FillInputData(inputData);
+
+    // the additional element must not be touched
+    ezDynamicArray<OutputData> outputData;
+    outputData.SetCount(uiNumInstances + 1);
+    outputData.PeekBack().m_vResult.Set(42.0f);
+    outputData.PeekBack().m_iHalfCount = 42;
+    outputData.PeekBack().m_fNoise = 42.0f;
+
+    Execute(vm, byteCode, inputData, outputData.GetArrayPtr().GetSubArray(0, uiNumInstances));
+
+    for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+    {
+      const ezVec3 vPos = inputData[i].m_vPosition;
+
+      EZ_TEST_FLOAT(outputData[i].m_vResult.x, vPos.x + vPos.y * 2.0f + vPos.z * 3.0f, 0.0001f);
+      EZ_TEST_FLOAT(outputData[i].m_vResult.y, -static_cast<float>(inputData[i].m_iCount), 0.0f);
+      EZ_TEST_INT(outputData[i].m_iHalfCount, inputData[i].m_iCount / 2);
+      EZ_TEST_BOOL(outputData[i].m_fNoise >= 0.0f && outputData[i].m_fNoise <= 1.0f);
+    }
+
+    EZ_TEST_VEC2(outputData.PeekBack().m_vResult, ezVec2(42.0f), 0.0f);
+    EZ_TEST_INT(outputData.PeekBack().m_iHalfCount, 42);
+    EZ_TEST_FLOAT(outputData.PeekBack().m_fNoise, 42.0f, 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Chunked Execution")
+  {
+    // several chunks that are executed in parallel plus a partial one
+    const ezUInt32 uiNumInstances = 3 * 4096 + 5;
+    const ezUInt32 uiBatchSize = 1000;
+
+    ezDynamicArray<InputData> inputData;
+    inputData.SetCount(uiNumInstances);
+    FillInputData(inputData);
+
+    ezDynamicArray<OutputData> outputData;
+    outputData.SetCount(uiNumInstances);
+    Execute(vm, byteCode, inputData, outputData);
+
+    // batches below the chunk size are executed serially and have to give the same results
+    ezDynamicArray<OutputData> expectedData;
+    expectedData.SetCount(uiNumInstances);
+    for (ezUInt32 uiFirst = 0; uiFirst < uiNumInstances; uiFirst += uiBatchSize)
+    {
+      const ezUInt32 uiCount = ezMath::Min(uiBatchSize, uiNumInstances - uiFirst);
+      Execute(vm, byteCode, inputData.GetArrayPtr().GetSubArray(uiFirst, uiCount), expectedData.GetArrayPtr().GetSubArray(uiFirst, uiCount));
+    }
+
+    ezUInt32 uiNumMismatches = 0;
+    for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+    {
+      const OutputData& o = outputData[i];
+      const OutputData& e = expectedData[i];
+
+      if (o.m_vResult != e.m_vResult || o.m_iHalfCount != e.m_iHalfCount || o.m_fNoise != e.m_fNoise)
+        ++uiNumMismatches;
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+    EZ_TEST_INT(outputData.PeekBack().m_iHalfCount, inputData.PeekBack().m_iCount / 2);
+  }
+}
@@ -0,0 +1,136 @@
+#include <RendererTestPCH.h>
+
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Meshes/MeshComponentBase.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+
+// These tests only sort and batch extracted render data on the CPU, no GPU is needed.
+EZ_CREATE_SIMPLE_TEST_GROUP(Pipeline);
+
+namespace
+{
+  void CreateRenderData(ezDeque<ezMeshRenderData>& renderData, ezUInt32 uiCount, ezRandom& rng)
+  {
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      ezMeshRenderData& data = renderData.ExpandAndGetRef();
+      data.m_GlobalTransform.SetIdentity();
+      data.m_GlobalTransform.m_vPosition.Set(rng.FloatMinMax(-500.0f, 500.0f), rng.FloatMinMax(-500.0f, 500.0f), rng.FloatMinMax(-50.0f, 50.0f));
+
+      // few different batches and materials, like in a typical scene
+      data.m_uiBatchId = rng.UIntInRange(500);
+      data.m_uiSortingKey = rng.UIntInRange(200);
+    }
+  }
+
+  void ExtractRenderData(ezExtractedRenderData& extractedData, const ezDeque<ezMeshRenderData>& renderData)
+  {
+    const ezRenderData::Category categories[] = {ezDefaultRenderDataCategories::LitOpaque, ezDefaultRenderDataCategories::LitMasked,
+      ezDefaultRenderDataCategories::LitTransparent, ezDefaultRenderDataCategories::SimpleOpaque};
+
+    for (ezUInt32 i = 0; i < renderData.GetCount(); ++i)
+    {
+      extractedData.AddRenderData(&renderData[i], categories[i % EZ_ARRAY_SIZE(categories)]);
+    }
+  }
+
+  ezUInt32 CheckSortingAndBatches(const ezExtractedRenderData& extractedData, ezRenderData::Category category)
+  {
+    ezRenderDataBatchList batchList = extractedData.GetRenderDataBatchesWithCategory(category);
+
+    ezUInt32 uiNumRenderData = 0;
+    ezUInt64 uiPrevSortingKey = 0;
+    ezUInt32 uiPrevBatchId = 0;
+
+    for (ezUInt32 uiBatch = 0; uiBatch < batchList.GetBatchCount(); ++uiBatch)
+    {
+      ezRenderDataBatch batch = batchList.GetBatch(uiBatch);
+      const ezUInt32 uiBatchId = batch.GetFirstData<ezRenderData>()->m_uiBatchId;
+
+      for (auto it = batch.GetIterator<ezRenderData>(); it.IsValid(); ++it)
+      {
+        const ezUInt64 uiSortingKey = it->GetCategorySortingKey(category, extractedData.GetCamera());
+
+        EZ_TEST_INT(it->m_uiBatchId, uiBatchId);
+
+        const bool bSorted = uiSortingKey > uiPrevSortingKey || (uiSortingKey == uiPrevSortingKey && it->m_uiBatchId >= uiPrevBatchId);
+        EZ_TEST_BOOL(uiNumRenderData == 0 || bSorted);
+
+        uiPrevSortingKey = uiSortingKey;
+        uiPrevBatchId = it->m_uiBatchId;
+        ++uiNumRenderData;
+      }
+    }
+
+    return uiNumRenderData;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Pipeline, SortAndBatch)
+{
+  ezCamera camera;
+  camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 60.0f, 1.0f, 1000.0f);
+
+  ezRandom rng;
+  rng.Initialize(17);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sorting Order")
+  {
+    // small counts use a comparison sort, large counts the radix sort, both must result in the same order
+    const ezUInt32 counts[] = {10, 300, 20000};
+
+    for (ezUInt32 uiCount : counts)
+    {
+      ezDeque<ezMeshRenderData> renderData;
+      CreateRenderData(renderData, uiCount, rng);
+
+      ezExtractedRenderData extractedData;
+      extractedData.SetCamera(camera);
+      ExtractRenderData(extractedData, renderData);
+      extractedData.SortAndBatch();
+
+      ezUInt32 uiNumRenderData = 0;
+      uiNumRenderData += CheckSortingAndBatches(extractedData, ezDefaultRenderDataCategories::LitOpaque);
+      uiNumRenderData += CheckSortingAndBatches(extractedData, ezDefaultRenderDataCategories::LitMasked);
+      uiNumRenderData += CheckSortingAndBatches(extractedData, ezDefaultRenderDataCategories::LitTransparent);
+      uiNumRenderData += CheckSortingAndBatches(extractedData, ezDefaultRenderDataCategories::SimpleOpaque);
+
+      EZ_TEST_INT(uiNumRenderData, uiCount);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Performance")
+  {
+    const ezUInt32 counts[] = {10000, 50000, 200000};
+
+    for (ezUInt32 uiCount : counts)
+    {
+      ezDeque<ezMeshRenderData> renderData;
+      CreateRenderData(renderData, uiCount, rng);
+
+      ezExtractedRenderData extractedData;
+      extractedData.SetCamera(camera);
+
+      ezTime tExtract;
+      ezTime tSortAndBatch;
+      const ezUInt32 uiNumFrames = 8;
+
+      for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        extractedData.Clear();
+
+        ezStopwatch sw;
+        ExtractRenderData(extractedData, renderData);
+        tExtract += sw.Checkpoint();
+
+        extractedData.SortAndBatch();
+        tSortAndBatch += sw.Checkpoint();
+      }
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%u render data: extract %.3fms, sort and batch %.3fms", uiCount,
+        tExtract.GetMilliseconds() / uiNumFrames, tSortAndBatch.GetMilliseconds() / uiNumFrames);
+    }
+  }
+}